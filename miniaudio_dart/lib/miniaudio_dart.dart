@@ -5,11 +5,18 @@ export "package:miniaudio_dart_platform_interface/miniaudio_dart_platform_interf
     show
         AudioData,
         AudioFormat,
+        EngineLatency,
+        EngineLoadStats,
+        EqBandType,
+        LatencyProfile,
         MiniaudioDartPlatformException,
         MiniaudioDartPlatformOutOfMemoryException,
         NoiseType,
         RecorderCodec,
         RecorderCodecConfig,
+        StreamPlayerEvent,
+        StreamPlayerStats,
+        StreamPlayerTelemetryCallback,
         WaveformType;
 
 /// Controls the loading and unloading of `Sound`s.
@@ -29,90 +36,318 @@ final class Engine {
 
   final _engine = PlatformEngine();
   final _loadedSounds = <Sound>[];
+  final _buses = <String, MixBus>{};
+  final _effects = <AudioEffect>{};
 
   /// Initializes an engine.
   ///
-  /// Change an update period (affects the sound latency).
-  Future<void> init([int periodMs = 10]) async {
+  /// Change an update period (affects the sound latency). [loadThreads] sets
+  /// how many native threads serve [loadSoundAsync] (default 1).
+  Future<void> init([int periodMs = 10, int? loadThreads]) async {
     if (isInit) throw EngineAlreadyInitError();
 
+    if (loadThreads != null) _engine.setLoaderThreads(loadThreads);
     await _engine.init(periodMs);
     isInit = true;
   }
 
+  /// Initializes an engine with no device, for rendering offline (exports,
+  /// bounces, tests). Instead of [init]. Nothing plays: the mix advances
+  /// only as [render] or [renderToFile] pull it, as fast as the CPU allows,
+  /// and the same calls always produce the same audio. Sounds, scheduling
+  /// and voice limits behave as they do live; load sounds with `predecode`
+  /// so streaming cannot fall behind. Not supported on web.
+  void initOffline({int channels = 2, int sampleRate = 48000}) {
+    if (isInit) throw EngineAlreadyInitError();
+
+    _engine.initOffline(channels, sampleRate);
+    isInit = true;
+  }
+
+  /// The next [frames] of an offline engine's mix, [channels] samples per
+  /// frame.
+  Float32List render(int frames) => _engine.render(frames);
+
+  /// Renders the next [frames] of an offline engine's mix into a 32-bit
+  /// float WAV file at [path]. Returns `false` if the file could not be
+  /// written.
+  bool renderToFile(String path, int frames) =>
+      _engine.renderToFile(path, frames);
+
+  /// Opens the engine's device in full duplex: it captures
+  /// [captureChannels] from the default input in the same callback that
+  /// plays the engine, so capture and output share one clock. Must be
+  /// called before [init]. [buffer] is how much audio [readDuplex] can fall
+  /// behind before frames are dropped. Not supported on web.
+  void enableDuplex({
+    int captureChannels = 1,
+    Duration buffer = const Duration(milliseconds: 500),
+  }) {
+    if (isInit) throw EngineAlreadyInitError();
+    _engine.setDuplex(captureChannels, buffer.inMilliseconds);
+  }
+
+  /// Capture channels in duplex mode, `0` otherwise.
+  int get captureChannels => _engine.captureChannels;
+
+  /// Output channels of the engine.
+  int get channels => _engine.channels;
+
+  /// Frames [readDuplex] can return right now.
+  int get duplexAvailable => _engine.duplexAvailable;
+
+  /// Up to [maxFrames] of captured audio with the output the engine played
+  /// in the same callbacks, frame for frame: `capture` has
+  /// [captureChannels] samples per frame and `reference` has [channels].
+  /// The reference is the far-end signal an echo canceller subtracts.
+  (Float32List capture, Float32List reference) readDuplex(int maxFrames) =>
+      _engine.readDuplex(maxFrames);
+
+  /// Gain of the capture mixed straight into the output in duplex mode, for
+  /// monitoring without a round trip through Dart. `0` (default) is off.
+  double get monitorGain => _engine.monitorGain;
+  set monitorGain(double value) => _engine.monitorGain = value;
+
+  /// Chooses how the engine's device is opened, trading robustness for
+  /// latency. Must be called before [init]:
+  /// - [LatencyProfile.conservative]: the `periodMs` passed to [init], as
+  ///   when no profile is set.
+  /// - [LatencyProfile.lowLatency]: 256-frame periods, 3 of them.
+  /// - [LatencyProfile.ultra]: 128-frame periods, 2 of them, exclusive
+  ///   mode where offered, and JACK or ALSA ahead of PulseAudio on Linux
+  ///   (if no engine, recorder or generator is running yet).
+  ///
+  /// [periodFrames], [periods] and [exclusive] override the profile. The
+  /// backend may not grant all of it: check [latency] after [init]. No-op
+  /// on web.
+  void setLatencyProfile(
+    LatencyProfile profile, {
+    int? periodFrames,
+    int? periods,
+    bool? exclusive,
+  }) {
+    if (isInit) throw EngineAlreadyInitError();
+    _engine.setLatencyProfile(profile,
+        periodFrames: periodFrames, periods: periods, exclusive: exclusive);
+  }
+
+  /// The output latency the backend negotiated: period size and count,
+  /// their total in milliseconds, the share mode and the backend name.
+  EngineLatency get latency => _engine.latency;
+
+  /// How busy the audio thread is: the share of each callback's period
+  /// spent rendering (smoothed and worst), the longest callback, and xruns
+  /// (callbacks that missed their deadline). Cheap enough to poll at a few
+  /// Hz, e.g. to lower [maxVoices] or codec complexity while
+  /// [EngineLoadStats.load] stays high. Counts restart when the output
+  /// device changes; not measured on web or offline.
+  EngineLoadStats get loadStats => _engine.loadStats;
+  void resetLoadStats() => _engine.resetLoadStats();
+
   /// Starts an engine.
   Future<void> start() async => _engine.start();
 
   /// Copies `data` to the internal memory location and creates a `Sound` from it.
-  Future<Sound> loadSound(AudioData audioData) async {
-    final engineSound = await _engine.loadSound(audioData);
+  ///
+  /// With [predecode], encoded data (MP3, FLAC, WAV...) is decoded once to PCM
+  /// in the engine's format and rate, so playback costs only a mix. Set
+  /// [background] to do that work off the calling isolate (native only).
+  Future<Sound> loadSound(
+    AudioData audioData, {
+    bool predecode = false,
+    bool background = false,
+  }) async {
+    final engineSound = await _engine.loadSound(
+      audioData,
+      predecode: predecode,
+      background: background,
+    );
+    final sound = Sound._(engineSound);
+    _loadedSounds.add(sound);
+    _soundsFinalizer.attach(this, sound, detach: sound);
+    return sound;
+  }
+
+  /// Creates a `Sound` that plays [path] without reading it into memory.
+  ///
+  /// By default the file is streamed from disk in small pages, which suits
+  /// long-form audio. [memoryMapped] decodes from a memory mapping of the
+  /// file instead; [predecode] decodes it fully to PCM like [loadSound].
+  /// Not available on the web.
+  Future<Sound> loadSoundFile(
+    String path, {
+    bool memoryMapped = false,
+    bool predecode = false,
+  }) async {
+    final engineSound = await _engine.loadSoundFile(
+      path,
+      memoryMapped: memoryMapped,
+      predecode: predecode,
+    );
+    return _register(engineSound);
+  }
+
+  /// Like [loadSound], but the work runs on the engine's native load
+  /// threads and this returns as soon as the data is copied. Issue many of
+  /// these together to load a level in parallel (see `init`'s `loadThreads`).
+  Future<Sound> loadSoundAsync(
+    AudioData audioData, {
+    bool predecode = false,
+  }) async =>
+      _register(await _engine.loadSoundAsync(audioData, predecode: predecode));
+
+  /// Like [loadSoundFile], on the engine's native load threads.
+  Future<Sound> loadSoundFileAsync(
+    String path, {
+    bool memoryMapped = false,
+    bool predecode = false,
+  }) async =>
+      _register(await _engine.loadSoundFileAsync(
+        path,
+        memoryMapped: memoryMapped,
+        predecode: predecode,
+      ));
+
+  /// Number of async loads not yet completed.
+  int get pendingLoads => _engine.pendingLoads;
+
+  Sound _register(PlatformSound engineSound) {
     final sound = Sound._(engineSound);
     _loadedSounds.add(sound);
     _soundsFinalizer.attach(this, sound, detach: sound);
     return sound;
   }
 
+  /// Creates a `Sound` that shares its data with every other sound loaded
+  /// from the same asset, so many instances of one sample cost one copy.
+  ///
+  /// Assets are identified by [key] or, without one, by their content. Once
+  /// a key is cached `audioData` may be null. [predecode] caches the decoded
+  /// PCM rather than the encoded bytes (see [loadSound]).
+  Future<Sound> loadSoundShared(
+    AudioData? audioData, {
+    String? key,
+    bool predecode = false,
+  }) async {
+    final engineSound = await _engine.loadSoundShared(
+      audioData,
+      key: key,
+      predecode: predecode,
+    );
+    final sound = Sound._(engineSound);
+    _loadedSounds.add(sound);
+    _soundsFinalizer.attach(this, sound, detach: sound);
+    return sound;
+  }
+
+  /// Whether an asset with [key] is cached.
+  bool hasSharedAsset(String key) => _engine.hasSharedAsset(key);
+
+  /// Removes [key] from the cache. Sounds already using it keep playing.
+  bool evictSharedAsset(String key) => _engine.evictSharedAsset(key);
+
+  /// Frees cached assets no sound uses any more. Returns the bytes released.
+  int trimSharedAssets() => _engine.trimSharedAssets();
+
+  /// Number of cached assets and their total size in bytes.
+  (int count, int bytes) get sharedAssetStats => _engine.sharedAssetStats;
+
+  /// Caps how many sounds are mixed at once (`0`, the default, means no cap).
+  ///
+  /// Playing sounds are ranked by [Sound.priority] times their volume; the
+  /// rest keep time silently without being decoded or mixed, and resume in
+  /// place once they rank high enough again.
+  int get maxVoices => _engine.maxVoices;
+  set maxVoices(int value) => _engine.maxVoices = value < 0 ? 0 : value;
+
+  /// Voices mixed and virtualized in the last audio callback.
+  (int mixed, int virtualized) get voiceStats => _engine.voiceStats;
+
+  /// The engine clock: output frames mixed since init, at [sampleRate].
+  ///
+  /// Schedule against it with [Sound.playAt] and [Sound.stopAt], e.g.
+  /// `sound.playAt(engine.timeInFrames + engine.sampleRate ~/ 2)`. Always `0`
+  /// on web, where scheduled calls act immediately.
+  int get timeInFrames => _engine.timeInFrames;
+  int get sampleRate => _engine.sampleRate;
+
+  /// The bus called [name], created the first time it is asked for. A new
+  /// bus plays straight to the engine; set its [MixBus.parent] to nest it.
+  ///
+  /// Route sounds, stream players and playlists into it with their `bus`
+  /// setters. One [MixBus.volume] or [MixBus.muted] change then applies to
+  /// all of them at once.
+  MixBus bus(String name) =>
+      _buses[name] ??= MixBus._(this, _engine.createBus(name));
+
+  /// Buses created so far, by name.
+  Map<String, MixBus> get buses => Map.unmodifiable(_buses);
+
+  /// An equalizer of [EqEffect.bands] bands: a low shelf, two peaks and a
+  /// high shelf, all flat until a gain is set.
+  ///
+  /// Effects do nothing until added to a sound, playlist, stream player or
+  /// bus with `addEffect`, and can be tuned while playing.
+  EqEffect createEq() =>
+      _track(EqEffect._(this, _engine.createEffect(EffectType.eq)));
+
+  /// A compressor, for taming peaks or gluing a bus together.
+  CompressorEffect createCompressor() => _track(
+      CompressorEffect._(this, _engine.createEffect(EffectType.compressor)));
+
+  /// A brickwall limiter, keeping its output under [LimiterEffect.ceiling].
+  /// Usually the last effect on a bus.
+  LimiterEffect createLimiter() => _track(
+      LimiterEffect._(this, _engine.createEffect(EffectType.limiter)));
+
+  /// An algorithmic room reverb. Best on a bus the dry sounds are sent to
+  /// as well as played directly, or with a [AudioEffect.mix] below `1`.
+  ReverbEffect createReverb() =>
+      _track(ReverbEffect._(this, _engine.createEffect(EffectType.reverb)));
+
+  T _track<T extends AudioEffect>(T effect) {
+    _effects.add(effect);
+    return effect;
+  }
+
+  /// Creates a gapless [Playlist] playing through this engine, blending
+  /// consecutive items over [crossfade].
+  Playlist createPlaylist({Duration crossfade = Duration.zero}) =>
+      Playlist._(_engine.createPlaylist(
+          crossfade < Duration.zero ? 0 : crossfade.inMilliseconds));
+
   /// Enumerate playback devices. Returns (name, isDefault).
   Future<List<(String, bool)>> enumeratePlaybackDevices() =>
       _engine.enumeratePlaybackDevices();
 
-  /// Select playback device by index (recreates native engine).
+  /// Moves output to the playback device at [index]. Only the native
+  /// device is swapped: sounds, stream players and playlists keep playing
+  /// from where they were, buffered stream audio included. On failure the
+  /// current device stays in use.
   Future<bool> selectPlaybackDeviceByIndex(int index) =>
       _engine.selectPlaybackDeviceByIndex(index);
 
-  /// Convenience: stop engine, switch device, restart.
+  /// Starts the engine if needed and switches to the device at [index].
   Future<bool> switchPlaybackDevice(int index) async {
     if (!isInit) return false;
     try {
-      // Caller should have disposed sounds/stream players first.
-      await start(); // ensures engine started (no-op if already)
-      // Stop before swap (platform engine handles internally if needed).
-      final ok = await selectPlaybackDeviceByIndex(index);
-      if (!ok) return false;
-      // Restart if needed.
-      await start();
-      return true;
+      await start(); // no-op if already started
+      return await selectPlaybackDeviceByIndex(index);
     } catch (_) {
       return false;
     }
   }
 
-  /// Switch playback device AND rebuild loaded sounds & stream players.
-  /// Generators & StreamPlayers are disposed and recreated (simpler & safe).
+  /// Same as [selectPlaybackDeviceByIndex]. Nothing has to be rebuilt
+  /// after a switch any more, so [streamPlayers] and [generators] are
+  /// ignored (generators have devices of their own).
   Future<bool> switchPlaybackDeviceAndRebuild(
     int index, {
     List<StreamPlayer>? streamPlayers,
     List<Generator>? generators,
   }) async {
     if (!isInit) return false;
-
-    final soundsToRebind = List<Sound>.from(_loadedSounds);
-
-    for (final s in soundsToRebind) {
-      try {
-        s.pause();
-      } catch (_) {}
-    }
-    streamPlayers?.forEach((sp) {
-      try {
-        sp.stop();
-      } catch (_) {}
-    });
-    generators?.forEach((g) {
-      try {
-        g.stop();
-      } catch (_) {}
-    });
-
-    final ok = await selectPlaybackDeviceByIndex(index);
-    if (!ok) return false;
-
-    for (final s in soundsToRebind) {
-      s._rebindAfterDeviceChange(this);
-    }
-
-    // StreamPlayers / Generators: simplest is caller recreates; skip snapshot complexity
-    return true;
+    return selectPlaybackDeviceByIndex(index);
   }
 
   /// Polls playback device generation and emits updated device lists.
@@ -137,9 +372,9 @@ final class Engine {
     }
   }
 
-  /// Switch playback device while keeping an optional recorder running.
-  /// If [monitorPlayer] provided, it is rebuilt (preserving basic params & volume).
-  /// Recorder keeps running; only monitoring is briefly interrupted.
+  /// Same as [selectPlaybackDeviceByIndex]: [recorder] has its own capture
+  /// device and [monitorPlayer] keeps playing through the switch, so both
+  /// run on untouched. [rebindSounds] is ignored for the same reason.
   Future<bool> switchPlaybackDevicePreservingMonitoring({
     required int index,
     Recorder? recorder,
@@ -147,102 +382,39 @@ final class Engine {
     bool rebindSounds = true,
   }) async {
     if (!isInit) return false;
-
-    // Snapshot monitor state
-    double? monitorVolume;
-    bool monitorWasStarted = false;
-    int? monChannels, monRate, monBufferMs;
-    if (monitorPlayer != null && monitorPlayer.isInit) {
-      monitorVolume = monitorPlayer.volume;
-      monitorWasStarted = monitorPlayer.isInit;
-      monChannels = monitorPlayer._channels;
-      monRate = monitorPlayer._sampleRate;
-      monBufferMs = monitorPlayer._bufferMs;
-      try {
-        monitorPlayer.stop();
-      } catch (_) {}
-    }
-
-    // (Optional) pause sounds before switch to avoid glitches
-    List<Sound> pausedSounds = [];
-    if (rebindSounds) {
-      pausedSounds = List<Sound>.from(_loadedSounds);
-      for (final s in pausedSounds) {
-        try {
-          s.pause();
-        } catch (_) {}
-      }
-    }
-
-    final ok = await selectPlaybackDeviceByIndex(index);
-    if (!ok) {
-      // Try to resume monitor if selection failed
-      if (monitorPlayer != null && monitorPlayer.isInit && monitorWasStarted) {
-        try {
-          monitorPlayer.start();
-        } catch (_) {}
-      }
-      return false;
-    }
-
-    // Rebind sounds (FFI impl does work; Web no-op)
-    if (rebindSounds) {
-      for (final s in pausedSounds) {
-        try {
-          s._rebindAfterDeviceChange(this);
-        } catch (_) {}
-      }
-      for (final s in pausedSounds) {
-        try {
-          s.play();
-        } catch (_) {}
-      }
-    }
-
-    // Recreate / re-init monitor player (simplest: dispose + new)
-    if (monitorPlayer != null) {
-      if (monitorPlayer.isInit) {
-        try {
-          monitorPlayer.dispose();
-        } catch (_) {}
-      }
-      final newPlayer = StreamPlayer(mainEngine: this);
-      await newPlayer.init(
-        channels: monChannels ?? 1,
-        sampleRate: monRate ?? 48000,
-        bufferMs: monBufferMs ?? 240,
-        format: AudioFormat.float32,
-      );
-      if (monitorVolume != null) {
-        newPlayer.volume = monitorVolume;
-      }
-      if (monitorWasStarted) {
-        newPlayer.start();
-      }
-      // Let caller replace their reference
-      monitorPlayer._replaceFrom(newPlayer);
-    }
-
-    return true;
+    return selectPlaybackDeviceByIndex(index);
   }
 
   /// Gracefully shut down the engine.
   /// PlatformEngine does not expose `uninit`; we just dispose.
   Future<void> uninit() async {
     if (!isInit) return;
+    for (final effect in List.of(_effects)) {
+      effect.dispose();
+    }
     try {
       _engine.dispose();
     } catch (_) {}
+    for (final bus in _buses.values) {
+      bus._disposed = true;
+    }
+    _buses.clear();
     isInit = false;
   }
 }
 
 /// A sound.
-final class Sound {
+final class Sound with _EffectChain {
   Sound._(PlatformSound sound) : _sound = sound;
 
   final PlatformSound _sound;
 
+  @override
+  bool _insertEffect(PlatformEffect effect, int index) =>
+      _sound.insertEffect(effect, index);
+  @override
+  bool _removeEffect(PlatformEffect effect) => _sound.removeEffect(effect);
+
   /// a `double` greater than `0` (values greater than `1` may behave differently from platform to platform)
   double get volume => _sound.volume;
   set volume(double value) => _sound.volume = value < 0 ? 0 : value;
@@ -250,6 +422,11 @@ final class Sound {
   Duration get duration =>
       Duration(milliseconds: (_sound.duration * 1000).toInt());
 
+  /// Weight under [Engine.maxVoices]; `0` makes the sound the first to be
+  /// virtualized. Defaults to `1`.
+  double get priority => _sound.priority;
+  set priority(double value) => _sound.priority = value < 0 ? 0 : value;
+
   bool get isLooped => _sound.looping.$1;
   Duration get loopDelay => Duration(milliseconds: _sound.looping.$2);
 
@@ -290,14 +467,460 @@ final class Sound {
     _sound.stop();
   }
 
-  void unload() => _sound.unload();
+  /// Like [play], but starts exactly at the engine time [timeInFrames] (see
+  /// [Engine.timeInFrames]) rather than when the call lands. A time already
+  /// passed starts in the next audio callback.
+  void playAt(int timeInFrames) {
+    if (_sound.looping.$1) _sound.looping = (false, 0);
+
+    _sound.stop();
+    if (!_sound.playAt(timeInFrames)) {
+      throw MiniaudioDartPlatformException("Failed to schedule the sound.");
+    }
+  }
+
+  /// Stops the sound exactly at the engine time [timeInFrames]. The position
+  /// is kept, as with [pause].
+  void stopAt(int timeInFrames) => _sound.stopAt(timeInFrames);
+
+  /// The bus this sound and its voices play into; null is the engine.
+  MixBus? get bus => _bus;
+  set bus(MixBus? value) {
+    if (value == _bus) return;
+    if (!_sound.setBus(MixBus._platform(value))) {
+      throw MiniaudioDartPlatformException("Failed to route the sound.");
+    }
+    _bus?._sounds.remove(this);
+    value?._sounds.add(this);
+    _bus = value;
+  }
+
+  MixBus? _bus;
+
+  void unload() {
+    _bus?._sounds.remove(this);
+    _bus = null;
+    _releaseEffects();
+    _sound.unload();
+  }
+
+  /// Lets the sound overlap itself with up to [maxVoices] plays through
+  /// [playVoice] (footsteps, gunshots) without loading copies. The voices
+  /// are allocated here; when all are busy [policy] picks the one to take
+  /// over. `0` releases them.
+  bool setPolyphony(
+    int maxVoices, {
+    VoiceStealPolicy policy = VoiceStealPolicy.oldest,
+  }) =>
+      _sound.setPolyphony(maxVoices, policy);
+
+  int get polyphony => _sound.polyphony;
+
+  /// Number of voices currently playing.
+  int get activeVoices => _sound.activeVoices;
+
+  /// Starts one more overlapping instance on a free (or stolen) voice.
+  ///
+  /// Returns null when no voice could be had: none were set up with
+  /// [setPolyphony], or the policy refused to steal.
+  SoundVoice? playVoice({
+    double volume = 1,
+    int priority = 0,
+    bool looped = false,
+  }) {
+    final id = _sound.playVoice(volume < 0 ? 0 : volume, priority, looped);
+    return id == 0 ? null : SoundVoice._(_sound, id);
+  }
+
+  /// [playVoice] starting exactly at the engine time [timeInFrames]. A voice
+  /// waiting for its start counts as busy.
+  SoundVoice? playVoiceAt(
+    int timeInFrames, {
+    double volume = 1,
+    int priority = 0,
+    bool looped = false,
+  }) {
+    final id = _sound.playVoiceAt(
+        volume < 0 ? 0 : volume, priority, looped, timeInFrames);
+    return id == 0 ? null : SoundVoice._(_sound, id);
+  }
+}
+
+/// One play started by [Sound.playVoice].
+///
+/// Once the voice finishes or is stolen by a later play the handle goes
+/// stale and its methods do nothing.
+final class SoundVoice {
+  SoundVoice._(this._sound, this._id);
+
+  final PlatformSound _sound;
+  final int _id;
+
+  bool get isPlaying => _sound.isVoicePlaying(_id);
+  set volume(double value) => _sound.setVoiceVolume(_id, value < 0 ? 0 : value);
+  void stop() => _sound.stopVoice(_id);
+}
+
+/// A queue of tracks played back to back without gaps (albums, ad breaks).
+///
+/// Each item is opened and its first moments decoded when it is added, so
+/// track changes never wait on a decoder. With a [crossfade] an item is
+/// blended into the next one over its last frames. Once drained the
+/// playlist plays silence until more is added.
+final class Playlist with _EffectChain {
+  Playlist._(PlatformPlaylist playlist) : _playlist = playlist;
+
+  final PlatformPlaylist _playlist;
+
+  @override
+  bool _insertEffect(PlatformEffect effect, int index) =>
+      _playlist.insertEffect(effect, index);
+  @override
+  bool _removeEffect(PlatformEffect effect) => _playlist.removeEffect(effect);
+
+  double get volume => _playlist.volume;
+  set volume(double value) => _playlist.volume = value < 0 ? 0 : value;
+
+  Duration get crossfade => Duration(milliseconds: _playlist.crossfadeMs);
+  set crossfade(Duration value) => _playlist.crossfadeMs =
+      value < Duration.zero ? 0 : value.inMilliseconds;
+
+  /// Queues encoded ([AudioFormat.unknown]) or raw PCM data. Returns the
+  /// item's id, as reported by [current].
+  int add(AudioData audioData) {
+    final id = _playlist.add(audioData);
+    if (id == 0) {
+      throw MiniaudioDartPlatformException("Failed to queue the audio.");
+    }
+    return id;
+  }
+
+  /// Queues an encoded file, streamed from disk (native only).
+  int addFile(String path) {
+    final id = _playlist.addFile(path);
+    if (id == 0) {
+      throw MiniaudioDartPlatformException("Failed to queue $path.");
+    }
+    return id;
+  }
+
+  void play() => _playlist.start();
+  void stop() => _playlist.stop();
+
+  /// Moves on to the next item.
+  void skip() => _playlist.skip();
+
+  /// Drops every item, the playing one included.
+  void clear() => _playlist.clear();
+
+  /// Id of the item playing, or null when the queue is drained.
+  int? get current {
+    final id = _playlist.current;
+    return id == 0 ? null : id;
+  }
+
+  /// Items left, the playing one included.
+  int get queued => _playlist.queued;
 
-  void _rebindAfterDeviceChange(Engine engine) {
-    // Delegates to platform implementation (FFI will perform real rebind, Web no-op).
-    _sound.rebindToEngine(engine._engine);
+  /// The bus this playlist plays into; null is the engine.
+  MixBus? get bus => _bus;
+  set bus(MixBus? value) {
+    if (value == _bus) return;
+    if (!_playlist.setBus(MixBus._platform(value))) {
+      throw MiniaudioDartPlatformException("Failed to route the playlist.");
+    }
+    _bus?._playlists.remove(this);
+    value?._playlists.add(this);
+    _bus = value;
+  }
+
+  MixBus? _bus;
+
+  void dispose() {
+    _bus?._playlists.remove(this);
+    _bus = null;
+    _releaseEffects();
+    _playlist.dispose();
   }
 }
 
+/// A named submix, from [Engine.bus].
+///
+/// Everything routed into a bus is summed once, then scaled by its
+/// [volume] and [muted] state on the way to its [parent], or the engine.
+/// Both changes are smoothed over a few milliseconds, so they do not click.
+final class MixBus with _EffectChain {
+  MixBus._(this._engine, this._bus);
+
+  final Engine _engine;
+  final PlatformMixBus _bus;
+  bool _disposed = false;
+
+  // Members, moved to the parent when the bus is disposed.
+  final _sounds = <Sound>{};
+  final _players = <StreamPlayer>{};
+  final _playlists = <Playlist>{};
+  final _children = <MixBus>{};
+
+  static PlatformMixBus? _platform(MixBus? bus) {
+    if (bus != null && bus._disposed) {
+      throw StateError("Bus ${bus.name} is disposed.");
+    }
+    return bus?._bus;
+  }
+
+  @override
+  bool _insertEffect(PlatformEffect effect, int index) =>
+      _bus.insertEffect(effect, index);
+  @override
+  bool _removeEffect(PlatformEffect effect) => _bus.removeEffect(effect);
+
+  String get name => _bus.name;
+
+  double get volume => _bus.volume;
+  set volume(double value) => _bus.volume = value < 0 ? 0 : value;
+
+  bool get muted => _bus.muted;
+  set muted(bool value) => _bus.muted = value;
+
+  /// The bus this one plays into; null is the engine. Throws
+  /// [ArgumentError] for a parent that would route back into this bus.
+  MixBus? get parent => _parent;
+  set parent(MixBus? value) {
+    if (value == _parent) return;
+    if (!_bus.setParent(MixBus._platform(value))) {
+      throw ArgumentError.value(value?.name, "parent", "would form a cycle");
+    }
+    _parent?._children.remove(this);
+    value?._children.add(this);
+    _parent = value;
+  }
+
+  MixBus? _parent;
+
+  /// Moves everything routed here to [parent] and releases the bus. The
+  /// name is free for [Engine.bus] again.
+  void dispose() {
+    if (_disposed) return;
+    for (final sound in List.of(_sounds)) {
+      sound.bus = _parent;
+    }
+    for (final player in List.of(_players)) {
+      player.bus = _parent;
+    }
+    for (final playlist in List.of(_playlists)) {
+      playlist.bus = _parent;
+    }
+    for (final child in List.of(_children)) {
+      child.parent = _parent;
+    }
+    parent = null;
+    _disposed = true;
+    _engine._buses.remove(name);
+    _releaseEffects();
+    _bus.dispose();
+  }
+}
+
+/// Effects in series on a sound, playlist, stream player or bus: the first
+/// of [effects] processes the source, the last feeds its bus or the engine.
+/// On a sound they process its voices too; on a bus they come after its
+/// volume.
+mixin _EffectChain {
+  final _chain = <AudioEffect>[];
+
+  bool _insertEffect(PlatformEffect effect, int index);
+  bool _removeEffect(PlatformEffect effect);
+
+  /// The effects in processing order.
+  List<AudioEffect> get effects => List.unmodifiable(_chain);
+
+  /// Inserts [effect] at [index] of [effects], or appends it. Up to 8
+  /// effects per chain. Throws [StateError] for an effect that is disposed
+  /// or already in a chain.
+  void addEffect(AudioEffect effect, [int? index]) {
+    if (effect._disposed) throw StateError("The effect is disposed.");
+    if (effect._host != null) {
+      throw StateError("The effect is already in a chain.");
+    }
+    final at = index == null || index < 0 || index > _chain.length
+        ? _chain.length
+        : index;
+    if (!_insertEffect(effect._effect, at)) {
+      throw MiniaudioDartPlatformException("Failed to insert the effect.");
+    }
+    _chain.insert(at, effect);
+    effect._host = this;
+  }
+
+  /// Takes [effect] out of the chain; it can be added elsewhere afterwards.
+  /// False if it was not in this chain.
+  bool removeEffect(AudioEffect effect) {
+    if (!_chain.remove(effect)) return false;
+    effect._host = null;
+    _removeEffect(effect._effect);
+    return true;
+  }
+
+  // The native chain lets go along with its owner.
+  void _releaseEffects() {
+    for (final effect in _chain) {
+      effect._host = null;
+    }
+    _chain.clear();
+  }
+}
+
+/// A built-in effect, from the `create` methods of [Engine].
+///
+/// Parameters can be changed while playing: levels, frequencies and [mix]
+/// glide to their new value over about 20 ms rather than jump, so they do
+/// not click. Values outside a parameter's range are clamped.
+sealed class AudioEffect {
+  AudioEffect._(this._engine, this._effect);
+
+  final Engine _engine;
+  final PlatformEffect _effect;
+  _EffectChain? _host;
+  bool _disposed = false;
+
+  /// `0` passes the input untouched, `1` is fully processed.
+  double get mix => _effect.getParam(EffectParam.mix);
+  set mix(double value) => _set(EffectParam.mix, value);
+
+  /// Forgets the signal processed so far (filter memory, envelopes, the
+  /// reverb tail), e.g. before reusing the effect on other material.
+  void reset() => _effect.reset();
+
+  /// Takes the effect out of its chain and releases it.
+  void dispose() {
+    if (_disposed) return;
+    _host?.removeEffect(this);
+    _disposed = true;
+    _engine._effects.remove(this);
+    _effect.dispose();
+  }
+
+  void _set(int param, double value) {
+    if (_disposed) throw StateError("The effect is disposed.");
+    _effect.setParam(param, value);
+  }
+
+  Duration _getMs(int param) =>
+      Duration(microseconds: (_effect.getParam(param) * 1000).round());
+  void _setMs(int param, Duration value) =>
+      _set(param, value.inMicroseconds / 1000);
+}
+
+/// Parametric equalizer of [bands] biquad bands in series. By default
+/// a low shelf at 100 Hz, peaks at 500 and 2500 Hz and a high shelf at
+/// 8 kHz, with no gain.
+final class EqEffect extends AudioEffect {
+  EqEffect._(super.engine, super.effect) : super._();
+
+  static const bands = EffectParam.eqBands;
+
+  /// Changes band [band] (`0` to [bands] - 1). [gainDb] applies to peaks and
+  /// shelves, ±24 dB; [q] sets a peak's width or a filter's resonance.
+  /// A new [type] switches at once, so set it before playing.
+  void setBand(
+    int band, {
+    EqBandType? type,
+    double? frequency,
+    double? gainDb,
+    double? q,
+  }) {
+    RangeError.checkValidIndex(band, null, "band", bands);
+    if (type != null) _set(EffectParam.eqType(band), type.index.toDouble());
+    if (frequency != null) _set(EffectParam.eqFrequency(band), frequency);
+    if (gainDb != null) _set(EffectParam.eqGain(band), gainDb);
+    if (q != null) _set(EffectParam.eqQ(band), q);
+  }
+
+  EqBandType bandType(int band) =>
+      EqBandType.values[_effect.getParam(EffectParam.eqType(band)).round()];
+  double bandFrequency(int band) =>
+      _effect.getParam(EffectParam.eqFrequency(band));
+  double bandGainDb(int band) => _effect.getParam(EffectParam.eqGain(band));
+  double bandQ(int band) => _effect.getParam(EffectParam.eqQ(band));
+}
+
+/// Downward compressor: levels over [thresholdDb] are scaled down by
+/// [ratio], eased in over [kneeDb], following peaks with [attack] and
+/// [release].
+final class CompressorEffect extends AudioEffect {
+  CompressorEffect._(super.engine, super.effect) : super._();
+
+  double get thresholdDb => _effect.getParam(EffectParam.threshold);
+  set thresholdDb(double value) => _set(EffectParam.threshold, value);
+
+  double get ratio => _effect.getParam(EffectParam.ratio);
+  set ratio(double value) => _set(EffectParam.ratio, value);
+
+  double get kneeDb => _effect.getParam(EffectParam.knee);
+  set kneeDb(double value) => _set(EffectParam.knee, value);
+
+  Duration get attack => _getMs(EffectParam.attack);
+  set attack(Duration value) => _setMs(EffectParam.attack, value);
+
+  Duration get release => _getMs(EffectParam.release);
+  set release(Duration value) => _setMs(EffectParam.release, value);
+
+  double get makeupDb => _effect.getParam(EffectParam.makeup);
+  set makeupDb(double value) => _set(EffectParam.makeup, value);
+
+  /// Delays the audio (up to 20 ms) so the gain moves before a peak
+  /// arrives. Switches at once.
+  Duration get lookahead => _getMs(EffectParam.lookahead);
+  set lookahead(Duration value) => _setMs(EffectParam.lookahead, value);
+
+  /// Gain reduction applied in the last few milliseconds, in dB (`<= 0`).
+  double get reductionDb => _effect.reductionDb;
+}
+
+/// Brickwall limiter: the audio is delayed by [lookahead] so the gain is
+/// already down when a peak comes out, and no sample exceeds [ceilingDb].
+final class LimiterEffect extends AudioEffect {
+  LimiterEffect._(super.engine, super.effect) : super._();
+
+  double get ceilingDb => _effect.getParam(EffectParam.ceiling);
+  set ceilingDb(double value) => _set(EffectParam.ceiling, value);
+
+  Duration get release => _getMs(EffectParam.release);
+  set release(Duration value) => _setMs(EffectParam.release, value);
+
+  /// Up to 20 ms; `0` limits without delay but lets the start of a peak
+  /// through. Switches at once.
+  Duration get lookahead => _getMs(EffectParam.lookahead);
+  set lookahead(Duration value) => _setMs(EffectParam.lookahead, value);
+
+  /// Gain reduction applied in the last few milliseconds, in dB (`<= 0`).
+  double get reductionDb => _effect.reductionDb;
+}
+
+/// Feedback delay network reverb.
+final class ReverbEffect extends AudioEffect {
+  ReverbEffect._(super.engine, super.effect) : super._();
+
+  /// Time for the tail to fall by 60 dB, 0.1 to 30 s.
+  Duration get decay => Duration(
+      milliseconds: (_effect.getParam(EffectParam.decay) * 1000).round());
+  set decay(Duration value) =>
+      _set(EffectParam.decay, value.inMilliseconds / 1000);
+
+  /// `0` bright to `1` dark: how much faster highs die away.
+  double get damping => _effect.getParam(EffectParam.damping);
+  set damping(double value) => _set(EffectParam.damping, value);
+
+  /// Gap before the tail starts, up to 200 ms. Switches at once.
+  Duration get predelay => _getMs(EffectParam.predelay);
+  set predelay(Duration value) => _setMs(EffectParam.predelay, value);
+
+  /// `0` mono to `1` full stereo tail.
+  double get width => _effect.getParam(EffectParam.width);
+  set width(double value) => _set(EffectParam.width, value);
+}
+
 /// Standalone codec for manual encoding/decoding
 final class CrossCoder {
   CrossCoder()
@@ -478,6 +1101,31 @@ final class Recorder {
   double get captureGain => _recorder.captureGain;
   set captureGain(double value) => _recorder.captureGain = value;
 
+  /// How far (dB) the built-in noise suppressor pulls down the noise
+  /// floor; `0` (default) turns it off. Float32 recorders only. Runs on
+  /// the capture thread before frames are buffered or encoded.
+  double get noiseSuppression => _recorder.noiseSuppression;
+  set noiseSuppression(double reductionDb) =>
+      _recorder.noiseSuppression = reductionDb;
+
+  /// Cancels the echo of what [engine] (this recorder's by default) plays
+  /// from the captured audio, before the noise suppressor. [filterLength]
+  /// is the longest echo path modelled. Disable it, or dispose the
+  /// recorder, before the engine goes away. Returns false where
+  /// unsupported (web, or a non-float32 recorder).
+  bool enableEchoCancellation({
+    Engine? engine,
+    Duration filterLength = const Duration(milliseconds: 64),
+  }) =>
+      _recorder.enableEchoCancellation(
+          (engine ?? this.engine)._engine, filterLength.inMilliseconds);
+
+  void disableEchoCancellation() => _recorder.disableEchoCancellation();
+
+  /// How much echo is removed, in dB (0 while disabled).
+  double get echoReturnLossEnhancement =>
+      _recorder.echoReturnLossEnhancement;
+
   /// Disposes of the recorder resources.
   void dispose() {
     _recorder.dispose();
@@ -622,7 +1270,7 @@ final class Generator {
 }
 
 /// Streamed playback of raw PCM (low latency, no per-chunk sounds).
-final class StreamPlayer {
+final class StreamPlayer with _EffectChain {
   StreamPlayer({Engine? mainEngine}) : engine = mainEngine ?? Engine();
 
   final Engine engine;
@@ -632,14 +1280,24 @@ final class StreamPlayer {
   int _sampleRate = 48000;
   int _format = AudioFormat.float32;
   int _bufferMs = 100;
+  bool _buffered = false;
+  int _prerollMs = 0;
+  int _fadeMs = 0;
   bool _isStarted = false;
+  StreamPlayer? _duckSidechain;
+  (double, double, int, int) _duckParams = (0.05, 0.25, 10, 250);
 
   // Initialize the underlying stream player.
+  // [prerollMs] holds playback until that much audio is queued (also after an
+  // underrun), with [fadeMs] fades at the transitions (0 = 5 ms).
   Future<void> init({
     int format = AudioFormat.float32,
     int channels = 1,
     int sampleRate = 48000,
     int bufferMs = 100,
+    bool buffered = false,
+    int prerollMs = 0,
+    int fadeMs = 0,
   }) async {
     if (_isInit) return;
     if (!engine.isInit) {
@@ -653,12 +1311,18 @@ final class StreamPlayer {
     _sampleRate = sampleRate;
     _format = format;
     _bufferMs = bufferMs;
+    _buffered = buffered;
+    _prerollMs = prerollMs;
+    _fadeMs = fadeMs;
     _player = MiniaudioDartPlatformInterface.instance.createStreamPlayer(
       engine: engine._engine,
       format: _format,
       channels: _channels,
       sampleRate: _sampleRate,
       bufferMs: _bufferMs,
+      buffered: _buffered,
+      prerollMs: _prerollMs,
+      fadeMs: _fadeMs,
     );
     _isInit = true;
   }
@@ -669,6 +1333,31 @@ final class StreamPlayer {
     _player!.volume = v < 0 ? 0 : v;
   }
 
+  /// The bus this player plays into; null is the engine.
+  MixBus? get bus => _bus;
+  set bus(MixBus? value) {
+    _ensureInit();
+    if (value == _bus) return;
+    if (!_player!.setBus(MixBus._platform(value))) {
+      throw MiniaudioDartPlatformException("Failed to route the player.");
+    }
+    _bus?._players.remove(this);
+    value?._players.add(this);
+    _bus = value;
+  }
+
+  MixBus? _bus;
+
+  @override
+  bool _insertEffect(PlatformEffect effect, int index) {
+    _ensureInit();
+    return _player!.insertEffect(effect, index);
+  }
+
+  @override
+  bool _removeEffect(PlatformEffect effect) =>
+      _player?.removeEffect(effect) ?? false;
+
   void start() {
     _ensureInit();
     _player!.start();
@@ -689,6 +1378,139 @@ final class StreamPlayer {
   int get channels => _channels;
   int get sampleRate => _sampleRate;
   int get bufferMs => _bufferMs;
+  bool get isBuffered => _buffered;
+
+  /// Audio that must be queued before playback (re)starts; 0 = ungated.
+  int get prerollMs => _prerollMs;
+
+  /// Playback position. In buffered mode this follows the timestamps passed
+  /// to [writeFloat32At]; in live mode it counts frames played.
+  Duration get position => _framesToDuration(_player?.positionFrames ?? 0);
+
+  /// Buffered mode: seek within the buffered window. Returns false when the
+  /// target has not been buffered (or has already been evicted).
+  bool seek(Duration position) {
+    _ensureInit();
+    return _player!.seekFrames(_durationToFrames(position));
+  }
+
+  /// Buffered mode: the currently seekable window, or null in live mode.
+  (Duration start, Duration end)? get bufferedRange {
+    final range = _player?.bufferedRange;
+    if (range == null) return null;
+    return (_framesToDuration(range.$1), _framesToDuration(range.$2));
+  }
+
+  /// Buffered mode: write PCM whose first frame sits at [timestamp].
+  int writeFloat32At(Float32List interleaved, Duration timestamp) {
+    _ensureInit();
+    if (interleaved.isEmpty) return 0;
+    return _player!
+        .writeFloat32At(interleaved, _durationToFrames(timestamp));
+  }
+
+  /// Automation gain, applied on top of [volume] on the audio thread.
+  double get gain => _player?.gain ?? 1.0;
+
+  /// Ramps [gain] to [target] over [duration], sample-accurately on the
+  /// audio thread. Exponential ramps move in equal dB steps.
+  void rampGain(double target, Duration duration, {bool exponential = false}) {
+    _ensureInit();
+    _player!.rampGain(target, duration.inMilliseconds, exponential: exponential);
+  }
+
+  /// Fades this player out and [other] in over the same [duration].
+  void crossfadeTo(StreamPlayer other, Duration duration,
+      {bool exponential = false}) {
+    _ensureInit();
+    other._ensureInit();
+    _player!.crossfadeTo(other._player!, duration.inMilliseconds,
+        exponential: exponential);
+  }
+
+  /// Ducks this player to [duckGain] while [sidechain] plays above
+  /// [threshold] (linear peak). Pass null to stop ducking.
+  bool setDucking(
+    StreamPlayer? sidechain, {
+    double threshold = 0.05,
+    double duckGain = 0.25,
+    Duration attack = const Duration(milliseconds: 10),
+    Duration release = const Duration(milliseconds: 250),
+  }) {
+    _ensureInit();
+    if (sidechain != null) sidechain._ensureInit();
+    _duckSidechain = sidechain;
+    _duckParams = (
+      threshold,
+      duckGain,
+      attack.inMilliseconds,
+      release.inMilliseconds
+    );
+    return _applyDucking();
+  }
+
+  bool _applyDucking() {
+    final (threshold, duckGain, attackMs, releaseMs) = _duckParams;
+    return _player!.setDucking(
+      _duckSidechain?._player,
+      threshold: threshold,
+      duckGain: duckGain,
+      attackMs: attackMs,
+      releaseMs: releaseMs,
+    );
+  }
+
+  /// Underrun/drop/fill/decode-error counters. Cheap enough to poll at 1 Hz.
+  StreamPlayerStats get stats {
+    _ensureInit();
+    return _player!.stats;
+  }
+
+  void resetStats() {
+    _ensureInit();
+    _player!.resetStats();
+  }
+
+  /// Calls [callback] when underruns, dropped frames or decode errors grow
+  /// by their threshold since the last notification (0 disables an event).
+  /// Survives device switches. Pass null to remove.
+  void setTelemetryCallback(
+    StreamPlayerTelemetryCallback? callback, {
+    int underrunThreshold = 1,
+    int dropThresholdFrames = 0,
+    int decodeErrorThreshold = 1,
+  }) {
+    _ensureInit();
+    _player!.setTelemetryCallback(
+      callback,
+      underrunThreshold: underrunThreshold,
+      dropThresholdFrames: dropThresholdFrames,
+      decodeErrorThreshold: decodeErrorThreshold,
+    );
+  }
+
+  Duration _framesToDuration(int frames) =>
+      Duration(microseconds: frames * 1000000 ~/ _sampleRate);
+  int _durationToFrames(Duration d) =>
+      d.inMicroseconds * _sampleRate ~/ 1000000;
+
+  /// Zero-copy write: returns a view into the playback buffer of at most
+  /// [maxFrames] frames (may be shorter, or empty when full). Render into it
+  /// and call [commitWrite] with the frames written before any other write.
+  Float32List acquireWriteRegion(int maxFrames) {
+    _ensureInit();
+    return _player!.acquireWriteRegion(maxFrames);
+  }
+
+  /// Publishes frames rendered into the last [acquireWriteRegion] view. In
+  /// buffered mode [timestamp] stamps the chunk like [writeFloat32At].
+  bool commitWrite(int frames, {Duration? timestamp}) {
+    _ensureInit();
+    return _player!.commitWrite(
+      frames,
+      timestampFrames: timestamp == null ? null : _durationToFrames(timestamp),
+    );
+  }
 
   /// Write raw PCM data
   int writeFloat32(Float32List interleaved) {
@@ -712,6 +1534,9 @@ final class StreamPlayer {
   }
 
   void dispose() {
+    _bus?._players.remove(this);
+    _bus = null;
+    _releaseEffects();
     _player?.dispose();
     _player = null;
     _isInit = false;
@@ -722,20 +1547,6 @@ final class StreamPlayer {
       throw StateError("StreamPlayer not initialized. Call init() first.");
     }
   }
-
-  void _replaceFrom(StreamPlayer other) {
-    // Copy essential internal state from the freshly created instance.
-    _player = other._player;
-    _isInit = other._isInit;
-    _channels = other._channels;
-    _sampleRate = other._sampleRate;
-    _bufferMs = other._bufferMs;
-    _format = other._format;
-    _isStarted = other._isStarted;
-    volume = other.volume;
-    // Dispose the donor's shell (avoid double free; donor should not be used).
-    other._player = null;
-  }
 }
 
 class EngineAlreadyInitError extends Error {
@@ -1,4 +1,5 @@
 import 'dart:async';
+import 'dart:io';
 import 'dart:typed_data';
 
 import 'package:flutter_test/flutter_test.dart';
@@ -9,6 +10,31 @@ import 'package:miniaudio_dart/miniaudio_dart.dart';
 void main() {
   TestWidgetsFlutterBinding.ensureInitialized();
 
+  // Silent 16-bit mono WAV at 24 kHz.
+  ByteData silentWav(int frames) {
+    final wav = ByteData(44 + frames * 2);
+    void tag(int at, String s) {
+      for (var i = 0; i < 4; i++) {
+        wav.setUint8(at + i, s.codeUnitAt(i));
+      }
+    }
+
+    tag(0, 'RIFF');
+    wav.setUint32(4, 36 + frames * 2, Endian.little);
+    tag(8, 'WAVE');
+    tag(12, 'fmt ');
+    wav.setUint32(16, 16, Endian.little);
+    wav.setUint16(20, 1, Endian.little);
+    wav.setUint16(22, 1, Endian.little);
+    wav.setUint32(24, 24000, Endian.little);
+    wav.setUint32(28, 48000, Endian.little);
+    wav.setUint16(32, 2, Endian.little);
+    wav.setUint16(34, 16, Endian.little);
+    tag(36, 'data');
+    wav.setUint32(40, frames * 2, Endian.little);
+    return wav;
+  }
+
   group('Engine (pure Dart interaction)', () {
     late Engine engine;
 
@@ -39,6 +65,253 @@ void main() {
       final sound = await engine.loadSound(data);
       expect(sound, isA<Sound>());
     });
+
+    test('predecoded sound loads in the background', () async {
+      // 0.1 s at 24 kHz, decoded to the engine format.
+      final data = AudioData(
+          silentWav(2400).buffer.asFloat32List(), AudioFormat.unknown, 0, 0);
+      final sound =
+          await engine.loadSound(data, predecode: true, background: true);
+      expect(sound.duration.inMilliseconds, closeTo(100, 10));
+    });
+
+    test('bulk async loads complete on the load threads', () async {
+      final pooled = Engine();
+      await pooled.init(10, 4);
+      try {
+        final wav = silentWav(2400).buffer.asFloat32List();
+        final sounds = await Future.wait([
+          for (int i = 0; i < 20; i++)
+            pooled.loadSoundAsync(
+                AudioData(wav, AudioFormat.unknown, 0, 0),
+                predecode: true),
+        ]);
+        expect(sounds, hasLength(20));
+        expect(sounds.first.duration.inMilliseconds, closeTo(100, 10));
+        expect(pooled.pendingLoads, 0);
+        await expectLater(
+          pooled.loadSoundFileAsync('/nonexistent/miniaudio_dart_test.wav'),
+          throwsA(isA<MiniaudioDartPlatformException>()),
+        );
+      } finally {
+        await pooled.uninit();
+      }
+    });
+
+    test('file sounds stream or map instead of copying', () async {
+      final file = File('${Directory.systemTemp.path}/miniaudio_dart_test.wav');
+      await file.writeAsBytes(silentWav(48000).buffer.asUint8List());
+      try {
+        final streamed = await engine.loadSoundFile(file.path);
+        expect(streamed.duration.inMilliseconds, closeTo(2000, 10));
+        final mapped = await engine.loadSoundFile(file.path, memoryMapped: true);
+        expect(mapped.duration.inMilliseconds, closeTo(2000, 10));
+        // Two streams opening at once on the default single load thread.
+        final background = await Future.wait([
+          engine.loadSoundFileAsync(file.path),
+          engine.loadSoundFileAsync(file.path),
+        ]);
+        expect(background.map((s) => s.duration.inMilliseconds),
+            everyElement(closeTo(2000, 10)));
+        await expectLater(
+          engine.loadSoundFile('${file.path}.missing'),
+          throwsA(isA<MiniaudioDartPlatformException>()),
+        );
+      } finally {
+        await file.delete();
+      }
+    });
+
+    test('shared sounds reference one cached asset', () async {
+      final data = AudioData(Float32List(480), AudioFormat.float32, 48000, 1);
+      await engine.loadSoundShared(data, key: 'click');
+      await engine.loadSoundShared(null, key: 'click');
+      await engine.loadSoundShared(data);
+      expect(engine.hasSharedAsset('click'), isTrue);
+      expect(engine.sharedAssetStats, (2, 2 * 480 * 4));
+
+      expect(engine.evictSharedAsset('click'), isTrue);
+      expect(engine.hasSharedAsset('click'), isFalse);
+      expect(engine.sharedAssetStats.$1, 1);
+    });
+
+    test('playlist queues, skips and clears', () async {
+      await engine.start();
+      final playlist = engine.createPlaylist(
+        crossfade: const Duration(milliseconds: 20),
+      );
+      final data = AudioData(Float32List(48000), AudioFormat.float32, 48000, 1);
+      final first = playlist.add(data);
+      final second = playlist.add(data);
+      expect(playlist.current, first);
+      expect(playlist.queued, 2);
+      expect(playlist.crossfade, const Duration(milliseconds: 20));
+
+      playlist.play();
+      playlist.skip();
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      expect(playlist.current, second);
+
+      playlist.clear();
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      expect(playlist.current, isNull);
+      expect(playlist.queued, 0);
+      playlist.dispose();
+    });
+
+    test('device switch keeps the engine running', () async {
+      await engine.start();
+      final devices = await engine.enumeratePlaybackDevices();
+      if (devices.isEmpty) return;
+      final data = AudioData(Float32List(48000), AudioFormat.float32, 48000, 1);
+      final sound = await engine.loadSound(data);
+      sound.playLooped();
+      final before = engine.timeInFrames;
+      expect(await engine.selectPlaybackDeviceByIndex(0), isTrue);
+      // Same graph on a new device: the clock carries on rather than reset.
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      expect(engine.timeInFrames, greaterThan(before));
+      expect(sound.duration, const Duration(seconds: 1));
+      sound.stop();
+    });
+
+    test('duplex engine returns capture with its output reference', () async {
+      expect(
+        () => engine.enableDuplex(),
+        throwsA(isA<EngineAlreadyInitError>()),
+      );
+      final duplex = Engine()..enableDuplex(captureChannels: 1);
+      await duplex.init();
+      await duplex.start();
+      expect(duplex.captureChannels, 1);
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      final (capture, reference) = duplex.readDuplex(duplex.duplexAvailable);
+      expect(capture.length, greaterThan(0));
+      // Both halves cover the same frames.
+      expect(reference.length, capture.length * duplex.channels);
+    });
+  });
+
+  group('Engine latency profiles', () {
+    test('profile is applied and reported', () async {
+      final engine = Engine()
+        ..setLatencyProfile(LatencyProfile.lowLatency, periods: 2);
+      await engine.init();
+      expect(
+        () => engine.setLatencyProfile(LatencyProfile.ultra),
+        throwsA(isA<EngineAlreadyInitError>()),
+      );
+      final latency = engine.latency;
+      expect(latency.periodFrames, greaterThan(0));
+      expect(latency.periods, greaterThan(0));
+      expect(latency.backend, isNotEmpty);
+      final frames = latency.periodFrames * latency.periods;
+      expect(latency.latencyMs, closeTo(frames * 1000 / latency.sampleRate, 0.01));
+    });
+
+    test('load meter times the device callbacks', () async {
+      final engine = Engine();
+      await engine.init();
+      await engine.start();
+      await Future<void>.delayed(const Duration(milliseconds: 200));
+      var stats = engine.loadStats;
+      expect(stats.callbacks, greaterThan(0));
+      expect(stats.periodUs, greaterThan(0));
+      expect(stats.maxCallbackUs, greaterThanOrEqualTo(stats.lastCallbackUs));
+      expect(stats.overruns, lessThanOrEqualTo(stats.xruns));
+      engine.resetLoadStats();
+      stats = engine.loadStats;
+      expect(stats.callbacks, lessThan(5));
+      await engine.uninit();
+    });
+  });
+
+  group('Offline engine', () {
+    test('renders a sound faster than realtime', () async {
+      final engine = Engine()..initOffline(channels: 2, sampleRate: 48000);
+      expect(
+        () => engine.initOffline(),
+        throwsA(isA<EngineAlreadyInitError>()),
+      );
+      final samples = Float32List(48000)..fillRange(0, 48000, 0.25);
+      final sound = await engine
+          .loadSound(AudioData(samples, AudioFormat.float32, 48000, 1));
+      await engine.start();
+      sound.play();
+      final watch = Stopwatch()..start();
+      final out = engine.render(48000);
+      expect(watch.elapsed, lessThan(const Duration(seconds: 1)));
+      expect(out.length, 48000 * 2);
+      expect(out[0], closeTo(0.25, 1e-6));
+      expect(engine.render(480).every((s) => s == 0), isTrue);
+      await engine.uninit();
+    });
+
+    test('buses scale, mute and nest their members', () async {
+      final engine = Engine()..initOffline(channels: 2, sampleRate: 48000);
+      final samples = Float32List(4800)..fillRange(0, 4800, 0.25);
+      final sound = await engine
+          .loadSound(AudioData(samples, AudioFormat.float32, 48000, 1));
+      await engine.start();
+      sound.playLooped();
+
+      final music = engine.bus('music');
+      expect(engine.bus('music'), same(music));
+      sound.bus = music;
+      music.volume = 0.5;
+      expect(engine.render(960).last, closeTo(0.125, 1e-4));
+
+      music.muted = true;
+      expect(engine.render(960).last, 0);
+      music.muted = false;
+
+      final master = engine.bus('master')..volume = 0.5;
+      music.parent = master;
+      expect(() => master.parent = music, throwsArgumentError);
+      expect(engine.render(960).last, closeTo(0.0625, 1e-4));
+
+      // The sound follows the bus it was on to that bus's parent.
+      music.dispose();
+      expect(sound.bus, same(master));
+      expect(engine.buses.keys, ['master']);
+      expect(engine.render(960).last, closeTo(0.125, 1e-4));
+      await engine.uninit();
+    });
+
+    test('effects process sounds and buses in order', () async {
+      final engine = Engine()..initOffline(channels: 2, sampleRate: 48000);
+      final samples = Float32List(4800)..fillRange(0, 4800, 0.25);
+      final sound = await engine
+          .loadSound(AudioData(samples, AudioFormat.float32, 48000, 1));
+      await engine.start();
+      sound.playLooped();
+
+      // +6 dB of low shelf lifts a constant by 10^(6/20), gliding there.
+      final eq = engine.createEq();
+      sound.addEffect(eq);
+      expect(() => engine.bus('fx').addEffect(eq), throwsStateError);
+      expect(engine.render(480).last, closeTo(0.25, 1e-3));
+      eq.setBand(0, gainDb: 6);
+      expect(engine.render(480).last, lessThan(0.45));
+      expect(engine.render(14400).last, closeTo(0.4988, 2e-3));
+
+      // Pushed into a -20 dB limiter on the bus, nothing gets over 0.1.
+      final limiter = engine.createLimiter()..ceilingDb = -20;
+      final fx = engine.bus('fx')..addEffect(limiter);
+      sound.bus = fx;
+      engine.render(960);
+      final out = engine.render(9600);
+      expect(out.every((s) => s.abs() <= 0.1 + 1e-4), isTrue);
+      expect(out.last, closeTo(0.1, 1e-3));
+      expect(limiter.reductionDb, lessThan(-1));
+
+      expect(sound.removeEffect(eq), isTrue);
+      expect(sound.effects, isEmpty);
+      limiter.dispose();
+      expect(fx.effects, isEmpty);
+      expect(engine.render(960).last, closeTo(0.25, 1e-4));
+      await engine.uninit();
+    });
   });
 
   group('Sound basic lifecycle', () {
@@ -53,6 +326,10 @@ void main() {
       await engine.start();
     });
 
+    // One second, so voices are still playing when the test looks at them.
+    Future<Sound> loadLong() => engine.loadSound(
+        AudioData(Float32List(48000), AudioFormat.float32, 48000, 1));
+
     tearDown(() async {
       try {
         await engine.uninit();
@@ -81,6 +358,63 @@ void main() {
       expect(sound.volume, closeTo(0.42, 1e-6));
     });
 
+    test('voices overlap and steal the oldest', () async {
+      final sound = await loadLong();
+      expect(sound.playVoice(), isNull);
+      expect(sound.setPolyphony(2), isTrue);
+      expect(sound.polyphony, 2);
+
+      final first = sound.playVoice()!;
+      final second = sound.playVoice()!;
+      expect(sound.activeVoices, 2);
+      final third = sound.playVoice()!;
+      expect(first.isPlaying, isFalse);
+      expect(second.isPlaying && third.isPlaying, isTrue);
+
+      sound.stop();
+      expect(sound.activeVoices, 0);
+    });
+
+    test('voice limit virtualizes the lowest priority', () async {
+      final sound = await loadLong();
+      final quiet = await loadLong();
+      quiet.priority = 0.5;
+      expect(quiet.priority, 0.5);
+      engine.maxVoices = 1;
+      expect(engine.maxVoices, 1);
+      sound.playLooped();
+      quiet.playLooped();
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      expect(engine.voiceStats, (1, 1));
+
+      engine.maxVoices = 0;
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      expect(engine.voiceStats, (2, 0));
+    });
+
+    test('steal policy none refuses a busy pool', () async {
+      final sound = await loadLong();
+      sound.setPolyphony(1, policy: VoiceStealPolicy.none);
+      expect(sound.playVoice(looped: true), isNotNull);
+      expect(sound.playVoice(), isNull);
+    });
+
+    test('scheduled voices hold their slot until they start', () async {
+      final sound = await loadLong();
+      final start = engine.timeInFrames;
+      await Future<void>.delayed(const Duration(milliseconds: 50));
+      expect(engine.timeInFrames, greaterThan(start));
+
+      sound.setPolyphony(2, policy: VoiceStealPolicy.none);
+      final later = engine.timeInFrames + engine.sampleRate;
+      final voice = sound.playVoiceAt(later);
+      expect(voice, isNotNull);
+      expect(voice!.isPlaying, isFalse);
+      expect(sound.activeVoices, 1);
+      expect(sound.playVoiceAt(later), isNotNull);
+      expect(sound.playVoiceAt(later), isNull);
+    });
+
     test('looped playback flag toggles', () {
       sound.playLooped(delay: const Duration(milliseconds: 50));
       expect(sound.isLooped, isTrue);
@@ -143,6 +477,22 @@ void main() {
       recorder.stop();
     });
 
+    test('echo cancellation and noise suppression run on capture', () async {
+      if (!available) {
+        return;
+      }
+      recorder.noiseSuppression = 20;
+      expect(recorder.noiseSuppression, 20);
+      expect(recorder.enableEchoCancellation(), isTrue);
+      recorder.start();
+      await Future.delayed(const Duration(milliseconds: 50));
+      expect(recorder.getAvailableFrames(), greaterThan(0));
+      recorder.stop();
+      recorder.disableEchoCancellation();
+      recorder.noiseSuppression = 0;
+      expect(recorder.echoReturnLossEnhancement, 0);
+    });
+
     test('available frames non-negative', () async {
       if (!available) {
         return;
@@ -0,0 +1,215 @@
+import 'dart:math' as math;
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:miniaudio_dart/miniaudio_dart.dart';
+
+/// StreamPlayer feature tests. Like the other suites they return early when
+/// no audio device is available.
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  Float32List tone(int frames, {double frequency = 440}) {
+    final data = Float32List(frames);
+    for (int i = 0; i < frames; i++) {
+      data[i] = 0.2 * math.sin(2 * math.pi * frequency * i / 48000);
+    }
+    return data;
+  }
+
+  group('StreamPlayer buffered mode', () {
+    late Engine engine;
+    late StreamPlayer player;
+
+    setUp(() async {
+      engine = Engine();
+      try {
+        await engine.init();
+        await engine.start();
+      } catch (_) {}
+      player = StreamPlayer(mainEngine: engine);
+    });
+
+    tearDown(() async {
+      try {
+        player.stop();
+        player.dispose();
+        await engine.uninit();
+      } catch (_) {}
+    });
+
+    test('timestamps drive position and seek', () async {
+      if (!engine.isInit) return;
+      await player.init(
+          channels: 1, sampleRate: 48000, bufferMs: 10000, buffered: true);
+      expect(player.isBuffered, isTrue);
+
+      // Two seconds of audio, written as a chunk starting at 30 s.
+      final written =
+          player.writeFloat32At(tone(96000), const Duration(seconds: 30));
+      expect(written, 96000);
+      expect(player.position, const Duration(seconds: 30));
+
+      final range = player.bufferedRange;
+      expect(range, isNotNull);
+      expect(range!.$1, const Duration(seconds: 30));
+      expect(range.$2, const Duration(seconds: 32));
+
+      expect(player.seek(const Duration(seconds: 31)), isTrue);
+      expect(player.position, const Duration(seconds: 31));
+      expect(player.seek(const Duration(seconds: 40)), isFalse);
+    });
+
+    test('live mode reports no buffered range', () async {
+      if (!engine.isInit) return;
+      await player.init(channels: 1, sampleRate: 48000, bufferMs: 200);
+      player.writeFloat32(tone(960));
+      expect(player.bufferedRange, isNull);
+      expect(player.seek(Duration.zero), isFalse);
+    });
+  });
+  group('StreamPlayer telemetry', () {
+    late Engine engine;
+    late StreamPlayer player;
+
+    setUp(() async {
+      engine = Engine();
+      try {
+        await engine.init();
+        await engine.start();
+      } catch (_) {}
+      player = StreamPlayer(mainEngine: engine);
+    });
+
+    tearDown(() async {
+      try {
+        player.dispose();
+        await engine.uninit();
+      } catch (_) {}
+    });
+
+    test('overflow is counted as dropped frames', () async {
+      if (!engine.isInit) return;
+      await player.init(channels: 1, sampleRate: 48000, bufferMs: 200);
+
+      final written = player.writeFloat32(tone(48000));
+      final stats = player.stats;
+      expect(stats.capacityFrames, greaterThan(0));
+      expect(stats.droppedFrames, 48000 - written);
+      expect(stats.fillFrames, written);
+      expect(stats.peakFillFrames, greaterThanOrEqualTo(stats.fillFrames));
+      expect(stats.underrunEvents, 0);
+
+      player.resetStats();
+      expect(player.stats.droppedFrames, 0);
+    });
+
+    test('pre-roll holds playback until the threshold is queued', () async {
+      if (!engine.isInit) return;
+      await player.init(
+          channels: 1, sampleRate: 48000, bufferMs: 500, prerollMs: 100);
+      expect(player.prerollMs, 100);
+      player.start();
+
+      // 20 ms queued, below the 100 ms pre-roll: nothing is consumed.
+      player.writeFloat32(tone(960));
+      await Future<void>.delayed(const Duration(milliseconds: 100));
+      expect(player.position, Duration.zero);
+      expect(player.stats.fillFrames, 960);
+      expect(player.stats.underrunEvents, 0);
+      player.stop();
+    });
+  });
+  group('StreamPlayer zero-copy writes', () {
+    late Engine engine;
+    late StreamPlayer player;
+
+    setUp(() async {
+      engine = Engine();
+      try {
+        await engine.init();
+        await engine.start();
+      } catch (_) {}
+      player = StreamPlayer(mainEngine: engine);
+    });
+
+    tearDown(() async {
+      try {
+        player.dispose();
+        await engine.uninit();
+      } catch (_) {}
+    });
+
+    test('rendered region is queued after commit', () async {
+      if (!engine.isInit) return;
+      await player.init(channels: 2, sampleRate: 48000, bufferMs: 200);
+
+      final region = player.acquireWriteRegion(480);
+      expect(region.length, 480 * 2);
+      region.fillRange(0, region.length, 0.25);
+      expect(player.commitWrite(480), isTrue);
+      expect(player.stats.fillFrames, 480);
+    });
+
+    test('buffered commit carries the timestamp', () async {
+      if (!engine.isInit) return;
+      await player.init(
+          channels: 1, sampleRate: 48000, bufferMs: 2000, buffered: true);
+
+      final region = player.acquireWriteRegion(4800);
+      region.setAll(0, tone(region.length));
+      expect(
+        player.commitWrite(region.length,
+            timestamp: const Duration(seconds: 5)),
+        isTrue,
+      );
+      expect(player.position, const Duration(seconds: 5));
+    });
+  });
+  group('StreamPlayer gain automation', () {
+    late Engine engine;
+    late StreamPlayer music;
+    late StreamPlayer voice;
+
+    setUp(() async {
+      engine = Engine();
+      try {
+        await engine.init();
+        await engine.start();
+      } catch (_) {}
+      music = StreamPlayer(mainEngine: engine);
+      voice = StreamPlayer(mainEngine: engine);
+    });
+
+    tearDown(() async {
+      try {
+        music.dispose();
+        voice.dispose();
+        await engine.uninit();
+      } catch (_) {}
+    });
+
+    test('ramp reaches its target on the audio thread', () async {
+      if (!engine.isInit) return;
+      await music.init(channels: 1, sampleRate: 48000, bufferMs: 1000);
+      music.start();
+      music.writeFloat32(tone(24000));
+
+      expect(music.gain, 1.0);
+      music.rampGain(0.5, const Duration(milliseconds: 20));
+      await Future<void>.delayed(const Duration(milliseconds: 150));
+      expect(music.gain, closeTo(0.5, 1e-6));
+      music.stop();
+    });
+
+    test('ducking links and unlinks a sidechain', () async {
+      if (!engine.isInit) return;
+      await music.init(channels: 1, sampleRate: 48000);
+      await voice.init(channels: 1, sampleRate: 48000);
+
+      expect(music.setDucking(voice, duckGain: 0.2), isTrue);
+      expect(music.setDucking(music), isFalse);
+      expect(music.setDucking(null), isTrue);
+    });
+  });
+}
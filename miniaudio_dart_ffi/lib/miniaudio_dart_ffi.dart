@@ -1,5 +1,6 @@
 // ignore_for_file: omit_local_variable_types
 
+import "dart:async";
 import "dart:ffi";
 import "dart:typed_data";
 
@@ -50,6 +51,9 @@ class MiniaudioDartFfi extends MiniaudioDartPlatformInterface {
     required int channels,
     required int sampleRate,
     int bufferMs = 240,
+    bool buffered = false,
+    int prerollMs = 0,
+    int fadeMs = 0,
   }) {
     final engWrapper = (engine as FfiEngine)._self;
     final sp = bindings.stream_player_alloc();
@@ -65,7 +69,11 @@ class MiniaudioDartFfi extends MiniaudioDartPlatformInterface {
         ..sampleRate = sampleRate
         ..bufferMilliseconds = bufferMs
         ..allowCodecPackets = 1 // Always allow codec packets
-        ..decodeAccumFrames = 0;
+        ..decodeAccumFrames = 0
+        ..bufferedMode = buffered ? 1 : 0
+        ..segmentMilliseconds = 0
+        ..prerollMilliseconds = prerollMs
+        ..fadeMilliseconds = fadeMs;
 
       final ok = bindings.stream_player_init_with_engine(
           sp, engWrapper.cast(), cfgPtr);
@@ -410,6 +418,32 @@ class FfiRecorder implements PlatformRecorder {
     bindings.recorder_set_capture_gain(_self, value);
   }
 
+  double _noiseSuppression = 0;
+  @override
+  double get noiseSuppression => _noiseSuppression;
+  @override
+  set noiseSuppression(double reductionDb) {
+    if (bindings.recorder_set_noise_suppression(_self, reductionDb) != 1) {
+      throw MiniaudioDartPlatformException(
+          "Noise suppression needs a float32 recorder.");
+    }
+    _noiseSuppression = reductionDb > 0 ? reductionDb : 0;
+  }
+
+  @override
+  bool enableEchoCancellation(PlatformEngine engine, int filterMs) =>
+      bindings.recorder_enable_echo_cancellation(
+          _self, (engine as FfiEngine)._self, filterMs) ==
+      1;
+
+  @override
+  void disableEchoCancellation() =>
+      bindings.recorder_disable_echo_cancellation(_self);
+
+  @override
+  double get echoReturnLossEnhancement =>
+      bindings.recorder_get_echo_return_loss_enhancement(_self);
+
   @override
   void dispose() => bindings.recorder_destroy(_self);
 
@@ -462,6 +496,12 @@ final class FfiStreamPlayer implements PlatformStreamPlayer {
   Pointer<Float> _scratch = nullptr;
   int _scratchFloats = 0;
 
+  Pointer<Pointer<Void>> _regionPtr = nullptr;
+  Pointer<Int> _regionFrames = nullptr;
+
+  Pointer<bindings.StreamPlayerStats> _statsPtr = nullptr;
+  NativeCallable<bindings.StreamPlayerTelemetryCallbackFunction>? _telemetry;
+
   double _volume = 1.0;
   @override
   double get volume => _volume;
@@ -497,28 +537,203 @@ final class FfiStreamPlayer implements PlatformStreamPlayer {
   // Safely writes interleaved Float32 samples. Returns frames written by native side.
   @override
   int writeFloat32(Float32List interleaved) {
+    final int frames = _stage(interleaved, "writeFloat32");
+    if (frames == 0) return 0;
+    final int written = bindings.stream_player_write_frames_f32(
+      _self,
+      _scratch,
+      frames,
+    );
+    return written;
+  }
+
+  @override
+  int writeFloat32At(Float32List interleaved, int timestampFrames) {
+    final int frames = _stage(interleaved, "writeFloat32At");
+    if (frames == 0) return 0;
+    return bindings.stream_player_write_frames_f32_at(
+      _self,
+      _scratch,
+      frames,
+      timestampFrames,
+    );
+  }
+
+  @override
+  Float32List acquireWriteRegion(int maxFrames) {
+    if (maxFrames <= 0) return Float32List(0);
+    if (_regionPtr == nullptr) {
+      _regionPtr = calloc<Pointer<Void>>();
+      _regionFrames = calloc<Int>();
+    }
+    _regionFrames.value = maxFrames;
+    final ok = bindings.stream_player_acquire_write_region(
+        _self, _regionPtr, _regionFrames);
+    if (ok != 1) {
+      throw MiniaudioDartPlatformException(
+          "stream_player_acquire_write_region failed.");
+    }
+    final frames = _regionFrames.value;
+    if (frames <= 0 || _regionPtr.value == nullptr) return Float32List(0);
+    return _regionPtr.value.cast<Float>().asTypedList(frames * _channels);
+  }
+
+  @override
+  bool commitWrite(int frames, {int? timestampFrames}) {
+    if (timestampFrames == null) {
+      return bindings.stream_player_commit_write(_self, frames) == 1;
+    }
+    return bindings.stream_player_commit_write_at(
+            _self, frames, timestampFrames) ==
+        1;
+  }
+
+  // Copies samples into the native scratch buffer; returns frame count.
+  int _stage(Float32List interleaved, String op) {
     if (interleaved.isEmpty) return 0;
     final int floats = interleaved.length;
     if (floats % _channels != 0) {
       throw MiniaudioDartPlatformException(
-        "writeFloat32: floats ($floats) not divisible by channels ($_channels)",
+        "$op: floats ($floats) not divisible by channels ($_channels)",
       );
     }
-    final int frames = floats ~/ _channels;
-
     if (_scratch == nullptr || _scratchFloats < floats) {
       if (_scratch != nullptr) calloc.free(_scratch);
       _scratch = calloc<Float>(floats);
       _scratchFloats = floats;
     }
     _scratch.asTypedList(floats).setAll(0, interleaved);
+    return floats ~/ _channels;
+  }
 
-    final int written = bindings.stream_player_write_frames_f32(
+  @override
+  int get positionFrames => bindings.stream_player_get_position(_self);
+
+  @override
+  bool seekFrames(int timestampFrames) =>
+      bindings.stream_player_seek(_self, timestampFrames) == 1;
+
+  @override
+  (int start, int end)? get bufferedRange {
+    final out = calloc<Int64>(2);
+    try {
+      final ok =
+          bindings.stream_player_get_buffered_range(_self, out, out + 1);
+      return ok == 1 ? (out[0], out[1]) : null;
+    } finally {
+      calloc.free(out);
+    }
+  }
+
+  @override
+  void rampGain(double target, int durationMs, {bool exponential = false}) =>
+      bindings.stream_player_ramp_gain(
+        _self,
+        target,
+        durationMs < 0 ? 0 : durationMs,
+        exponential
+            ? bindings.StreamPlayerRampCurve.STREAM_PLAYER_RAMP_EXPONENTIAL.value
+            : bindings.StreamPlayerRampCurve.STREAM_PLAYER_RAMP_LINEAR.value,
+      );
+
+  @override
+  double get gain => bindings.stream_player_get_gain(_self);
+
+  @override
+  void crossfadeTo(PlatformStreamPlayer to, int durationMs,
+          {bool exponential = false}) =>
+      bindings.stream_player_crossfade(
+        _self,
+        (to as FfiStreamPlayer)._self,
+        durationMs < 0 ? 0 : durationMs,
+        exponential
+            ? bindings.StreamPlayerRampCurve.STREAM_PLAYER_RAMP_EXPONENTIAL.value
+            : bindings.StreamPlayerRampCurve.STREAM_PLAYER_RAMP_LINEAR.value,
+      );
+
+  @override
+  bool setDucking(
+    PlatformStreamPlayer? sidechain, {
+    double threshold = 0.05,
+    double duckGain = 0.25,
+    int attackMs = 10,
+    int releaseMs = 250,
+  }) =>
+      bindings.stream_player_set_ducking(
+        _self,
+        sidechain == null ? nullptr : (sidechain as FfiStreamPlayer)._self,
+        threshold,
+        duckGain,
+        attackMs < 0 ? 0 : attackMs,
+        releaseMs < 0 ? 0 : releaseMs,
+      ) ==
+      1;
+
+  @override
+  bool setBus(PlatformMixBus? bus) =>
+      bindings.stream_player_set_bus(_self, FfiMixBus._native(bus)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) {
+    final node = FfiEffect._node(effect);
+    return bindings.stream_player_insert_effect(_self, node, index) == 1;
+  }
+
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      bindings.stream_player_remove_effect(_self, FfiEffect._node(effect)) == 1;
+
+  @override
+  StreamPlayerStats get stats {
+    if (_statsPtr == nullptr) _statsPtr = calloc<bindings.StreamPlayerStats>();
+    if (bindings.stream_player_get_stats(_self, _statsPtr) != 1) {
+      throw MiniaudioDartPlatformException("stream_player_get_stats failed.");
+    }
+    final s = _statsPtr.ref;
+    return StreamPlayerStats(
+      underrunEvents: s.underrunEvents,
+      silenceFrames: s.silenceFrames,
+      droppedFrames: s.droppedFrames,
+      fillFrames: s.fillFrames,
+      peakFillFrames: s.peakFillFrames,
+      capacityFrames: s.capacityFrames,
+      decodeErrors: List<int>.generate(
+          bindings.STREAM_PLAYER_CODEC_SLOTS, (i) => s.decodeErrors[i]),
+    );
+  }
+
+  @override
+  void resetStats() => bindings.stream_player_reset_stats(_self);
+
+  @override
+  void setTelemetryCallback(
+    StreamPlayerTelemetryCallback? callback, {
+    int underrunThreshold = 1,
+    int dropThresholdFrames = 0,
+    int decodeErrorThreshold = 1,
+  }) {
+    // Detach natively before closing the previous callable.
+    bindings.stream_player_set_telemetry_callback(
+        _self, nullptr, nullptr, 0, 0, 0);
+    _telemetry?.close();
+    _telemetry = null;
+    if (callback == null) return;
+
+    // The native side invokes this from whichever thread writes or polls,
+    // so it must be a listener rather than an isolate-local callback.
+    _telemetry =
+        NativeCallable<bindings.StreamPlayerTelemetryCallbackFunction>.listener(
+      (Pointer<Void> _, int event, int total) =>
+          callback(StreamPlayerEvent.values[event - 1], total),
+    );
+    bindings.stream_player_set_telemetry_callback(
       _self,
-      _scratch,
-      frames,
+      _telemetry!.nativeFunction,
+      nullptr,
+      underrunThreshold,
+      dropThresholdFrames,
+      decodeErrorThreshold,
     );
-    return written;
   }
 
   @override
@@ -552,6 +767,17 @@ final class FfiStreamPlayer implements PlatformStreamPlayer {
       _scratch = nullptr;
       _scratchFloats = 0;
     }
+    setTelemetryCallback(null);
+    if (_regionPtr != nullptr) {
+      calloc.free(_regionPtr);
+      calloc.free(_regionFrames);
+      _regionPtr = nullptr;
+      _regionFrames = nullptr;
+    }
+    if (_statsPtr != nullptr) {
+      calloc.free(_statsPtr);
+      _statsPtr = nullptr;
+    }
     bindings.stream_player_free(_self);
   }
 }
@@ -564,6 +790,16 @@ final class FfiEngine implements PlatformEngine {
 
   EngineState state = EngineState.uninit;
 
+  // Background loads in flight, keyed by the native Sound address.
+  final Map<int, Completer<PlatformSound>> _loads = {};
+  NativeCallable<bindings.SoundLoadCallbackFunction>? _loadCallback;
+
+  // Their sounds live in this engine's graph, so they go first.
+  final Set<FfiPlaylist> _playlists = {};
+  final Set<FfiMixBus> _buses = {};
+  // After the playlists and buses that may still hold them.
+  final Set<FfiEffect> _effects = {};
+
   @override
   Future<void> init(int periodMs) async {
     if (bindings.engine_init(_self, periodMs) != 1) {
@@ -571,10 +807,34 @@ final class FfiEngine implements PlatformEngine {
     }
   }
 
+  @override
+  void initOffline(int channels, int sampleRate) {
+    if (bindings.engine_init_offline(_self, channels, sampleRate) != 1) {
+      throw MiniaudioDartPlatformException("Failed to init the engine.");
+    }
+  }
+
   @override
   void dispose() {
     if (_disposed) return;
+    for (final p in List.of(_playlists)) {
+      p.dispose();
+    }
+    for (final b in List.of(_buses)) {
+      b.dispose();
+    }
+    for (final e in List.of(_effects)) {
+      e.dispose();
+    }
+    // Waits for outstanding load jobs before tearing down.
     bindings.engine_uninit(_self);
+    _loadCallback?.close();
+    _loadCallback = null;
+    for (final c in _loads.values) {
+      c.completeError(
+          MiniaudioDartPlatformException("Engine disposed while loading."));
+    }
+    _loads.clear();
     bindings.engine_free(_self); // correct native free
     _disposed = true;
   }
@@ -587,38 +847,444 @@ final class FfiEngine implements PlatformEngine {
   }
 
   @override
-  Future<PlatformSound> loadSound(AudioData audioData) async {
-    // Allocate exact number of float samples (elements), not bytes.
-    final int sampleCount = audioData.buffer.length;
-    final Pointer<Float> dataPtr = calloc<Float>(sampleCount);
-    // Copy PCM into native buffer.
-    dataPtr.asTypedList(sampleCount).setAll(0, audioData.buffer);
-    // Size in bytes for the native API (if it expects bytes).
-    final int dataSize = sampleCount * sizeOf<Float>();
+  Future<PlatformSound> loadSound(AudioData audioData,
+      {bool predecode = false, bool background = false}) async {
+    if (background) return loadSoundAsync(audioData, predecode: predecode);
     final Pointer<bindings.Sound> sound = bindings.sound_alloc();
     if (sound == nullptr) {
-      calloc.free(dataPtr);
       throw MiniaudioDartPlatformException("Failed to allocate a sound.");
     }
+    final Pointer<Void> dataPtr = _stageSoundData(audioData);
+    if (dataPtr == nullptr) {
+      bindings.sound_free(sound);
+      throw MiniaudioDartPlatformException("Failed to allocate sound data.");
+    }
 
-    final int maFormat = audioData.format;
-    final int result = bindings.engine_load_sound(
+    // The sound takes the buffer over (and frees it, even on failure).
+    final int result = bindings.engine_load_sound_adopt(
       _self,
       sound,
       dataPtr,
-      dataSize,
-      bindings.ma_format.fromValue(maFormat),
+      audioData.buffer.lengthInBytes,
+      bindings.ma_format.fromValue(audioData.format),
       audioData.sampleRate,
       audioData.channels,
+      predecode ? bindings.SoundLoadFlags.SOUND_LOAD_DECODE.value : 0,
+      nullptr,
     );
-
     if (result != 1) {
       bindings.sound_unload(sound);
-      calloc.free(dataPtr); // avoid leak on failure
       throw MiniaudioDartPlatformException("Failed to load a sound.");
     }
 
-    return FfiSound._fromPtrs(sound, dataPtr);
+    return FfiSound._fromPtrs(sound, nullptr);
+  }
+
+  // The one copy of a load: straight into a native buffer the sound adopts
+  // and later frees. nullptr when the allocation fails.
+  Pointer<Void> _stageSoundData(AudioData audioData) {
+    final int dataSize = audioData.buffer.lengthInBytes;
+    final Pointer<Void> dataPtr = bindings.sound_data_alloc(dataSize);
+    if (dataPtr != nullptr) {
+      dataPtr.cast<Float>().asTypedList(audioData.buffer.length).setAll(
+          0, audioData.buffer);
+    }
+    return dataPtr;
+  }
+
+  @override
+  Future<PlatformSound> loadSoundFile(String path,
+      {bool memoryMapped = false, bool predecode = false}) async {
+    final int flags = predecode
+        ? bindings.SoundLoadFlags.SOUND_LOAD_DECODE.value
+        : memoryMapped
+            ? bindings.SoundLoadFlags.SOUND_LOAD_MMAP.value
+            : bindings.SoundLoadFlags.SOUND_LOAD_STREAM.value;
+    final Pointer<bindings.Sound> sound = bindings.sound_alloc();
+    if (sound == nullptr) {
+      throw MiniaudioDartPlatformException("Failed to allocate a sound.");
+    }
+    final pathPtr = path.toNativeUtf8(allocator: calloc);
+    try {
+      if (bindings.engine_load_sound_file(
+              _self, sound, pathPtr.cast(), flags) !=
+          1) {
+        bindings.sound_free(sound);
+        throw MiniaudioDartPlatformException(
+            "Failed to load a sound from $path.");
+      }
+    } finally {
+      calloc.free(pathPtr);
+    }
+    return FfiSound._fromPtrs(sound, nullptr);
+  }
+
+  @override
+  void setLoaderThreads(int count) {
+    if (bindings.engine_set_job_threads(_self, count) != 1) {
+      throw MiniaudioDartPlatformException(
+          "Loader threads must be set before init.");
+    }
+  }
+
+  @override
+  int get pendingLoads => bindings.engine_get_pending_loads(_self);
+
+  @override
+  Future<PlatformSound> loadSoundAsync(AudioData audioData,
+      {bool predecode = false}) {
+    // Staged only once the sound exists; the job then owns the buffer.
+    return _submitLoad((sound) {
+      final Pointer<Void> dataPtr = _stageSoundData(audioData);
+      if (dataPtr == nullptr) return 0;
+      return bindings.engine_load_sound_adopt_async(
+        _self,
+        sound,
+        dataPtr,
+        audioData.buffer.lengthInBytes,
+        bindings.ma_format.fromValue(audioData.format),
+        audioData.sampleRate,
+        audioData.channels,
+        predecode ? bindings.SoundLoadFlags.SOUND_LOAD_DECODE.value : 0,
+        nullptr,
+      );
+    });
+  }
+
+  @override
+  Future<PlatformSound> loadSoundFileAsync(String path,
+      {bool memoryMapped = false, bool predecode = false}) {
+    final int flags = predecode
+        ? bindings.SoundLoadFlags.SOUND_LOAD_DECODE.value
+        : memoryMapped
+            ? bindings.SoundLoadFlags.SOUND_LOAD_MMAP.value
+            : bindings.SoundLoadFlags.SOUND_LOAD_STREAM.value;
+    final pathPtr = path.toNativeUtf8(allocator: calloc);
+    try {
+      return _submitLoad((sound) => bindings.engine_load_sound_file_async(
+          _self, sound, pathPtr.cast(), flags));
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  Future<PlatformSound> _submitLoad(
+      int Function(Pointer<bindings.Sound>) submit) {
+    final Pointer<bindings.Sound> sound = bindings.sound_alloc();
+    if (sound == nullptr) {
+      throw MiniaudioDartPlatformException("Failed to allocate a sound.");
+    }
+    if (_loadCallback == null) {
+      // Invoked on a job thread, so it must be a listener.
+      _loadCallback =
+          NativeCallable<bindings.SoundLoadCallbackFunction>.listener(
+              _onSoundLoaded);
+      bindings.engine_set_load_callback(
+          _self, _loadCallback!.nativeFunction, nullptr);
+    }
+    // Registered first: without job threads the load completes inside submit.
+    final completer = Completer<PlatformSound>();
+    _loads[sound.address] = completer;
+    if (submit(sound) != 1) {
+      _loads.remove(sound.address);
+      bindings.sound_free(sound);
+      throw MiniaudioDartPlatformException("Failed to queue a sound load.");
+    }
+    return completer.future;
+  }
+
+  void _onSoundLoaded(Pointer<bindings.Sound> sound, int ok, Pointer<Void> _) {
+    final completer = _loads.remove(sound.address);
+    if (completer == null) return;
+    if (ok != 1) {
+      bindings.sound_free(sound);
+      completer.completeError(
+          MiniaudioDartPlatformException("Failed to load a sound."));
+      return;
+    }
+    completer.complete(FfiSound._fromPtrs(sound, nullptr));
+  }
+
+  @override
+  Future<PlatformSound> loadSoundShared(AudioData? audioData,
+      {String? key, bool predecode = false}) async {
+    if (audioData == null && key == null) {
+      throw MiniaudioDartPlatformException(
+          "loadSoundShared: audioData or key required");
+    }
+    final Pointer<bindings.Sound> sound = bindings.sound_alloc();
+    if (sound == nullptr) {
+      throw MiniaudioDartPlatformException("Failed to allocate a sound.");
+    }
+    final keyPtr = key?.toNativeUtf8(allocator: calloc) ?? nullptr;
+    // Only staged when the asset still has to be inserted; the cache copies it.
+    final bool cached = key != null &&
+        bindings.engine_has_asset(_self, keyPtr.cast()) == 1;
+    final int sampleCount = cached ? 0 : (audioData?.buffer.length ?? 0);
+    final Pointer<Float> dataPtr =
+        sampleCount > 0 ? calloc<Float>(sampleCount) : nullptr;
+    try {
+      if (dataPtr != nullptr) {
+        dataPtr.asTypedList(sampleCount).setAll(0, audioData!.buffer);
+      }
+      final int result = bindings.engine_load_sound_shared(
+        _self,
+        sound,
+        keyPtr.cast(),
+        dataPtr,
+        sampleCount * sizeOf<Float>(),
+        bindings.ma_format.fromValue(audioData?.format ?? 0),
+        audioData?.sampleRate ?? 0,
+        audioData?.channels ?? 0,
+        predecode ? bindings.SoundLoadFlags.SOUND_LOAD_DECODE.value : 0,
+      );
+      if (result != 1) {
+        bindings.sound_free(sound);
+        throw MiniaudioDartPlatformException("Failed to load a sound.");
+      }
+      return FfiSound._fromPtrs(sound, nullptr);
+    } finally {
+      if (dataPtr != nullptr) calloc.free(dataPtr);
+      if (keyPtr != nullptr) calloc.free(keyPtr);
+    }
+  }
+
+  @override
+  bool hasSharedAsset(String key) =>
+      _withKey(key, (k) => bindings.engine_has_asset(_self, k) == 1);
+
+  @override
+  bool evictSharedAsset(String key) =>
+      _withKey(key, (k) => bindings.engine_evict_asset(_self, k) == 1);
+
+  @override
+  int trimSharedAssets() => bindings.engine_trim_assets(_self);
+
+  @override
+  (int count, int bytes) get sharedAssetStats {
+    final count = calloc<Uint32>();
+    final bytes = calloc<Uint64>();
+    try {
+      if (bindings.engine_get_asset_stats(_self, count, bytes) != 1) {
+        return (0, 0);
+      }
+      return (count.value, bytes.value);
+    } finally {
+      calloc.free(count);
+      calloc.free(bytes);
+    }
+  }
+
+  @override
+  int get maxVoices => bindings.engine_get_max_voices(_self);
+  @override
+  set maxVoices(int value) => bindings.engine_set_max_voices(_self, value);
+
+  @override
+  (int mixed, int virtualized) get voiceStats {
+    final stats = calloc<Uint32>(2);
+    try {
+      if (bindings.engine_get_voice_stats(_self, stats, stats + 1) != 1) {
+        return (0, 0);
+      }
+      return (stats[0], stats[1]);
+    } finally {
+      calloc.free(stats);
+    }
+  }
+
+  @override
+  int get timeInFrames => bindings.engine_get_time_in_pcm_frames(_self);
+  @override
+  int get sampleRate => bindings.engine_get_sample_rate(_self);
+
+  @override
+  void setDuplex(int captureChannels, int bufferMs) {
+    if (bindings.engine_set_duplex(_self, captureChannels, bufferMs) != 1) {
+      throw MiniaudioDartPlatformException(
+          "Duplex mode must be set before init.");
+    }
+  }
+
+  @override
+  int get captureChannels => bindings.engine_get_capture_channels(_self);
+  @override
+  int get channels => bindings.engine_get_channels(_self);
+  @override
+  int get duplexAvailable => bindings.engine_duplex_available(_self);
+
+  @override
+  (Float32List capture, Float32List reference) readDuplex(int maxFrames) {
+    final inCh = captureChannels;
+    final outCh = channels;
+    if (maxFrames <= 0 || inCh == 0) return (Float32List(0), Float32List(0));
+    final capture = calloc<Float>(maxFrames * inCh);
+    final reference = calloc<Float>(maxFrames * outCh);
+    try {
+      final frames =
+          bindings.engine_duplex_read(_self, capture, reference, maxFrames);
+      return (
+        Float32List.fromList(capture.asTypedList(frames * inCh)),
+        Float32List.fromList(reference.asTypedList(frames * outCh)),
+      );
+    } finally {
+      calloc.free(capture);
+      calloc.free(reference);
+    }
+  }
+
+  @override
+  double get monitorGain => bindings.engine_get_monitor_gain(_self);
+  @override
+  set monitorGain(double value) =>
+      bindings.engine_set_monitor_gain(_self, value);
+
+  @override
+  void setLatencyProfile(LatencyProfile profile,
+      {int? periodFrames, int? periods, bool? exclusive}) {
+    final cfg = calloc<bindings.EngineLatencyConfig>();
+    try {
+      cfg.ref = bindings.engine_latency_config_init(
+          bindings.EngineLatencyProfile.fromValue(profile.index));
+      if (periodFrames != null) cfg.ref.periodFrames = periodFrames;
+      if (periods != null) cfg.ref.periods = periods;
+      if (exclusive != null) cfg.ref.exclusive = exclusive ? 1 : 0;
+      if (bindings.engine_set_latency_config(_self, cfg) != 1) {
+        throw MiniaudioDartPlatformException(
+            "Latency profile must be set before init.");
+      }
+    } finally {
+      calloc.free(cfg);
+    }
+  }
+
+  @override
+  EngineLatency get latency {
+    final info = calloc<bindings.EngineLatencyInfo>();
+    try {
+      bindings.engine_get_latency_info(_self, info);
+      return (
+        periodFrames: info.ref.periodFrames,
+        periods: info.ref.periods,
+        sampleRate: info.ref.sampleRate,
+        latencyMs: info.ref.latencyMs,
+        exclusive: info.ref.exclusive != 0,
+        backend: bindings
+            .engine_get_backend_name(_self)
+            .cast<Utf8>()
+            .toDartString(),
+      );
+    } finally {
+      calloc.free(info);
+    }
+  }
+
+  @override
+  EngineLoadStats get loadStats {
+    final s = calloc<bindings.EngineLoadStats>();
+    try {
+      if (bindings.engine_get_load_stats(_self, s) != 1) {
+        throw MiniaudioDartPlatformException("engine_get_load_stats failed.");
+      }
+      return EngineLoadStats(
+        callbacks: s.ref.callbacks,
+        frames: s.ref.frames,
+        xruns: s.ref.xruns,
+        overruns: s.ref.overruns,
+        load: s.ref.load,
+        peakLoad: s.ref.peakLoad,
+        lastCallbackUs: s.ref.lastCallbackUs,
+        maxCallbackUs: s.ref.maxCallbackUs,
+        periodUs: s.ref.periodUs,
+        backend: bindings
+            .engine_get_backend_name(_self)
+            .cast<Utf8>()
+            .toDartString(),
+      );
+    } finally {
+      calloc.free(s);
+    }
+  }
+
+  @override
+  void resetLoadStats() => bindings.engine_reset_load_stats(_self);
+
+  @override
+  Float32List render(int frames) {
+    if (frames <= 0) return Float32List(0);
+    final ch = channels;
+    final out = calloc<Float>(frames * ch);
+    try {
+      final rendered = bindings.engine_render(_self, out, frames);
+      return Float32List.fromList(out.asTypedList(rendered * ch));
+    } finally {
+      calloc.free(out);
+    }
+  }
+
+  @override
+  bool renderToFile(String path, int frames) {
+    final pathPtr = path.toNativeUtf8(allocator: calloc);
+    try {
+      return bindings.engine_render_to_file(
+              _self, pathPtr.cast(), frames) ==
+          1;
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  @override
+  PlatformPlaylist createPlaylist(int crossfadeMs) {
+    final self = bindings.playlist_alloc();
+    if (self == nullptr) throw MiniaudioDartPlatformOutOfMemoryException();
+    if (bindings.playlist_init(self, _self, crossfadeMs) != 1) {
+      bindings.playlist_free(self);
+      throw MiniaudioDartPlatformException("Failed to init the playlist.");
+    }
+    final playlist = FfiPlaylist._(self, this);
+    _playlists.add(playlist);
+    return playlist;
+  }
+
+  @override
+  PlatformMixBus createBus(String name) {
+    final self = bindings.mix_bus_alloc();
+    if (self == nullptr) throw MiniaudioDartPlatformOutOfMemoryException();
+    final namePtr = name.toNativeUtf8(allocator: calloc);
+    try {
+      if (bindings.mix_bus_init(self, _self, namePtr.cast()) != 1) {
+        bindings.mix_bus_free(self);
+        throw MiniaudioDartPlatformException("Failed to init the bus.");
+      }
+    } finally {
+      calloc.free(namePtr);
+    }
+    final bus = FfiMixBus._(self, this, name);
+    _buses.add(bus);
+    return bus;
+  }
+
+  @override
+  PlatformEffect createEffect(EffectType type) {
+    final self = bindings.effect_alloc();
+    if (self == nullptr) throw MiniaudioDartPlatformOutOfMemoryException();
+    if (bindings.effect_init(self, _self, type.index) != 1) {
+      bindings.effect_free(self);
+      throw MiniaudioDartPlatformException("Failed to init the effect.");
+    }
+    final effect = FfiEffect._(self, this, type);
+    _effects.add(effect);
+    return effect;
+  }
+
+  T _withKey<T>(String key, T Function(Pointer<Char> key) body) {
+    final keyPtr = key.toNativeUtf8(allocator: calloc);
+    try {
+      return body(keyPtr.cast());
+    } finally {
+      calloc.free(keyPtr);
+    }
   }
 
   Future<List<(String name, bool isDefault)>> enumeratePlaybackDevices() async {
@@ -653,8 +1319,7 @@ final class FfiEngine implements PlatformEngine {
   }
 
   Future<bool> selectPlaybackDeviceByIndex(int index) async {
-    // IMPORTANT: Existing Sound / StreamPlayer objects tied to previous engine
-    // must be recreated after a successful switch.
+    // Only the native device is replaced; sounds and players keep running.
     final ok = bindings.engine_select_playback_device_by_index(_self, index);
     return ok != 0;
   }
@@ -691,6 +1356,11 @@ final class FfiSound implements PlatformSound {
   @override
   double get duration => _duration;
 
+  @override
+  double get priority => bindings.sound_get_priority(_self);
+  @override
+  set priority(double value) => bindings.sound_set_priority(_self, value);
+
   PlatformSoundLooping _looping = (false, 0);
   @override
   PlatformSoundLooping get looping => _looping;
@@ -725,6 +1395,46 @@ final class FfiSound implements PlatformSound {
   void pause() => bindings.sound_pause(_self);
   @override
   void stop() => bindings.sound_stop(_self);
+  @override
+  bool playAt(int timeInFrames) =>
+      bindings.sound_play_at(_self, timeInFrames) == 1;
+  @override
+  void stopAt(int timeInFrames) => bindings.sound_stop_at(_self, timeInFrames);
+
+  @override
+  bool setPolyphony(int maxVoices, VoiceStealPolicy policy) =>
+      bindings.sound_set_polyphony(_self, maxVoices, policy.index) == 1;
+  @override
+  int get polyphony => bindings.sound_get_polyphony(_self);
+  @override
+  int playVoice(double volume, int priority, bool looped) =>
+      bindings.sound_play_voice(_self, volume, priority, looped);
+  @override
+  int playVoiceAt(
+      double volume, int priority, bool looped, int timeInFrames) =>
+      bindings.sound_play_voice_at(
+          _self, volume, priority, looped, timeInFrames);
+  @override
+  void stopVoice(int voice) => bindings.sound_stop_voice(_self, voice);
+  @override
+  bool isVoicePlaying(int voice) =>
+      bindings.sound_voice_is_playing(_self, voice);
+  @override
+  void setVoiceVolume(int voice, double value) =>
+      bindings.sound_set_voice_volume(_self, voice, value);
+  @override
+  int get activeVoices => bindings.sound_get_active_voices(_self);
+
+  @override
+  bool setBus(PlatformMixBus? bus) =>
+      bindings.sound_set_bus(_self, FfiMixBus._native(bus)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) =>
+      bindings.sound_insert_effect(_self, FfiEffect._node(effect), index) == 1;
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      bindings.sound_remove_effect(_self, FfiEffect._node(effect)) == 1;
 
   @override
   bool rebindToEngine(PlatformEngine engine) {
@@ -735,6 +1445,179 @@ final class FfiSound implements PlatformSound {
   }
 }
 
+// playlist ffi
+final class FfiPlaylist implements PlatformPlaylist {
+  FfiPlaylist._(this._self, this._engine);
+
+  final Pointer<bindings.Playlist> _self;
+  final FfiEngine _engine;
+  bool _disposed = false;
+
+  @override
+  void start() {
+    if (bindings.playlist_start(_self) != 1) {
+      throw MiniaudioDartPlatformException("Failed to start the playlist.");
+    }
+  }
+
+  @override
+  void stop() => bindings.playlist_stop(_self);
+
+  @override
+  double get volume => bindings.playlist_get_volume(_self);
+  @override
+  set volume(double value) => bindings.playlist_set_volume(_self, value);
+
+  @override
+  int get crossfadeMs => bindings.playlist_get_crossfade(_self);
+  @override
+  set crossfadeMs(int value) => bindings.playlist_set_crossfade(_self, value);
+
+  @override
+  int add(AudioData audioData) {
+    final bytes = audioData.buffer.lengthInBytes;
+    final dataPtr = calloc<Float>(audioData.buffer.length);
+    try {
+      dataPtr
+          .asTypedList(audioData.buffer.length)
+          .setAll(0, audioData.buffer);
+      if (audioData.format == AudioFormat.unknown) {
+        return bindings.playlist_enqueue(_self, dataPtr.cast(), bytes);
+      }
+      return bindings.playlist_enqueue_pcm(
+        _self,
+        dataPtr.cast(),
+        bytes,
+        bindings.ma_format.fromValue(audioData.format),
+        audioData.channels,
+        audioData.sampleRate,
+      );
+    } finally {
+      calloc.free(dataPtr);
+    }
+  }
+
+  @override
+  int addFile(String path) {
+    final pathPtr = path.toNativeUtf8(allocator: calloc);
+    try {
+      return bindings.playlist_enqueue_file(_self, pathPtr.cast());
+    } finally {
+      calloc.free(pathPtr);
+    }
+  }
+
+  @override
+  void skip() => bindings.playlist_skip(_self);
+  @override
+  void clear() => bindings.playlist_clear(_self);
+
+  @override
+  int get current => bindings.playlist_get_current(_self);
+  @override
+  int get queued => bindings.playlist_get_queued(_self);
+
+  @override
+  bool setBus(PlatformMixBus? bus) =>
+      bindings.playlist_set_bus(_self, FfiMixBus._native(bus)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) =>
+      bindings.playlist_insert_effect(_self, FfiEffect._node(effect), index) ==
+      1;
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      bindings.playlist_remove_effect(_self, FfiEffect._node(effect)) == 1;
+
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _engine._playlists.remove(this);
+    bindings.playlist_free(_self);
+  }
+}
+
+// mix bus ffi
+final class FfiMixBus implements PlatformMixBus {
+  FfiMixBus._(this._self, this._engine, this.name);
+
+  final Pointer<bindings.MixBus> _self;
+  final FfiEngine _engine;
+  bool _disposed = false;
+
+  static Pointer<bindings.MixBus> _native(PlatformMixBus? bus) =>
+      bus is FfiMixBus && !bus._disposed ? bus._self : nullptr;
+
+  @override
+  final String name;
+
+  @override
+  double get volume => bindings.mix_bus_get_volume(_self);
+  @override
+  set volume(double value) => bindings.mix_bus_set_volume(_self, value);
+
+  @override
+  bool get muted => bindings.mix_bus_get_muted(_self);
+  @override
+  set muted(bool value) => bindings.mix_bus_set_muted(_self, value);
+
+  @override
+  bool setParent(PlatformMixBus? parent) =>
+      bindings.mix_bus_set_parent(_self, _native(parent)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) =>
+      bindings.mix_bus_insert_effect(_self, FfiEffect._node(effect), index) ==
+      1;
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      bindings.mix_bus_remove_effect(_self, FfiEffect._node(effect)) == 1;
+
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _engine._buses.remove(this);
+    bindings.mix_bus_free(_self);
+  }
+}
+
+// effect ffi
+final class FfiEffect implements PlatformEffect {
+  FfiEffect._(this._self, this._engine, this.type);
+
+  final Pointer<bindings.Effect> _self;
+  final FfiEngine _engine;
+  bool _disposed = false;
+
+  static Pointer<bindings.ma_node> _node(PlatformEffect effect) =>
+      effect is FfiEffect && !effect._disposed ? effect._self.cast() : nullptr;
+
+  @override
+  final EffectType type;
+
+  @override
+  double getParam(int param) => bindings.effect_get_param(_self, param);
+  @override
+  bool setParam(int param, double value) =>
+      bindings.effect_set_param(_self, param, value) == 1;
+
+  @override
+  double get reductionDb => bindings.effect_get_reduction_db(_self);
+
+  @override
+  void reset() => bindings.effect_reset(_self);
+
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _engine._effects.remove(this);
+    bindings.effect_free(_self);
+  }
+}
+
 // generator ffi
 class FfiGenerator implements PlatformGenerator {
   FfiGenerator(Pointer<bindings.Generator> self)
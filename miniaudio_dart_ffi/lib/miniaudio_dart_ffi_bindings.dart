@@ -51,6 +51,11 @@ external void silence_data_source_uninit(
 @ffi.Native<ffi.Pointer<Sound> Function()>()
 external ffi.Pointer<Sound> sound_alloc();
 
+@ffi.Native<ffi.Pointer<ffi.Void> Function(ffi.Size)>()
+external ffi.Pointer<ffi.Void> sound_data_alloc(
+  int size,
+);
+
 @ffi.Native<
     ffi.Int Function(
         ffi.Pointer<Sound>,
@@ -89,6 +94,18 @@ int sound_init(
       engine,
     );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<Sound>)>(symbol: 'sound_get_load_state')
+external int _sound_get_load_state(
+  ffi.Pointer<Sound> self,
+);
+
+SoundLoadState sound_get_load_state(
+  ffi.Pointer<Sound> self,
+) =>
+    SoundLoadState.fromValue(_sound_get_load_state(
+      self,
+    ));
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<Sound>)>()
 external void sound_unload(
   ffi.Pointer<Sound> self,
@@ -119,6 +136,85 @@ external void sound_stop(
   ffi.Pointer<Sound> self,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<Sound>, ffi.Uint64)>()
+external int sound_play_at(
+  ffi.Pointer<Sound> self,
+  int time_in_frames,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Sound>, ffi.Uint64)>()
+external void sound_stop_at(
+  ffi.Pointer<Sound> self,
+  int time_in_frames,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Sound>, ffi.Uint32, ffi.Int)>()
+external int sound_set_polyphony(
+  ffi.Pointer<Sound> self,
+  int max_voices,
+  int policy,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Sound>)>()
+external int sound_get_polyphony(
+  ffi.Pointer<Sound> self,
+);
+
+@ffi.Native<
+    ffi.Uint32 Function(ffi.Pointer<Sound>, ffi.Float, ffi.Int, ffi.Bool)>()
+external int sound_play_voice(
+  ffi.Pointer<Sound> self,
+  double volume,
+  int priority,
+  bool looped,
+);
+
+@ffi.Native<
+    ffi.Uint32 Function(
+        ffi.Pointer<Sound>, ffi.Float, ffi.Int, ffi.Bool, ffi.Uint64)>()
+external int sound_play_voice_at(
+  ffi.Pointer<Sound> self,
+  double volume,
+  int priority,
+  bool looped,
+  int time_in_frames,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Sound>, ffi.Uint32)>()
+external void sound_stop_voice(
+  ffi.Pointer<Sound> self,
+  int voice,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<Sound>, ffi.Uint32)>()
+external bool sound_voice_is_playing(
+  ffi.Pointer<Sound> self,
+  int voice,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Sound>, ffi.Uint32, ffi.Float)>()
+external void sound_set_voice_volume(
+  ffi.Pointer<Sound> self,
+  int voice,
+  double value,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Sound>)>()
+external int sound_get_active_voices(
+  ffi.Pointer<Sound> self,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<Sound>)>()
+external double sound_get_priority(
+  ffi.Pointer<Sound> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Sound>, ffi.Float)>()
+external void sound_set_priority(
+  ffi.Pointer<Sound> self,
+  double value,
+);
+
 @ffi.Native<ffi.Float Function(ffi.Pointer<Sound>)>()
 external double sound_get_volume(
   ffi.Pointer<Sound> self,
@@ -135,6 +231,31 @@ external double sound_get_duration(
   ffi.Pointer<Sound> self,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<Sound>, ffi.Pointer<MixBus>)>()
+external int sound_set_bus(
+  ffi.Pointer<Sound> self,
+  ffi.Pointer<MixBus> bus,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Sound>, ffi.Pointer<ma_node>, ffi.Int)>()
+external int sound_insert_effect(
+  ffi.Pointer<Sound> self,
+  ffi.Pointer<ma_node> effect,
+  int index,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Sound>, ffi.Pointer<ma_node>)>()
+external int sound_remove_effect(
+  ffi.Pointer<Sound> self,
+  ffi.Pointer<ma_node> effect,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Sound>)>()
+external void sound_clear_effects(
+  ffi.Pointer<Sound> self,
+);
+
 @ffi.Native<ffi.Bool Function(ffi.Pointer<Sound>)>()
 external bool sound_get_is_looped(
   ffi.Pointer<Sound> self,
@@ -172,6 +293,30 @@ external int engine_init(
   int period_ms,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<Engine>, ffi.Uint32, ffi.Uint32)>()
+external int engine_init_offline(
+  ffi.Pointer<Engine> self,
+  int channels,
+  int sample_rate,
+);
+
+@ffi.Native<
+    ffi.Uint64 Function(
+        ffi.Pointer<Engine>, ffi.Pointer<ffi.Float>, ffi.Uint64)>()
+external int engine_render(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Float> out,
+  int frames,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<ffi.Char>, ffi.Uint64)>()
+external int engine_render_to_file(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Char> path,
+  int frames,
+);
+
 @ffi.Native<ffi.Void Function(ffi.Pointer<Engine>)>()
 external void engine_uninit(
   ffi.Pointer<Engine> self,
@@ -220,6 +365,737 @@ int engine_load_sound(
       channels,
     );
 
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<Engine>,
+        ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Float>,
+        ffi.Size,
+        ffi.UnsignedInt,
+        ffi.Int,
+        ffi.Int,
+        ffi.Uint32)>(symbol: 'engine_load_sound_ex')
+external int _engine_load_sound_ex(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Float> data,
+  int data_size,
+  int format,
+  int sample_rate,
+  int channels,
+  int flags,
+);
+
+int engine_load_sound_ex(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Float> data,
+  int data_size,
+  ma_format format,
+  int sample_rate,
+  int channels,
+  int flags,
+) =>
+    _engine_load_sound_ex(
+      self,
+      sound,
+      data,
+      data_size,
+      format.value,
+      sample_rate,
+      channels,
+      flags,
+    );
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<Engine>,
+        ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Void>,
+        ffi.Size,
+        ffi.UnsignedInt,
+        ffi.Int,
+        ffi.Int,
+        ffi.Uint32,
+        SoundDataFree)>(symbol: 'engine_load_sound_adopt')
+external int _engine_load_sound_adopt(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Void> data,
+  int data_size,
+  int format,
+  int sample_rate,
+  int channels,
+  int flags,
+  SoundDataFree free_fn,
+);
+
+int engine_load_sound_adopt(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Void> data,
+  int data_size,
+  ma_format format,
+  int sample_rate,
+  int channels,
+  int flags,
+  SoundDataFree free_fn,
+) =>
+    _engine_load_sound_adopt(
+      self,
+      sound,
+      data,
+      data_size,
+      format.value,
+      sample_rate,
+      channels,
+      flags,
+      free_fn,
+    );
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<Engine>,
+        ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Void>,
+        ffi.Size,
+        ffi.UnsignedInt,
+        ffi.Int,
+        ffi.Int,
+        ffi.Uint32,
+        SoundDataRelease,
+        ffi.Pointer<ffi.Void>)>(symbol: 'engine_load_sound_external')
+external int _engine_load_sound_external(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Void> data,
+  int data_size,
+  int format,
+  int sample_rate,
+  int channels,
+  int flags,
+  SoundDataRelease release,
+  ffi.Pointer<ffi.Void> user_data,
+);
+
+int engine_load_sound_external(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Void> data,
+  int data_size,
+  ma_format format,
+  int sample_rate,
+  int channels,
+  int flags,
+  SoundDataRelease release,
+  ffi.Pointer<ffi.Void> user_data,
+) =>
+    _engine_load_sound_external(
+      self,
+      sound,
+      data,
+      data_size,
+      format.value,
+      sample_rate,
+      channels,
+      flags,
+      release,
+      user_data,
+    );
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Char>, ffi.Uint32)>()
+external int engine_load_sound_file(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Char> path,
+  int flags,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Engine>, ffi.Uint32)>()
+external int engine_set_job_threads(
+  ffi.Pointer<Engine> self,
+  int count,
+);
+
+@ffi.Native<
+    ffi.Void Function(
+        ffi.Pointer<Engine>, SoundLoadCallback, ffi.Pointer<ffi.Void>)>()
+external void engine_set_load_callback(
+  ffi.Pointer<Engine> self,
+  SoundLoadCallback callback,
+  ffi.Pointer<ffi.Void> user_data,
+);
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<Engine>,
+        ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Float>,
+        ffi.Size,
+        ffi.UnsignedInt,
+        ffi.Int,
+        ffi.Int,
+        ffi.Uint32)>(symbol: 'engine_load_sound_async')
+external int _engine_load_sound_async(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Float> data,
+  int data_size,
+  int format,
+  int sample_rate,
+  int channels,
+  int flags,
+);
+
+int engine_load_sound_async(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Float> data,
+  int data_size,
+  ma_format format,
+  int sample_rate,
+  int channels,
+  int flags,
+) =>
+    _engine_load_sound_async(
+      self,
+      sound,
+      data,
+      data_size,
+      format.value,
+      sample_rate,
+      channels,
+      flags,
+    );
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<Engine>,
+        ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Void>,
+        ffi.Size,
+        ffi.UnsignedInt,
+        ffi.Int,
+        ffi.Int,
+        ffi.Uint32,
+        SoundDataFree)>(symbol: 'engine_load_sound_adopt_async')
+external int _engine_load_sound_adopt_async(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Void> data,
+  int data_size,
+  int format,
+  int sample_rate,
+  int channels,
+  int flags,
+  SoundDataFree free_fn,
+);
+
+int engine_load_sound_adopt_async(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Void> data,
+  int data_size,
+  ma_format format,
+  int sample_rate,
+  int channels,
+  int flags,
+  SoundDataFree free_fn,
+) =>
+    _engine_load_sound_adopt_async(
+      self,
+      sound,
+      data,
+      data_size,
+      format.value,
+      sample_rate,
+      channels,
+      flags,
+      free_fn,
+    );
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Char>, ffi.Uint32)>()
+external int engine_load_sound_file_async(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Char> path,
+  int flags,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Engine>)>()
+external int engine_get_pending_loads(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<Engine>,
+        ffi.Pointer<Sound>,
+        ffi.Pointer<ffi.Char>,
+        ffi.Pointer<ffi.Float>,
+        ffi.Size,
+        ffi.UnsignedInt,
+        ffi.Int,
+        ffi.Int,
+        ffi.Uint32)>(symbol: 'engine_load_sound_shared')
+external int _engine_load_sound_shared(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Char> key,
+  ffi.Pointer<ffi.Float> data,
+  int data_size,
+  int format,
+  int sample_rate,
+  int channels,
+  int flags,
+);
+
+int engine_load_sound_shared(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<Sound> sound,
+  ffi.Pointer<ffi.Char> key,
+  ffi.Pointer<ffi.Float> data,
+  int data_size,
+  ma_format format,
+  int sample_rate,
+  int channels,
+  int flags,
+) =>
+    _engine_load_sound_shared(
+      self,
+      sound,
+      key,
+      data,
+      data_size,
+      format.value,
+      sample_rate,
+      channels,
+      flags,
+    );
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<ffi.Char>)>()
+external int engine_has_asset(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Char> key,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<ffi.Char>)>()
+external int engine_evict_asset(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Char> key,
+);
+
+@ffi.Native<ffi.Uint64 Function(ffi.Pointer<Engine>)>()
+external int engine_trim_assets(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<ffi.Uint32>,
+        ffi.Pointer<ffi.Uint64>)>()
+external int engine_get_asset_stats(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Uint32> outCount,
+  ffi.Pointer<ffi.Uint64> outBytes,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Engine>, ffi.Uint32)>()
+external void engine_set_max_voices(
+  ffi.Pointer<Engine> self,
+  int max_voices,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Engine>)>()
+external int engine_get_max_voices(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<ffi.Uint32>,
+        ffi.Pointer<ffi.Uint32>)>()
+external int engine_get_voice_stats(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Uint32> outMixed,
+  ffi.Pointer<ffi.Uint32> outVirtual,
+);
+
+@ffi.Native<ffi.Uint64 Function(ffi.Pointer<Engine>)>()
+external int engine_get_time_in_pcm_frames(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Engine>)>()
+external int engine_get_sample_rate(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Engine>, ffi.Uint32, ffi.Uint32)>()
+external int engine_set_duplex(
+  ffi.Pointer<Engine> self,
+  int capture_channels,
+  int buffer_ms,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Engine>)>()
+external int engine_get_capture_channels(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Engine>)>()
+external int engine_get_channels(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Engine>)>()
+external int engine_duplex_available(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<
+    ffi.Uint32 Function(ffi.Pointer<Engine>, ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>, ffi.Uint32)>()
+external int engine_duplex_read(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<ffi.Float> capture,
+  ffi.Pointer<ffi.Float> reference,
+  int frames,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Engine>, ffi.Float)>()
+external void engine_set_monitor_gain(
+  ffi.Pointer<Engine> self,
+  double gain,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<Engine>)>()
+external double engine_get_monitor_gain(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<EchoCanceller>)>()
+external int engine_set_echo_reference(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<EchoCanceller> ec,
+);
+
+@ffi.Native<EngineLatencyConfig Function(ffi.UnsignedInt)>(
+    symbol: 'engine_latency_config_init')
+external EngineLatencyConfig _engine_latency_config_init(
+  int profile,
+);
+
+EngineLatencyConfig engine_latency_config_init(
+  EngineLatencyProfile profile,
+) =>
+    _engine_latency_config_init(
+      profile.value,
+    );
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<EngineLatencyConfig>)>()
+external int engine_set_latency_config(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<EngineLatencyConfig> config,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<EngineLatencyInfo>)>()
+external int engine_get_latency_info(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<EngineLatencyInfo> out,
+);
+
+@ffi.Native<ffi.Pointer<ffi.Char> Function(ffi.Pointer<Engine>)>()
+external ffi.Pointer<ffi.Char> engine_get_backend_name(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Engine>, ffi.Pointer<EngineLoadStats>)>()
+external int engine_get_load_stats(
+  ffi.Pointer<Engine> self,
+  ffi.Pointer<EngineLoadStats> out,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Engine>)>()
+external void engine_reset_load_stats(
+  ffi.Pointer<Engine> self,
+);
+
+@ffi.Native<ffi.Pointer<Playlist> Function()>()
+external ffi.Pointer<Playlist> playlist_alloc();
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>)>()
+external void playlist_free(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Playlist>, ffi.Pointer<Engine>, ffi.Uint32)>()
+external int playlist_init(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<Engine> engine,
+  int crossfade_ms,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>)>()
+external void playlist_uninit(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Playlist>)>()
+external int playlist_start(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Playlist>)>()
+external int playlist_stop(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>, ffi.Float)>()
+external void playlist_set_volume(
+  ffi.Pointer<Playlist> self,
+  double volume,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<Playlist>)>()
+external double playlist_get_volume(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>, ffi.Uint32)>()
+external void playlist_set_crossfade(
+  ffi.Pointer<Playlist> self,
+  int crossfade_ms,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Playlist>)>()
+external int playlist_get_crossfade(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<
+    ffi.Uint32 Function(
+        ffi.Pointer<Playlist>, ffi.Pointer<ffi.Void>, ffi.Size)>()
+external int playlist_enqueue(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<ffi.Void> data,
+  int size,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Playlist>, ffi.Pointer<ffi.Char>)>()
+external int playlist_enqueue_file(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<ffi.Char> path,
+);
+
+@ffi.Native<
+    ffi.Uint32 Function(ffi.Pointer<Playlist>, ffi.Pointer<ffi.Void>, ffi.Size,
+        ffi.UnsignedInt, ffi.Int, ffi.Int)>(symbol: 'playlist_enqueue_pcm')
+external int _playlist_enqueue_pcm(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<ffi.Void> data,
+  int size,
+  int format,
+  int channels,
+  int sample_rate,
+);
+
+int playlist_enqueue_pcm(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<ffi.Void> data,
+  int size,
+  ma_format format,
+  int channels,
+  int sample_rate,
+) =>
+    _playlist_enqueue_pcm(
+      self,
+      data,
+      size,
+      format.value,
+      channels,
+      sample_rate,
+    );
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>)>()
+external void playlist_skip(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>)>()
+external void playlist_clear(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Playlist>)>()
+external int playlist_get_current(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Uint32 Function(ffi.Pointer<Playlist>)>()
+external int playlist_get_queued(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Playlist>, ffi.Pointer<MixBus>)>()
+external int playlist_set_bus(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<MixBus> bus,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Playlist>, ffi.Pointer<ma_node>, ffi.Int)>()
+external int playlist_insert_effect(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<ma_node> effect,
+  int index,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Playlist>, ffi.Pointer<ma_node>)>()
+external int playlist_remove_effect(
+  ffi.Pointer<Playlist> self,
+  ffi.Pointer<ma_node> effect,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Playlist>)>()
+external void playlist_clear_effects(
+  ffi.Pointer<Playlist> self,
+);
+
+@ffi.Native<ffi.Pointer<MixBus> Function()>()
+external ffi.Pointer<MixBus> mix_bus_alloc();
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<MixBus>)>()
+external void mix_bus_free(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<MixBus>, ffi.Pointer<Engine>, ffi.Pointer<ffi.Char>)>()
+external int mix_bus_init(
+  ffi.Pointer<MixBus> self,
+  ffi.Pointer<Engine> engine,
+  ffi.Pointer<ffi.Char> name,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<MixBus>)>()
+external void mix_bus_uninit(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<ffi.Pointer<ffi.Char> Function(ffi.Pointer<MixBus>)>()
+external ffi.Pointer<ffi.Char> mix_bus_get_name(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<MixBus>, ffi.Float)>()
+external void mix_bus_set_volume(
+  ffi.Pointer<MixBus> self,
+  double volume,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<MixBus>)>()
+external double mix_bus_get_volume(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<MixBus>, ffi.Bool)>()
+external void mix_bus_set_muted(
+  ffi.Pointer<MixBus> self,
+  bool muted,
+);
+
+@ffi.Native<ffi.Bool Function(ffi.Pointer<MixBus>)>()
+external bool mix_bus_get_muted(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<MixBus>, ffi.Pointer<MixBus>)>()
+external int mix_bus_set_parent(
+  ffi.Pointer<MixBus> self,
+  ffi.Pointer<MixBus> parent,
+);
+
+@ffi.Native<ffi.Pointer<MixBus> Function(ffi.Pointer<MixBus>)>()
+external ffi.Pointer<MixBus> mix_bus_get_parent(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<MixBus>, ffi.Pointer<ma_node>, ffi.Int)>()
+external int mix_bus_insert_effect(
+  ffi.Pointer<MixBus> self,
+  ffi.Pointer<ma_node> effect,
+  int index,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<MixBus>, ffi.Pointer<ma_node>)>()
+external int mix_bus_remove_effect(
+  ffi.Pointer<MixBus> self,
+  ffi.Pointer<ma_node> effect,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<MixBus>)>()
+external void mix_bus_clear_effects(
+  ffi.Pointer<MixBus> self,
+);
+
+@ffi.Native<ffi.Pointer<Effect> Function()>()
+external ffi.Pointer<Effect> effect_alloc();
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Effect>)>()
+external void effect_free(
+  ffi.Pointer<Effect> self,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Effect>, ffi.Pointer<Engine>, ffi.Int)>()
+external int effect_init(
+  ffi.Pointer<Effect> self,
+  ffi.Pointer<Engine> engine,
+  int type,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Effect>)>()
+external void effect_uninit(
+  ffi.Pointer<Effect> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Effect>)>()
+external int effect_get_type(
+  ffi.Pointer<Effect> self,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Effect>, ffi.Int, ffi.Float)>()
+external int effect_set_param(
+  ffi.Pointer<Effect> self,
+  int param,
+  double value,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<Effect>, ffi.Int)>()
+external double effect_get_param(
+  ffi.Pointer<Effect> self,
+  int param,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<Effect>)>()
+external double effect_get_reduction_db(
+  ffi.Pointer<Effect> self,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Effect>)>()
+external void effect_reset(
+  ffi.Pointer<Effect> self,
+);
+
 @ffi.Native<ffi.Int Function(ffi.Pointer<Engine>)>()
 external int engine_refresh_playback_devices(
   ffi.Pointer<Engine> self,
@@ -446,6 +1322,99 @@ external double recorder_get_capture_gain(
   ffi.Pointer<Recorder> r,
 );
 
+@ffi.Native<
+    ffi.Uint32 Function(
+        ffi.Pointer<Recorder>, CaptureProcessFn, ffi.Pointer<ffi.Void>)>()
+external int recorder_add_processor(
+  ffi.Pointer<Recorder> r,
+  CaptureProcessFn fn,
+  ffi.Pointer<ffi.Void> user_data,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Recorder>, ffi.Uint32)>()
+external int recorder_remove_processor(
+  ffi.Pointer<Recorder> r,
+  int id,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<Recorder>, ffi.Float)>()
+external int recorder_set_noise_suppression(
+  ffi.Pointer<Recorder> r,
+  double reductionDb,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<Recorder>, ffi.Pointer<Engine>, ffi.Uint32)>()
+external int recorder_enable_echo_cancellation(
+  ffi.Pointer<Recorder> r,
+  ffi.Pointer<Engine> engine,
+  int filterMs,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<Recorder>)>()
+external void recorder_disable_echo_cancellation(
+  ffi.Pointer<Recorder> r,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<Recorder>)>()
+external double recorder_get_echo_return_loss_enhancement(
+  ffi.Pointer<Recorder> r,
+);
+
+@ffi.Native<ffi.Pointer<EchoCanceller> Function(ffi.Uint32, ffi.Uint32)>()
+external ffi.Pointer<EchoCanceller> echo_canceller_create(
+  int sample_rate,
+  int filter_ms,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<EchoCanceller>)>()
+external void echo_canceller_destroy(
+  ffi.Pointer<EchoCanceller> ec,
+);
+
+@ffi.Native<
+    ffi.Void Function(ffi.Pointer<EchoCanceller>, ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Float>, ffi.Uint32, ffi.Uint32)>()
+external void echo_canceller_process(
+  ffi.Pointer<EchoCanceller> ec,
+  ffi.Pointer<ffi.Float> capture,
+  ffi.Pointer<ffi.Float> reference,
+  int frame_count,
+  int channels,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<EchoCanceller>)>()
+external double echo_canceller_get_erle(
+  ffi.Pointer<EchoCanceller> ec,
+);
+
+@ffi.Native<ffi.Pointer<NoiseSuppressor> Function(ffi.Uint32, ffi.Float)>()
+external ffi.Pointer<NoiseSuppressor> noise_suppressor_create(
+  int sample_rate,
+  double reduction_db,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<NoiseSuppressor>)>()
+external void noise_suppressor_destroy(
+  ffi.Pointer<NoiseSuppressor> ns,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<NoiseSuppressor>, ffi.Float)>()
+external void noise_suppressor_set_reduction(
+  ffi.Pointer<NoiseSuppressor> ns,
+  double reduction_db,
+);
+
+@ffi.Native<
+    ffi.Void Function(
+        ffi.Pointer<ffi.Void>, ffi.Pointer<ffi.Float>, ffi.Uint32, ffi.Uint32)>()
+external void noise_suppressor_process(
+  ffi.Pointer<ffi.Void> ns,
+  ffi.Pointer<ffi.Float> frames,
+  int frame_count,
+  int channels,
+);
+
 @ffi.Native<ffi.UnsignedInt Function(ffi.Pointer<Recorder>)>(
     symbol: 'recorder_get_codec')
 external int _recorder_get_codec(
@@ -810,6 +1779,33 @@ external double stream_player_get_volume(
   ffi.Pointer<StreamPlayer> sp,
 );
 
+@ffi.Native<ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<MixBus>)>()
+external int stream_player_set_bus(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<MixBus> bus,
+);
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<StreamPlayer>, ffi.Pointer<ma_node>, ffi.Int)>()
+external int stream_player_insert_effect(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<ma_node> effect,
+  int index,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<ma_node>)>()
+external int stream_player_remove_effect(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<ma_node> effect,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<StreamPlayer>)>()
+external void stream_player_clear_effects(
+  ffi.Pointer<StreamPlayer> sp,
+);
+
 @ffi.Native<
     ffi.Size Function(
         ffi.Pointer<StreamPlayer>, ffi.Pointer<ffi.Float>, ffi.Size)>()
@@ -819,6 +1815,125 @@ external int stream_player_write_frames_f32(
   int frameCount,
 );
 
+@ffi.Native<
+    ffi.Size Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<ffi.Float>,
+        ffi.Size, ffi.Int64)>()
+external int stream_player_write_frames_f32_at(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<ffi.Float> frames,
+  int frameCount,
+  int timestampFrames,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<ffi.Pointer<ffi.Void>>,
+        ffi.Pointer<ffi.Int>)>()
+external int stream_player_acquire_write_region(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<ffi.Pointer<ffi.Void>> outPtr,
+  ffi.Pointer<ffi.Int> outFrames,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Int)>()
+external int stream_player_commit_write(
+  ffi.Pointer<StreamPlayer> sp,
+  int frames,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Int, ffi.Int64)>()
+external int stream_player_commit_write_at(
+  ffi.Pointer<StreamPlayer> sp,
+  int frames,
+  int timestampFrames,
+);
+
+@ffi.Native<ffi.Int64 Function(ffi.Pointer<StreamPlayer>)>()
+external int stream_player_get_position(
+  ffi.Pointer<StreamPlayer> sp,
+);
+
+@ffi.Native<ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Int64)>()
+external int stream_player_seek(
+  ffi.Pointer<StreamPlayer> sp,
+  int timestampFrames,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<ffi.Int64>,
+        ffi.Pointer<ffi.Int64>)>()
+external int stream_player_get_buffered_range(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<ffi.Int64> outStart,
+  ffi.Pointer<ffi.Int64> outEnd,
+);
+
+@ffi.Native<
+    ffi.Void Function(
+        ffi.Pointer<StreamPlayer>, ffi.Float, ffi.Uint32, ffi.Int)>()
+external void stream_player_ramp_gain(
+  ffi.Pointer<StreamPlayer> sp,
+  double target,
+  int durationMs,
+  int curve,
+);
+
+@ffi.Native<ffi.Float Function(ffi.Pointer<StreamPlayer>)>()
+external double stream_player_get_gain(
+  ffi.Pointer<StreamPlayer> sp,
+);
+
+@ffi.Native<
+    ffi.Void Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<StreamPlayer>,
+        ffi.Uint32, ffi.Int)>()
+external void stream_player_crossfade(
+  ffi.Pointer<StreamPlayer> from,
+  ffi.Pointer<StreamPlayer> to,
+  int durationMs,
+  int curve,
+);
+
+@ffi.Native<
+    ffi.Int Function(ffi.Pointer<StreamPlayer>, ffi.Pointer<StreamPlayer>,
+        ffi.Float, ffi.Float, ffi.Uint32, ffi.Uint32)>()
+external int stream_player_set_ducking(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<StreamPlayer> sidechain,
+  double threshold,
+  double duckGain,
+  int attackMs,
+  int releaseMs,
+);
+
+@ffi.Native<
+    ffi.Int Function(
+        ffi.Pointer<StreamPlayer>, ffi.Pointer<StreamPlayerStats>)>()
+external int stream_player_get_stats(
+  ffi.Pointer<StreamPlayer> sp,
+  ffi.Pointer<StreamPlayerStats> outStats,
+);
+
+@ffi.Native<ffi.Void Function(ffi.Pointer<StreamPlayer>)>()
+external void stream_player_reset_stats(
+  ffi.Pointer<StreamPlayer> sp,
+);
+
+@ffi.Native<
+    ffi.Void Function(
+        ffi.Pointer<StreamPlayer>,
+        StreamPlayerTelemetryCallback,
+        ffi.Pointer<ffi.Void>,
+        ffi.Uint32,
+        ffi.Uint32,
+        ffi.Uint32)>()
+external void stream_player_set_telemetry_callback(
+  ffi.Pointer<StreamPlayer> sp,
+  StreamPlayerTelemetryCallback cb,
+  ffi.Pointer<ffi.Void> userData,
+  int underrunThreshold,
+  int dropThresholdFrames,
+  int decodeErrorThreshold,
+);
+
 @ffi.Native<
     ffi.Int Function(
         ffi.Pointer<StreamPlayer>, ffi.Pointer<ffi.Void>, ffi.Int)>()
@@ -5007,6 +6122,101 @@ final class Sound extends ffi.Struct {
 
 final class Engine extends ffi.Opaque {}
 
+enum EngineLatencyProfile {
+  ENGINE_LATENCY_CONSERVATIVE(0),
+  ENGINE_LATENCY_LOW(1),
+  ENGINE_LATENCY_ULTRA(2);
+
+  final int value;
+  const EngineLatencyProfile(this.value);
+
+  static EngineLatencyProfile fromValue(int value) => switch (value) {
+        0 => ENGINE_LATENCY_CONSERVATIVE,
+        1 => ENGINE_LATENCY_LOW,
+        2 => ENGINE_LATENCY_ULTRA,
+        _ => throw ArgumentError(
+            'Unknown value for EngineLatencyProfile: $value'),
+      };
+}
+
+final class EngineLatencyConfig extends ffi.Struct {
+  @ffi.UnsignedInt()
+  external int profileAsInt;
+
+  EngineLatencyProfile get profile =>
+      EngineLatencyProfile.fromValue(profileAsInt);
+
+  @ffi.Uint32()
+  external int periodFrames;
+
+  @ffi.Uint32()
+  external int periods;
+
+  @ffi.Int()
+  external int exclusive;
+
+  @ffi.Int()
+  external int noFixedSizedCallback;
+
+  @ffi.Int()
+  external int preferLowLatencyBackend;
+}
+
+final class EngineLatencyInfo extends ffi.Struct {
+  @ffi.Uint32()
+  external int periodFrames;
+
+  @ffi.Uint32()
+  external int periods;
+
+  @ffi.Uint32()
+  external int sampleRate;
+
+  @ffi.Uint32()
+  external int latencyFrames;
+
+  @ffi.Float()
+  external double latencyMs;
+
+  @ffi.Int()
+  external int exclusive;
+
+  @ffi.Int()
+  external int backend;
+}
+
+final class EngineLoadStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int callbacks;
+
+  @ffi.Uint64()
+  external int frames;
+
+  @ffi.Uint64()
+  external int xruns;
+
+  @ffi.Uint64()
+  external int overruns;
+
+  @ffi.Float()
+  external double load;
+
+  @ffi.Float()
+  external double peakLoad;
+
+  @ffi.Float()
+  external double lastCallbackUs;
+
+  @ffi.Float()
+  external double maxCallbackUs;
+
+  @ffi.Float()
+  external double periodUs;
+
+  @ffi.Int()
+  external int backend;
+}
+
 final class PlaybackDeviceInfo extends ffi.Struct {
   @ffi.Array.multi([256])
   external ffi.Array<ffi.Char> name;
@@ -5125,6 +6335,10 @@ final class CrossCoder extends ffi.Struct {
 
 final class Recorder extends ffi.Opaque {}
 
+final class EchoCanceller extends ffi.Opaque {}
+
+final class NoiseSuppressor extends ffi.Opaque {}
+
 enum RecorderCodec {
   RECORDER_CODEC_PCM(0),
   RECORDER_CODEC_OPUS(1);
@@ -5273,6 +6487,12 @@ enum ma_noise_type {
 
 final class StreamPlayer extends ffi.Opaque {}
 
+final class Playlist extends ffi.Opaque {}
+
+final class MixBus extends ffi.Opaque {}
+
+final class Effect extends ffi.Opaque {}
+
 final class CodecRuntime extends ffi.Struct {
   external ffi.Pointer<Codec> current;
 
@@ -5301,8 +6521,168 @@ final class StreamPlayerConfig extends ffi.Struct {
 
   @ffi.Int()
   external int decodeAccumFrames;
+
+  @ffi.Int()
+  external int bufferedMode;
+
+  @ffi.Uint32()
+  external int segmentMilliseconds;
+
+  @ffi.Uint32()
+  external int prerollMilliseconds;
+
+  @ffi.Uint32()
+  external int fadeMilliseconds;
+}
+
+final class StreamPlayerStats extends ffi.Struct {
+  @ffi.Uint64()
+  external int underrunEvents;
+
+  @ffi.Uint64()
+  external int silenceFrames;
+
+  @ffi.Uint64()
+  external int droppedFrames;
+
+  @ffi.Uint32()
+  external int fillFrames;
+
+  @ffi.Uint32()
+  external int peakFillFrames;
+
+  @ffi.Uint32()
+  external int capacityFrames;
+
+  @ffi.Array.multi([2])
+  external ffi.Array<ffi.Uint32> decodeErrors;
 }
 
+enum SoundLoadFlags {
+  SOUND_LOAD_DEFAULT(0),
+  SOUND_LOAD_DECODE(1),
+  SOUND_LOAD_STREAM(2),
+  SOUND_LOAD_MMAP(4);
+
+  final int value;
+  const SoundLoadFlags(this.value);
+
+  static SoundLoadFlags fromValue(int value) => switch (value) {
+        0 => SOUND_LOAD_DEFAULT,
+        1 => SOUND_LOAD_DECODE,
+        2 => SOUND_LOAD_STREAM,
+        4 => SOUND_LOAD_MMAP,
+        _ => throw ArgumentError('Unknown value for SoundLoadFlags: $value'),
+      };
+}
+
+enum SoundStealPolicy {
+  SOUND_STEAL_OLDEST(0),
+  SOUND_STEAL_QUIETEST(1),
+  SOUND_STEAL_LOWEST_PRIORITY(2),
+  SOUND_STEAL_NONE(3);
+
+  final int value;
+  const SoundStealPolicy(this.value);
+
+  static SoundStealPolicy fromValue(int value) => switch (value) {
+        0 => SOUND_STEAL_OLDEST,
+        1 => SOUND_STEAL_QUIETEST,
+        2 => SOUND_STEAL_LOWEST_PRIORITY,
+        3 => SOUND_STEAL_NONE,
+        _ => throw ArgumentError('Unknown value for SoundStealPolicy: $value'),
+      };
+}
+
+const int VOICE_POOL_MAX_VOICES = 64;
+
+enum SoundLoadState {
+  SOUND_LOAD_STATE_NONE(0),
+  SOUND_LOAD_STATE_PENDING(1),
+  SOUND_LOAD_STATE_READY(2),
+  SOUND_LOAD_STATE_FAILED(3);
+
+  final int value;
+  const SoundLoadState(this.value);
+
+  static SoundLoadState fromValue(int value) => switch (value) {
+        0 => SOUND_LOAD_STATE_NONE,
+        1 => SOUND_LOAD_STATE_PENDING,
+        2 => SOUND_LOAD_STATE_READY,
+        3 => SOUND_LOAD_STATE_FAILED,
+        _ => throw ArgumentError('Unknown value for SoundLoadState: $value'),
+      };
+}
+
+typedef SoundLoadCallbackFunction = ffi.Void Function(
+    ffi.Pointer<Sound> sound, ffi.Int ok, ffi.Pointer<ffi.Void> userData);
+typedef DartSoundLoadCallbackFunction = void Function(
+    ffi.Pointer<Sound> sound, int ok, ffi.Pointer<ffi.Void> userData);
+typedef SoundLoadCallback
+    = ffi.Pointer<ffi.NativeFunction<SoundLoadCallbackFunction>>;
+typedef SoundDataFreeFunction = ffi.Void Function(ffi.Pointer<ffi.Void> data);
+typedef DartSoundDataFreeFunction = void Function(ffi.Pointer<ffi.Void> data);
+typedef SoundDataFree = ffi.Pointer<ffi.NativeFunction<SoundDataFreeFunction>>;
+typedef SoundDataReleaseFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Void> data, ffi.Pointer<ffi.Void> user_data);
+typedef DartSoundDataReleaseFunction = void Function(
+    ffi.Pointer<ffi.Void> data, ffi.Pointer<ffi.Void> user_data);
+typedef SoundDataRelease
+    = ffi.Pointer<ffi.NativeFunction<SoundDataReleaseFunction>>;
+typedef CaptureProcessFnFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Void> user_data,
+    ffi.Pointer<ffi.Float> frames,
+    ffi.Uint32 frame_count,
+    ffi.Uint32 channels);
+typedef DartCaptureProcessFnFunction = void Function(
+    ffi.Pointer<ffi.Void> user_data,
+    ffi.Pointer<ffi.Float> frames,
+    int frame_count,
+    int channels);
+typedef CaptureProcessFn
+    = ffi.Pointer<ffi.NativeFunction<CaptureProcessFnFunction>>;
+
+enum StreamPlayerRampCurve {
+  STREAM_PLAYER_RAMP_LINEAR(0),
+  STREAM_PLAYER_RAMP_EXPONENTIAL(1);
+
+  final int value;
+  const StreamPlayerRampCurve(this.value);
+
+  static StreamPlayerRampCurve fromValue(int value) => switch (value) {
+        0 => STREAM_PLAYER_RAMP_LINEAR,
+        1 => STREAM_PLAYER_RAMP_EXPONENTIAL,
+        _ => throw ArgumentError(
+            'Unknown value for StreamPlayerRampCurve: $value'),
+      };
+}
+
+enum StreamPlayerEvent {
+  STREAM_PLAYER_EVENT_UNDERRUN(1),
+  STREAM_PLAYER_EVENT_DROP(2),
+  STREAM_PLAYER_EVENT_DECODE_ERROR(3);
+
+  final int value;
+  const StreamPlayerEvent(this.value);
+
+  static StreamPlayerEvent fromValue(int value) => switch (value) {
+        1 => STREAM_PLAYER_EVENT_UNDERRUN,
+        2 => STREAM_PLAYER_EVENT_DROP,
+        3 => STREAM_PLAYER_EVENT_DECODE_ERROR,
+        _ =>
+          throw ArgumentError('Unknown value for StreamPlayerEvent: $value'),
+      };
+}
+
+typedef StreamPlayerTelemetryCallbackFunction = ffi.Void Function(
+    ffi.Pointer<ffi.Void> userData, ffi.Int event, ffi.Uint64 total);
+typedef DartStreamPlayerTelemetryCallbackFunction = void Function(
+    ffi.Pointer<ffi.Void> userData, int event, int total);
+typedef StreamPlayerTelemetryCallback
+    = ffi.Pointer<ffi.NativeFunction<StreamPlayerTelemetryCallbackFunction>>;
+
+const int STREAM_PLAYER_CODEC_SLOTS = 2;
+
 const int CODEC_VTABLE_VERSION = 1;
 
 const int CODEC_FRAME_HEADER_BYTES = 6;
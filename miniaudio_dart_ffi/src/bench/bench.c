@@ -0,0 +1,142 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef BENCH_VERSION
+#define BENCH_VERSION "unknown"
+#endif
+
+typedef struct BenchResult {
+    const char* suite;
+    const char* name;
+    const char* param;
+    int64_t     value;
+    const char* unit;
+    int         lowerIsBetter;
+    double      median;
+    double      min;
+    double      max;
+} BenchResult;
+
+static BenchResult   b_results[BENCH_MAX_RESULTS];
+static int           b_count = 0;
+static int           b_reps = 7;
+static const char*   b_suite = NULL;
+static volatile float b_sink = 0.0f;
+
+static int compare_doubles(const void* a, const void* b) {
+    double const x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double bench_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int bench_reps(void) {
+    return b_reps;
+}
+
+int bench_selected(const char* suite) {
+    return b_suite == NULL || strcmp(b_suite, suite) == 0;
+}
+
+void bench_consume(float value) {
+    b_sink += value;
+}
+
+void bench_report(const char* suite, const char* name,
+                  const char* param, int64_t value,
+                  const char* unit, int lowerIsBetter,
+                  const double* samples, int count) {
+    if (count <= 0 || b_count == BENCH_MAX_RESULTS) return;
+    double sorted[BENCH_MAX_REPS];
+    if (count > BENCH_MAX_REPS) count = BENCH_MAX_REPS;
+    memcpy(sorted, samples, count * sizeof(double));
+    qsort(sorted, count, sizeof(double), compare_doubles);
+
+    BenchResult* r = &b_results[b_count++];
+    r->suite         = suite;
+    r->name          = name;
+    r->param         = param;
+    r->value         = value;
+    r->unit          = unit;
+    r->lowerIsBetter = lowerIsBetter;
+    r->median        = count % 2 ? sorted[count / 2]
+                                 : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+    r->min           = sorted[0];
+    r->max           = sorted[count - 1];
+
+    char label[96];
+    if (param) snprintf(label, sizeof(label), "%s %s=%lld", name, param, (long long)value);
+    else       snprintf(label, sizeof(label), "%s", name);
+    printf("%-8s %-40s %12.3f %-10s (min %.3f, max %.3f)\n",
+           suite, label, r->median, unit, r->min, r->max);
+    fflush(stdout);
+}
+
+static int write_json(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return 0;
+#ifdef HAVE_OPUS
+    int const opus = 1;
+#else
+    int const opus = 0;
+#endif
+    fprintf(f, "{\n  \"schema\": 1,\n  \"version\": \"%s\",\n  \"opus\": %s,\n"
+               "  \"repetitions\": %d,\n  \"results\": [\n",
+            BENCH_VERSION, opus ? "true" : "false", b_reps);
+    for (int i = 0; i < b_count; ++i) {
+        BenchResult const* r = &b_results[i];
+        fprintf(f, "    { \"suite\": \"%s\", \"name\": \"%s\", ", r->suite, r->name);
+        if (r->param) fprintf(f, "\"param\": \"%s\", \"value\": %lld, ", r->param, (long long)r->value);
+        fprintf(f, "\"unit\": \"%s\", \"better\": \"%s\", "
+                   "\"median\": %.6g, \"min\": %.6g, \"max\": %.6g }%s\n",
+                r->unit, r->lowerIsBetter ? "lower" : "higher",
+                r->median, r->min, r->max, i + 1 < b_count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+static void usage(void) {
+    printf("usage: miniaudio_dart_bench [--json FILE] [--suite ring|codec|stream|mix|capture|effects]\n"
+           "                            [--reps N] [--quick]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* json = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json = argv[++i];
+        } else if (strcmp(argv[i], "--suite") == 0 && i + 1 < argc) {
+            b_suite = argv[++i];
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            b_reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            b_reps = 2;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (b_reps < 1) b_reps = 1;
+    if (b_reps > BENCH_MAX_REPS) b_reps = BENCH_MAX_REPS;
+
+    if (bench_selected("ring"))    bench_ring();
+    if (bench_selected("codec"))   bench_codec();
+    if (bench_selected("stream"))  bench_stream();
+    if (bench_selected("mix"))     bench_mix();
+    if (bench_selected("capture")) bench_capture();
+    if (bench_selected("effects")) bench_effects();
+
+    if (json && !write_json(json)) {
+        fprintf(stderr, "could not write %s\n", json);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/* Microbenchmarks for the native layer.
+
+   Each benchmark runs a warm-up pass and then a fixed number of timed
+   repetitions with fixed inputs, so two runs on one machine are directly
+   comparable. Results are printed as they come and, with --json, written as
+   one document per run for tracking across releases:
+
+     { "schema": 1, "version": "...", "opus": true, "repetitions": 7,
+       "results": [ { "suite": "ring", "name": "circular_buffer",
+                      "param": "chunk", "value": 256, "unit": "MB/s",
+                      "better": "higher", "median": ..., "min": ...,
+                      "max": ... }, ... ] } */
+
+#define BENCH_MAX_RESULTS 256
+#define BENCH_MAX_REPS    15
+
+/* Monotonic wall time. */
+double bench_now_us(void);
+
+/* Timed repetitions for this run (--reps, --quick). */
+int    bench_reps(void);
+/* Whether a suite was selected (--suite, default all). */
+int    bench_selected(const char* suite);
+
+/* Records one benchmark from its per-repetition samples. param may be NULL
+   when the benchmark has none. */
+void   bench_report(const char* suite, const char* name,
+                    const char* param, int64_t value,
+                    const char* unit, int lowerIsBetter,
+                    const double* samples, int count);
+
+/* Keeps the optimizer from discarding a computed result. */
+void   bench_consume(float value);
+
+/* Suites. */
+void   bench_ring(void);
+void   bench_codec(void);
+void   bench_stream(void);
+void   bench_mix(void);
+void   bench_capture(void);
+void   bench_effects(void);
+
+#endif /* BENCH_H */
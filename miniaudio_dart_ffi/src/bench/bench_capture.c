@@ -0,0 +1,62 @@
+#include "bench.h"
+#include <stdlib.h>
+#include "../include/capture_chain.h"
+
+/* Capture processing cost per 10 ms mono block at 48 kHz. */
+
+#define CAPTURE_RATE   48000
+#define CAPTURE_BLOCK  480
+#define CAPTURE_BLOCKS 500 /* 5 s per repetition */
+
+static void fill(float* block, uint32_t* seed, float gain) {
+    for (uint32_t i = 0; i < CAPTURE_BLOCK; ++i) {
+        *seed ^= *seed << 13;
+        *seed ^= *seed >> 17;
+        *seed ^= *seed << 5;
+        block[i] = gain * ((float)(*seed & 0xFFFF) / 65535.0f - 0.5f);
+    }
+}
+
+void bench_capture(void) {
+    float capture[CAPTURE_BLOCK];
+    float reference[CAPTURE_BLOCK];
+    double samples[BENCH_MAX_REPS];
+
+    EchoCanceller* ec = echo_canceller_create(CAPTURE_RATE, ECHO_CANCELLER_DEFAULT_MS);
+    if (ec) {
+        uint32_t seed = 99;
+        for (int rep = -1; rep < bench_reps(); ++rep) {
+            double elapsed = 0.0;
+            for (int i = 0; i < CAPTURE_BLOCKS; ++i) {
+                fill(reference, &seed, 0.5f);
+                for (uint32_t j = 0; j < CAPTURE_BLOCK; ++j) capture[j] = 0.3f * reference[j];
+                double const start = bench_now_us();
+                echo_canceller_process(ec, capture, reference, CAPTURE_BLOCK, 1);
+                elapsed += bench_now_us() - start;
+            }
+            if (rep >= 0) samples[rep] = elapsed / CAPTURE_BLOCKS;
+        }
+        bench_consume(capture[0]);
+        bench_report("capture", "echo_canceller_10ms", "filter_ms", ECHO_CANCELLER_DEFAULT_MS,
+                     "us", 1, samples, bench_reps());
+        echo_canceller_destroy(ec);
+    }
+
+    NoiseSuppressor* ns = noise_suppressor_create(CAPTURE_RATE, 12.0f);
+    if (ns) {
+        uint32_t seed = 7;
+        for (int rep = -1; rep < bench_reps(); ++rep) {
+            double elapsed = 0.0;
+            for (int i = 0; i < CAPTURE_BLOCKS; ++i) {
+                fill(capture, &seed, 0.01f);
+                double const start = bench_now_us();
+                noise_suppressor_process(ns, capture, CAPTURE_BLOCK, 1);
+                elapsed += bench_now_us() - start;
+            }
+            if (rep >= 0) samples[rep] = elapsed / CAPTURE_BLOCKS;
+        }
+        bench_consume(capture[0]);
+        bench_report("capture", "noise_suppressor_10ms", NULL, 0, "us", 1, samples, bench_reps());
+        noise_suppressor_destroy(ns);
+    }
+}
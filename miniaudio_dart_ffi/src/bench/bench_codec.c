@@ -0,0 +1,101 @@
+#include "bench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/crosscoder.h"
+
+/* Encode and decode cost per 20 ms frame through CrossCoder, mono 48 kHz.
+   Opus is measured at every encoder complexity; its decoder cost does not
+   depend on it much, but the packets it decodes do. */
+
+#define CODEC_RATE       48000
+#define CODEC_FRAMES     960
+#define CODEC_BENCH_COUNT 250 /* 5 s of audio per repetition */
+#define CODEC_PACKET_CAP 8192
+#define CODEC_TWO_PI     6.283185307179586
+
+typedef struct CodecBuffers {
+    float*   pcm;     /* CODEC_BENCH_COUNT frames of input */
+    uint8_t* packets; /* CODEC_BENCH_COUNT packets of CODEC_PACKET_CAP */
+    int*     sizes;
+    float    decoded[CODEC_FRAMES];
+} CodecBuffers;
+
+/* A fixed mix of tones and noise, so the encoder has something to do. */
+static void fill_signal(float* pcm, uint32_t frames) {
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < frames; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        float const noise = (float)(seed & 0xFFFF) / 65535.0f - 0.5f;
+        double const t = (double)i / CODEC_RATE;
+        pcm[i] = 0.3f * (float)sin(CODEC_TWO_PI * 440.0 * t)
+               + 0.1f * (float)sin(CODEC_TWO_PI * 3100.0 * t)
+               + 0.05f * noise;
+    }
+}
+
+/* complexity < 0: not applicable (PCM). */
+static void bench_crosscoder(const char* name, CodecID id, int complexity,
+                             CodecBuffers* b) {
+    CodecConfig config = { CODEC_RATE, 1, 32 };
+    CrossCoder* cc = crosscoder_create(&config, id, 2049 /* OPUS_APPLICATION_AUDIO */, 0);
+    if (!cc) {
+        fprintf(stderr, "%s: could not create the codec\n", name);
+        return;
+    }
+    if (complexity >= 0) crosscoder_set_complexity(cc, complexity);
+
+    double encode[BENCH_MAX_REPS];
+    double decode[BENCH_MAX_REPS];
+    float sink = 0.0f;
+    for (int rep = -1; rep < bench_reps(); ++rep) {
+        double start = bench_now_us();
+        for (int i = 0; i < CODEC_BENCH_COUNT; ++i) {
+            crosscoder_encode_push_f32(cc, b->pcm + (size_t)i * CODEC_FRAMES, CODEC_FRAMES,
+                                       b->packets + (size_t)i * CODEC_PACKET_CAP,
+                                       CODEC_PACKET_CAP, &b->sizes[i]);
+        }
+        double const encoded = bench_now_us();
+        for (int i = 0; i < CODEC_BENCH_COUNT; ++i) {
+            int const n = crosscoder_decode_packet(cc, b->packets + (size_t)i * CODEC_PACKET_CAP,
+                                                   b->sizes[i], b->decoded, CODEC_FRAMES);
+            if (n > 0) sink += b->decoded[n - 1];
+        }
+        double const decoded = bench_now_us();
+        if (rep >= 0) {
+            encode[rep] = (encoded - start) / CODEC_BENCH_COUNT;
+            decode[rep] = (decoded - encoded) / CODEC_BENCH_COUNT;
+        }
+    }
+    bench_consume(sink);
+
+    /* The report keeps the name pointers, so they are literals. */
+    int const opus = id == CODEC_ID_OPUS;
+    const char* param = complexity >= 0 ? "complexity" : NULL;
+    bench_report("codec", opus ? "opus_encode" : "pcm_encode", param, complexity,
+                 "us/frame", 1, encode, bench_reps());
+    bench_report("codec", opus ? "opus_decode" : "pcm_decode", param, complexity,
+                 "us/frame", 1, decode, bench_reps());
+    crosscoder_destroy(cc);
+}
+
+void bench_codec(void) {
+    CodecBuffers b;
+    b.pcm     = (float*)malloc((size_t)CODEC_BENCH_COUNT * CODEC_FRAMES * sizeof(float));
+    b.packets = (uint8_t*)malloc((size_t)CODEC_BENCH_COUNT * CODEC_PACKET_CAP);
+    b.sizes   = (int*)calloc(CODEC_BENCH_COUNT, sizeof(int));
+    if (b.pcm && b.packets && b.sizes) {
+        fill_signal(b.pcm, CODEC_BENCH_COUNT * CODEC_FRAMES);
+        bench_crosscoder("pcm", CODEC_ID_PCM, -1, &b);
+#ifdef HAVE_OPUS
+        for (int complexity = 0; complexity <= 10; ++complexity) {
+            bench_crosscoder("opus", CODEC_ID_OPUS, complexity, &b);
+        }
+#endif
+    }
+    free(b.pcm);
+    free(b.packets);
+    free(b.sizes);
+}
@@ -0,0 +1,84 @@
+#include "bench.h"
+#include <stdlib.h>
+#include "../include/effects.h"
+#include "../include/engine.h"
+#include "../include/sound.h"
+
+/* Cost of each built-in effect on one looping sound of an offline engine,
+   rendered in 10 ms stereo blocks, next to the same render without it. */
+
+#define EFFECTS_RATE   48000
+#define EFFECTS_BLOCK  480
+#define EFFECTS_BLOCKS 200 /* 2 s per repetition */
+
+typedef struct EffectCase {
+    const char* name;
+    int         type; /* < 0: no effect */
+} EffectCase;
+
+static const EffectCase k_cases[] = {
+    { "none",       -1 },
+    { "eq",         EFFECT_EQ },
+    { "compressor", EFFECT_COMPRESSOR },
+    { "limiter",    EFFECT_LIMITER },
+    { "reverb",     EFFECT_REVERB },
+};
+
+static void bench_effect(const EffectCase* c, Engine* engine, Sound* sound, float* out) {
+    Effect* effect = NULL;
+    if (c->type >= 0) {
+        effect = effect_alloc();
+        if (!effect || !effect_init(effect, engine, c->type)) {
+            free(effect);
+            return;
+        }
+        /* Every EQ band in use, so none is skipped. */
+        for (int b = 0; b < EFFECT_EQ_BANDS && c->type == EFFECT_EQ; ++b) {
+            effect_set_param(effect, EFFECT_PARAM_EQ(b, EFFECT_EQ_GAIN), 3.0f);
+        }
+        if (!sound_insert_effect(sound, (ma_node*)effect, -1)) {
+            effect_free(effect);
+            return;
+        }
+    }
+
+    double samples[BENCH_MAX_REPS];
+    for (int rep = -1; rep < bench_reps(); ++rep) {
+        double const start = bench_now_us();
+        for (int i = 0; i < EFFECTS_BLOCKS; ++i) engine_render(engine, out, EFFECTS_BLOCK);
+        double const elapsed = bench_now_us() - start;
+        if (rep >= 0) samples[rep] = elapsed / EFFECTS_BLOCKS;
+    }
+    bench_consume(out[0]);
+    bench_report("effects", c->name, NULL, 0, "us/10ms", 1, samples, bench_reps());
+
+    if (effect) {
+        sound_remove_effect(sound, (ma_node*)effect);
+        effect_free(effect);
+    }
+}
+
+void bench_effects(void) {
+    uint32_t const frames = EFFECTS_RATE; /* 1 s loop */
+    float* data = (float*)malloc(frames * sizeof(float));
+    float* out  = (float*)malloc(EFFECTS_BLOCK * 2 * sizeof(float));
+    Engine* engine = engine_alloc();
+    Sound* sound = sound_alloc();
+    if (data && out && engine && sound && engine_init_offline(engine, 2, EFFECTS_RATE)) {
+        for (uint32_t i = 0; i < frames; ++i) data[i] = (float)((int)(i % 97) - 48) / 96.0f;
+        if (engine_load_sound(engine, sound, data, frames * sizeof(float),
+                              ma_format_f32, EFFECTS_RATE, 1)) {
+            sound_set_looped(sound, true, 0);
+            sound_play(sound);
+            for (size_t i = 0; i < sizeof(k_cases) / sizeof(k_cases[0]); ++i) {
+                bench_effect(&k_cases[i], engine, sound, out);
+            }
+            sound_unload(sound);
+        }
+        engine_uninit(engine);
+    }
+    free(sound);
+    engine_free(engine);
+    free(data);
+    free(out);
+}
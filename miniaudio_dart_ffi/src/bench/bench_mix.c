@@ -0,0 +1,75 @@
+#include "bench.h"
+#include <stdlib.h>
+#include "../include/engine.h"
+#include "../include/sound.h"
+
+/* Mixing cost: N looping mono sounds on an offline engine, rendered in
+   10 ms stereo blocks. Reported per block and as how many times faster
+   than realtime the mix runs. */
+
+#define MIX_RATE    48000
+#define MIX_BLOCK   480
+#define MIX_SECONDS 2
+#define MIX_MAX     128
+
+static const uint32_t k_streams[] = { 1, 8, 32, 128 };
+
+static void bench_mix_streams(uint32_t count, float* data, uint32_t frames, float* out) {
+    Engine* engine = engine_alloc();
+    Sound* sounds[MIX_MAX] = { 0 };
+    uint32_t loaded = 0;
+    if (!engine || !engine_init_offline(engine, 2, MIX_RATE)) {
+        engine_free(engine);
+        return;
+    }
+    for (; loaded < count; ++loaded) {
+        sounds[loaded] = sound_alloc();
+        if (!sounds[loaded] ||
+            !engine_load_sound(engine, sounds[loaded], data, frames * sizeof(float),
+                               ma_format_f32, MIX_RATE, 1)) {
+            free(sounds[loaded]);
+            break;
+        }
+        sound_set_looped(sounds[loaded], true, 0);
+        sound_play(sounds[loaded]);
+    }
+
+    if (loaded == count) {
+        uint32_t const blocks = MIX_SECONDS * MIX_RATE / MIX_BLOCK;
+        double perBlock[BENCH_MAX_REPS];
+        double realtime[BENCH_MAX_REPS];
+        for (int rep = -1; rep < bench_reps(); ++rep) {
+            double const start = bench_now_us();
+            for (uint32_t i = 0; i < blocks; ++i) engine_render(engine, out, MIX_BLOCK);
+            double const elapsed = bench_now_us() - start;
+            if (rep >= 0) {
+                perBlock[rep] = elapsed / blocks;
+                realtime[rep] = MIX_SECONDS * 1e6 / elapsed;
+            }
+        }
+        bench_consume(out[0]);
+        bench_report("mix", "render_10ms", "streams", count, "us", 1, perBlock, bench_reps());
+        bench_report("mix", "realtime_factor", "streams", count, "x", 0, realtime, bench_reps());
+    }
+
+    for (uint32_t i = 0; i < loaded; ++i) {
+        sound_unload(sounds[i]);
+        free(sounds[i]);
+    }
+    engine_uninit(engine);
+    engine_free(engine);
+}
+
+void bench_mix(void) {
+    uint32_t const frames = MIX_RATE; /* 1 s loop */
+    float* data = (float*)malloc(frames * sizeof(float));
+    float* out  = (float*)malloc(MIX_BLOCK * 2 * sizeof(float));
+    if (data && out) {
+        for (uint32_t i = 0; i < frames; ++i) data[i] = (float)((int)(i % 97) - 48) / 4800.0f;
+        for (size_t i = 0; i < sizeof(k_streams) / sizeof(k_streams[0]); ++i) {
+            bench_mix_streams(k_streams[i], data, frames, out);
+        }
+    }
+    free(data);
+    free(out);
+}
@@ -0,0 +1,106 @@
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+#include "../include/circular_buffer.h"
+#include "../include/codec_packet_queue.h"
+#include "../external/miniaudio/include/miniaudio.h"
+
+/* Ring throughput: one thread writing a chunk and reading it back, so the
+   numbers are the copy and bookkeeping cost without any contention. */
+
+#define RING_FLOATS (1 << 16)
+#define RING_BYTES_PER_REP (64u << 20)
+
+static const uint32_t k_chunks[] = { 64, 256, 1024, 4096 };
+static const uint16_t k_packets[] = { 60, 160, 1275 };
+
+static void bench_circular_buffer(uint32_t chunk, float* src, float* dst) {
+    CircularBuffer cb;
+    if (circular_buffer_init(&cb, RING_FLOATS * sizeof(float)) != 0) return; /* 0 = ok */
+    size_t const rounds = RING_BYTES_PER_REP / (chunk * sizeof(float));
+    double samples[BENCH_MAX_REPS];
+    for (int rep = -1; rep < bench_reps(); ++rep) {
+        double const start = bench_now_us();
+        for (size_t i = 0; i < rounds; ++i) {
+            circular_buffer_write(&cb, src, chunk);
+            circular_buffer_read(&cb, dst, chunk);
+        }
+        double const elapsed = bench_now_us() - start;
+        if (rep >= 0) samples[rep] = RING_BYTES_PER_REP / elapsed; /* bytes/us = MB/s */
+    }
+    bench_consume(dst[chunk - 1]);
+    bench_report("ring", "circular_buffer", "chunk", chunk, "MB/s", 0, samples, bench_reps());
+    circular_buffer_uninit(&cb);
+}
+
+static void bench_pcm_rb(uint32_t chunk) {
+    ma_pcm_rb rb;
+    if (ma_pcm_rb_init(ma_format_f32, 1, RING_FLOATS, NULL, NULL, &rb) != MA_SUCCESS) return;
+    size_t const rounds = RING_BYTES_PER_REP / (chunk * sizeof(float));
+    float sink = 0.0f;
+    double samples[BENCH_MAX_REPS];
+    for (int rep = -1; rep < bench_reps(); ++rep) {
+        double const start = bench_now_us();
+        for (size_t i = 0; i < rounds; ++i) {
+            /* chunk divides the ring, so a region never wraps. */
+            ma_uint32 n = chunk;
+            void* region = NULL;
+            ma_pcm_rb_acquire_write(&rb, &n, &region);
+            memset(region, 0, n * sizeof(float));
+            ma_pcm_rb_commit_write(&rb, n);
+            n = chunk;
+            ma_pcm_rb_acquire_read(&rb, &n, &region);
+            sink += ((const float*)region)[n - 1];
+            ma_pcm_rb_commit_read(&rb, n);
+        }
+        double const elapsed = bench_now_us() - start;
+        if (rep >= 0) samples[rep] = RING_BYTES_PER_REP / elapsed;
+    }
+    bench_consume(sink);
+    bench_report("ring", "pcm_rb", "chunk", chunk, "MB/s", 0, samples, bench_reps());
+    ma_pcm_rb_uninit(&rb);
+}
+
+static void bench_packet_queue(uint16_t bytes) {
+    CodecPacketQueue q = { 0 };
+    if (!codec_packet_queue_init(&q, 64)) return;
+    uint8_t packet[CODEC_MAX_PACKET_BYTES] = { 1 };
+    uint8_t out[CODEC_MAX_PACKET_BYTES];
+    uint32_t const rounds = 200000;
+    int sink = 0;
+    double samples[BENCH_MAX_REPS];
+    for (int rep = -1; rep < bench_reps(); ++rep) {
+        double const start = bench_now_us();
+        for (uint32_t i = 0; i < rounds; ++i) {
+            codec_packet_queue_push(&q, packet, bytes);
+            sink += codec_packet_queue_pop(&q, out, sizeof(out));
+        }
+        double const elapsed = bench_now_us() - start;
+        if (rep >= 0) samples[rep] = rounds / elapsed; /* packets/us = Mpackets/s */
+    }
+    bench_consume((float)sink);
+    bench_report("ring", "codec_packet_queue", "bytes", bytes, "Mpkt/s", 0, samples, bench_reps());
+    codec_packet_queue_uninit(&q);
+}
+
+void bench_ring(void) {
+    float* src = (float*)calloc(4096, sizeof(float));
+    float* dst = (float*)calloc(4096, sizeof(float));
+    if (!src || !dst) {
+        free(src);
+        free(dst);
+        return;
+    }
+    for (uint32_t i = 0; i < 4096; ++i) src[i] = (float)i;
+    for (size_t i = 0; i < sizeof(k_chunks) / sizeof(k_chunks[0]); ++i) {
+        bench_circular_buffer(k_chunks[i], src, dst);
+    }
+    for (size_t i = 0; i < sizeof(k_chunks) / sizeof(k_chunks[0]); ++i) {
+        bench_pcm_rb(k_chunks[i]);
+    }
+    for (size_t i = 0; i < sizeof(k_packets) / sizeof(k_packets[0]); ++i) {
+        bench_packet_queue(k_packets[i]);
+    }
+    free(src);
+    free(dst);
+}
@@ -0,0 +1,120 @@
+#include "bench.h"
+#include <stdlib.h>
+#include "../include/engine.h"
+#include "../include/stream_player.h"
+
+/* StreamPlayer on an offline engine, whose clock only moves when it
+   renders: push-to-read latency is counted in frames of that clock and
+   comes out the same on every machine, while the write and render costs
+   are wall time. */
+
+#define STREAM_RATE    48000
+#define STREAM_BLOCK   480 /* 10 ms, a typical device period */
+#define STREAM_MARKER  0.5f
+#define STREAM_FILL    0.001f
+
+static const uint32_t k_queued[] = { 0, 480, 2400, 4800 };
+
+typedef struct StreamBench {
+    Engine*       engine;
+    StreamPlayer* player;
+    float         out[STREAM_BLOCK * 2];
+    float         in[STREAM_BLOCK];
+} StreamBench;
+
+static int stream_bench_init(StreamBench* s) {
+    s->engine = engine_alloc();
+    s->player = stream_player_alloc();
+    if (!s->engine || !s->player) return 0;
+    if (!engine_init_offline(s->engine, 2, STREAM_RATE)) return 0;
+    StreamPlayerConfig config = stream_player_config_default(1, STREAM_RATE);
+    if (stream_player_init_with_engine(s->player, s->engine, &config) != 1) return 0;
+    return stream_player_start(s->player) == 1;
+}
+
+static void stream_bench_uninit(StreamBench* s) {
+    if (s->player) {
+        stream_player_stop(s->player);
+        stream_player_uninit(s->player);
+        stream_player_free(s->player);
+    }
+    if (s->engine) {
+        engine_uninit(s->engine);
+        engine_free(s->engine);
+    }
+}
+
+/* Frames from writing a marker behind `queued` frames of quiet audio to
+   the marker coming out of the engine, or -1 if it never does. */
+static int64_t push_to_read(StreamBench* s, uint32_t queued) {
+    stream_player_clear(s->player);
+    for (uint32_t i = 0; i < STREAM_BLOCK; ++i) s->in[i] = STREAM_FILL;
+    for (uint32_t left = queued; left > 0;) {
+        uint32_t const n = left < STREAM_BLOCK ? left : STREAM_BLOCK;
+        stream_player_write_frames_f32(s->player, s->in, n);
+        left -= n;
+    }
+    s->in[0] = STREAM_MARKER;
+    stream_player_write_frames_f32(s->player, s->in, 1);
+
+    int64_t const written = (int64_t)engine_get_time_in_pcm_frames(s->engine);
+    for (int block = 0; block < 100; ++block) {
+        int64_t const at = (int64_t)engine_get_time_in_pcm_frames(s->engine);
+        engine_render(s->engine, s->out, STREAM_BLOCK);
+        for (uint32_t i = 0; i < STREAM_BLOCK; ++i) {
+            if (s->out[i * 2] > STREAM_MARKER / 2) return at + i - written;
+        }
+    }
+    return -1;
+}
+
+void bench_stream(void) {
+    StreamBench s = { 0 };
+    if (!stream_bench_init(&s)) {
+        stream_bench_uninit(&s);
+        return;
+    }
+    engine_render(s.engine, s.out, STREAM_BLOCK);
+
+    for (size_t q = 0; q < sizeof(k_queued) / sizeof(k_queued[0]); ++q) {
+        double samples[BENCH_MAX_REPS];
+        int ok = 1;
+        for (int rep = 0; rep < bench_reps(); ++rep) {
+            int64_t const latency = push_to_read(&s, k_queued[q]);
+            ok &= latency >= 0;
+            samples[rep] = (double)latency;
+        }
+        if (ok) {
+            bench_report("stream", "push_to_read", "queued", k_queued[q], "frames", 1,
+                         samples, bench_reps());
+        }
+    }
+
+    /* Steady state: one 10 ms write and one 10 ms render per round. */
+    uint32_t const rounds = 1000;
+    double write[BENCH_MAX_REPS];
+    double render[BENCH_MAX_REPS];
+    for (uint32_t i = 0; i < STREAM_BLOCK; ++i) s.in[i] = 0.25f;
+    stream_player_clear(s.player);
+    for (int rep = -1; rep < bench_reps(); ++rep) {
+        double writing = 0.0, rendering = 0.0;
+        for (uint32_t i = 0; i < rounds; ++i) {
+            double const start = bench_now_us();
+            stream_player_write_frames_f32(s.player, s.in, STREAM_BLOCK);
+            double const written = bench_now_us();
+            engine_render(s.engine, s.out, STREAM_BLOCK);
+            double const rendered = bench_now_us();
+            writing += written - start;
+            rendering += rendered - written;
+        }
+        if (rep >= 0) {
+            write[rep]  = writing / rounds;
+            render[rep] = rendering / rounds;
+        }
+    }
+    bench_consume(s.out[0]);
+    bench_report("stream", "write_10ms", NULL, 0, "us", 1, write, bench_reps());
+    bench_report("stream", "render_10ms", NULL, 0, "us", 1, render, bench_reps());
+
+    stream_bench_uninit(&s);
+}
@@ -0,0 +1,77 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Immutable, reference-counted sound data shared by any number of Sounds.
+
+   Assets are keyed either by a user string or, when no key is given, by a
+   hash of their bytes and layout (format, channels, rate; verified on
+   lookup). The cache holds one reference
+   per entry and every Sound built from an asset holds another, so memory
+   scales with unique assets rather than with instances. Evicting an entry
+   only drops the cache's reference; Sounds still playing it keep it alive.
+
+   The cache is guarded by a mutex and is never touched by the audio thread. */
+
+#define ASSET_CACHE_BUCKETS 64
+
+typedef struct SoundAsset SoundAsset;
+struct SoundAsset {
+    volatile uint32_t refCount;
+    uint64_t    hash;
+    char*       key;        /* NULL for content-addressed assets */
+    void*       data;
+    size_t      size;
+    ma_format   format;     /* ma_format_unknown for encoded data */
+    int         channels;
+    int         sampleRate;
+    SoundAsset* next;       /* bucket chain */
+};
+
+typedef struct AssetCache {
+    ma_mutex    lock;
+    SoundAsset* buckets[ASSET_CACHE_BUCKETS];
+    uint32_t    count;
+    uint64_t    bytes;
+} AssetCache;
+
+int  asset_cache_init(AssetCache* cache);
+void asset_cache_uninit(AssetCache* cache);
+
+uint64_t asset_cache_hash(const void* data, size_t size);
+
+/* Find-or-insert. Returns a new reference, or NULL when the asset is not
+   cached and data is NULL (lookup only) or allocation fails. */
+SoundAsset* asset_cache_acquire(AssetCache* cache,
+                                const char* key,
+                                const void* data,
+                                size_t size,
+                                ma_format format,
+                                int channels,
+                                int sampleRate);
+
+int      asset_cache_contains(AssetCache* cache, const char* key);
+int      asset_cache_evict(AssetCache* cache, const char* key);
+/* Drop every entry no Sound references; returns bytes released. */
+uint64_t asset_cache_trim(AssetCache* cache);
+
+void sound_asset_retain(SoundAsset* asset);
+void sound_asset_release(SoundAsset* asset);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ASSET_CACHE_H */
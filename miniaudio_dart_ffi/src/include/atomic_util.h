@@ -0,0 +1,93 @@
+#ifndef ATOMIC_UTIL_H
+#define ATOMIC_UTIL_H
+
+/* Minimal lock-free helpers for state shared between the audio callback and
+   API threads. miniaudio keeps its own atomics private to miniaudio.c, so we
+   wrap the compiler builtins here (GCC/Clang/Emscripten and MSVC). All
+   operations are sequentially consistent. */
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define AU_INLINE static __inline
+
+AU_INLINE uint32_t au_load_u32(volatile uint32_t* p) {
+    return (uint32_t)_InterlockedOr((volatile long*)p, 0);
+}
+AU_INLINE void au_store_u32(volatile uint32_t* p, uint32_t v) {
+    _InterlockedExchange((volatile long*)p, (long)v);
+}
+AU_INLINE uint32_t au_exchange_u32(volatile uint32_t* p, uint32_t v) {
+    return (uint32_t)_InterlockedExchange((volatile long*)p, (long)v);
+}
+AU_INLINE uint32_t au_fetch_add_u32(volatile uint32_t* p, uint32_t v) {
+    return (uint32_t)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+}
+AU_INLINE int au_cas_u32(volatile uint32_t* p, uint32_t expected, uint32_t desired) {
+    return (uint32_t)_InterlockedCompareExchange((volatile long*)p, (long)desired, (long)expected) == expected;
+}
+AU_INLINE uint64_t au_load_u64(volatile uint64_t* p) {
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)p, 0, 0);
+}
+AU_INLINE int au_cas_u64(volatile uint64_t* p, uint64_t expected, uint64_t desired) {
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)expected) == expected;
+}
+AU_INLINE void au_store_u64(volatile uint64_t* p, uint64_t v) {
+    uint64_t cur = au_load_u64(p);
+    while (!au_cas_u64(p, cur, v)) cur = au_load_u64(p);
+}
+AU_INLINE uint64_t au_fetch_add_u64(volatile uint64_t* p, uint64_t v) {
+    uint64_t cur = au_load_u64(p);
+    while (!au_cas_u64(p, cur, cur + v)) cur = au_load_u64(p);
+    return cur;
+}
+AU_INLINE uint64_t au_exchange_u64(volatile uint64_t* p, uint64_t v) {
+    uint64_t cur = au_load_u64(p);
+    while (!au_cas_u64(p, cur, v)) cur = au_load_u64(p);
+    return cur;
+}
+AU_INLINE void au_fence(void) {
+    volatile long barrier = 0;
+    _InterlockedOr(&barrier, 0); /* full barrier on every target */
+}
+#else
+#define AU_INLINE static inline
+AU_INLINE uint32_t au_load_u32(volatile uint32_t* p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+AU_INLINE void     au_store_u32(volatile uint32_t* p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+AU_INLINE uint32_t au_exchange_u32(volatile uint32_t* p, uint32_t v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+AU_INLINE uint32_t au_fetch_add_u32(volatile uint32_t* p, uint32_t v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+AU_INLINE int au_cas_u32(volatile uint32_t* p, uint32_t expected, uint32_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+AU_INLINE uint64_t au_load_u64(volatile uint64_t* p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+AU_INLINE void     au_store_u64(volatile uint64_t* p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_SEQ_CST); }
+AU_INLINE uint64_t au_fetch_add_u64(volatile uint64_t* p, uint64_t v) { return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+AU_INLINE uint64_t au_exchange_u64(volatile uint64_t* p, uint64_t v) { return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+AU_INLINE int au_cas_u64(volatile uint64_t* p, uint64_t expected, uint64_t desired) {
+    return __atomic_compare_exchange_n(p, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+AU_INLINE void au_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+#endif
+
+/* Floats are stored as their bit pattern in a uint32_t slot. */
+AU_INLINE float au_load_f32(volatile uint32_t* p) {
+    uint32_t bits = au_load_u32(p);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+AU_INLINE void au_store_f32(volatile uint32_t* p, float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    au_store_u32(p, bits);
+}
+
+/* Raise *p to v if v is larger (peak tracking). */
+AU_INLINE void au_max_u32(volatile uint32_t* p, uint32_t v) {
+    uint32_t cur = au_load_u32(p);
+    while (v > cur && !au_cas_u32(p, cur, v)) cur = au_load_u32(p);
+}
+
+#endif /* ATOMIC_UTIL_H */
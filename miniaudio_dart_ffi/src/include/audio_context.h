@@ -0,0 +1,65 @@
+#ifndef AUDIO_CONTEXT_H
+#define AUDIO_CONTEXT_H
+
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One ma_context for the whole process.
+
+   Engines, recorders and generators acquire it instead of initializing a
+   backend each, so PulseAudio/ALSA/JACK (or CoreAudio, WASAPI, ...) is
+   connected to once and its threads are shared. The context lives while at
+   least one component holds a reference.
+
+   Devices are enumerated into a single cache the first time anyone asks
+   and again only on an explicit refresh, which every holder then sees.
+   Entries are copied out under a spinlock that is only ever held for the
+   copy, so a refresh on one thread never leaves another reading a freed
+   list, and reading the cache never waits on a backend being initialized
+   or enumerated (those run under a mutex of their own). */
+
+typedef struct AudioDeviceInfo {
+    char         name[256];
+    ma_device_id id;
+    ma_bool32    isDefault;
+} AudioDeviceInfo;
+
+/* NULL when no backend could be initialized. Pair with a release. */
+ma_context* audio_context_acquire(void);
+void        audio_context_release(void);
+
+/* Try these backends first, then the rest in miniaudio's order. Applies
+   when the context is next created: returns 0 if one is already live, in
+   which case its backend stays. */
+int         audio_context_prefer_backends(const ma_backend* backends, uint32_t count);
+
+/* Use only a custom backend (miniaudio's ma_backend_custom) with these
+   callbacks; NULL goes back to the platform backends. Same rules as
+   audio_context_prefer_backends. This is how the native tests run every
+   component against virtual devices. Needs MA_ENABLE_CUSTOM. */
+int         audio_context_use_custom_backend(const ma_backend_callbacks* callbacks, void* user_data);
+
+/* Enumerate unless the cache is already filled. Needs a reference. */
+int      audio_context_ensure_devices(void);
+/* Re-enumerate now; bumps the generation. Needs a reference. */
+int      audio_context_refresh_devices(void);
+uint32_t audio_context_get_generation(void);
+
+/* type is ma_device_type_playback or ma_device_type_capture. */
+uint32_t audio_context_get_device_count(ma_device_type type);
+int      audio_context_get_device(ma_device_type type, uint32_t index, AudioDeviceInfo* out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* AUDIO_CONTEXT_H */
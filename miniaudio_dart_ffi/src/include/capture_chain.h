@@ -0,0 +1,125 @@
+#ifndef CAPTURE_CHAIN_H
+#define CAPTURE_CHAIN_H
+
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+#include "export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Processing applied to captured audio before it is buffered or encoded.
+
+   A chain is an ordered list of in-place stages over interleaved f32
+   frames. Stages run on the capture thread, so they must not block or
+   allocate. Lower order runs first; the built-in stages use
+   CAPTURE_ORDER_ECHO and CAPTURE_ORDER_NOISE so echo is removed before the
+   noise floor is estimated, and other stages default to after both.
+
+   Stages are added and removed on a control thread under a spinlock the
+   capture thread only try-locks: a block captured while the chain is being
+   edited passes through unprocessed. Once a remove returns, the stage is
+   no longer running and its user data can be freed.
+
+   The echo canceller and noise suppressor also work on plain buffers, so
+   they can be run offline, e.g. over WAV fixtures. */
+
+#define CAPTURE_CHAIN_MAX_STAGES 8
+#define CAPTURE_ORDER_ECHO       0
+#define CAPTURE_ORDER_NOISE      100
+#define CAPTURE_ORDER_DEFAULT    200
+
+typedef void (*CaptureProcessFn)(void* user_data,
+                                 float* frames,
+                                 uint32_t frame_count,
+                                 uint32_t channels);
+
+typedef struct CaptureStage {
+    CaptureProcessFn fn;
+    void*            user_data;
+    uint32_t         id;
+    int              order;
+} CaptureStage;
+
+typedef struct CaptureChain {
+    CaptureStage      stages[CAPTURE_CHAIN_MAX_STAGES];
+    uint32_t          count;
+    uint32_t          nextId;
+    volatile uint32_t lock;
+} CaptureChain;
+
+void     capture_chain_init(CaptureChain* chain);
+/* Returns the stage id, or 0 when the chain is full. */
+uint32_t capture_chain_add(CaptureChain* chain, int order, CaptureProcessFn fn, void* user_data);
+int      capture_chain_remove(CaptureChain* chain, uint32_t id);
+uint32_t capture_chain_count(CaptureChain* chain);
+/* Capture thread. */
+void     capture_chain_process(CaptureChain* chain, float* frames, uint32_t frame_count, uint32_t channels);
+
+/* Acoustic echo canceller: an NLMS filter of filter_ms (rounded up to
+   whole 128-tap partitions) that models the path from a far-end reference
+   (what was played) to the capture, and subtracts its estimate from every
+   capture channel. It runs as a partitioned-block frequency-domain filter,
+   adapting once per 128 frames, without delaying the capture. Frames where
+   the near end is clearly louder than the reference (double talk) are left
+   out of the adaptation.
+
+   The reference is either passed along with each block, or pushed from
+   the playback side (engine_set_echo_reference) into a queue that
+   echo_canceller_process_queued drains. Pushed audio is downmixed and
+   resampled to the canceller's rate. */
+
+#define ECHO_CANCELLER_DEFAULT_MS 64
+
+typedef struct EchoCanceller EchoCanceller;
+
+EXPORT EchoCanceller* echo_canceller_create(uint32_t sample_rate, uint32_t filter_ms);
+EXPORT void           echo_canceller_destroy(EchoCanceller* ec);
+/* reference: mono, frame_count frames; NULL counts as silence. */
+EXPORT void           echo_canceller_process(EchoCanceller* ec,
+                                             float* capture,
+                                             const float* reference,
+                                             uint32_t frame_count,
+                                             uint32_t channels);
+/* Rate of the audio echo_canceller_push_reference receives. Not on the
+   playback thread: it may allocate. */
+int                   echo_canceller_set_reference_rate(EchoCanceller* ec, uint32_t sample_rate);
+void                  echo_canceller_push_reference(EchoCanceller* ec,
+                                                    const float* frames,
+                                                    uint32_t frame_count,
+                                                    uint32_t channels);
+/* A CaptureProcessFn; user_data is the EchoCanceller. */
+void                  echo_canceller_process_queued(void* ec,
+                                                    float* capture,
+                                                    uint32_t frame_count,
+                                                    uint32_t channels);
+/* Echo return loss enhancement in dB, smoothed. */
+EXPORT float          echo_canceller_get_erle(EchoCanceller* ec);
+
+/* Noise suppressor: tracks the noise floor from the quietest recent 10 ms
+   blocks and attenuates blocks near it by up to reduction_db, with a fast
+   attack and a slower release so speech onsets are kept. Broadband: the
+   gain is the same at every frequency. */
+
+typedef struct NoiseSuppressor NoiseSuppressor;
+
+EXPORT NoiseSuppressor* noise_suppressor_create(uint32_t sample_rate, float reduction_db);
+EXPORT void             noise_suppressor_destroy(NoiseSuppressor* ns);
+EXPORT void             noise_suppressor_set_reduction(NoiseSuppressor* ns, float reduction_db);
+/* Also a CaptureProcessFn; user_data is the NoiseSuppressor. */
+EXPORT void             noise_suppressor_process(void* ns,
+                                                 float* frames,
+                                                 uint32_t frame_count,
+                                                 uint32_t channels);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAPTURE_CHAIN_H */
@@ -1,8 +1,12 @@
 #ifndef CODEC_OPUS_DIAG_H
 #define CODEC_OPUS_DIAG_H
+struct Codec;
 #ifdef HAVE_OPUS
 const char* codec_opus_last_error(void);
+/* Applies an encoder complexity (0-10) to a live Opus codec. */
+int codec_opus_set_complexity(struct Codec* c, int complexity);
 #else
 static inline const char* codec_opus_last_error(void){ return "opus disabled"; }
+static inline int codec_opus_set_complexity(struct Codec* c, int complexity){ (void)c; (void)complexity; return 0; }
 #endif
 #endif
\ No newline at end of file
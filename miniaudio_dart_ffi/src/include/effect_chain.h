@@ -0,0 +1,54 @@
+#ifndef EFFECT_CHAIN_H
+#define EFFECT_CHAIN_H
+
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Effects between an owner's output and where it plays.
+
+   The chain keeps the links, not the effects: effects[0] -> ... -> target,
+   output bus 0 into input bus 0 all the way. The owner feeds whatever
+   effect_chain_input returns, the first effect or the target itself when
+   the chain is empty, and is told through route whenever that changes, so
+   a removed effect is only cut loose once nothing reaches it any more.
+   Effects are ma_nodes with one input and one output at the engine's
+   channel count; a node belongs to one chain at a time.
+
+   Control thread only. miniaudio's attach is safe against the audio
+   thread, which at worst renders one block with an effect bypassed. */
+
+#define EFFECT_CHAIN_MAX 8
+
+typedef void (*EffectChainRoute)(void* owner, ma_node* input);
+
+typedef struct EffectChain {
+    ma_node*         target;
+    ma_node*         effects[EFFECT_CHAIN_MAX];
+    uint32_t         count;
+    EffectChainRoute route;
+    void*            owner;
+} EffectChain;
+
+void     effect_chain_init(EffectChain* chain, ma_node* target, EffectChainRoute route, void* owner);
+ma_node* effect_chain_input(const EffectChain* chain);
+/* index < 0 or past the end appends. Returns 0 when the chain is full,
+   already holds the effect, or the effect is in another graph. */
+int      effect_chain_insert(EffectChain* chain, ma_node* effect, int index);
+int      effect_chain_remove(EffectChain* chain, ma_node* effect);
+void     effect_chain_clear(EffectChain* chain);
+void     effect_chain_set_target(EffectChain* chain, ma_node* target);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EFFECT_CHAIN_H */
@@ -0,0 +1,122 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+#include "engine.h"
+#include "export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Built-in effects, each an ma_node with one input and one output at the
+   engine's channel count, for the effect chains of sounds, stream players,
+   playlists and buses (effect_chain.h). An Effect* can be passed wherever
+   an ma_node* is expected.
+
+   EFFECT_EQ       EFFECT_EQ_BANDS ma_biquad bands in series (RBJ cookbook).
+   EFFECT_COMPRESSOR
+                   Feed-forward peak compressor with a soft knee, attack and
+                   release in the dB domain and optional lookahead.
+   EFFECT_LIMITER  Lookahead brickwall limiter: the gain reaches its target
+                   by the time a peak leaves the delay, so the output stays
+                   under the ceiling.
+   EFFECT_REVERB   8-line feedback delay network with a Hadamard mix,
+                   per-line damping and a pre-delay.
+
+   Parameters are set from any thread and picked up by the audio thread at
+   the next EFFECT_BLOCK frames, where levels, frequencies and the wet/dry
+   mix glide to their new value over about EFFECT_SMOOTH_MS instead of
+   jumping. Band types, lookahead and pre-delay switch at once, so change
+   those before playing. Buffers are allocated in effect_init; processing never
+   allocates.
+
+   An effect belongs to one chain at a time and must be removed from it
+   before effect_uninit. */
+
+#define EFFECT_BLOCK            32
+#define EFFECT_SMOOTH_MS        20
+#define EFFECT_EQ_BANDS         4
+#define EFFECT_MAX_LOOKAHEAD_MS 20
+#define EFFECT_MAX_PREDELAY_MS  200
+
+typedef enum EffectType {
+    EFFECT_EQ = 0,
+    EFFECT_COMPRESSOR,
+    EFFECT_LIMITER,
+    EFFECT_REVERB,
+} EffectType;
+
+typedef enum EffectEqBandType {
+    EFFECT_EQ_OFF = 0,
+    EFFECT_EQ_PEAK,
+    EFFECT_EQ_LOW_SHELF,
+    EFFECT_EQ_HIGH_SHELF,
+    EFFECT_EQ_LOW_PASS,
+    EFFECT_EQ_HIGH_PASS,
+} EffectEqBandType;
+
+/* Fields of one EQ band; band b's are at EFFECT_PARAM_EQ(b, field). */
+typedef enum EffectEqField {
+    EFFECT_EQ_TYPE = 0,      /* EffectEqBandType */
+    EFFECT_EQ_FREQUENCY,     /* Hz */
+    EFFECT_EQ_GAIN,          /* dB, peak and shelves */
+    EFFECT_EQ_Q,
+    EFFECT_EQ_FIELDS,
+} EffectEqField;
+
+#define EFFECT_PARAM_EQ(band, field) (EFFECT_PARAM_EQ_FIRST + (band) * EFFECT_EQ_FIELDS + (field))
+
+typedef enum EffectParam {
+    EFFECT_PARAM_MIX = 0,        /* 0 dry .. 1 wet, all types */
+    EFFECT_PARAM_EQ_FIRST = 1,   /* EFFECT_PARAM_EQ(band, field) */
+    /* Compressor */
+    EFFECT_PARAM_THRESHOLD = 20, /* dB */
+    EFFECT_PARAM_RATIO,
+    EFFECT_PARAM_KNEE,           /* dB */
+    EFFECT_PARAM_ATTACK,         /* ms */
+    EFFECT_PARAM_RELEASE,        /* ms, limiter too */
+    EFFECT_PARAM_MAKEUP,         /* dB */
+    EFFECT_PARAM_LOOKAHEAD,      /* ms, limiter too */
+    EFFECT_PARAM_CEILING,        /* dB, limiter */
+    /* Reverb */
+    EFFECT_PARAM_DECAY = 32,     /* RT60, s */
+    EFFECT_PARAM_DAMPING,        /* 0 bright .. 1 dark */
+    EFFECT_PARAM_PREDELAY,       /* ms */
+    EFFECT_PARAM_WIDTH,          /* 0 mono .. 1 full stereo */
+    EFFECT_PARAM_COUNT = 40,
+} EffectParam;
+
+typedef struct Effect Effect;
+
+EXPORT Effect* effect_alloc(void);
+EXPORT void    effect_free(Effect* self);
+
+/* type is an EffectType. Sized for the engine's channels and sample rate. */
+EXPORT int  effect_init(Effect* self, Engine* engine, int type);
+EXPORT void effect_uninit(Effect* self);
+
+EXPORT int   effect_get_type(Effect* self);
+/* Values are clamped to the parameter's range. Returns 0 for a parameter
+   the effect does not have. */
+EXPORT int   effect_set_param(Effect* self, int param, float value);
+/* The last value set, or the default. */
+EXPORT float effect_get_param(Effect* self, int param);
+/* Deepest gain reduction of the last processed block, in dB (<= 0), for
+   the compressor and limiter; 0 otherwise. */
+EXPORT float effect_get_reduction_db(Effect* self);
+/* Drops the filter, envelope and reverb state at the next block, e.g.
+   before reusing the effect on other material. */
+EXPORT void  effect_reset(Effect* self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EFFECTS_H */
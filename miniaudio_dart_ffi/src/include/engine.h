@@ -6,6 +6,8 @@
 #include "../external/miniaudio/include/miniaudio.h"
 #include "export.h"
 #include "sound.h"
+#include "sound_loader.h"
+#include "capture_chain.h"
 
 typedef struct Engine Engine;
 
@@ -23,6 +25,16 @@ EXPORT ma_uint32 engine_get_playback_device_generation(Engine* self);
 EXPORT Engine*  engine_alloc(void);
 EXPORT void     engine_free(Engine* self);
 EXPORT int      engine_init(Engine* self, uint32_t period_ms);
+// Offline: no device or backend at all (0 = 2 channels, 48000 Hz). The
+// mix advances only when pulled with engine_render or written out with
+// engine_render_to_file (32-bit float WAV), as fast as the CPU allows,
+// and the same input renders the same output. Everything else works as
+// with a device; decoded sounds are best, as streamed ones may not keep
+// up with faster-than-realtime pulls.
+#define ENGINE_RENDER_BLOCK 1024
+EXPORT int      engine_init_offline(Engine* self, uint32_t channels, uint32_t sample_rate);
+EXPORT uint64_t engine_render(Engine* self, float* out, uint64_t frames);
+EXPORT int      engine_render_to_file(Engine* self, const char* path, uint64_t frames);
 EXPORT void     engine_uninit(Engine* self);
 EXPORT int      engine_start(Engine* self);
 EXPORT int      engine_load_sound(Engine* self,
@@ -32,6 +44,105 @@ EXPORT int      engine_load_sound(Engine* self,
                                   ma_format format,
                                   int sample_rate,
                                   int channels);
+// As engine_load_sound, with SoundLoadFlags (e.g. SOUND_LOAD_DECODE).
+EXPORT int      engine_load_sound_ex(Engine* self,
+                                     struct Sound* sound,
+                                     float* data,
+                                     size_t data_size,
+                                     ma_format format,
+                                     int sample_rate,
+                                     int channels,
+                                     uint32_t flags);
+// As engine_load_sound_ex without the copy. _adopt takes ownership of data
+// and releases it with free_fn (free() when NULL, for sound_data_alloc
+// buffers); _external borrows memory the caller keeps and calls
+// release(data, user_data) once the sound is done with it. Either way the
+// buffer is released on failure too, so the caller never frees it.
+EXPORT int      engine_load_sound_adopt(Engine* self,
+                                        struct Sound* sound,
+                                        void* data,
+                                        size_t data_size,
+                                        ma_format format,
+                                        int sample_rate,
+                                        int channels,
+                                        uint32_t flags,
+                                        void (*free_fn)(void* data));
+EXPORT int      engine_load_sound_external(Engine* self,
+                                           struct Sound* sound,
+                                           const void* data,
+                                           size_t data_size,
+                                           ma_format format,
+                                           int sample_rate,
+                                           int channels,
+                                           uint32_t flags,
+                                           SoundDataRelease release,
+                                           void* user_data);
+// Load from a UTF-8 file path without copying it into memory: streamed by
+// default, SOUND_LOAD_MMAP to decode from a mapping, or SOUND_LOAD_DECODE.
+EXPORT int      engine_load_sound_file(Engine* self,
+                                       struct Sound* sound,
+                                       const char* path,
+                                       uint32_t flags);
+
+// Background loading on the resource manager's job threads. Each call copies
+// its input and returns at once; the sound's state is polled with
+// sound_get_load_state and/or reported through the load callback, which runs
+// on a job thread. The thread count (default 1) is fixed at engine_init.
+EXPORT int      engine_set_job_threads(Engine* self, uint32_t count);
+EXPORT void     engine_set_load_callback(Engine* self,
+                                         SoundLoadCallback callback,
+                                         void* user_data);
+EXPORT int      engine_load_sound_async(Engine* self,
+                                        struct Sound* sound,
+                                        float* data,
+                                        size_t data_size,
+                                        ma_format format,
+                                        int sample_rate,
+                                        int channels,
+                                        uint32_t flags);
+// engine_load_sound_async taking ownership of data, as engine_load_sound_adopt.
+EXPORT int      engine_load_sound_adopt_async(Engine* self,
+                                              struct Sound* sound,
+                                              void* data,
+                                              size_t data_size,
+                                              ma_format format,
+                                              int sample_rate,
+                                              int channels,
+                                              uint32_t flags,
+                                              void (*free_fn)(void* data));
+EXPORT int      engine_load_sound_file_async(Engine* self,
+                                             struct Sound* sound,
+                                             const char* path,
+                                             uint32_t flags);
+EXPORT uint32_t engine_get_pending_loads(Engine* self);
+
+// Shared assets: Sounds loaded this way reference one cached copy of the
+// data. key may be NULL to key by content. With a key, data may be NULL to
+// load an already cached asset (returns 0 if it is not cached).
+EXPORT int      engine_load_sound_shared(Engine* self,
+                                         struct Sound* sound,
+                                         const char* key,
+                                         float* data,
+                                         size_t data_size,
+                                         ma_format format,
+                                         int sample_rate,
+                                         int channels,
+                                         uint32_t flags);
+EXPORT int      engine_has_asset(Engine* self, const char* key);
+EXPORT int      engine_evict_asset(Engine* self, const char* key);
+EXPORT uint64_t engine_trim_assets(Engine* self);
+EXPORT int      engine_get_asset_stats(Engine* self, uint32_t* outCount, uint64_t* outBytes);
+
+// Engine-wide voice limit: at most max_voices sounds (0 = no limit) are
+// mixed, chosen by priority x gain; the rest are virtualized and resume in
+// place. Stats are from the last device callback.
+EXPORT void     engine_set_max_voices(Engine* self, uint32_t max_voices);
+EXPORT uint32_t engine_get_max_voices(Engine* self);
+EXPORT int      engine_get_voice_stats(Engine* self, uint32_t* outMixed, uint32_t* outVirtual);
+
+// The engine clock in output frames, for sound_play_at/sound_stop_at.
+EXPORT uint64_t engine_get_time_in_pcm_frames(Engine* self);
+EXPORT uint32_t engine_get_sample_rate(Engine* self);
 
 // playback device enumeration/selection
 EXPORT int       engine_refresh_playback_devices(Engine* self);
@@ -44,6 +155,97 @@ EXPORT int       engine_get_playback_device_name(Engine* self,
 EXPORT int       engine_select_playback_device_by_index(Engine* self,
                                                         ma_uint32 index);
 
+// Full duplex: one device captures from the default input and plays the
+// engine, in the same callback, so capture and output share a clock. Each
+// callback queues its capture frames together with the output it rendered
+// (the far-end reference for echo cancellation); engine_duplex_read hands
+// both back frame-aligned, de-interleaved into capture (capture_channels
+// per frame) and reference (engine_get_channels per frame). Either may be
+// NULL to drop it. Set before engine_init; 0 channels turns it off and
+// buffer_ms 0 keeps ENGINE_DUPLEX_BUFFER_MS.
+#define ENGINE_DUPLEX_BUFFER_MS 500
+EXPORT int      engine_set_duplex(Engine* self, uint32_t capture_channels, uint32_t buffer_ms);
+EXPORT uint32_t engine_get_capture_channels(Engine* self);
+EXPORT uint32_t engine_get_channels(Engine* self);
+EXPORT uint32_t engine_duplex_available(Engine* self);
+EXPORT uint32_t engine_duplex_read(Engine* self, float* capture, float* reference, uint32_t frames);
+// Capture mixed straight into the output, for zero-latency monitoring. It
+// is added after the reference is taken, so echo cancellation never sees
+// the near end's own voice as far-end audio.
+EXPORT void     engine_set_monitor_gain(Engine* self, float gain);
+EXPORT float    engine_get_monitor_gain(Engine* self);
+
+// Feed everything the engine renders, monitoring aside, to an echo
+// canceller as its far-end reference (NULL detaches). Once this returns
+// the previous one is no longer touched by the audio thread.
+EXPORT int      engine_set_echo_reference(Engine* self, EchoCanceller* ec);
+// The same, only if the engine is still referencing `expected`: returns 0
+// and changes nothing when another canceller holds the slot. For owners
+// sharing one engine, so none of them detaches another's.
+int             engine_replace_echo_reference(Engine* self, EchoCanceller* expected,
+                                              EchoCanceller* ec);
+
+// Latency profiles. By default the engine opens its device as miniaudio
+// would, with engine_init's period_ms. A latency config set before
+// engine_init instead fixes the period in frames, the number of periods,
+// the share mode and whether callbacks must be fixed size, and can move
+// JACK and ALSA ahead of PulseAudio (only if no component has created the
+// shared context yet). Exclusive mode falls back to shared when refused.
+// What the backend actually granted is reported by engine_get_latency_info.
+typedef enum EngineLatencyProfile {
+    ENGINE_LATENCY_CONSERVATIVE = 0, // period_ms, shared, as before
+    ENGINE_LATENCY_LOW          = 1, // 256 frames x 3, shared
+    ENGINE_LATENCY_ULTRA        = 2  // 128 frames x 2, exclusive, JACK/ALSA first
+} EngineLatencyProfile;
+
+typedef struct EngineLatencyConfig {
+    EngineLatencyProfile profile;   // miniaudio's performance profile
+    uint32_t periodFrames;          // 0 = period_ms from engine_init
+    uint32_t periods;               // 0 = backend default
+    int      exclusive;
+    int      noFixedSizedCallback;  // let the backend pick callback sizes
+    int      preferLowLatencyBackend;
+} EngineLatencyConfig;
+
+typedef struct EngineLatencyInfo {
+    uint32_t periodFrames;
+    uint32_t periods;
+    uint32_t sampleRate;
+    uint32_t latencyFrames;         // periodFrames x periods
+    float    latencyMs;
+    int      exclusive;
+    int      backend;               // ma_backend
+} EngineLatencyInfo;
+
+EXPORT EngineLatencyConfig engine_latency_config_init(EngineLatencyProfile profile);
+EXPORT int         engine_set_latency_config(Engine* self, const EngineLatencyConfig* config);
+EXPORT int         engine_get_latency_info(Engine* self, EngineLatencyInfo* out);
+EXPORT const char* engine_get_backend_name(Engine* self);
+
+// Audio thread load. Every device callback is timed, and a snapshot can
+// be taken from any thread without ever blocking the audio thread. load is
+// callback time over the callback's period (1 = the deadline), smoothed
+// over about 300 ms; peakLoad is the worst single callback. An xrun is a
+// callback that ran past its period (also counted in overruns) or came so
+// long after the previous one that the device buffer must have run dry.
+// The counts belong to the current device and backend and restart when
+// the engine opens another. Offline engines are not timed.
+typedef struct EngineLoadStats {
+    uint64_t callbacks;
+    uint64_t frames;
+    uint64_t xruns;
+    uint64_t overruns;
+    float    load;
+    float    peakLoad;
+    float    lastCallbackUs;
+    float    maxCallbackUs;
+    float    periodUs;              // of the last callback
+    int      backend;               // ma_backend
+} EngineLoadStats;
+
+EXPORT int  engine_get_load_stats(Engine* self, EngineLoadStats* out);
+EXPORT void engine_reset_load_stats(Engine* self);
+
 EXPORT ma_engine* engine_get_ma_engine(Engine* self);
 
 #endif
@@ -0,0 +1,25 @@
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Read-only memory mapping of a whole file. Pages are faulted in by the OS
+   as they are touched, so a long file only costs resident memory for the
+   part actually being decoded. Paths are UTF-8 on every platform. */
+typedef struct FileMap {
+    void*  data;
+    size_t size;
+    void*  handle;  /* Windows mapping handle; unused elsewhere */
+} FileMap;
+
+int  file_map_open(FileMap* map, const char* path);
+void file_map_close(FileMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* FILE_MAP_H */
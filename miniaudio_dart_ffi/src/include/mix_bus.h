@@ -0,0 +1,68 @@
+#ifndef MIX_BUS_H
+#define MIX_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+#include "engine.h"
+#include "export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Named submix on an ma_sound_group.
+
+   Sounds, stream players, playlists and other buses routed into a bus are
+   summed once by its group, which then applies the bus volume and mute
+   and feeds the bus's own effects on the way to its parent (another bus,
+   or the engine endpoint). Changing the gain of everything on a bus is one
+   call, and one gain stage on the audio thread, however many members it has.
+
+   Volume changes are smoothed over MIX_BUS_SMOOTH_MS and mute fades over
+   the same time, so neither clicks. A bus must outlive what is routed into
+   it: move members (and child buses) elsewhere before uninit, or they fall
+   silent until they are routed again. */
+
+#define MIX_BUS_NAME_MAX  64
+#define MIX_BUS_SMOOTH_MS 5
+
+typedef struct MixBus MixBus;
+
+EXPORT MixBus* mix_bus_alloc(void);
+EXPORT void    mix_bus_free(MixBus* self);
+
+EXPORT int  mix_bus_init(MixBus* self, Engine* engine, const char* name);
+EXPORT void mix_bus_uninit(MixBus* self);
+
+EXPORT const char* mix_bus_get_name(MixBus* self);
+EXPORT void  mix_bus_set_volume(MixBus* self, float volume);
+EXPORT float mix_bus_get_volume(MixBus* self);
+EXPORT void  mix_bus_set_muted(MixBus* self, bool muted);
+EXPORT bool  mix_bus_get_muted(MixBus* self);
+
+/* NULL plays straight to the engine. Returns 0 for a bus of another engine
+   or one that would route back into self. */
+EXPORT int     mix_bus_set_parent(MixBus* self, MixBus* parent);
+EXPORT MixBus* mix_bus_get_parent(MixBus* self);
+
+/* Effects run in order after the bus gain (effect_chain.h). The bus does
+   not own them. index < 0 appends. */
+EXPORT int  mix_bus_insert_effect(MixBus* self, ma_node* effect, int index);
+EXPORT int  mix_bus_remove_effect(MixBus* self, ma_node* effect);
+EXPORT void mix_bus_clear_effects(MixBus* self);
+
+/* Where members attach: the bus's group. */
+ma_node*   mix_bus_get_input(MixBus* self);
+ma_engine* mix_bus_get_engine(MixBus* self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MIX_BUS_H */
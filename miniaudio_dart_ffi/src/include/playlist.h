@@ -0,0 +1,89 @@
+#ifndef PLAYLIST_H
+#define PLAYLIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+#include "engine.h"
+#include "export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Gapless queue of tracks played through one ma_sound.
+
+   Items are encoded data, encoded files or raw PCM. The audio thread never
+   decodes or reads a file: PCM is converted to the engine format whole
+   when queued, and an encoded item is decoded into a ring of
+   PLAYLIST_PREFETCH_MS (or the crossfade, if longer). The caller's thread
+   opens the decoder and fills the ring; from then on a job on the engine's
+   resource manager threads refills it each time half of it has played. At
+   a track boundary the audio thread only copies decoded frames, so the
+   next item starts in the same callback the previous one ends in. A ring
+   that runs dry (job threads busy with loads for longer than that) plays
+   silence until the refill lands, rather than waiting on it.
+
+   With a crossfade set, an item whose length is known is blended into the
+   next one over its last frames (equal power). A drained queue plays
+   silence until more is queued.
+
+   The queue is a single-producer ring: queueing, skipping and clearing
+   happen on one control thread, finished items are freed there too, and
+   the audio thread only ever advances the head. */
+
+#define PLAYLIST_MAX_ITEMS   64
+#define PLAYLIST_PREFETCH_MS 250
+
+typedef struct Playlist Playlist;
+struct MixBus;
+
+EXPORT Playlist* playlist_alloc(void);
+EXPORT void      playlist_free(Playlist* self);
+
+EXPORT int  playlist_init(Playlist* self, Engine* engine, uint32_t crossfade_ms);
+EXPORT void playlist_uninit(Playlist* self);
+EXPORT int  playlist_start(Playlist* self);
+EXPORT int  playlist_stop(Playlist* self);
+EXPORT void  playlist_set_volume(Playlist* self, float volume);
+EXPORT float playlist_get_volume(Playlist* self);
+/* Play into a bus of the same engine (mix_bus.h), or NULL for the engine. */
+EXPORT int   playlist_set_bus(Playlist* self, struct MixBus* bus);
+/* Effects between the playlist and its bus (effect_chain.h); not owned,
+   released by uninit. index < 0 appends. */
+EXPORT int   playlist_insert_effect(Playlist* self, ma_node* effect, int index);
+EXPORT int   playlist_remove_effect(Playlist* self, ma_node* effect);
+EXPORT void  playlist_clear_effects(Playlist* self);
+EXPORT void     playlist_set_crossfade(Playlist* self, uint32_t crossfade_ms);
+EXPORT uint32_t playlist_get_crossfade(Playlist* self);
+
+/* Each returns the item's id, or 0 when it could not be opened or the
+   queue is full. The data is copied. */
+EXPORT uint32_t playlist_enqueue(Playlist* self, const void* data, size_t size);
+EXPORT uint32_t playlist_enqueue_file(Playlist* self, const char* path);
+EXPORT uint32_t playlist_enqueue_pcm(Playlist* self,
+                                     const void* data,
+                                     size_t size,
+                                     ma_format format,
+                                     int channels,
+                                     int sample_rate);
+
+/* Takes effect in the next audio callback. */
+EXPORT void playlist_skip(Playlist* self);
+EXPORT void playlist_clear(Playlist* self);
+
+/* Id of the item playing (0 when drained) and the items left, the current
+   one included. */
+EXPORT uint32_t playlist_get_current(Playlist* self);
+EXPORT uint32_t playlist_get_queued(Playlist* self);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PLAYLIST_H */
@@ -11,6 +11,8 @@
 #endif
 #include "codec.h"
 #include "crosscoder.h"
+#include "capture_chain.h"
+#include "engine.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -62,6 +64,30 @@ EXPORT int recorder_commit_read_frames(Recorder* r, int frames);
 EXPORT void  recorder_set_capture_gain(Recorder* r, float gain);
 EXPORT float recorder_get_capture_gain(Recorder* r);
 
+/* Capture processing, between the device and the buffer or encoder.
+   Only for f32 recorders (always the case with a codec). Stages run on
+   the capture thread in blocks of up to RECORDER_PROCESS_FRAMES, after the
+   capture gain; see capture_chain.h. */
+#define RECORDER_PROCESS_FRAMES 1024
+
+/* Returns the stage id, 0 on failure. */
+EXPORT uint32_t recorder_add_processor(Recorder* r, CaptureProcessFn fn, void* user_data);
+EXPORT int      recorder_remove_processor(Recorder* r, uint32_t id);
+
+/* Built-in noise suppressor attenuating up to reductionDb; 0 turns it off. */
+EXPORT int      recorder_set_noise_suppression(Recorder* r, float reductionDb);
+
+/* Built-in echo canceller, referenced to what engine plays. Runs before
+   the noise suppressor and any added stage. The engine must outlive it:
+   disable it (or destroy the recorder) before uninitializing the engine.
+   An engine serves one canceller: this fails while another recorder's is
+   attached to it, and disabling only detaches the recorder's own.
+   filterMs 0 = ECHO_CANCELLER_DEFAULT_MS. */
+EXPORT int      recorder_enable_echo_cancellation(Recorder* r, Engine* engine, uint32_t filterMs);
+EXPORT void     recorder_disable_echo_cancellation(Recorder* r);
+/* Echo return loss enhancement in dB, 0 when off. */
+EXPORT float    recorder_get_echo_return_loss_enhancement(Recorder* r);
+
 /* Query codec in use */
 EXPORT RecorderCodec recorder_get_codec(Recorder* r);
 
@@ -3,10 +3,42 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "../external/miniaudio/include/miniaudio.h"
 #include "export.h"
 #include "silence_data_source.h"
+#include "asset_cache.h"
+#include "file_map.h"
+#include "voice_pool.h"
+#include "voice_scheduler.h"
+#include "effect_chain.h"
+
+// Load flags for engine_load_sound_ex / engine_load_sound_shared.
+typedef enum {
+    SOUND_LOAD_DEFAULT = 0,
+    // Fully decode encoded data at load time into PCM in the engine's format,
+    // channel count and sample rate, so playback is a plain buffer read.
+    SOUND_LOAD_DECODE  = 1,
+    // File loads only: stream from disk through the engine's resource
+    // manager (the default for files), or decode from a memory-mapped file.
+    SOUND_LOAD_STREAM  = 2,
+    SOUND_LOAD_MMAP    = 4,
+} SoundLoadFlags;
+
+// Progress of a background load (engine_load_sound_async).
+typedef enum {
+    SOUND_LOAD_STATE_NONE    = 0,  // loaded synchronously, or never loaded
+    SOUND_LOAD_STATE_PENDING = 1,
+    SOUND_LOAD_STATE_READY   = 2,
+    SOUND_LOAD_STATE_FAILED  = 3,
+} SoundLoadState;
+
+struct MixBus;
+
+// Gives back a caller's buffer once a sound no longer reads it
+// (sound_init_external).
+typedef void (*SoundDataRelease)(void *data, void *user_data);
 
 typedef struct Sound {
     ma_engine *engine;
@@ -28,9 +60,45 @@ typedef struct Sound {
     // Own a copy of the input bytes for decoder/buffer lifetime
     void*  owned_data;
     size_t owned_size;
+
+    // Caller buffers taken over without a copy: owned_data is released with
+    // data_release(owned_data, data_release_user) or data_free(owned_data)
+    // instead of free().
+    void (*data_free)(void *data);
+    SoundDataRelease data_release;
+    void *data_release_user;
+
+    // When set, owned_data points into this shared asset instead (not freed)
+    SoundAsset* asset;
+
+    // File-backed sources: is_stream plays path through the resource
+    // manager; a mapped file backs owned_data instead of a heap copy.
+    bool    is_stream;
+    char*   path;
+    FileMap map;
+
+    // SoundLoadState; written by the loader thread, polled by anyone.
+    volatile uint32_t load_state;
+
+    // Extra voices for overlapping plays (sound_set_polyphony); empty by default.
+    VoicePool voices;
+
+    // The engine's voice limiter this sound and its voices are ranked by.
+    VoiceScheduler* scheduler;
+    float           priority;
+
+    // Submix the sound and its voices play into (mix_bus.h); NULL plays
+    // straight to the engine.
+    struct MixBus* bus;
+
+    // Effects between the sound (and its voices) and the bus or engine.
+    EffectChain effects;
 } Sound;
 
 EXPORT Sound *sound_alloc();
+// Buffers allocated here may be handed to sound_init_adopt with a NULL
+// free_fn, which releases them with free().
+EXPORT void *sound_data_alloc(size_t const size);
 
 int sound_init(
     Sound *const self,
@@ -39,7 +107,71 @@ int sound_init(
     const ma_format format,
     const int channels,
     const int sample_rate,
+    const uint32_t flags,
+    ma_engine *const engine);
+// As sound_init, but takes ownership of a malloc'd buffer (freed on failure).
+int sound_init_owned(
+    Sound *const self,
+    void *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
     ma_engine *const engine);
+// As sound_init_owned, but the buffer is released with free_fn (free() when
+// NULL). Either way it belongs to the sound from here on: it is released at
+// unload, on failure, or right after SOUND_LOAD_DECODE has decoded it.
+int sound_init_adopt(
+    Sound *const self,
+    void *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
+    void (*free_fn)(void *data),
+    ma_engine *const engine);
+// Reference memory the caller keeps. release(data, user_data) is called
+// exactly once when the sound stops reading it, under the same rules as
+// sound_init_adopt; the memory must stay valid and unchanged until then.
+int sound_init_external(
+    Sound *const self,
+    const void *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
+    SoundDataRelease release,
+    void *user_data,
+    ma_engine *const engine);
+// Load from a UTF-8 path: SOUND_LOAD_STREAM (default), SOUND_LOAD_MMAP or
+// SOUND_LOAD_DECODE. Nothing but the decoder state is held in memory for the
+// first two.
+int sound_init_from_file(
+    Sound *const self,
+    const char *path,
+    const uint32_t flags,
+    ma_engine *const engine);
+// Decode encoded bytes to interleaved f32 at the engine's channels and rate.
+// The returned buffer is malloc'd and owned by the caller.
+int sound_decode_to_pcm(
+    const void *data,
+    size_t const data_size,
+    ma_engine *const engine,
+    void **out_data,
+    size_t *out_size,
+    int *out_channels,
+    int *out_sample_rate);
+// Reference a shared asset instead of copying; takes its own reference.
+int sound_init_from_asset(
+    Sound *const self,
+    SoundAsset *asset,
+    ma_engine *const engine);
+EXPORT int  sound_get_load_state(Sound const *const self);
+// Register with the engine's voice limiter (done by the engine's loaders).
+void sound_attach_scheduler(Sound *const self, VoiceScheduler *scheduler);
 EXPORT void sound_unload(Sound *const self);
 EXPORT void sound_free(Sound *self);
 
@@ -47,16 +179,54 @@ EXPORT int sound_play(Sound *const self);
 EXPORT int sound_replay(Sound *const self);
 EXPORT void sound_pause(Sound *const self);
 EXPORT void sound_stop(Sound *const self);
+// Sample-accurate scheduling on the engine clock (engine_get_time_in_pcm_frames).
+// A time already passed takes effect in the next callback. play_at on a
+// playing sound holds it until then; sound_play clears a pending start.
+EXPORT int  sound_play_at(Sound *const self, uint64_t const time_in_frames);
+EXPORT void sound_stop_at(Sound *const self, uint64_t const time_in_frames);
 
 EXPORT float sound_get_volume(Sound const *const self);
 EXPORT void sound_set_volume(Sound *const self, float const value);
 
 EXPORT float sound_get_duration(Sound *const self);
 
+// Route the sound and its voices into a bus of the same engine, or back to
+// the engine with NULL. Fails while a background load is pending.
+EXPORT int sound_set_bus(Sound *const self, struct MixBus *bus);
+
+// Effects (effects.h, or any one-in one-out ma_node of the same engine) run
+// in order on the sound and its voices before the bus. The sound does not
+// own them; unloading releases them. index < 0 appends. Insert fails while
+// a background load is pending.
+EXPORT int  sound_insert_effect(Sound *const self, ma_node *effect, int index);
+EXPORT int  sound_remove_effect(Sound *const self, ma_node *effect);
+EXPORT void sound_clear_effects(Sound *const self);
+
+// Weight for the engine's voice limit (default 1); ranked as priority x gain.
+EXPORT float sound_get_priority(Sound const *const self);
+EXPORT void sound_set_priority(Sound *const self, float const value);
+
 EXPORT bool sound_get_is_looped(Sound const *const self);
 EXPORT void sound_set_looped(Sound *const self, bool const value, size_t const delay_ms);
 
-// Rebind to a new engine (device change)
+// Polyphony: up to max_voices overlapping plays, each on its own
+// preallocated voice (SoundStealPolicy picks the victim when all are busy).
+// 0 releases the voices. Voices ignore the loop delay and the Sound's own
+// volume; sound_stop stops them too.
+EXPORT int      sound_set_polyphony(Sound *const self, uint32_t const max_voices, int const policy);
+EXPORT uint32_t sound_get_polyphony(Sound const *const self);
+// Returns a voice handle, or 0 when no voice could be had.
+EXPORT uint32_t sound_play_voice(Sound *const self, float const volume, int const priority, bool const looped);
+EXPORT uint32_t sound_play_voice_at(Sound *const self, float const volume, int const priority, bool const looped, uint64_t const time_in_frames);
+EXPORT void     sound_stop_voice(Sound *const self, uint32_t const voice);
+EXPORT bool     sound_voice_is_playing(Sound *const self, uint32_t const voice);
+EXPORT void     sound_set_voice_volume(Sound *const self, uint32_t const voice, float const value);
+EXPORT uint32_t sound_get_active_voices(Sound *const self);
+
+// Rebuild on another ma_engine. A no-op for the engine the sound already
+// plays on, which is the case after engine_select_playback_device_by_index.
+// A bus and effects belong to the old engine, so the sound comes back
+// unrouted and without effects.
 EXPORT int sound_rebind_engine(struct Sound* self, ma_engine* newEngine);
 
 #endif
@@ -0,0 +1,91 @@
+#ifndef SOUND_LOADER_H
+#define SOUND_LOADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Background Sound loading on worker threads of its own.
+
+   Each submit copies its input (or the path) and posts a custom job to the
+   workers, so the caller may release its buffer as soon as submit returns;
+   submit_adopted takes the buffer over instead of copying it. The job runs
+   sound_init_adopt or sound_init_from_file, stores the Sound's load_state
+   and then calls the completion callback on the worker thread. Jobs are
+   spread over as many workers as the engine's resource manager has job
+   threads, so bulk loads scale with the configured thread count.
+
+   The workers are a second, otherwise unused ma_resource_manager rather than
+   the engine's job threads: opening a stream posts a job to the engine's
+   resource manager and blocks until one of its threads has run it, which
+   would never happen if the load itself held the only one.
+
+   When the engine's resource manager has no job threads (single-threaded
+   wasm) jobs run inline inside submit. */
+
+struct Sound;
+typedef struct SoundLoadJob SoundLoadJob;
+
+/* ok is 1 on success. Called on a job thread (or inline, see above). */
+typedef void (*SoundLoadCallback)(struct Sound* sound, int ok, void* userData);
+
+typedef struct SoundLoader {
+    ma_resource_manager* resourceManager;
+    ma_engine*           engine;
+    volatile uint32_t    pending;   /* submitted, not yet completed */
+    ma_spinlock          lock;      /* guards callback/userData */
+    SoundLoadCallback    callback;
+    void*                userData;
+    struct VoiceScheduler* scheduler; /* loaded sounds register here, may be NULL */
+    ma_resource_manager  workers;   /* job threads only, see above */
+    int                  workersReady;
+} SoundLoader;
+
+void sound_loader_init(SoundLoader* loader, ma_resource_manager* rm, ma_engine* engine);
+/* Waits for outstanding jobs, then stops the workers. */
+void sound_loader_uninit(SoundLoader* loader);
+void sound_loader_set_callback(SoundLoader* loader, SoundLoadCallback cb, void* userData);
+
+int  sound_loader_submit_memory(SoundLoader* loader,
+                                struct Sound* sound,
+                                const void* data,
+                                size_t size,
+                                ma_format format,
+                                int channels,
+                                int sampleRate,
+                                uint32_t flags);
+/* As submit_memory without the copy: data belongs to the job from here on,
+   even when this fails, and is released as sound_init_adopt describes. */
+int  sound_loader_submit_adopted(SoundLoader* loader,
+                                 struct Sound* sound,
+                                 void* data,
+                                 size_t size,
+                                 ma_format format,
+                                 int channels,
+                                 int sampleRate,
+                                 uint32_t flags,
+                                 void (*freeFn)(void* data));
+int  sound_loader_submit_file(SoundLoader* loader,
+                              struct Sound* sound,
+                              const char* path,
+                              uint32_t flags);
+
+uint32_t sound_loader_pending(SoundLoader* loader);
+/* Block until every submitted job has completed. Must precede tearing down
+   or re-initializing the engine the jobs attach to. */
+void     sound_loader_wait_idle(SoundLoader* loader);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SOUND_LOADER_H */
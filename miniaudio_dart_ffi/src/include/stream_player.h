@@ -13,6 +13,7 @@
 #include "codec.h"
 #include "codec_runtime.h"
 #include "codec_packet_format.h"
+#include "stream_timeline.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -20,6 +21,7 @@ extern "C" {
 #endif
 
 typedef struct StreamPlayer StreamPlayer;
+struct MixBus;
 
 typedef struct StreamPlayerConfig {
     ma_format format;
@@ -28,8 +30,40 @@ typedef struct StreamPlayerConfig {
     uint32_t  bufferMilliseconds;
     int       allowCodecPackets;
     int       decodeAccumFrames; /* reserved */
+    /* Buffered mode: keep played audio as seekable history instead of a
+       live ring. bufferMilliseconds then sizes the whole retained window. */
+    int       bufferedMode;
+    uint32_t  segmentMilliseconds; /* 0 = 1000 ms segments */
+    /* Pre-roll gate: output silence until this much audio is queued, and
+       again after every underrun. 0 disables gating. */
+    uint32_t  prerollMilliseconds;
+    uint32_t  fadeMilliseconds;    /* gate transition fades; 0 = 5 ms */
 } StreamPlayerConfig;
 
+/* Telemetry. Counters are updated lock-free on the audio path; a snapshot
+   is cheap enough to poll from the UI thread. Decode errors are indexed by
+   CodecID. */
+#define STREAM_PLAYER_CODEC_SLOTS 2
+
+typedef struct StreamPlayerStats {
+    uint64_t underrunEvents;   /* transitions from playing to starved */
+    uint64_t silenceFrames;    /* frames zero-filled while starved */
+    uint64_t droppedFrames;    /* frames discarded because the buffer was full */
+    uint32_t fillFrames;       /* frames currently queued */
+    uint32_t peakFillFrames;   /* highest fill since the last reset */
+    uint32_t capacityFrames;
+    uint32_t decodeErrors[STREAM_PLAYER_CODEC_SLOTS];
+} StreamPlayerStats;
+
+typedef enum {
+    STREAM_PLAYER_EVENT_UNDERRUN     = 1,
+    STREAM_PLAYER_EVENT_DROP         = 2,
+    STREAM_PLAYER_EVENT_DECODE_ERROR = 3,
+} StreamPlayerEvent;
+
+/* total is the counter's current value (events, frames or errors). */
+typedef void (*StreamPlayerTelemetryCallback)(void* userData, int event, uint64_t total);
+
 EXPORT StreamPlayerConfig stream_player_config_default(int channels, int sampleRate);
 
 EXPORT StreamPlayer* stream_player_alloc(void);
@@ -49,11 +83,84 @@ EXPORT int  stream_player_stop(StreamPlayer* sp);
 EXPORT void stream_player_clear(StreamPlayer* sp);
 EXPORT void  stream_player_set_volume(StreamPlayer* sp, float volume);
 EXPORT float stream_player_get_volume(StreamPlayer* sp);
+/* Play into a bus of the same engine (mix_bus.h), or NULL for the engine. */
+EXPORT int   stream_player_set_bus(StreamPlayer* sp, struct MixBus* bus);
+/* Effects between the player and its bus (effect_chain.h); not owned,
+   released by uninit. index < 0 appends. */
+EXPORT int   stream_player_insert_effect(StreamPlayer* sp, ma_node* effect, int index);
+EXPORT int   stream_player_remove_effect(StreamPlayer* sp, ma_node* effect);
+EXPORT void  stream_player_clear_effects(StreamPlayer* sp);
 
 EXPORT size_t stream_player_write_frames_f32(StreamPlayer* sp,
                                              const float* frames,
                                              size_t frameCount);
 
+/* Zero-copy producer. On input *outFrames is the most frames wanted (<= 0
+   for as many as fit); on return it is the size of a contiguous writable
+   region inside the playback buffer, which may be smaller or 0 when full.
+   Render into *outPtr, then commit the frames actually written. Only one
+   region may be outstanding, and it is invalid after the commit. */
+EXPORT int stream_player_acquire_write_region(StreamPlayer* sp, void** outPtr, int* outFrames);
+EXPORT int stream_player_commit_write(StreamPlayer* sp, int frames);
+/* Buffered mode: commit the region as a chunk starting at timestampFrames. */
+EXPORT int stream_player_commit_write_at(StreamPlayer* sp, int frames, int64_t timestampFrames);
+
+/* Buffered mode: write a chunk whose first frame has the given stream
+   timestamp (in frames). Plain writes continue the previous chunk. */
+EXPORT size_t stream_player_write_frames_f32_at(StreamPlayer* sp,
+                                                const float* frames,
+                                                size_t frameCount,
+                                                int64_t timestampFrames);
+
+/* Timestamp (frames) of the next frame to be played. In live mode this is
+   the number of buffered frames played so far. */
+EXPORT int64_t stream_player_get_position(StreamPlayer* sp);
+
+/* Buffered mode only: move playback to a timestamp inside the buffered
+   window. Returns 0 if the target is not buffered. */
+EXPORT int stream_player_seek(StreamPlayer* sp, int64_t timestampFrames);
+EXPORT int stream_player_get_buffered_range(StreamPlayer* sp,
+                                            int64_t* outStart,
+                                            int64_t* outEnd);
+
+/* Gain automation, applied on the audio thread on top of the volume.
+   A new ramp starts from the current gain and replaces any ramp in
+   progress. Exponential ramps move in equal dB steps (floor -80 dB). */
+typedef enum {
+    STREAM_PLAYER_RAMP_LINEAR      = 0,
+    STREAM_PLAYER_RAMP_EXPONENTIAL = 1,
+} StreamPlayerRampCurve;
+
+EXPORT void  stream_player_ramp_gain(StreamPlayer* sp, float target, uint32_t durationMs, int curve);
+EXPORT float stream_player_get_gain(StreamPlayer* sp);
+/* Ramps `from` to 0 and `to` to 1 over the same duration. */
+EXPORT void  stream_player_crossfade(StreamPlayer* from, StreamPlayer* to, uint32_t durationMs, int curve);
+
+/* Sidechain ducking: while the sidechain player's level is above threshold
+   (linear peak), sp's gain moves towards duckGain with the given attack and
+   release times. Pass a NULL sidechain to disable. The sidechain may be
+   disposed first; ducking then releases. */
+EXPORT int stream_player_set_ducking(StreamPlayer* sp,
+                                     StreamPlayer* sidechain,
+                                     float threshold,
+                                     float duckGain,
+                                     uint32_t attackMs,
+                                     uint32_t releaseMs);
+
+EXPORT int  stream_player_get_stats(StreamPlayer* sp, StreamPlayerStats* outStats);
+EXPORT void stream_player_reset_stats(StreamPlayer* sp);
+
+/* Invoke cb whenever a counter has grown by at least its threshold since
+   the last notification (0 disables that event). The callback runs on the
+   thread writing to the player or polling stats, never the audio thread.
+   Pass NULL to remove it. */
+EXPORT void stream_player_set_telemetry_callback(StreamPlayer* sp,
+                                                 StreamPlayerTelemetryCallback cb,
+                                                 void* userData,
+                                                 uint32_t underrunThreshold,
+                                                 uint32_t dropThresholdFrames,
+                                                 uint32_t decodeErrorThreshold);
+
 EXPORT int stream_player_push_encoded_packet(StreamPlayer* sp,
                                              const void* packet,
                                              int packetBytes);
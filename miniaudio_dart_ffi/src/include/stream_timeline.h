@@ -0,0 +1,88 @@
+#ifndef STREAM_TIMELINE_H
+#define STREAM_TIMELINE_H
+
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Segmented, seekable PCM buffer used by StreamPlayer's buffered mode.
+
+   Frames are addressed by an absolute index (total frames ever written).
+   Storage is a ring of fixed-size segments allocated lazily by the writer,
+   so a long window only costs memory once it is actually filled. Frames
+   behind the read cursor are kept as history until the writer needs the
+   space, which is what makes backward seeks possible.
+
+   Each written chunk may carry a timestamp (in frames at the stream rate).
+   Chunks are recorded in a small table that maps absolute indices back to
+   timestamps for position reporting and seeking.
+
+   Threading: one writer thread, one reader (the audio callback). Seeks and
+   position queries may come from any non-audio thread; they share a
+   spinlock with the writer but never block the reader. */
+
+#define STREAM_TIMELINE_NO_TIMESTAMP  INT64_MIN
+#define STREAM_TIMELINE_MAX_CHUNKS    1024
+
+typedef struct StreamTimelineChunk {
+    uint64_t absStart;   /* absolute index of the chunk's first frame */
+    int64_t  timestamp;  /* stream timestamp of that frame */
+} StreamTimelineChunk;
+
+typedef struct StreamTimeline {
+    ma_uint32  frameSizeBytes;
+    ma_uint32  segmentFrames;
+    ma_uint32  segmentCount;
+    uint64_t   capacityFrames;
+    ma_uint8** segments;
+
+    /* Shared with the audio thread (atomic access). */
+    volatile uint64_t writeAbs;     /* committed frames */
+    volatile uint64_t readAbs;      /* owned by the reader */
+    volatile uint64_t pendingSeek;  /* UINT64_MAX when none */
+
+    /* Writer/seeker state (guarded by lock). */
+    ma_spinlock         lock;
+    uint64_t            baseAbs;     /* oldest frame still addressable */
+    uint64_t            reserveEnd;  /* end of an acquired, uncommitted region */
+    StreamTimelineChunk chunks[STREAM_TIMELINE_MAX_CHUNKS];
+    ma_uint32           chunkHead;   /* index of the oldest chunk */
+    ma_uint32           chunkCount;
+} StreamTimeline;
+
+int  stream_timeline_init(StreamTimeline* tl,
+                          ma_uint32 frameSizeBytes,
+                          ma_uint32 segmentFrames,
+                          uint64_t windowFrames);
+void stream_timeline_uninit(StreamTimeline* tl);
+
+/* Writer side. acquire returns a contiguous region (never spanning a segment
+   boundary) of up to *inOutFrames frames; commit publishes it. */
+int  stream_timeline_acquire_write(StreamTimeline* tl, ma_uint32* inOutFrames, void** ppWrite);
+int  stream_timeline_commit_write(StreamTimeline* tl, ma_uint32 frames, int64_t timestamp);
+size_t stream_timeline_write(StreamTimeline* tl, const void* frames, size_t frameCount, int64_t timestamp);
+
+/* Reader side (audio thread). Returns frames copied; never blocks. */
+ma_uint32 stream_timeline_read(StreamTimeline* tl, void* out, ma_uint32 frames);
+ma_uint32 stream_timeline_available_read(StreamTimeline* tl);
+ma_uint32 stream_timeline_available_write(StreamTimeline* tl);
+
+/* Control side. */
+int64_t stream_timeline_get_position(StreamTimeline* tl);
+int     stream_timeline_seek(StreamTimeline* tl, int64_t timestamp);
+int     stream_timeline_get_range(StreamTimeline* tl, int64_t* outStart, int64_t* outEnd);
+void    stream_timeline_clear(StreamTimeline* tl);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STREAM_TIMELINE_H */
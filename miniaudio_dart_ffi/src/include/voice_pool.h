@@ -0,0 +1,74 @@
+#ifndef VOICE_POOL_H
+#define VOICE_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Preallocated voices for overlapping plays of one Sound.
+
+   Every voice owns an ma_sound and its own cursor (a buffer or decoder over
+   the Sound's data, or a separate stream), built once when the polyphony is
+   set. Playing picks an idle voice or, when all are busy, steals one by the
+   pool's policy, then seeks and restarts it: nothing is allocated. A voice
+   scheduled to start later counts as busy.
+
+   A voice handle packs the slot index with a generation counter that is
+   bumped on every (re)start, so a stale handle from a stolen or finished
+   voice is ignored rather than acting on its new owner. 0 is never a valid
+   handle.
+
+   Not thread-safe; driven from the control thread like the rest of Sound. */
+
+#define VOICE_POOL_MAX_VOICES 64
+
+typedef enum {
+    SOUND_STEAL_OLDEST           = 0,
+    SOUND_STEAL_QUIETEST         = 1,
+    SOUND_STEAL_LOWEST_PRIORITY  = 2,
+    SOUND_STEAL_NONE             = 3,  /* play fails when every voice is busy */
+} SoundStealPolicy;
+
+typedef struct SoundVoice {
+    ma_sound        sound;
+    ma_audio_buffer buffer;   /* raw PCM voices */
+    ma_decoder      decoder;  /* encoded voices */
+    uint32_t        generation;
+    uint64_t        started;  /* pool clock at the last start */
+    int             priority;
+} SoundVoice;
+
+typedef struct VoicePool {
+    SoundVoice*      voices;
+    uint32_t         count;
+    SoundStealPolicy policy;
+    uint64_t         clock;
+} VoicePool;
+
+int  voice_pool_alloc(VoicePool* pool, uint32_t count, SoundStealPolicy policy);
+void voice_pool_free(VoicePool* pool);
+
+/* Choose the voice for a new play (stopping it if it is stolen) and stamp
+   it. Returns NULL when the policy refuses to steal. *stolen is set when a
+   playing voice was taken over. */
+SoundVoice* voice_pool_acquire(VoicePool* pool, int priority, bool* stolen);
+
+uint32_t    voice_pool_handle(VoicePool const* pool, SoundVoice const* voice);
+/* The voice a handle refers to, or NULL when it is stale or invalid. */
+SoundVoice* voice_pool_lookup(VoicePool* pool, uint32_t handle);
+uint32_t    voice_pool_active(VoicePool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* VOICE_POOL_H */
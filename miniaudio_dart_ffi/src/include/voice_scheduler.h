@@ -0,0 +1,94 @@
+#ifndef VOICE_SCHEDULER_H
+#define VOICE_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Engine-wide cap on mixed voices.
+
+   Every ma_sound the engine hands out is registered here with a weight.
+   Before each device callback the scheduler ranks the playing ones by
+   weight x volume x fade and keeps at most maxVoices of them in the graph.
+   The rest are virtualized: their output bus is detached, so the graph
+   neither decodes nor mixes them, and their position is tracked from the
+   engine clock. When a virtual voice ranks high enough again it is seeked
+   to where it would have been and reattached with a short fade-in; one that
+   would have ended meanwhile is stopped and rewound instead. Real voices get
+   a small bonus when ranking so near-equal voices do not swap every callback.
+
+   Sounds registered with slowSeek (decoder-backed: a seek decodes, which for
+   MP3 or Vorbis has no useful bound) are never seeked on the audio thread.
+   Their seek is posted to the engine's resource manager job threads, and the
+   voice stays virtual until it has landed; it resumes up to one period
+   behind where it would have been.
+
+   Registration happens on control and loader threads under a spinlock the
+   audio thread only ever try-locks, skipping a pass rather than waiting. */
+
+typedef struct VoiceSchedulerEntry {
+    ma_sound* sound;
+    float     weight;
+    bool      isVirtual;
+    ma_node*  outNode;     /* where to reattach */
+    ma_uint32 outBus;
+    ma_uint64 cursor;      /* source frame at virtualization */
+    ma_uint64 since;       /* engine time at virtualization */
+    bool      slowSeek;
+    uint32_t  seek;        /* VS_SEEK_*, slowSeek only */
+    bool      seekRewind;  /* the queued seek rewinds a finished voice */
+} VoiceSchedulerEntry;
+
+typedef struct VoiceScheduler {
+    ma_engine*           engine;
+    volatile uint32_t    lock;
+    VoiceSchedulerEntry* entries;
+    float*               scores;    /* per entry, -1 when not playing */
+    float*               ranked;    /* selection scratch */
+    uint32_t             count;
+    uint32_t             capacity;
+    volatile uint32_t    maxVoices; /* 0 = unlimited */
+    volatile uint32_t    mixedVoices;
+    volatile uint32_t    virtualVoices;
+    volatile uint32_t    pendingSeeks; /* posted, not yet completed */
+} VoiceScheduler;
+
+void voice_scheduler_init(VoiceScheduler* s, ma_engine* engine);
+/* Waits for queued seeks; the job threads must still be running. */
+void voice_scheduler_uninit(VoiceScheduler* s);
+
+int  voice_scheduler_add(VoiceScheduler* s, ma_sound* sound, float weight, bool slowSeek);
+/* Reattaches the sound if it is virtual, after any seek queued for it has
+   landed. Call before ma_sound_uninit. */
+void voice_scheduler_remove(VoiceScheduler* s, ma_sound* sound);
+void voice_scheduler_set_weight(VoiceScheduler* s, ma_sound* sound, float weight);
+void voice_scheduler_set_max_voices(VoiceScheduler* s, uint32_t maxVoices);
+/* Moves the sound's output to input bus 0 of target. A virtual voice only
+   has its saved attachment changed and lands there when it is restored.
+   Sounds that are not registered (or a NULL s) are attached directly. */
+void voice_scheduler_route(VoiceScheduler* s, ma_sound* sound, ma_node* target);
+
+/* Audio thread, outside any graph read. */
+void voice_scheduler_process(VoiceScheduler* s);
+
+/* Earliest scheduled start or stop of a registered sound inside (beg, end),
+   or end when there is none. miniaudio only changes a node's state on a read
+   boundary, so the engine splits its reads here to keep them sample-exact.
+   Stop times are stored one frame late (see sound_stop_at) and reported as
+   the frame the sound falls silent on. Audio thread. */
+ma_uint64 voice_scheduler_next_event(VoiceScheduler* s, ma_uint64 beg, ma_uint64 end);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* VOICE_SCHEDULER_H */
@@ -0,0 +1,205 @@
+#include "../include/asset_cache.h"
+#include "../include/atomic_util.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*************
+ ** private **
+ *************/
+
+static uint64_t ac_hash_key(const char* key) {
+    return asset_cache_hash(key, strlen(key));
+}
+
+/* The same bytes read as another layout are another asset. */
+static uint64_t ac_hash_content(const void* data, size_t size, ma_format format,
+                                int channels, int sampleRate) {
+    uint64_t h = asset_cache_hash(data, size);
+    h = (h ^ (uint64_t)format) * 0x100000001b3ULL;
+    h = (h ^ (uint64_t)(uint32_t)channels) * 0x100000001b3ULL;
+    return (h ^ (uint64_t)(uint32_t)sampleRate) * 0x100000001b3ULL;
+}
+
+static int ac_matches(const SoundAsset* a,
+                      uint64_t hash,
+                      const char* key,
+                      const void* data,
+                      size_t size,
+                      ma_format format,
+                      int channels,
+                      int sampleRate)
+{
+    if (a->hash != hash) return 0;
+    if (key) return a->key != NULL && strcmp(a->key, key) == 0;
+    /* Content-addressed: confirm the layout and the bytes, a 64-bit hash
+       is not proof. */
+    return a->key == NULL && a->size == size && a->format == format &&
+           a->channels == channels && a->sampleRate == sampleRate &&
+           (data == NULL || memcmp(a->data, data, size) == 0);
+}
+
+static void ac_destroy(SoundAsset* a) {
+    free(a->data);
+    free(a->key);
+    free(a);
+}
+
+/* Unlink *link (caller holds the lock) and drop the cache's reference. */
+static void ac_unlink(AssetCache* cache, SoundAsset** link) {
+    SoundAsset* a = *link;
+    *link = a->next;
+    a->next = NULL;
+    cache->count--;
+    cache->bytes -= a->size;
+    sound_asset_release(a);
+}
+
+/************
+ ** public **
+ ************/
+
+int asset_cache_init(AssetCache* cache) {
+    if (!cache) return 0;
+    memset(cache, 0, sizeof(*cache));
+    return ma_mutex_init(&cache->lock) == MA_SUCCESS;
+}
+
+void asset_cache_uninit(AssetCache* cache) {
+    if (!cache) return;
+    ma_mutex_lock(&cache->lock);
+    for (int b = 0; b < ASSET_CACHE_BUCKETS; ++b) {
+        while (cache->buckets[b]) ac_unlink(cache, &cache->buckets[b]);
+    }
+    ma_mutex_unlock(&cache->lock);
+    ma_mutex_uninit(&cache->lock);
+}
+
+/* FNV-1a over 64-bit words, then the tail bytes. */
+uint64_t asset_cache_hash(const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0x100000001b3ULL;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    }
+    return h ^ (uint64_t)size;
+}
+
+SoundAsset* asset_cache_acquire(AssetCache* cache,
+                                const char* key,
+                                const void* data,
+                                size_t size,
+                                ma_format format,
+                                int channels,
+                                int sampleRate)
+{
+    if (!cache) return NULL;
+    if (!key && (!data || size == 0)) return NULL;
+
+    uint64_t hash = key ? ac_hash_key(key)
+                        : ac_hash_content(data, size, format, channels, sampleRate);
+    SoundAsset** bucket = &cache->buckets[hash % ASSET_CACHE_BUCKETS];
+
+    ma_mutex_lock(&cache->lock);
+    for (SoundAsset* a = *bucket; a; a = a->next) {
+        if (ac_matches(a, hash, key, data, size, format, channels, sampleRate)) {
+            sound_asset_retain(a);
+            ma_mutex_unlock(&cache->lock);
+            return a;
+        }
+    }
+    if (!data || size == 0) {
+        ma_mutex_unlock(&cache->lock);
+        return NULL;
+    }
+
+    SoundAsset* a = (SoundAsset*)calloc(1, sizeof(SoundAsset));
+    if (a) {
+        a->data = malloc(size);
+        a->key  = key ? (char*)malloc(strlen(key) + 1) : NULL;
+    }
+    if (!a || !a->data || (key && !a->key)) {
+        if (a) ac_destroy(a);
+        ma_mutex_unlock(&cache->lock);
+        return NULL;
+    }
+    memcpy(a->data, data, size);
+    if (key) strcpy(a->key, key);
+    a->hash       = hash;
+    a->size       = size;
+    a->format     = format;
+    a->channels   = channels;
+    a->sampleRate = sampleRate;
+    a->refCount   = 2; /* cache + caller */
+    a->next       = *bucket;
+    *bucket       = a;
+    cache->count++;
+    cache->bytes += size;
+    ma_mutex_unlock(&cache->lock);
+    return a;
+}
+
+int asset_cache_contains(AssetCache* cache, const char* key) {
+    if (!cache || !key) return 0;
+    uint64_t hash = ac_hash_key(key);
+    int found = 0;
+    ma_mutex_lock(&cache->lock);
+    for (SoundAsset* a = cache->buckets[hash % ASSET_CACHE_BUCKETS]; a; a = a->next) {
+        if (ac_matches(a, hash, key, NULL, 0, ma_format_unknown, 0, 0)) { found = 1; break; }
+    }
+    ma_mutex_unlock(&cache->lock);
+    return found;
+}
+
+int asset_cache_evict(AssetCache* cache, const char* key) {
+    if (!cache || !key) return 0;
+    uint64_t hash = ac_hash_key(key);
+    int removed = 0;
+    ma_mutex_lock(&cache->lock);
+    for (SoundAsset** link = &cache->buckets[hash % ASSET_CACHE_BUCKETS]; *link; link = &(*link)->next) {
+        if (ac_matches(*link, hash, key, NULL, 0, ma_format_unknown, 0, 0)) {
+            ac_unlink(cache, link);
+            removed = 1;
+            break;
+        }
+    }
+    ma_mutex_unlock(&cache->lock);
+    return removed;
+}
+
+uint64_t asset_cache_trim(AssetCache* cache) {
+    if (!cache) return 0;
+    uint64_t freed = 0;
+    ma_mutex_lock(&cache->lock);
+    for (int b = 0; b < ASSET_CACHE_BUCKETS; ++b) {
+        SoundAsset** link = &cache->buckets[b];
+        while (*link) {
+            /* Only the cache's own reference left. New references are only
+               handed out under the lock, so this cannot race upwards. */
+            if (au_load_u32(&(*link)->refCount) == 1) {
+                freed += (*link)->size;
+                ac_unlink(cache, link);
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+    ma_mutex_unlock(&cache->lock);
+    return freed;
+}
+
+void sound_asset_retain(SoundAsset* asset) {
+    if (asset) au_fetch_add_u32(&asset->refCount, 1);
+}
+
+void sound_asset_release(SoundAsset* asset) {
+    if (!asset) return;
+    if (au_fetch_add_u32(&asset->refCount, (uint32_t)-1) == 1) {
+        ac_destroy(asset);
+    }
+}
@@ -0,0 +1,217 @@
+#include "../include/audio_context.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*************
+ ** private **
+ *************/
+
+/* Two locks. ac_mutex guards the context, its references and config, and
+   is held across the slow calls: backend init and teardown, enumeration.
+   ac_lock guards only the device cache, so the getters never wait on a
+   backend; whoever replaces the cache holds both. ac_mutex is created on
+   first use, under ac_lock, and lives as long as the process. */
+static ma_spinlock      ac_lock = 0;
+static ma_mutex         ac_mutex;
+static int              ac_mutexReady = 0;
+static ma_context       ac_context;
+static uint32_t         ac_refs = 0;
+static int              ac_enumerated = 0;
+static uint32_t         ac_generation = 0;
+static AudioDeviceInfo* ac_playback = NULL;
+static uint32_t         ac_playbackCount = 0;
+static AudioDeviceInfo* ac_capture = NULL;
+static uint32_t         ac_captureCount = 0;
+static ma_backend       ac_backends[MA_BACKEND_COUNT];
+static uint32_t         ac_backendCount = 0; /* 0 = miniaudio's order */
+static ma_backend_callbacks ac_custom;      /* used when ac_customSet */
+static void*            ac_customUserData = NULL;
+static int              ac_customSet = 0;
+
+static int ac_lock_slow(void) {
+    ma_spinlock_lock(&ac_lock);
+    if (!ac_mutexReady) ac_mutexReady = ma_mutex_init(&ac_mutex) == MA_SUCCESS;
+    int const ready = ac_mutexReady;
+    ma_spinlock_unlock(&ac_lock);
+    if (ready) ma_mutex_lock(&ac_mutex);
+    return ready;
+}
+
+static void ac_unlock_slow(void) {
+    ma_mutex_unlock(&ac_mutex);
+}
+
+/* Swap in a new cache (NULL lists to empty it) and free the old one
+   outside the spinlock. Under ac_mutex. */
+static void ac_set_devices(AudioDeviceInfo* playback, uint32_t playbackCount,
+                           AudioDeviceInfo* capture, uint32_t captureCount, int enumerated) {
+    ma_spinlock_lock(&ac_lock);
+    AudioDeviceInfo* const oldPlayback = ac_playback;
+    AudioDeviceInfo* const oldCapture  = ac_capture;
+    ac_playback      = playback;
+    ac_playbackCount = playbackCount;
+    ac_capture       = capture;
+    ac_captureCount  = captureCount;
+    ac_enumerated    = enumerated;
+    if (enumerated) ac_generation++;
+    ma_spinlock_unlock(&ac_lock);
+    free(oldPlayback);
+    free(oldCapture);
+}
+
+static void ac_free_devices(void) {
+    ac_set_devices(NULL, 0, NULL, 0, 0);
+}
+
+static AudioDeviceInfo* ac_copy_devices(const ma_device_info* src, uint32_t count) {
+    if (count == 0) return NULL;
+    AudioDeviceInfo* dst = (AudioDeviceInfo*)calloc(count, sizeof(AudioDeviceInfo));
+    if (!dst) return NULL;
+    for (uint32_t i = 0; i < count; ++i) {
+        size_t n = strlen(src[i].name);
+        if (n >= sizeof(dst[i].name)) n = sizeof(dst[i].name) - 1;
+        memcpy(dst[i].name, src[i].name, n);
+        dst[i].id        = src[i].id;
+        dst[i].isDefault = src[i].isDefault;
+    }
+    return dst;
+}
+
+static int ac_enumerate(void) {
+    if (ac_refs == 0) return 0;
+
+    ma_device_info* pPlayback = NULL;
+    ma_device_info* pCapture  = NULL;
+    ma_uint32 playbackCount = 0, captureCount = 0;
+    if (ma_context_get_devices(&ac_context, &pPlayback, &playbackCount,
+                               &pCapture, &captureCount) != MA_SUCCESS) {
+        return 0;
+    }
+    /* The context owns those lists until its next enumeration; keep copies. */
+    AudioDeviceInfo* playback = ac_copy_devices(pPlayback, playbackCount);
+    AudioDeviceInfo* capture  = ac_copy_devices(pCapture, captureCount);
+    if ((playbackCount && !playback) || (captureCount && !capture)) {
+        free(playback);
+        free(capture);
+        return 0;
+    }
+    ac_set_devices(playback, playbackCount, capture, captureCount, 1);
+    return 1;
+}
+
+/************
+ ** public **
+ ************/
+
+ma_context* audio_context_acquire(void) {
+    ma_context* context = NULL;
+    if (!ac_lock_slow()) return NULL;
+    if (ac_refs == 0) {
+        ma_context_config cfg = ma_context_config_init();
+        if (ac_customSet) {
+            static const ma_backend custom = ma_backend_custom;
+            cfg.custom    = ac_custom;
+            cfg.pUserData = ac_customUserData;
+            if (ma_context_init(&custom, 1, &cfg, &ac_context) == MA_SUCCESS) ac_refs = 1;
+        } else if (ma_context_init(ac_backendCount ? ac_backends : NULL, ac_backendCount,
+                                   &cfg, &ac_context) == MA_SUCCESS) {
+            ac_refs = 1;
+        }
+    } else {
+        ac_refs++;
+    }
+    if (ac_refs > 0) context = &ac_context;
+    ac_unlock_slow();
+    return context;
+}
+
+void audio_context_release(void) {
+    if (!ac_lock_slow()) return;
+    if (ac_refs > 0 && --ac_refs == 0) {
+        ac_free_devices();
+        ma_context_uninit(&ac_context);
+    }
+    ac_unlock_slow();
+}
+
+int audio_context_prefer_backends(const ma_backend* backends, uint32_t count) {
+    ma_backend enabled[MA_BACKEND_COUNT];
+    size_t enabledCount = 0;
+    if (ma_get_enabled_backends(enabled, MA_BACKEND_COUNT, &enabledCount) != MA_SUCCESS) return 0;
+
+    int ok = 0;
+    if (!ac_lock_slow()) return 0;
+    if (ac_refs == 0) {
+        /* Preferred ones that are compiled in, then everything else. */
+        uint32_t n = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            for (size_t j = 0; j < enabledCount; ++j) {
+                if (enabled[j] == backends[i] && n < MA_BACKEND_COUNT) ac_backends[n++] = backends[i];
+            }
+        }
+        for (size_t j = 0; j < enabledCount; ++j) {
+            uint32_t k = 0;
+            while (k < n && ac_backends[k] != enabled[j]) k++;
+            if (k == n && n < MA_BACKEND_COUNT) ac_backends[n++] = enabled[j];
+        }
+        ac_backendCount = n;
+        ok = 1;
+    }
+    ac_unlock_slow();
+    return ok;
+}
+
+int audio_context_use_custom_backend(const ma_backend_callbacks* callbacks, void* user_data) {
+    int ok = 0;
+    if (!ac_lock_slow()) return 0;
+    if (ac_refs == 0) {
+        ac_customSet = callbacks != NULL;
+        if (callbacks) ac_custom = *callbacks;
+        ac_customUserData = user_data;
+        ok = 1;
+    }
+    ac_unlock_slow();
+    return ok;
+}
+
+int audio_context_ensure_devices(void) {
+    if (!ac_lock_slow()) return 0;
+    int const ok = ac_enumerated ? 1 : ac_enumerate();
+    ac_unlock_slow();
+    return ok;
+}
+
+int audio_context_refresh_devices(void) {
+    if (!ac_lock_slow()) return 0;
+    int const ok = ac_enumerate();
+    ac_unlock_slow();
+    return ok;
+}
+
+uint32_t audio_context_get_generation(void) {
+    ma_spinlock_lock(&ac_lock);
+    uint32_t const generation = ac_generation;
+    ma_spinlock_unlock(&ac_lock);
+    return generation;
+}
+
+uint32_t audio_context_get_device_count(ma_device_type type) {
+    ma_spinlock_lock(&ac_lock);
+    uint32_t const count = type == ma_device_type_capture ? ac_captureCount : ac_playbackCount;
+    ma_spinlock_unlock(&ac_lock);
+    return count;
+}
+
+int audio_context_get_device(ma_device_type type, uint32_t index, AudioDeviceInfo* out) {
+    if (!out) return 0;
+    int ok = 0;
+    ma_spinlock_lock(&ac_lock);
+    AudioDeviceInfo const* list = type == ma_device_type_capture ? ac_capture : ac_playback;
+    uint32_t const count = type == ma_device_type_capture ? ac_captureCount : ac_playbackCount;
+    if (index < count) {
+        *out = list[index];
+        ok = 1;
+    }
+    ma_spinlock_unlock(&ac_lock);
+    return ok;
+}
@@ -0,0 +1,594 @@
+#include "../include/capture_chain.h"
+#include "../include/atomic_util.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EC_CHUNK        256    /* frames handled per pass when pushing */
+#define EC_QUEUE_MS     250    /* reference queued ahead of the capture */
+#define EC_BLOCK        128    /* frames per adaptation, and taps per partition */
+#define EC_FFT          (2 * EC_BLOCK)
+#define EC_BINS         (EC_BLOCK + 1)
+#define EC_STEP         0.5f   /* NLMS step size */
+#define EC_DOUBLE_TALK  0.5f   /* Geigel threshold */
+#define EC_SILENCE      1e-4f  /* reference peak below which nothing adapts */
+#define EC_POWER_DECAY  0.9f   /* per-block smoothing of the reference spectrum */
+#define EC_REGULARIZE   0.01f  /* of the mean bin power, for near-empty bins */
+#define NS_BLOCK_MS     10
+#define NS_NOISE_RISE   1.0023f /* ~ +1 dB/s at 10 ms blocks */
+#define NS_RELEASE      0.3f
+#define NS_OVERSUBTRACT 4.0f   /* minima sit below the mean noise power */
+
+/*************
+ ** private **
+ *************/
+
+static void cc_lock(CaptureChain* c) {
+    while (!au_cas_u32(&c->lock, 0, 1)) { /* held briefly by the capture thread */ }
+}
+
+static void cc_unlock(CaptureChain* c) {
+    au_store_u32(&c->lock, 0);
+}
+
+/* Partitioned-block frequency-domain NLMS. The filter is split into
+   `partitions` blocks of EC_BLOCK taps, each kept as an EC_FFT-point
+   spectrum (overlap-save). Once per block the reference spectrum is taken,
+   every partition adapts on the block's error, normalized per bin, and
+   the echo of the partitions past the first is predicted for the next
+   block in one inverse transform. The first partition can only be known
+   sample by sample, so it is also kept in the time domain and applied per
+   frame: the capture is not delayed.
+
+   Adapting in the frequency domain lets the weights pick up circular
+   wrap-around; the first partition is constrained back to EC_BLOCK taps
+   every block, the others one per block in turn. */
+struct EchoCanceller {
+    uint32_t  sampleRate;
+    uint32_t  taps;         /* partitions * EC_BLOCK */
+    uint32_t  partitions;
+    float*    wr;           /* partitions x EC_BINS spectra */
+    float*    wi;
+    float*    xr;           /* last `partitions` reference spectra, a ring */
+    float*    xi;
+    uint32_t  xhead;        /* newest spectrum */
+    uint32_t  constrain;    /* next partition past the first to constrain */
+    float     power[EC_BINS];
+    float     w0[EC_BLOCK];     /* first partition, newest tap last */
+    float     xtime[EC_FFT];    /* previous block, then the current one */
+    float     yrest[EC_BLOCK];  /* echo of the other partitions, this block */
+    float     err[EC_BLOCK];    /* 0 where the frame may not adapt */
+    uint32_t  fill;             /* frames into the block */
+    uint32_t  adapting;         /* frames of the block that may adapt */
+
+    /* Geigel detector: sliding maximum of |reference| over the filter. */
+    float*    peakValue;
+    uint32_t* peakIndex;
+    uint32_t  peakHead;
+    uint32_t  peakCount;
+    uint32_t  tick;
+
+    /* Transform scratch and tables. */
+    float     re[EC_FFT];
+    float     im[EC_FFT];
+    float     cosTable[EC_FFT / 2];
+    float     sinTable[EC_FFT / 2];
+    uint16_t  bitrev[EC_FFT];
+
+    /* Pushed reference, mono at sampleRate. */
+    ma_pcm_rb           queue;
+    ma_linear_resampler resampler;
+    int                 resamplerReady;
+    uint32_t            referenceRate;
+    float               mono[EC_CHUNK];
+    float               resampled[EC_CHUNK];
+
+    float             nearEnergy;
+    float             outEnergy;
+    volatile uint32_t erle; /* float bits */
+};
+
+static void ec_reset_resampler(EchoCanceller* ec) {
+    if (!ec->resamplerReady) return;
+    ma_linear_resampler_uninit(&ec->resampler, NULL);
+    ec->resamplerReady = 0;
+}
+
+static void ec_init_tables(EchoCanceller* ec) {
+    for (uint32_t k = 0; k < EC_FFT / 2; ++k) {
+        double const a = 2.0 * 3.14159265358979323846 * k / EC_FFT;
+        ec->cosTable[k] = (float)cos(a);
+        ec->sinTable[k] = (float)sin(a);
+    }
+    uint32_t bits = 0;
+    while ((1u << bits) < EC_FFT) ++bits;
+    for (uint32_t i = 0; i < EC_FFT; ++i) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; ++b) r |= ((i >> b) & 1u) << (bits - 1 - b);
+        ec->bitrev[i] = (uint16_t)r;
+    }
+}
+
+/* In place on ec->re/im, radix 2. The inverse is not scaled. */
+static void ec_fft(EchoCanceller* ec, int inverse) {
+    float* const re = ec->re;
+    float* const im = ec->im;
+    for (uint32_t i = 0; i < EC_FFT; ++i) {
+        uint32_t const j = ec->bitrev[i];
+        if (j <= i) continue;
+        float t = re[i]; re[i] = re[j]; re[j] = t;
+        t = im[i]; im[i] = im[j]; im[j] = t;
+    }
+    float const sign = inverse ? 1.0f : -1.0f;
+    for (uint32_t len = 2; len <= EC_FFT; len <<= 1) {
+        uint32_t const half = len / 2, step = EC_FFT / len;
+        for (uint32_t i = 0; i < EC_FFT; i += len) {
+            for (uint32_t k = 0; k < half; ++k) {
+                float const c = ec->cosTable[k * step];
+                float const s = sign * ec->sinTable[k * step];
+                uint32_t const a = i + k, b = a + half;
+                float const tr = re[b] * c - im[b] * s;
+                float const ti = re[b] * s + im[b] * c;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+/* Spectra (bins 0..EC_BLOCK) of two real sequences in one transform. */
+static void ec_forward2(EchoCanceller* ec, const float* a, const float* b,
+                        float* ar, float* ai, float* br, float* bi) {
+    memcpy(ec->re, a, sizeof(ec->re));
+    memcpy(ec->im, b, sizeof(ec->im));
+    ec_fft(ec, 0);
+    for (uint32_t f = 0; f < EC_BINS; ++f) {
+        uint32_t const g = (EC_FFT - f) & (EC_FFT - 1);
+        float const zr = ec->re[f], zi = ec->im[f], yr = ec->re[g], yi = ec->im[g];
+        ar[f] = 0.5f * (zr + yr);
+        ai[f] = 0.5f * (zi - yi);
+        br[f] = 0.5f * (zi + yi);
+        bi[f] = 0.5f * (yr - zr);
+    }
+}
+
+/* The reverse: two real sequences, scaled, into ec->re and ec->im. The
+   second spectrum may be NULL. */
+static void ec_inverse2(EchoCanceller* ec, const float* ar, const float* ai,
+                        const float* br, const float* bi) {
+    for (uint32_t f = 0; f < EC_BINS; ++f) {
+        float const r2 = br ? br[f] : 0.0f, i2 = br ? bi[f] : 0.0f;
+        ec->re[f] = ar[f] - i2;
+        ec->im[f] = ai[f] + r2;
+        if (f == 0 || f == EC_BLOCK) continue;
+        ec->re[EC_FFT - f] = ar[f] + i2;
+        ec->im[EC_FFT - f] = r2 - ai[f];
+    }
+    ec_fft(ec, 1);
+    float const scale = 1.0f / EC_FFT;
+    for (uint32_t i = 0; i < EC_FFT; ++i) {
+        ec->re[i] *= scale;
+        ec->im[i] *= scale;
+    }
+}
+
+/* Cut two partitions' impulse responses back to EC_BLOCK taps. p may
+   equal q. Returns the first one's taps in ec->re. */
+static void ec_constrain(EchoCanceller* ec, uint32_t p, uint32_t q) {
+    float* const pr = ec->wr + (size_t)p * EC_BINS;
+    float* const pi = ec->wi + (size_t)p * EC_BINS;
+    float* const qr = ec->wr + (size_t)q * EC_BINS;
+    float* const qi = ec->wi + (size_t)q * EC_BINS;
+    ec_inverse2(ec, pr, pi, p == q ? NULL : qr, p == q ? NULL : qi);
+    float a[EC_FFT], b[EC_FFT];
+    memcpy(a, ec->re, EC_BLOCK * sizeof(float));
+    memcpy(b, ec->im, EC_BLOCK * sizeof(float));
+    memset(a + EC_BLOCK, 0, EC_BLOCK * sizeof(float));
+    memset(b + EC_BLOCK, 0, EC_BLOCK * sizeof(float));
+    float sr[EC_BINS], si[EC_BINS];
+    ec_forward2(ec, a, b, pr, pi, sr, si);
+    if (p != q) {
+        memcpy(qr, sr, sizeof(sr));
+        memcpy(qi, si, sizeof(si));
+    }
+    memcpy(ec->re, a, EC_BLOCK * sizeof(float));
+}
+
+/* Sliding maximum of |reference| over the filter: a deque of decreasing
+   values, as the limiter's minimum in effects.c. */
+static float ec_track_peak(EchoCanceller* ec, float x) {
+    uint32_t const cap = ec->taps;
+    float const a = fabsf(x);
+    while (ec->peakCount > 0 &&
+           ec->peakValue[(ec->peakHead + ec->peakCount - 1) % cap] <= a) {
+        --ec->peakCount;
+    }
+    uint32_t const back = (ec->peakHead + ec->peakCount) % cap;
+    ec->peakValue[back] = a;
+    ec->peakIndex[back] = ec->tick;
+    ++ec->peakCount;
+    while (ec->tick - ec->peakIndex[ec->peakHead] >= cap) {
+        ec->peakHead = (ec->peakHead + 1) % cap;
+        --ec->peakCount;
+    }
+    ++ec->tick;
+    return ec->peakValue[ec->peakHead];
+}
+
+/* End of a block: adapt on its error, then predict the next block's echo
+   from every partition but the first. */
+static void ec_block(EchoCanceller* ec) {
+    uint32_t const parts = ec->partitions;
+    ec->xhead = ec->xhead + 1 == parts ? 0 : ec->xhead + 1;
+    float* const xr = ec->xr + (size_t)ec->xhead * EC_BINS;
+    float* const xi = ec->xi + (size_t)ec->xhead * EC_BINS;
+    float e[EC_FFT];
+    float er[EC_BINS], ei[EC_BINS];
+    memset(e, 0, EC_BLOCK * sizeof(float));
+    memcpy(e + EC_BLOCK, ec->err, EC_BLOCK * sizeof(float));
+    ec_forward2(ec, ec->xtime, e, xr, xi, er, ei);
+
+    float mean = 0.0f;
+    for (uint32_t f = 0; f < EC_BINS; ++f) {
+        float const p = xr[f] * xr[f] + xi[f] * xi[f];
+        ec->power[f] = EC_POWER_DECAY * ec->power[f] + (1.0f - EC_POWER_DECAY) * p;
+        mean += ec->power[f];
+    }
+    mean /= EC_BINS;
+
+    if (ec->adapting > 0) {
+        /* Block NLMS, per bin: the step of EC_STEP over the whole filter. */
+        float const reg = EC_REGULARIZE * mean + 1e-12f;
+        float const gain = 2.0f * EC_STEP / (float)parts;
+        for (uint32_t f = 0; f < EC_BINS; ++f) {
+            float const g = gain / (ec->power[f] + reg);
+            er[f] *= g;
+            ei[f] *= g;
+        }
+        for (uint32_t p = 0; p < parts; ++p) {
+            uint32_t const slot = (ec->xhead + parts - p) % parts;
+            const float* const sr = ec->xr + (size_t)slot * EC_BINS;
+            const float* const si = ec->xi + (size_t)slot * EC_BINS;
+            float* const wr = ec->wr + (size_t)p * EC_BINS;
+            float* const wi = ec->wi + (size_t)p * EC_BINS;
+            for (uint32_t f = 0; f < EC_BINS; ++f) {
+                /* conj(X) * E */
+                wr[f] += sr[f] * er[f] + si[f] * ei[f];
+                wi[f] += sr[f] * ei[f] - si[f] * er[f];
+            }
+        }
+        uint32_t q = 0;
+        if (parts > 1) {
+            q = ec->constrain;
+            ec->constrain = q + 1 == parts ? 1 : q + 1;
+        }
+        ec_constrain(ec, 0, q);
+        for (uint32_t k = 0; k < EC_BLOCK; ++k) ec->w0[k] = ec->re[EC_BLOCK - 1 - k];
+    }
+    ec->adapting = 0;
+
+    /* Partition p reaches the next block through the spectrum p - 1 blocks
+       older than this one. */
+    float yr[EC_BINS], yi[EC_BINS];
+    memset(yr, 0, sizeof(yr));
+    memset(yi, 0, sizeof(yi));
+    for (uint32_t p = 1; p < parts; ++p) {
+        uint32_t const slot = (ec->xhead + parts - (p - 1)) % parts;
+        const float* const sr = ec->xr + (size_t)slot * EC_BINS;
+        const float* const si = ec->xi + (size_t)slot * EC_BINS;
+        const float* const wr = ec->wr + (size_t)p * EC_BINS;
+        const float* const wi = ec->wi + (size_t)p * EC_BINS;
+        for (uint32_t f = 0; f < EC_BINS; ++f) {
+            yr[f] += wr[f] * sr[f] - wi[f] * si[f];
+            yi[f] += wr[f] * si[f] + wi[f] * sr[f];
+        }
+    }
+    if (parts > 1) {
+        ec_inverse2(ec, yr, yi, NULL, NULL);
+        memcpy(ec->yrest, ec->re + EC_BLOCK, sizeof(ec->yrest));
+    }
+    memmove(ec->xtime, ec->xtime + EC_BLOCK, EC_BLOCK * sizeof(float));
+}
+
+struct NoiseSuppressor {
+    uint32_t          block;   /* frames per estimate */
+    volatile uint32_t floor;   /* float bits: lowest gain */
+    float             noise;   /* mean square of the noise floor */
+    float             gain;
+};
+
+/************
+ ** public **
+ ************/
+
+void capture_chain_init(CaptureChain* chain) {
+    memset(chain, 0, sizeof(*chain));
+    chain->nextId = 1;
+}
+
+uint32_t capture_chain_add(CaptureChain* chain, int order, CaptureProcessFn fn, void* user_data) {
+    if (!chain || !fn) return 0;
+    cc_lock(chain);
+    if (chain->count == CAPTURE_CHAIN_MAX_STAGES) {
+        cc_unlock(chain);
+        return 0;
+    }
+    /* Keep the list sorted; equal orders run in the order added. */
+    uint32_t at = chain->count;
+    while (at > 0 && chain->stages[at - 1].order > order) {
+        chain->stages[at] = chain->stages[at - 1];
+        at--;
+    }
+    CaptureStage* s = &chain->stages[at];
+    s->fn        = fn;
+    s->user_data = user_data;
+    s->order     = order;
+    s->id        = chain->nextId++;
+    chain->count++;
+    uint32_t const id = s->id;
+    cc_unlock(chain);
+    return id;
+}
+
+int capture_chain_remove(CaptureChain* chain, uint32_t id) {
+    if (!chain || id == 0) return 0;
+    int found = 0;
+    cc_lock(chain);
+    for (uint32_t i = 0; i < chain->count; ++i) {
+        if (chain->stages[i].id != id) continue;
+        memmove(&chain->stages[i], &chain->stages[i + 1],
+                (chain->count - i - 1) * sizeof(CaptureStage));
+        chain->count--;
+        found = 1;
+        break;
+    }
+    cc_unlock(chain);
+    return found;
+}
+
+uint32_t capture_chain_count(CaptureChain* chain) {
+    return chain ? au_load_u32(&chain->count) : 0;
+}
+
+void capture_chain_process(CaptureChain* chain, float* frames, uint32_t frame_count, uint32_t channels) {
+    if (!au_cas_u32(&chain->lock, 0, 1)) return; /* being edited */
+    for (uint32_t i = 0; i < chain->count; ++i) {
+        chain->stages[i].fn(chain->stages[i].user_data, frames, frame_count, channels);
+    }
+    cc_unlock(chain);
+}
+
+EchoCanceller* echo_canceller_create(uint32_t sample_rate, uint32_t filter_ms) {
+    if (sample_rate == 0) return NULL;
+    if (filter_ms == 0) filter_ms = ECHO_CANCELLER_DEFAULT_MS;
+
+    EchoCanceller* ec = (EchoCanceller*)calloc(1, sizeof(EchoCanceller));
+    if (!ec) return NULL;
+    ec->sampleRate = sample_rate;
+    uint32_t const taps = sample_rate * filter_ms / 1000;
+    ec->partitions = taps > EC_BLOCK ? (taps + EC_BLOCK - 1) / EC_BLOCK : 1;
+    ec->taps = ec->partitions * EC_BLOCK;
+    size_t const bins = (size_t)ec->partitions * EC_BINS;
+    ec->wr = (float*)calloc(bins, sizeof(float));
+    ec->wi = (float*)calloc(bins, sizeof(float));
+    ec->xr = (float*)calloc(bins, sizeof(float));
+    ec->xi = (float*)calloc(bins, sizeof(float));
+    ec->peakValue = (float*)calloc(ec->taps, sizeof(float));
+    ec->peakIndex = (uint32_t*)calloc(ec->taps, sizeof(uint32_t));
+    ma_uint32 const queueFrames = sample_rate * EC_QUEUE_MS / 1000 * 2;
+    if (!ec->wr || !ec->wi || !ec->xr || !ec->xi || !ec->peakValue || !ec->peakIndex ||
+        ma_pcm_rb_init(ma_format_f32, 1, queueFrames, NULL, NULL, &ec->queue) != MA_SUCCESS) {
+        free(ec->wr);
+        free(ec->wi);
+        free(ec->xr);
+        free(ec->xi);
+        free(ec->peakValue);
+        free(ec->peakIndex);
+        free(ec);
+        return NULL;
+    }
+    ec->constrain = 1;
+    ec_init_tables(ec);
+    ec->referenceRate = sample_rate;
+    return ec;
+}
+
+void echo_canceller_destroy(EchoCanceller* ec) {
+    if (!ec) return;
+    ec_reset_resampler(ec);
+    ma_pcm_rb_uninit(&ec->queue);
+    free(ec->wr);
+    free(ec->wi);
+    free(ec->xr);
+    free(ec->xi);
+    free(ec->peakValue);
+    free(ec->peakIndex);
+    free(ec);
+}
+
+void echo_canceller_process(EchoCanceller* ec, float* capture, const float* reference,
+                            uint32_t frame_count, uint32_t channels) {
+    if (!ec || !capture || channels == 0) return;
+    float nearEnergy = 0.0f, outEnergy = 0.0f;
+
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        float* frame = capture + (size_t)i * channels;
+        uint32_t const j = ec->fill;
+
+        float const x = reference ? reference[i] : 0.0f;
+        ec->xtime[EC_BLOCK + j] = x;
+        float const peak = ec_track_peak(ec, x);
+
+        /* The first partition here, the rest predicted by the last block. */
+        const float* const h = ec->xtime + j + 1;
+        float y = ec->yrest[j];
+        for (uint32_t k = 0; k < EC_BLOCK; ++k) y += ec->w0[k] * h[k];
+
+        float d = 0.0f;
+        for (uint32_t c = 0; c < channels; ++c) d += frame[c];
+        d /= (float)channels;
+        float const e = d - y;
+        for (uint32_t c = 0; c < channels; ++c) frame[c] -= y;
+
+        nearEnergy += d * d;
+        outEnergy  += e * e;
+
+        /* Double talk or no reference: this frame does not adapt. */
+        int const adapt = peak >= EC_SILENCE && fabsf(d) < EC_DOUBLE_TALK * peak;
+        ec->err[j] = adapt ? e : 0.0f;
+        ec->adapting += (uint32_t)adapt;
+        if (++ec->fill == EC_BLOCK) {
+            ec->fill = 0;
+            ec_block(ec);
+        }
+    }
+
+    ec->nearEnergy = 0.9f * ec->nearEnergy + 0.1f * nearEnergy;
+    ec->outEnergy  = 0.9f * ec->outEnergy  + 0.1f * outEnergy;
+    au_store_f32(&ec->erle, 10.0f * log10f((ec->nearEnergy + 1e-9f) / (ec->outEnergy + 1e-9f)));
+}
+
+int echo_canceller_set_reference_rate(EchoCanceller* ec, uint32_t sample_rate) {
+    if (!ec || sample_rate == 0) return 0;
+    ec_reset_resampler(ec);
+    ec->referenceRate = sample_rate;
+    if (sample_rate == ec->sampleRate) return 1;
+    ma_linear_resampler_config cfg =
+        ma_linear_resampler_config_init(ma_format_f32, 1, sample_rate, ec->sampleRate);
+    ec->resamplerReady = ma_linear_resampler_init(&cfg, NULL, &ec->resampler) == MA_SUCCESS;
+    return ec->resamplerReady;
+}
+
+static void ec_queue(EchoCanceller* ec, const float* frames, uint32_t count) {
+    while (count > 0) {
+        ma_uint32 n = count;
+        void* dst = NULL;
+        if (ma_pcm_rb_acquire_write(&ec->queue, &n, &dst) != MA_SUCCESS || n == 0) return;
+        memcpy(dst, frames, n * sizeof(float));
+        ma_pcm_rb_commit_write(&ec->queue, n);
+        frames += n;
+        count -= n;
+    }
+}
+
+void echo_canceller_push_reference(EchoCanceller* ec, const float* frames,
+                                   uint32_t frame_count, uint32_t channels) {
+    if (!ec || !frames || channels == 0) return;
+    if (ec->referenceRate != ec->sampleRate && !ec->resamplerReady) return;
+
+    while (frame_count > 0) {
+        uint32_t const n = frame_count < EC_CHUNK ? frame_count : EC_CHUNK;
+        for (uint32_t i = 0; i < n; ++i) {
+            float s = 0.0f;
+            for (uint32_t c = 0; c < channels; ++c) s += frames[(size_t)i * channels + c];
+            ec->mono[i] = s / (float)channels;
+        }
+        if (!ec->resamplerReady) {
+            ec_queue(ec, ec->mono, n);
+        } else {
+            ma_uint64 consumed = 0;
+            while (consumed < n) {
+                ma_uint64 in = n - consumed;
+                ma_uint64 out = EC_CHUNK;
+                ma_linear_resampler_process_pcm_frames(&ec->resampler, ec->mono + consumed, &in,
+                                                       ec->resampled, &out);
+                ec_queue(ec, ec->resampled, (uint32_t)out);
+                if (in == 0 && out == 0) break;
+                consumed += in;
+            }
+        }
+        frames += (size_t)n * channels;
+        frame_count -= n;
+    }
+}
+
+void echo_canceller_process_queued(void* user_data, float* capture,
+                                   uint32_t frame_count, uint32_t channels) {
+    EchoCanceller* ec = (EchoCanceller*)user_data;
+    if (!ec) return;
+
+    /* The two devices run on their own clocks; if playback got ahead by
+       more than the filter can model, drop the excess and re-converge. */
+    ma_uint32 const queued = ma_pcm_rb_available_read(&ec->queue);
+    ma_uint32 const slack = ec->taps / 2 + frame_count;
+    if (queued > slack) ma_pcm_rb_seek_read(&ec->queue, queued - slack);
+
+    uint32_t done = 0;
+    while (done < frame_count) {
+        ma_uint32 n = frame_count - done;
+        void* src = NULL;
+        if (ma_pcm_rb_acquire_read(&ec->queue, &n, &src) != MA_SUCCESS || n == 0) break;
+        echo_canceller_process(ec, capture + (size_t)done * channels, (const float*)src, n, channels);
+        ma_pcm_rb_commit_read(&ec->queue, n);
+        done += n;
+    }
+    /* Nothing played for the rest: still run it so the window moves on. */
+    if (done < frame_count) {
+        echo_canceller_process(ec, capture + (size_t)done * channels, NULL, frame_count - done, channels);
+    }
+}
+
+float echo_canceller_get_erle(EchoCanceller* ec) {
+    return ec ? au_load_f32(&ec->erle) : 0.0f;
+}
+
+NoiseSuppressor* noise_suppressor_create(uint32_t sample_rate, float reduction_db) {
+    if (sample_rate == 0) return NULL;
+    NoiseSuppressor* ns = (NoiseSuppressor*)calloc(1, sizeof(NoiseSuppressor));
+    if (!ns) return NULL;
+    ns->block = sample_rate * NS_BLOCK_MS / 1000;
+    if (ns->block == 0) ns->block = 1;
+    ns->gain = 1.0f;
+    noise_suppressor_set_reduction(ns, reduction_db);
+    return ns;
+}
+
+void noise_suppressor_destroy(NoiseSuppressor* ns) {
+    free(ns);
+}
+
+void noise_suppressor_set_reduction(NoiseSuppressor* ns, float reduction_db) {
+    if (!ns) return;
+    if (reduction_db < 0.0f) reduction_db = 0.0f;
+    au_store_f32(&ns->floor, powf(10.0f, -reduction_db / 20.0f));
+}
+
+void noise_suppressor_process(void* user_data, float* frames,
+                              uint32_t frame_count, uint32_t channels) {
+    NoiseSuppressor* ns = (NoiseSuppressor*)user_data;
+    if (!ns || !frames || channels == 0) return;
+    float const floor = au_load_f32(&ns->floor);
+
+    while (frame_count > 0) {
+        uint32_t const n = frame_count < ns->block ? frame_count : ns->block;
+        size_t const samples = (size_t)n * channels;
+
+        float energy = 0.0f;
+        for (size_t i = 0; i < samples; ++i) energy += frames[i] * frames[i];
+        energy /= (float)samples;
+
+        /* Minimum tracking: fall at once, creep up slowly. */
+        if (ns->noise == 0.0f || energy < ns->noise) ns->noise = energy;
+        else ns->noise *= NS_NOISE_RISE;
+
+        /* Power subtraction gain, as amplitude. */
+        float target = energy > 0.0f ? 1.0f - NS_OVERSUBTRACT * ns->noise / energy : 0.0f;
+        target = target > 0.0f ? sqrtf(target) : 0.0f;
+        if (target < floor) target = floor;
+        float const next = target > ns->gain ? target : ns->gain + (target - ns->gain) * NS_RELEASE;
+
+        /* Ramp across the block so gain changes never click. */
+        float const step = (next - ns->gain) / (float)n;
+        float g = ns->gain;
+        for (uint32_t i = 0; i < n; ++i) {
+            g += step;
+            for (uint32_t c = 0; c < channels; ++c) frames[(size_t)i * channels + c] *= g;
+        }
+        ns->gain = next;
+
+        frames += samples;
+        frame_count -= n;
+    }
+}
@@ -49,6 +49,13 @@ static int opus_encode_wrap(Codec* c,const void* pcmFrames,int frameCount,uint8_
     return ret;
 }
 
+int codec_opus_set_complexity(Codec* c, int complexity){
+    if(!c || c->vt.id!=CODEC_ID_OPUS) return 0;
+    OpusPair* p=(OpusPair*)c->impl;
+    if(!p || !p->enc) return 0;
+    return opus_encoder_ctl(p->enc, OPUS_SET_COMPLEXITY(complexity))==OPUS_OK;
+}
+
 static int opus_decode_wrap(Codec* c,const uint8_t* packet,int packetLen,void* pcmOut,int maxFrames){
     OpusPair* p=(OpusPair*)c->impl;
     if(!p)return -1;
@@ -1,4 +1,5 @@
 #include "../include/crosscoder.h"
+#include "../include/codec_opus_diag.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -379,8 +380,10 @@ int crosscoder_set_complexity(CrossCoder* cc, int complexity) {
     if (complexity < 0) complexity = 0;
     if (complexity > 10) complexity = 10;
     cc->complexity = complexity;
+    if (cc->codec && cc->codecId == CODEC_ID_OPUS) {
+        codec_opus_set_complexity(cc->codec, complexity);
+    }
     
-    /* Store for next codec recreation */
     ma_mutex_unlock(&cc->lock);
     return 1;
 }
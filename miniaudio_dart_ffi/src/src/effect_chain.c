@@ -0,0 +1,84 @@
+#include "../include/effect_chain.h"
+#include <string.h>
+
+/*************
+ ** private **
+ *************/
+
+static ma_node* ec_next(const EffectChain* chain, uint32_t i) {
+    return i + 1 < chain->count ? chain->effects[i + 1] : chain->target;
+}
+
+static int ec_find(const EffectChain* chain, ma_node* effect) {
+    for (uint32_t i = 0; i < chain->count; ++i) {
+        if (chain->effects[i] == effect) return (int)i;
+    }
+    return -1;
+}
+
+/* Links into effects[i] (or the target past the end) from whatever feeds it. */
+static void ec_link_into(EffectChain* chain, uint32_t i) {
+    ma_node* const node = i < chain->count ? chain->effects[i] : chain->target;
+    if (i == 0) {
+        if (chain->route) chain->route(chain->owner, node);
+    } else {
+        ma_node_attach_output_bus(chain->effects[i - 1], 0, node, 0);
+    }
+}
+
+/************
+ ** public **
+ ************/
+
+void effect_chain_init(EffectChain* chain, ma_node* target, EffectChainRoute route, void* owner) {
+    memset(chain, 0, sizeof(*chain));
+    chain->target = target;
+    chain->route  = route;
+    chain->owner  = owner;
+}
+
+ma_node* effect_chain_input(const EffectChain* chain) {
+    return chain->count > 0 ? chain->effects[0] : chain->target;
+}
+
+int effect_chain_insert(EffectChain* chain, ma_node* effect, int index) {
+    if (!chain || !effect || chain->count == EFFECT_CHAIN_MAX) return 0;
+    if (ec_find(chain, effect) >= 0) return 0;
+    if (ma_node_get_node_graph(effect) != ma_node_get_node_graph(chain->target)) return 0;
+    uint32_t const at = (index < 0 || (uint32_t)index > chain->count) ? chain->count : (uint32_t)index;
+
+    memmove(&chain->effects[at + 1], &chain->effects[at],
+            (chain->count - at) * sizeof(ma_node*));
+    chain->effects[at] = effect;
+    chain->count++;
+    /* Downstream first, so the new effect has somewhere to go before
+       anything reaches it. */
+    ma_node_attach_output_bus(effect, 0, ec_next(chain, at), 0);
+    ec_link_into(chain, at);
+    return 1;
+}
+
+int effect_chain_remove(EffectChain* chain, ma_node* effect) {
+    if (!chain || !effect) return 0;
+    int const found = ec_find(chain, effect);
+    if (found < 0) return 0;
+    uint32_t const at = (uint32_t)found;
+
+    memmove(&chain->effects[at], &chain->effects[at + 1],
+            (chain->count - at - 1) * sizeof(ma_node*));
+    chain->count--;
+    ec_link_into(chain, at);  /* bypass it, then cut it loose */
+    ma_node_detach_output_bus(effect, 0);
+    return 1;
+}
+
+void effect_chain_clear(EffectChain* chain) {
+    if (!chain) return;
+    while (chain->count > 0) effect_chain_remove(chain, chain->effects[chain->count - 1]);
+}
+
+void effect_chain_set_target(EffectChain* chain, ma_node* target) {
+    if (!chain || !target) return;
+    chain->target = target;
+    ec_link_into(chain, chain->count);
+}
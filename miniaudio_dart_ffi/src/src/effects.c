@@ -0,0 +1,752 @@
+#include "../include/effects.h"
+#include "../include/atomic_util.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The per-sample work is written as plain loops over fixed-size or
+   restrict-qualified arrays (gain, mix, the FDN's 8 lanes), which
+   compilers vectorize for every target the plugin builds for (wasm with
+   -msimd128, set in CMakeLists.txt). The envelope followers and biquads
+   are recursive in time and stay scalar. */
+
+#if defined(_MSC_VER)
+#define EFFECT_RESTRICT __restrict
+#else
+#define EFFECT_RESTRICT __restrict__
+#endif
+
+#define EFFECT_PI           3.14159265358979323846
+#define EFFECT_LINES        8
+#define EFFECT_DENORMAL     1e-18f
+#define EFFECT_SILENCE_DB   -160.0f
+#define EFFECT_DB_PER_LOG2  6.0205999f /* 20 * log10(2) */
+
+/* FDN line lengths in frames at 48 kHz, mutually prime, scaled to the
+   engine rate. */
+static const uint32_t k_line_frames[EFFECT_LINES] = {
+    1433, 1601, 1867, 2053, 2251, 2399, 2617, 2797
+};
+
+typedef struct EffectParamSpec {
+    float min;
+    float max;
+    float def;
+    int   smooth;
+} EffectParamSpec;
+
+typedef struct EffectDynamics {
+    float*    delay;       /* lookahead ring, interleaved */
+    uint32_t  ring;        /* ring size in frames */
+    uint32_t  pos;
+    uint32_t  lookahead;   /* frames */
+    float     attack;      /* per-frame coefficients */
+    float     release;
+    float     env;         /* compressor: smoothed reduction, dB <= 0 */
+    /* Limiter: release-smoothed required gain, then a sliding minimum and
+       a moving average over lookahead + 1 frames. */
+    float     held;
+    float*    minValue;
+    uint32_t* minIndex;
+    uint32_t  minHead;
+    uint32_t  minCount;
+    uint32_t  tick;
+    float*    box;
+    uint32_t  boxPos;
+    double    boxSum;
+} EffectDynamics;
+
+typedef struct EffectReverb {
+    float*   line[EFFECT_LINES];
+    uint32_t length[EFFECT_LINES];
+    uint32_t pos[EFFECT_LINES];
+    float    state[EFFECT_LINES];    /* damping low-pass */
+    float    feedback[EFFECT_LINES];
+    float    damping;
+    float*   predelay;
+    uint32_t predelayRing;
+    uint32_t predelayPos;
+    uint32_t predelayFrames;
+    float    denormal;
+} EffectReverb;
+
+struct Effect {
+    ma_node_base      base;     /* first, so an Effect* is an ma_node* */
+    EffectType        type;
+    uint32_t          channels;
+    uint32_t          sampleRate;
+
+    /* Control side: targets as f32 bits, and a version bumped after each
+       store so the audio thread only rescans on change. */
+    volatile uint32_t target[EFFECT_PARAM_COUNT];
+    volatile uint32_t version;
+    volatile uint32_t resetRequested;
+    volatile uint32_t reduction; /* f32 bits, dB */
+
+    /* Audio side. */
+    float             value[EFFECT_PARAM_COUNT];
+    uint32_t          seen;
+    int               settling;
+    int               primed;
+    float             smooth;   /* one-pole coefficient per block */
+    float*            dry;      /* EFFECT_BLOCK frames */
+    float             gain[EFFECT_BLOCK];
+    float             peak[EFFECT_BLOCK];
+
+    ma_biquad         eq[EFFECT_EQ_BANDS];
+    int               eqType[EFFECT_EQ_BANDS];
+    int               eqActive[EFFECT_EQ_BANDS];
+    EffectDynamics    dyn;
+    EffectReverb      rev;
+
+    float*            memory;
+    int               initialized;
+};
+
+/*************
+ ** private **
+ *************/
+
+static int effect_param_spec(EffectType type, int param, EffectParamSpec* spec) {
+    EffectParamSpec s = { 0.0f, 1.0f, 1.0f, 1 };
+    if (param == EFFECT_PARAM_MIX) {
+        if (type == EFFECT_REVERB) s.def = 0.3f;
+        *spec = s;
+        return 1;
+    }
+    switch (type) {
+    case EFFECT_EQ: {
+        if (param < EFFECT_PARAM_EQ_FIRST ||
+            param >= EFFECT_PARAM_EQ(EFFECT_EQ_BANDS, 0)) return 0;
+        int const band = (param - EFFECT_PARAM_EQ_FIRST) / EFFECT_EQ_FIELDS;
+        /* Low shelf, two peaks, high shelf; flat until a gain is set. */
+        static const float k_freq[EFFECT_EQ_BANDS] = { 100.0f, 500.0f, 2500.0f, 8000.0f };
+        static const int k_type[EFFECT_EQ_BANDS] = {
+            EFFECT_EQ_LOW_SHELF, EFFECT_EQ_PEAK, EFFECT_EQ_PEAK, EFFECT_EQ_HIGH_SHELF
+        };
+        switch ((param - EFFECT_PARAM_EQ_FIRST) % EFFECT_EQ_FIELDS) {
+        case EFFECT_EQ_TYPE:
+            s.min = EFFECT_EQ_OFF; s.max = EFFECT_EQ_HIGH_PASS;
+            s.def = (float)k_type[band]; s.smooth = 0;
+            break;
+        case EFFECT_EQ_FREQUENCY: s.min = 10.0f;  s.max = 24000.0f; s.def = k_freq[band]; break;
+        case EFFECT_EQ_GAIN:      s.min = -24.0f; s.max = 24.0f;    s.def = 0.0f; break;
+        default:                  s.min = 0.1f;   s.max = 20.0f;    s.def = 0.707f; break;
+        }
+        break;
+    }
+    case EFFECT_COMPRESSOR:
+        switch (param) {
+        case EFFECT_PARAM_THRESHOLD: s.min = -60.0f; s.max = 0.0f;    s.def = -18.0f; break;
+        case EFFECT_PARAM_RATIO:     s.min = 1.0f;   s.max = 20.0f;   s.def = 4.0f; break;
+        case EFFECT_PARAM_KNEE:      s.min = 0.0f;   s.max = 24.0f;   s.def = 6.0f; break;
+        case EFFECT_PARAM_ATTACK:    s.min = 0.1f;   s.max = 500.0f;  s.def = 10.0f; s.smooth = 0; break;
+        case EFFECT_PARAM_RELEASE:   s.min = 1.0f;   s.max = 5000.0f; s.def = 100.0f; s.smooth = 0; break;
+        case EFFECT_PARAM_MAKEUP:    s.min = -24.0f; s.max = 24.0f;   s.def = 0.0f; break;
+        case EFFECT_PARAM_LOOKAHEAD:
+            s.min = 0.0f; s.max = EFFECT_MAX_LOOKAHEAD_MS; s.def = 0.0f; s.smooth = 0;
+            break;
+        default: return 0;
+        }
+        break;
+    case EFFECT_LIMITER:
+        switch (param) {
+        case EFFECT_PARAM_CEILING: s.min = -24.0f; s.max = 0.0f;    s.def = -1.0f; break;
+        case EFFECT_PARAM_RELEASE: s.min = 1.0f;   s.max = 5000.0f; s.def = 50.0f; s.smooth = 0; break;
+        case EFFECT_PARAM_LOOKAHEAD:
+            s.min = 0.0f; s.max = EFFECT_MAX_LOOKAHEAD_MS; s.def = 5.0f; s.smooth = 0;
+            break;
+        default: return 0;
+        }
+        break;
+    case EFFECT_REVERB:
+        switch (param) {
+        case EFFECT_PARAM_DECAY:   s.min = 0.1f; s.max = 30.0f; s.def = 1.5f; break;
+        case EFFECT_PARAM_DAMPING: s.min = 0.0f; s.max = 1.0f;  s.def = 0.5f; break;
+        case EFFECT_PARAM_WIDTH:   s.min = 0.0f; s.max = 1.0f;  s.def = 1.0f; break;
+        case EFFECT_PARAM_PREDELAY:
+            s.min = 0.0f; s.max = EFFECT_MAX_PREDELAY_MS; s.def = 10.0f; s.smooth = 0;
+            break;
+        default: return 0;
+        }
+        break;
+    default:
+        return 0;
+    }
+    *spec = s;
+    return 1;
+}
+
+static uint32_t effect_ms_to_frames(const Effect* self, float ms) {
+    return (uint32_t)(ms * (float)self->sampleRate / 1000.0f + 0.5f);
+}
+
+static float effect_time_coef(const Effect* self, float ms) {
+    return expf(-1000.0f / (ms * (float)self->sampleRate));
+}
+
+/* ---- EQ ---- */
+
+static void effect_biquad_clear(ma_biquad* bq, uint32_t channels) {
+    /* ma_biquad_clear_cache only clears the first channel. */
+    for (uint32_t c = 0; c < channels; ++c) {
+        bq->pR1[c].f32 = 0.0f;
+        bq->pR2[c].f32 = 0.0f;
+    }
+}
+
+static void effect_eq_update(Effect* self) {
+    for (int b = 0; b < EFFECT_EQ_BANDS; ++b) {
+        int const type = (int)self->value[EFFECT_PARAM_EQ(b, EFFECT_EQ_TYPE)];
+        double const gain = self->value[EFFECT_PARAM_EQ(b, EFFECT_EQ_GAIN)];
+        double freq = self->value[EFFECT_PARAM_EQ(b, EFFECT_EQ_FREQUENCY)];
+        if (freq > 0.45 * self->sampleRate) freq = 0.45 * self->sampleRate;
+
+        int const active = type == EFFECT_EQ_LOW_PASS || type == EFFECT_EQ_HIGH_PASS ||
+                           (type != EFFECT_EQ_OFF && fabs(gain) > 1e-3);
+        if (type != self->eqType[b] || (active && !self->eqActive[b])) {
+            effect_biquad_clear(&self->eq[b], self->channels);
+        }
+        self->eqType[b] = type;
+        self->eqActive[b] = active;
+        if (!active) continue;
+
+        /* Robert Bristow-Johnson, "Cookbook formulae for audio EQ biquad
+           filter coefficients". */
+        double const w0 = 2.0 * EFFECT_PI * freq / self->sampleRate;
+        double const cw = cos(w0);
+        double const alpha = sin(w0) / (2.0 * self->value[EFFECT_PARAM_EQ(b, EFFECT_EQ_Q)]);
+        double const A = pow(10.0, gain / 40.0);
+        double const sa = 2.0 * sqrt(A) * alpha;
+        double b0, b1, b2, a0, a1, a2;
+        switch (type) {
+        case EFFECT_EQ_PEAK:
+            b0 = 1.0 + alpha * A; b1 = -2.0 * cw; b2 = 1.0 - alpha * A;
+            a0 = 1.0 + alpha / A; a1 = -2.0 * cw; a2 = 1.0 - alpha / A;
+            break;
+        case EFFECT_EQ_LOW_SHELF:
+            b0 = A * ((A + 1.0) - (A - 1.0) * cw + sa);
+            b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cw);
+            b2 = A * ((A + 1.0) - (A - 1.0) * cw - sa);
+            a0 = (A + 1.0) + (A - 1.0) * cw + sa;
+            a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cw);
+            a2 = (A + 1.0) + (A - 1.0) * cw - sa;
+            break;
+        case EFFECT_EQ_HIGH_SHELF:
+            b0 = A * ((A + 1.0) + (A - 1.0) * cw + sa);
+            b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cw);
+            b2 = A * ((A + 1.0) + (A - 1.0) * cw - sa);
+            a0 = (A + 1.0) - (A - 1.0) * cw + sa;
+            a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cw);
+            a2 = (A + 1.0) - (A - 1.0) * cw - sa;
+            break;
+        case EFFECT_EQ_LOW_PASS:
+            b0 = (1.0 - cw) / 2.0; b1 = 1.0 - cw; b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        default: /* EFFECT_EQ_HIGH_PASS */
+            b0 = (1.0 + cw) / 2.0; b1 = -(1.0 + cw); b2 = b0;
+            a0 = 1.0 + alpha; a1 = -2.0 * cw; a2 = 1.0 - alpha;
+            break;
+        }
+        /* Same format and channels, so this only swaps the coefficients. */
+        ma_biquad_config config = ma_biquad_config_init(ma_format_f32, self->channels,
+                                                        b0, b1, b2, a0, a1, a2);
+        ma_biquad_reinit(&config, &self->eq[b]);
+    }
+}
+
+static const float* effect_eq_process(Effect* self, const float* x, float* y, uint32_t frames) {
+    const float* src = x;
+    for (int b = 0; b < EFFECT_EQ_BANDS; ++b) {
+        if (!self->eqActive[b]) continue;
+        ma_biquad_process_pcm_frames(&self->eq[b], y, src, frames);
+        src = y;
+    }
+    if (src == x) memcpy(y, x, (size_t)frames * self->channels * sizeof(float));
+    return x;
+}
+
+/* ---- Dynamics ---- */
+
+static void effect_dynamics_restart(Effect* self) {
+    EffectDynamics* d = &self->dyn;
+    uint32_t const window = d->lookahead + 1;
+    d->minHead = 0;
+    d->minCount = 0;
+    for (uint32_t i = 0; i < window; ++i) d->box[i] = d->held;
+    d->boxPos = 0;
+    d->boxSum = (double)d->held * window;
+}
+
+static void effect_dynamics_update(Effect* self) {
+    EffectDynamics* d = &self->dyn;
+    if (self->type == EFFECT_COMPRESSOR) {
+        d->attack = effect_time_coef(self, self->value[EFFECT_PARAM_ATTACK]);
+    }
+    d->release = effect_time_coef(self, self->value[EFFECT_PARAM_RELEASE]);
+    uint32_t lookahead = effect_ms_to_frames(self, self->value[EFFECT_PARAM_LOOKAHEAD]);
+    if (lookahead >= d->ring) lookahead = d->ring - 1;
+    if (lookahead != d->lookahead) {
+        d->lookahead = lookahead;
+        effect_dynamics_restart(self);
+    }
+}
+
+/* Writes x into the lookahead ring and the frames leaving it into out. */
+static void effect_delay(EffectDynamics* d, const float* x, float* out,
+                         uint32_t frames, uint32_t channels) {
+    size_t const bytes = channels * sizeof(float);
+    for (uint32_t i = 0; i < frames; ++i) {
+        uint32_t const read = (d->pos + d->ring - d->lookahead) % d->ring;
+        memcpy(d->delay + (size_t)d->pos * channels, x + (size_t)i * channels, bytes);
+        memcpy(out + (size_t)i * channels, d->delay + (size_t)read * channels, bytes);
+        d->pos = d->pos + 1 == d->ring ? 0 : d->pos + 1;
+    }
+}
+
+static void effect_peaks(const float* EFFECT_RESTRICT x, float* EFFECT_RESTRICT peak,
+                         uint32_t frames, uint32_t channels) {
+    for (uint32_t i = 0; i < frames; ++i) {
+        float p = 0.0f;
+        for (uint32_t c = 0; c < channels; ++c) {
+            float const a = fabsf(x[(size_t)i * channels + c]);
+            p = a > p ? a : p;
+        }
+        peak[i] = p;
+    }
+}
+
+/* Gains in dB; returns the deepest reduction. */
+static float effect_compressor_gains(Effect* self, uint32_t frames) {
+    EffectDynamics* d = &self->dyn;
+    float const threshold = self->value[EFFECT_PARAM_THRESHOLD];
+    float const knee = self->value[EFFECT_PARAM_KNEE];
+    float const makeup = self->value[EFFECT_PARAM_MAKEUP];
+    float const slope = 1.0f / self->value[EFFECT_PARAM_RATIO] - 1.0f;
+    float env = d->env;
+    float deepest = 0.0f;
+    for (uint32_t i = 0; i < frames; ++i) {
+        float const level = self->peak[i] > 1e-8f ? EFFECT_DB_PER_LOG2 * log2f(self->peak[i])
+                                                  : EFFECT_SILENCE_DB;
+        float const over = level - threshold;
+        float target;
+        if (knee > 0.0f && 2.0f * fabsf(over) <= knee) {
+            float const k = over + knee * 0.5f;
+            target = slope * k * k / (2.0f * knee);
+        } else {
+            target = over > 0.0f ? slope * over : 0.0f;
+        }
+        float const coef = target < env ? d->attack : d->release;
+        env = target + (env - target) * coef;
+        deepest = env < deepest ? env : deepest;
+        self->gain[i] = env + makeup;
+    }
+    d->env = env;
+    for (uint32_t i = 0; i < frames; ++i) self->gain[i] = exp2f(self->gain[i] / EFFECT_DB_PER_LOG2);
+    return deepest;
+}
+
+/* Linear gains; returns the deepest reduction in dB. With window
+   = lookahead + 1, every average that lands on a peak only covers minima
+   that already saw it, so the gain is at or under what the peak needs by
+   the time the delay lets it out. */
+static float effect_limiter_gains(Effect* self, uint32_t frames) {
+    EffectDynamics* d = &self->dyn;
+    uint32_t const window = d->lookahead + 1;
+    uint32_t const cap = d->ring;
+    float const ceiling = powf(10.0f, self->value[EFFECT_PARAM_CEILING] / 20.0f);
+    float lowest = 1.0f;
+    for (uint32_t i = 0; i < frames; ++i) {
+        float const peak = self->peak[i];
+        float const need = peak > ceiling ? ceiling / peak : 1.0f;
+        d->held = need < d->held ? need : need + (d->held - need) * d->release;
+
+        /* Sliding minimum: a deque of increasing values. */
+        while (d->minCount > 0 &&
+               d->minValue[(d->minHead + d->minCount - 1) % cap] >= d->held) {
+            --d->minCount;
+        }
+        uint32_t const back = (d->minHead + d->minCount) % cap;
+        d->minValue[back] = d->held;
+        d->minIndex[back] = d->tick;
+        ++d->minCount;
+        while (d->tick - d->minIndex[d->minHead] >= window) {
+            d->minHead = (d->minHead + 1) % cap;
+            --d->minCount;
+        }
+        ++d->tick;
+        float const m = d->minValue[d->minHead];
+
+        d->boxSum += (double)m - d->box[d->boxPos];
+        d->box[d->boxPos] = m;
+        if (++d->boxPos == window) {
+            /* Resum once per window so rounding cannot build up. */
+            d->boxPos = 0;
+            double sum = 0.0;
+            for (uint32_t j = 0; j < window; ++j) sum += d->box[j];
+            d->boxSum = sum;
+        }
+        float g = (float)(d->boxSum / window);
+        g = g > 1.0f ? 1.0f : g;
+        lowest = g < lowest ? g : lowest;
+        self->gain[i] = g;
+    }
+    return lowest < 1.0f ? 20.0f * log10f(lowest) : 0.0f;
+}
+
+static const float* effect_dynamics_process(Effect* self, const float* x, float* y,
+                                            uint32_t frames, float* deepest) {
+    uint32_t const channels = self->channels;
+    effect_peaks(x, self->peak, frames, channels);
+    effect_delay(&self->dyn, x, self->dry, frames, channels);
+    float const reduction = self->type == EFFECT_COMPRESSOR ? effect_compressor_gains(self, frames)
+                                                            : effect_limiter_gains(self, frames);
+    *deepest = reduction < *deepest ? reduction : *deepest;
+
+    const float* EFFECT_RESTRICT in = self->dry;
+    float* EFFECT_RESTRICT out = y;
+    for (uint32_t i = 0; i < frames; ++i) {
+        float const g = self->gain[i];
+        for (uint32_t c = 0; c < channels; ++c) {
+            out[(size_t)i * channels + c] = in[(size_t)i * channels + c] * g;
+        }
+    }
+    return self->dry;
+}
+
+/* ---- Reverb ---- */
+
+static void effect_reverb_update(Effect* self) {
+    EffectReverb* r = &self->rev;
+    float const decay = self->value[EFFECT_PARAM_DECAY];
+    /* -60 dB after decay seconds, per trip round each line. */
+    for (int j = 0; j < EFFECT_LINES; ++j) {
+        r->feedback[j] = powf(10.0f, -3.0f * (float)r->length[j] /
+                                     (decay * (float)self->sampleRate));
+    }
+    r->damping = 0.9f * self->value[EFFECT_PARAM_DAMPING];
+    uint32_t predelay = effect_ms_to_frames(self, self->value[EFFECT_PARAM_PREDELAY]);
+    r->predelayFrames = predelay >= r->predelayRing ? r->predelayRing - 1 : predelay;
+}
+
+/* Orthogonal 8-point Hadamard: three butterfly stages, scaled by 1/sqrt(8). */
+static void effect_hadamard(float* EFFECT_RESTRICT v) {
+    float t[EFFECT_LINES];
+    for (int i = 0; i < 4; ++i) { t[i] = v[i] + v[i + 4]; t[i + 4] = v[i] - v[i + 4]; }
+    for (int i = 0; i < 2; ++i) {
+        v[i]     = t[i] + t[i + 2];     v[i + 2] = t[i] - t[i + 2];
+        v[i + 4] = t[i + 4] + t[i + 6]; v[i + 6] = t[i + 4] - t[i + 6];
+    }
+    for (int i = 0; i < EFFECT_LINES; i += 2) {
+        float const a = v[i], b = v[i + 1];
+        v[i]     = (a + b) * 0.35355339f;
+        v[i + 1] = (a - b) * 0.35355339f;
+    }
+}
+
+static const float* effect_reverb_process(Effect* self, const float* x, float* y, uint32_t frames) {
+    static const float k_input[EFFECT_LINES] = {
+        0.35f, -0.35f, 0.35f, -0.35f, 0.35f, -0.35f, 0.35f, -0.35f
+    };
+    EffectReverb* r = &self->rev;
+    uint32_t const channels = self->channels;
+    float const scale = 1.0f / (float)channels;
+    float const width = self->value[EFFECT_PARAM_WIDTH];
+    float const damping = r->damping;
+    r->denormal = -r->denormal;
+
+    for (uint32_t i = 0; i < frames; ++i) {
+        float in = 0.0f;
+        for (uint32_t c = 0; c < channels; ++c) in += x[(size_t)i * channels + c];
+        r->predelay[r->predelayPos] = in * scale;
+        uint32_t const read = (r->predelayPos + r->predelayRing - r->predelayFrames) % r->predelayRing;
+        float const dry = r->predelay[read] + r->denormal;
+        r->predelayPos = r->predelayPos + 1 == r->predelayRing ? 0 : r->predelayPos + 1;
+
+        float v[EFFECT_LINES];
+        for (int j = 0; j < EFFECT_LINES; ++j) v[j] = r->line[j][r->pos[j]];
+        for (int j = 0; j < EFFECT_LINES; ++j) {
+            r->state[j] = v[j] + (r->state[j] - v[j]) * damping;
+            v[j] = r->state[j];
+        }
+        float const left  = 0.5f * (v[0] + v[2] + v[4] + v[6]);
+        float const right = 0.5f * (v[1] + v[3] + v[5] + v[7]);
+        effect_hadamard(v);
+        for (int j = 0; j < EFFECT_LINES; ++j) {
+            r->line[j][r->pos[j]] = v[j] * r->feedback[j] + dry * k_input[j];
+            r->pos[j] = r->pos[j] + 1 == r->length[j] ? 0 : r->pos[j] + 1;
+        }
+
+        float const mid = 0.5f * (left + right);
+        float const side = 0.5f * (left - right) * width;
+        float* out = y + (size_t)i * channels;
+        if (channels == 1) {
+            out[0] = mid;
+        } else {
+            for (uint32_t c = 0; c < channels; ++c) out[c] = (c & 1) ? mid - side : mid + side;
+        }
+    }
+    return x;
+}
+
+/* ---- Node ---- */
+
+static void effect_clear_state(Effect* self) {
+    if (self->type == EFFECT_EQ) {
+        for (int b = 0; b < EFFECT_EQ_BANDS; ++b) effect_biquad_clear(&self->eq[b], self->channels);
+    }
+    if (self->dyn.delay) {
+        memset(self->dyn.delay, 0, (size_t)self->dyn.ring * self->channels * sizeof(float));
+        self->dyn.env = 0.0f;
+        self->dyn.held = 1.0f;
+        effect_dynamics_restart(self);
+    }
+    if (self->rev.predelay) {
+        for (int j = 0; j < EFFECT_LINES; ++j) {
+            memset(self->rev.line[j], 0, self->rev.length[j] * sizeof(float));
+            self->rev.state[j] = 0.0f;
+        }
+        memset(self->rev.predelay, 0, self->rev.predelayRing * sizeof(float));
+    }
+}
+
+/* Moves the parameters toward their targets, one step per block. Before
+   the first block they take their targets at once. */
+static void effect_update(Effect* self) {
+    if (au_exchange_u32(&self->resetRequested, 0)) effect_clear_state(self);
+    uint32_t const version = au_load_u32(&self->version);
+    if (self->primed && version == self->seen && !self->settling) return;
+    self->seen = version;
+
+    int changed = !self->primed;
+    int settling = 0;
+    for (int p = 0; p < EFFECT_PARAM_COUNT; ++p) {
+        EffectParamSpec spec;
+        if (!effect_param_spec(self->type, p, &spec)) continue;
+        float const target = au_load_f32(&self->target[p]);
+        float v = self->value[p];
+        if (v == target) continue;
+        if (!self->primed || !spec.smooth) {
+            v = target;
+        } else {
+            v += (target - v) * self->smooth;
+            if (fabsf(target - v) <= 1e-4f * (1.0f + fabsf(target))) v = target;
+            else settling = 1;
+        }
+        self->value[p] = v;
+        changed = 1;
+    }
+    self->settling = settling;
+    self->primed = 1;
+    if (!changed) return;
+
+    switch (self->type) {
+    case EFFECT_EQ:         effect_eq_update(self); break;
+    case EFFECT_COMPRESSOR:
+    case EFFECT_LIMITER:    effect_dynamics_update(self); break;
+    case EFFECT_REVERB:     effect_reverb_update(self); break;
+    }
+}
+
+/* wet = dry + (wet - dry) * mix, with mix ramped across the block. */
+static void effect_mix(float* EFFECT_RESTRICT wet, const float* EFFECT_RESTRICT dry,
+                       uint32_t frames, uint32_t channels, float from, float to) {
+    if (from >= 1.0f && to >= 1.0f) return;
+    float const step = (to - from) / (float)frames;
+    for (uint32_t i = 0; i < frames; ++i) {
+        float const m = from + step * (float)(i + 1);
+        for (uint32_t c = 0; c < channels; ++c) {
+            size_t const k = (size_t)i * channels + c;
+            wet[k] = dry[k] + (wet[k] - dry[k]) * m;
+        }
+    }
+}
+
+static void effect_node_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn,
+                                float** ppFramesOut, ma_uint32* pFrameCountOut) {
+    Effect* self = (Effect*)pNode;
+    ma_uint32 const frameCount = *pFrameCountOut;
+    uint32_t const channels = self->channels;
+    float deepest = 0.0f;
+    (void)pFrameCountIn;
+
+    for (ma_uint32 done = 0; done < frameCount;) {
+        uint32_t const n = frameCount - done < EFFECT_BLOCK ? frameCount - done : EFFECT_BLOCK;
+        const float* x = ppFramesIn[0] + (size_t)done * channels;
+        float* y = ppFramesOut[0] + (size_t)done * channels;
+
+        float const mixFrom = self->primed ? self->value[EFFECT_PARAM_MIX] : -1.0f;
+        effect_update(self);
+        float const mixTo = self->value[EFFECT_PARAM_MIX];
+
+        const float* dry;
+        switch (self->type) {
+        case EFFECT_EQ:     dry = effect_eq_process(self, x, y, n); break;
+        case EFFECT_REVERB: dry = effect_reverb_process(self, x, y, n); break;
+        default:            dry = effect_dynamics_process(self, x, y, n, &deepest); break;
+        }
+        effect_mix(y, dry, n, channels, mixFrom < 0.0f ? mixTo : mixFrom, mixTo);
+        done += n;
+    }
+    au_store_f32(&self->reduction, deepest);
+}
+
+static ma_node_vtable g_effect_vtable = {
+    effect_node_process,
+    NULL,
+    1, /* 1 input bus */
+    1, /* 1 output bus */
+    MA_NODE_FLAG_CONTINUOUS_PROCESSING /* tails and lookahead outlast the input */
+};
+
+static int effect_alloc_buffers(Effect* self) {
+    uint32_t const channels = self->channels;
+    size_t floats = (size_t)EFFECT_BLOCK * channels;
+    uint32_t ring = 0, predelayRing = 0;
+    uint32_t length[EFFECT_LINES] = { 0 };
+    if (self->type == EFFECT_COMPRESSOR || self->type == EFFECT_LIMITER) {
+        ring = effect_ms_to_frames(self, EFFECT_MAX_LOOKAHEAD_MS) + 1;
+        floats += (size_t)ring * channels + 3 * (size_t)ring;
+    } else if (self->type == EFFECT_REVERB) {
+        predelayRing = effect_ms_to_frames(self, EFFECT_MAX_PREDELAY_MS) + 1;
+        floats += predelayRing;
+        for (int j = 0; j < EFFECT_LINES; ++j) {
+            length[j] = (uint32_t)((uint64_t)k_line_frames[j] * self->sampleRate / 48000);
+            if (length[j] < 1) length[j] = 1;
+            floats += length[j];
+        }
+    }
+
+    float* p = (float*)calloc(floats, sizeof(float));
+    if (!p) return 0;
+    self->memory = p;
+    self->dry = p;
+    p += (size_t)EFFECT_BLOCK * channels;
+    if (ring) {
+        EffectDynamics* d = &self->dyn;
+        d->ring = ring;
+        d->delay = p;                 p += (size_t)ring * channels;
+        d->minValue = p;              p += ring;
+        d->minIndex = (uint32_t*)p;   p += ring;
+        d->box = p;
+        d->held = 1.0f;
+        effect_dynamics_restart(self);
+    }
+    if (predelayRing) {
+        EffectReverb* r = &self->rev;
+        r->predelayRing = predelayRing;
+        r->predelay = p;              p += predelayRing;
+        for (int j = 0; j < EFFECT_LINES; ++j) {
+            r->length[j] = length[j];
+            r->line[j] = p;           p += length[j];
+        }
+        r->denormal = EFFECT_DENORMAL;
+    }
+    return 1;
+}
+
+/************
+ ** public **
+ ************/
+
+Effect* effect_alloc(void) {
+    return (Effect*)calloc(1, sizeof(Effect));
+}
+
+void effect_free(Effect* self) {
+    if (!self) return;
+    effect_uninit(self);
+    free(self);
+}
+
+int effect_init(Effect* self, Engine* engine, int type) {
+    if (!self || !engine || self->initialized) return 0;
+    if (type < EFFECT_EQ || type > EFFECT_REVERB) return 0;
+    ma_engine* mae = engine_get_ma_engine(engine);
+    if (!mae) return 0;
+
+    memset(self, 0, sizeof(*self));
+    self->type = (EffectType)type;
+    self->channels = ma_engine_get_channels(mae);
+    self->sampleRate = ma_engine_get_sample_rate(mae);
+    self->smooth = 1.0f - expf(-(float)EFFECT_BLOCK /
+                               (EFFECT_SMOOTH_MS * (float)self->sampleRate / 1000.0f));
+    for (int p = 0; p < EFFECT_PARAM_COUNT; ++p) {
+        EffectParamSpec spec;
+        if (effect_param_spec(self->type, p, &spec)) au_store_f32(&self->target[p], spec.def);
+    }
+    if (!effect_alloc_buffers(self)) return 0;
+
+    int bands = 0;
+    if (type == EFFECT_EQ) {
+        /* Allocated here, so the audio thread only ever reinits them. */
+        ma_biquad_config config = ma_biquad_config_init(ma_format_f32, self->channels,
+                                                        1.0, 0.0, 0.0, 1.0, 0.0, 0.0);
+        for (; bands < EFFECT_EQ_BANDS; ++bands) {
+            if (ma_biquad_init(&config, NULL, &self->eq[bands]) != MA_SUCCESS) break;
+        }
+        if (bands < EFFECT_EQ_BANDS) goto fail;
+    }
+
+    ma_uint32 const channels = self->channels;
+    ma_node_config config = ma_node_config_init();
+    config.vtable = &g_effect_vtable;
+    config.pInputChannels = &channels;
+    config.pOutputChannels = &channels;
+    if (ma_node_init(ma_engine_get_node_graph(mae), &config, NULL, &self->base) != MA_SUCCESS) {
+        goto fail;
+    }
+    self->initialized = 1;
+    return 1;
+
+fail:
+    while (bands > 0) ma_biquad_uninit(&self->eq[--bands], NULL);
+    free(self->memory);
+    self->memory = NULL;
+    return 0;
+}
+
+void effect_uninit(Effect* self) {
+    if (!self || !self->initialized) return;
+    ma_node_uninit(&self->base, NULL);
+    if (self->type == EFFECT_EQ) {
+        for (int b = 0; b < EFFECT_EQ_BANDS; ++b) ma_biquad_uninit(&self->eq[b], NULL);
+    }
+    free(self->memory);
+    self->memory = NULL;
+    self->initialized = 0;
+}
+
+int effect_get_type(Effect* self) {
+    return self ? (int)self->type : -1;
+}
+
+int effect_set_param(Effect* self, int param, float value) {
+    EffectParamSpec spec;
+    if (!self || !self->initialized || param < 0 || param >= EFFECT_PARAM_COUNT) return 0;
+    if (!effect_param_spec(self->type, param, &spec) || value != value) return 0;
+    if (value < spec.min) value = spec.min;
+    if (value > spec.max) value = spec.max;
+    if (self->type == EFFECT_EQ && param != EFFECT_PARAM_MIX &&
+        (param - EFFECT_PARAM_EQ_FIRST) % EFFECT_EQ_FIELDS == EFFECT_EQ_TYPE) {
+        value = floorf(value + 0.5f);
+    }
+    au_store_f32(&self->target[param], value);
+    au_fetch_add_u32(&self->version, 1);
+    return 1;
+}
+
+float effect_get_param(Effect* self, int param) {
+    if (!self || param < 0 || param >= EFFECT_PARAM_COUNT) return 0.0f;
+    return au_load_f32(&self->target[param]);
+}
+
+float effect_get_reduction_db(Effect* self) {
+    return self ? au_load_f32(&self->reduction) : 0.0f;
+}
+
+void effect_reset(Effect* self) {
+    if (!self || !self->initialized) return;
+    au_store_u32(&self->resetRequested, 1);
+}
@@ -1,10 +1,18 @@
 #include "../include/engine.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h> // <- add this
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 
 #include "../include/miniaudio.h"
+#include "../include/audio_context.h"
+#include "../include/atomic_util.h"
 
 /*************
  ** private **
@@ -15,18 +23,269 @@ struct Engine
     bool is_started;
     ma_engine engine;
     ma_decoder_config dec_config;
-    ma_context context;
-    PlaybackDeviceInfo* playbackInfos;
-    ma_uint32 playbackCount;
-    ma_uint32 playbackGeneration; // NEW
+    ma_context* context;          // process-wide, see audio_context.h
+    ma_uint32 playbackGeneration; // device switches; refreshes are counted by the registry
+    AssetCache assets;            // outlives engine re-inits and device switches
+    bool assets_ready;
+    // Owned so it (and its job threads) survives device switches.
+    ma_resource_manager resource_manager;
+    bool resource_manager_ready;
+    ma_uint32 job_threads;
+    SoundLoader loader;
+    // Caps mixed voices; runs at the start of every device callback.
+    VoiceScheduler scheduler;
+    uint32_t period_ms;           // reused for devices opened on a switch
+    // Duplex mode: one device captures and plays. Each callback pushes its
+    // capture frames and the output it rendered into one ring, side by
+    // side, so readers get them in lockstep.
+    uint32_t duplex_channels;     // capture channels; 0 = playback only
+    uint32_t duplex_buffer_ms;
+    ma_pcm_rb duplex_rb;          // [capture | reference] frames
+    bool duplex_ready;
+    volatile uint32_t monitor_gain; // float bits; capture mixed into output
+    // Receives the output of every callback, see engine_set_echo_reference.
+    EchoCanceller* echo_reference;
+    volatile uint32_t echo_lock;    // try-locked by the audio thread
+    EngineLatencyConfig latency;  // applies to devices we open ourselves
+    bool latency_set;
+    bool offline;                 // no device; engine_render drives the mix
+    // Callback timing, see engine_get_load_stats. Written only by the audio
+    // thread, as a seqlock: load_seq is odd while it writes.
+    EngineLoadStats load;
+    volatile uint32_t load_seq;
+    volatile uint32_t load_reset;   // requested by engine_reset_load_stats
+    double last_callback_us;        // start of the previous callback; 0 = none
 };
 
-static void engine_free_playback_cache(Engine* self) {
-    if (self->playbackInfos != NULL) {
-        free(self->playbackInfos);
-        self->playbackInfos = NULL;
-        self->playbackCount = 0;
+static double engine_now_us(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1e6 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+#endif
+}
+
+// Queue the captured frames next to the output the engine rendered. Frames
+// that do not fit in the ring are dropped.
+static void engine_duplex_queue(Engine* self, const float* out, const float* in, ma_uint32 frameCount) {
+    ma_uint32 const outCh = ma_engine_get_channels(&self->engine);
+    ma_uint32 const inCh  = self->duplex_channels;
+
+    ma_uint32 done = 0;
+    while (done < frameCount) {
+        ma_uint32 n = frameCount - done;
+        void* dst = NULL;
+        if (ma_pcm_rb_acquire_write(&self->duplex_rb, &n, &dst) != MA_SUCCESS || n == 0) break;
+        float* f = (float*)dst;
+        for (ma_uint32 i = 0; i < n; ++i) {
+            memcpy(f, in + (done + i) * inCh, inCh * sizeof(float));
+            memcpy(f + inCh, out + (done + i) * outCh, outCh * sizeof(float));
+            f += inCh + outCh;
+        }
+        ma_pcm_rb_commit_write(&self->duplex_rb, n);
+        done += n;
+    }
+}
+
+// Mix the captured frames into the output (monitoring). A mono input is
+// heard on every output channel; otherwise channels pair up to the smaller
+// count.
+static void engine_duplex_monitor(Engine* self, float* out, const float* in, ma_uint32 frameCount) {
+    ma_uint32 const outCh = ma_engine_get_channels(&self->engine);
+    ma_uint32 const inCh  = self->duplex_channels;
+
+    float const gain = au_load_f32(&self->monitor_gain);
+    if (gain <= 0.0f) return;
+    for (ma_uint32 i = 0; i < frameCount; ++i) {
+        for (ma_uint32 c = 0; c < outCh; ++c) {
+            if (inCh == 1) out[i * outCh + c] += gain * in[i];
+            else if (c < inCh) out[i * outCh + c] += gain * in[i * inCh + c];
+        }
+    }
+}
+
+// One block of the mix, as a device callback renders it. Returns the
+// frames rendered.
+static ma_uint32 engine_render_block(Engine* self, float* out, ma_uint32 frameCount) {
+    ma_engine* maEngine = &self->engine;
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    // As miniaudio's own callback: nothing else runs resource manager jobs.
+    ma_resource_manager_process_next_job(&self->resource_manager);
+#endif
+    voice_scheduler_process(&self->scheduler);
+
+    // Read in pieces ending on scheduled start/stop times, so sounds
+    // scheduled with sound_play_at/sound_stop_at land on their exact frame.
+    ma_uint32 const channels = ma_engine_get_channels(maEngine);
+    ma_uint32 left = frameCount;
+    while (left > 0) {
+        ma_uint64 const now = ma_engine_get_time_in_pcm_frames(maEngine);
+        ma_uint64 const next = voice_scheduler_next_event(&self->scheduler, now, now + left);
+        ma_uint64 read = 0;
+        ma_engine_read_pcm_frames(maEngine, out, next - now, &read);
+        if (read == 0) {
+            // Nothing attached. The block is still owed in full, live or
+            // offline: fill in silence and move the clock on as a read
+            // would have, so scheduled sounds and duplex capture carry on.
+            read = next - now;
+            memset(out, 0, (size_t)read * channels * sizeof(float));
+            ma_engine_set_time_in_pcm_frames(maEngine, now + read);
+        }
+        out += read * channels;
+        left -= (ma_uint32)read;
+    }
+    return frameCount - left;
+}
+
+// Publishes the timing of one callback that started at start_us.
+static void engine_profile_callback(Engine* self, ma_device* device, double start_us,
+                                    double end_us, ma_uint32 frameCount) {
+    double const period = frameCount * 1e6 / device->sampleRate;
+    double const elapsed = end_us - start_us;
+    // A callback can be at most its own period plus the device buffer
+    // after the previous one; any later and the buffer played out dry.
+    double const buffer = device->playback.internalSampleRate
+        ? (double)device->playback.internalPeriodSizeInFrames * device->playback.internalPeriods
+              * 1e6 / device->playback.internalSampleRate
+        : period;
+    bool const late = self->last_callback_us > 0 &&
+                      start_us - self->last_callback_us > period + buffer;
+    bool const overrun = elapsed > period;
+    self->last_callback_us = start_us;
+
+    uint32_t const seq = au_load_u32(&self->load_seq);
+    au_store_u32(&self->load_seq, seq + 1);
+    au_fence();
+    EngineLoadStats* s = &self->load;
+    if (au_exchange_u32(&self->load_reset, 0)) memset(s, 0, sizeof(*s));
+    float const load = (float)(elapsed / period);
+    s->callbacks++;
+    s->frames += frameCount;
+    if (late || overrun) s->xruns++;
+    if (overrun) s->overruns++;
+    s->load += (load - s->load) * (float)(period / (period + 300000.0));
+    if (load > s->peakLoad) s->peakLoad = load;
+    s->lastCallbackUs = (float)elapsed;
+    if (s->lastCallbackUs > s->maxCallbackUs) s->maxCallbackUs = s->lastCallbackUs;
+    s->periodUs = (float)period;
+    s->backend = device->pContext->backend;
+    au_store_u32(&self->load_seq, seq + 2);
+}
+
+static void engine_process_callback(Engine* self, float* pOutput, const float* pInput,
+                                    ma_uint32 frameCount) {
+    ma_engine* maEngine = &self->engine;
+    ma_uint32 const rendered = engine_render_block(self, pOutput, frameCount);
+    bool const duplex = pInput != NULL && self->duplex_ready;
+
+    // The far-end reference is what the engine rendered, before the
+    // monitored input is added: the echo canceller must not learn to cancel
+    // the near end's own voice.
+    if (duplex) engine_duplex_queue(self, pOutput, pInput, rendered);
+    if (self->echo_reference != NULL && au_cas_u32(&self->echo_lock, 0, 1)) {
+        if (self->echo_reference != NULL) {
+            echo_canceller_push_reference(self->echo_reference, pOutput,
+                                          rendered, ma_engine_get_channels(maEngine));
+        }
+        au_store_u32(&self->echo_lock, 0);
     }
+    if (duplex) engine_duplex_monitor(self, pOutput, pInput, rendered);
+}
+
+static void engine_data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    ma_engine* maEngine = (ma_engine*)pDevice->pUserData;
+    Engine* self = (Engine*)((char*)maEngine - offsetof(Engine, engine));
+
+#if defined(__EMSCRIPTEN__)
+    // The audio worklet scope has no clock to time the callback with.
+    engine_process_callback(self, (float*)pOutput, (const float*)pInput, frameCount);
+#else
+    double const start = engine_now_us();
+    engine_process_callback(self, (float*)pOutput, (const float*)pInput, frameCount);
+    engine_profile_callback(self, pDevice, start, engine_now_us(), frameCount);
+#endif
+}
+
+static int engine_init_resource_manager(Engine* self) {
+    ma_resource_manager_config cfg = ma_resource_manager_config_init();
+    cfg.decodedFormat  = ma_format_f32;
+    cfg.jobThreadCount = self->job_threads;
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    // No threads in the browser build; loads run inline.
+    cfg.jobThreadCount = 0;
+    cfg.flags |= MA_RESOURCE_MANAGER_FLAG_NO_THREADING;
+#endif
+    self->resource_manager_ready =
+        ma_resource_manager_init(&cfg, &self->resource_manager) == MA_SUCCESS;
+    return self->resource_manager_ready;
+}
+
+// A playback device feeding this engine, as ma_engine_init would open it,
+// with the latency config applied. On a switch it runs at the engine's
+// channel count and rate so the graph can stay as is; 0 for either takes
+// the device's own. In duplex mode it also captures from the default
+// input. Allocated with the default allocator, as the engine allocates
+// its own device.
+static ma_device* engine_open_device(Engine* self, const ma_device_id* id,
+                                     ma_uint32 channels, ma_uint32 sampleRate) {
+    ma_device* device = (ma_device*)ma_malloc(sizeof(*device), NULL);
+    if (device == NULL) return NULL;
+    EngineLatencyConfig const* latency = &self->latency;
+
+    ma_device_config cfg = ma_device_config_init(
+        self->duplex_channels ? ma_device_type_duplex : ma_device_type_playback);
+    cfg.playback.pDeviceID        = id;
+    cfg.playback.format           = ma_format_f32;
+    cfg.playback.channels         = channels;
+    cfg.capture.format            = ma_format_f32;
+    cfg.capture.channels          = self->duplex_channels;
+    cfg.sampleRate                = sampleRate;
+    cfg.dataCallback              = engine_data_callback;
+    cfg.pUserData                 = &self->engine;
+    cfg.periodSizeInMilliseconds  = self->period_ms;
+    cfg.periodSizeInFrames        = latency->periodFrames;
+    cfg.periods                   = latency->periods;
+    cfg.performanceProfile        = latency->profile == ENGINE_LATENCY_CONSERVATIVE
+                                        ? ma_performance_profile_conservative
+                                        : ma_performance_profile_low_latency;
+    cfg.noFixedSizedCallback      = latency->noFixedSizedCallback ? MA_TRUE : MA_FALSE;
+    cfg.playback.shareMode        = latency->exclusive ? ma_share_mode_exclusive : ma_share_mode_shared;
+    cfg.capture.shareMode         = cfg.playback.shareMode;
+    cfg.noPreSilencedOutputBuffer = MA_TRUE;
+    cfg.noClip                    = MA_TRUE;
+    ma_result result = ma_device_init(self->context, &cfg, device);
+    if (result != MA_SUCCESS && latency->exclusive) {
+        // Held by another client or not offered at all; take what we can.
+        cfg.playback.shareMode = ma_share_mode_shared;
+        cfg.capture.shareMode  = ma_share_mode_shared;
+        result = ma_device_init(self->context, &cfg, device);
+    }
+    if (result != MA_SUCCESS) {
+        ma_free(device, NULL);
+        return NULL;
+    }
+    return device;
+}
+
+static int engine_init_duplex_ring(Engine* self, ma_device* device) {
+    ma_uint32 const frames = device->sampleRate * self->duplex_buffer_ms / 1000;
+    self->duplex_ready = ma_pcm_rb_init(ma_format_f32,
+                                        self->duplex_channels + device->playback.channels,
+                                        frames ? frames : 1, NULL, NULL,
+                                        &self->duplex_rb) == MA_SUCCESS;
+    return self->duplex_ready;
+}
+
+static void engine_uninit_duplex_ring(Engine* self) {
+    if (!self->duplex_ready) return;
+    self->duplex_ready = false;
+    ma_pcm_rb_uninit(&self->duplex_rb);
 }
 
 /************
@@ -38,51 +297,183 @@ Engine *engine_alloc()
     Engine *const engine = malloc(sizeof(Engine));
     if (engine) {
         memset(engine, 0, sizeof(*engine));
+        engine->job_threads = 1;
+        engine->assets_ready = asset_cache_init(&engine->assets) != 0;
     }
     return engine;
 }
 
 void engine_free(Engine* self) {
     if (self) {
+        // Drops only the cache's references; loaded sounds keep theirs.
+        if (self->assets_ready) asset_cache_uninit(&self->assets);
         free(self);
     }
 }
 
-int engine_init(Engine *const self, uint32_t const period_ms)
-{
+// The part of engine_init and engine_init_offline after the engine config
+// is filled in. Undoes its own work on failure.
+static int engine_init_graph(Engine* self, ma_engine_config* engine_config) {
     self->is_started = false;
-    self->playbackInfos = NULL;
-    self->playbackCount = 0;
     self->playbackGeneration = 0; // NEW
+    memset(&self->load, 0, sizeof(self->load));
+    self->load_reset = 0;
+    self->last_callback_us = 0;
 
-    // Init a shared context so we can enumerate/select devices.
-    ma_context_config ctxCfg = ma_context_config_init();
-    if (ma_context_init(NULL, 0, &ctxCfg, &self->context) != MA_SUCCESS)
+    if (!engine_init_resource_manager(self))
         return 0;
 
-    ma_engine_config engine_config = ma_engine_config_init();
-    engine_config.periodSizeInMilliseconds = period_ms;
-    engine_config.noAutoStart = true;
-    engine_config.pContext = &self->context; // ensure same context
-    if (ma_engine_init(&engine_config, &self->engine) != MA_SUCCESS) {
-        ma_context_uninit(&self->context);
+    engine_config->noAutoStart = true;
+    engine_config->pResourceManager = &self->resource_manager;
+    engine_config->dataCallback = engine_data_callback;
+    if (!engine_config->noDevice && (self->duplex_channels > 0 || self->latency_set)) {
+        // The engine renders into a device we open, so capture can share
+        // its callback and the latency settings ma_engine_config lacks
+        // apply. ma_engine_uninit leaves such a device to us.
+        engine_config->pDevice = engine_open_device(self, NULL, 0, 0);
+        if (engine_config->pDevice == NULL ||
+            (self->duplex_channels > 0 && !engine_init_duplex_ring(self, engine_config->pDevice))) {
+            if (engine_config->pDevice) {
+                ma_device_uninit(engine_config->pDevice);
+                ma_free(engine_config->pDevice, NULL);
+            }
+            ma_resource_manager_uninit(&self->resource_manager);
+            self->resource_manager_ready = false;
+            return 0;
+        }
+    }
+    if (ma_engine_init(engine_config, &self->engine) != MA_SUCCESS) {
+        if (engine_config->pDevice) {
+            ma_device_uninit(engine_config->pDevice);
+            ma_free(engine_config->pDevice, NULL);
+        }
+        engine_uninit_duplex_ring(self);
+        ma_resource_manager_uninit(&self->resource_manager);
+        self->resource_manager_ready = false;
         return 0;
     }
+    // With a device, miniaudio renders the graph in period-sized chunks and
+    // caches the rest, so the clock would jump a whole period on the split
+    // reads engine_render_block makes for scheduled starts and stops.
+    self->engine.nodeGraph.processingSizeInFrames = 0;
+    voice_scheduler_init(&self->scheduler, &self->engine);
+    sound_loader_init(&self->loader, &self->resource_manager, &self->engine);
+    self->loader.scheduler = &self->scheduler;
 
     self->dec_config = ma_decoder_config_init(
-        self->engine.pDevice->playback.format,
-        self->engine.pDevice->playback.channels,
+        ma_format_f32,
+        ma_engine_get_channels(&self->engine),
         self->engine.sampleRate);
+    return 1;
+}
+
+int engine_init(Engine *const self, uint32_t const period_ms)
+{
+    self->period_ms = period_ms;
+
+    if (self->latency_set && self->latency.preferLowLatencyBackend) {
+        static const ma_backend low_latency[] = { ma_backend_jack, ma_backend_alsa };
+        audio_context_prefer_backends(low_latency, 2);
+    }
+
+    // The process-wide context, shared with recorders and generators.
+    self->context = audio_context_acquire();
+    if (self->context == NULL)
+        return 0;
+
+    ma_engine_config engine_config = ma_engine_config_init();
+    engine_config.periodSizeInMilliseconds = period_ms;
+    engine_config.pContext = self->context; // ensure same context
+    if (!engine_init_graph(self, &engine_config)) {
+        audio_context_release();
+        self->context = NULL;
+        return 0;
+    }
 
-    // Cache devices once at init; caller can refresh later.
-    engine_refresh_playback_devices(self);
+    // Enumerated once per process; callers refresh when devices change.
+    audio_context_ensure_devices();
     return 1;
 }
 
+int engine_init_offline(Engine *const self, uint32_t channels, uint32_t sample_rate)
+{
+    // No device and no backend: nothing is opened, so this works headless.
+    ma_engine_config engine_config = ma_engine_config_init();
+    engine_config.noDevice   = MA_TRUE;
+    engine_config.channels   = channels ? channels : 2;
+    engine_config.sampleRate = sample_rate ? sample_rate : 48000;
+    self->context = NULL;
+    self->offline = true;
+    if (!engine_init_graph(self, &engine_config)) {
+        self->offline = false;
+        return 0;
+    }
+    return 1;
+}
+
+uint64_t engine_render(Engine *const self, float *out, uint64_t frames)
+{
+    if (self == NULL || !self->offline || out == NULL) return 0;
+    ma_uint32 const channels = ma_engine_get_channels(&self->engine);
+    uint64_t done = 0;
+    while (done < frames) {
+        // In device-sized blocks, so voice limits and scheduled events are
+        // evaluated as often as they would be live.
+        uint64_t const want = frames - done;
+        ma_uint32 const n = want < ENGINE_RENDER_BLOCK ? (ma_uint32)want : ENGINE_RENDER_BLOCK;
+        ma_uint32 const got = engine_render_block(self, out + done * channels, n);
+        done += got;
+        if (got < n) break;
+    }
+    return done;
+}
+
+int engine_render_to_file(Engine *const self, const char *path, uint64_t frames)
+{
+    if (self == NULL || !self->offline || path == NULL) return 0;
+    ma_uint32 const channels = ma_engine_get_channels(&self->engine);
+    float* block = (float*)malloc((size_t)ENGINE_RENDER_BLOCK * channels * sizeof(float));
+    if (block == NULL) return 0;
+
+    ma_encoder encoder;
+    ma_encoder_config cfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32,
+                                                   channels, ma_engine_get_sample_rate(&self->engine));
+    if (ma_encoder_init_file(path, &cfg, &encoder) != MA_SUCCESS) {
+        free(block);
+        return 0;
+    }
+    int ok = 1;
+    uint64_t done = 0;
+    while (ok && done < frames) {
+        uint64_t const want = frames - done;
+        ma_uint32 const n = want < ENGINE_RENDER_BLOCK ? (ma_uint32)want : ENGINE_RENDER_BLOCK;
+        ma_uint32 const got = (ma_uint32)engine_render(self, block, n);
+        ok = got == n && ma_encoder_write_pcm_frames(&encoder, block, got, NULL) == MA_SUCCESS;
+        done += got;
+    }
+    ma_encoder_uninit(&encoder);
+    free(block);
+    return ok;
+}
+
 void engine_uninit(Engine *const self) {
-    ma_engine_uninit(&self->engine);
-    engine_free_playback_cache(self);
-    ma_context_uninit(&self->context);
+    // In-flight loads attach to the engine; let them land first.
+    sound_loader_uninit(&self->loader);
+    ma_device* device = self->engine.ownsDevice ? NULL : self->engine.pDevice;
+    ma_engine_uninit(&self->engine); // stops a device it does not own
+    if (device) {
+        ma_device_uninit(device);
+        ma_free(device, NULL);
+    }
+    engine_uninit_duplex_ring(self);
+    voice_scheduler_uninit(&self->scheduler);
+    if (self->resource_manager_ready) {
+        ma_resource_manager_uninit(&self->resource_manager);
+        self->resource_manager_ready = false;
+    }
+    if (self->context != NULL) audio_context_release(); // none when offline
+    self->context = NULL;
+    self->offline = false;
 }
 
 int engine_start(Engine *const self)
@@ -90,7 +481,10 @@ int engine_start(Engine *const self)
     if (self->is_started)
         return 1;
 
-    if (ma_engine_start(&self->engine) != MA_SUCCESS)
+    // Offline, "started" only means sounds are free to play; the mix runs
+    // whenever engine_render pulls it.
+    self->last_callback_us = 0; // the device is stopped: no gap to measure
+    if (!self->offline && ma_engine_start(&self->engine) != MA_SUCCESS)
         return 0;
 
     self->is_started = true;
@@ -106,113 +500,322 @@ int engine_load_sound(
     int sample_rate,
     int channels)
 {
-    return sound_init(sound, data, data_size, format, channels, sample_rate, &self->engine);
+    return engine_load_sound_ex(self, sound, data, data_size, format,
+                                sample_rate, channels, SOUND_LOAD_DEFAULT);
 }
 
-// Enumerate and cache playback devices.
-int engine_refresh_playback_devices(Engine* self) {
-    if (self == NULL) return 0;
-    engine_free_playback_cache(self);
-
-    ma_result res;
-    ma_device_info* pPlaybackInfos = NULL;
-    ma_uint32 playbackCount = 0;
-    ma_device_info* pCaptureInfos = NULL;
-    ma_uint32 captureCount = 0;
-
-    res = ma_context_get_devices(&self->context,
-                                 &pPlaybackInfos, &playbackCount,
-                                 &pCaptureInfos, &captureCount);
-    if (res != MA_SUCCESS) {
+int engine_load_sound_ex(
+    Engine *const self,
+    Sound *const sound,
+    float *data,
+    size_t const data_size,
+    ma_format format,
+    int sample_rate,
+    int channels,
+    uint32_t flags)
+{
+    if (!sound_init(sound, data, data_size, format, channels, sample_rate,
+                    flags, &self->engine))
         return 0;
-    }
+    sound_attach_scheduler(sound, &self->scheduler);
+    return 1;
+}
 
-    if (playbackCount == 0) {
-        self->playbackInfos = NULL;
-        self->playbackCount = 0;
-        return 1;
-    }
+int engine_load_sound_adopt(
+    Engine *const self,
+    Sound *const sound,
+    void *data,
+    size_t const data_size,
+    ma_format format,
+    int sample_rate,
+    int channels,
+    uint32_t flags,
+    void (*free_fn)(void *data))
+{
+    if (!sound_init_adopt(sound, data, data_size, format, channels, sample_rate,
+                          flags, free_fn, &self->engine))
+        return 0;
+    sound_attach_scheduler(sound, &self->scheduler);
+    return 1;
+}
 
-    self->playbackInfos = (PlaybackDeviceInfo*)malloc(sizeof(PlaybackDeviceInfo) * playbackCount);
-    if (self->playbackInfos == NULL) {
-        self->playbackCount = 0;
+int engine_load_sound_external(
+    Engine *const self,
+    Sound *const sound,
+    const void *data,
+    size_t const data_size,
+    ma_format format,
+    int sample_rate,
+    int channels,
+    uint32_t flags,
+    SoundDataRelease release,
+    void *user_data)
+{
+    if (!sound_init_external(sound, data, data_size, format, channels, sample_rate,
+                             flags, release, user_data, &self->engine))
         return 0;
+    sound_attach_scheduler(sound, &self->scheduler);
+    return 1;
+}
+
+int engine_load_sound_file(
+    Engine *const self,
+    Sound *const sound,
+    const char *path,
+    uint32_t flags)
+{
+    if (self == NULL || sound == NULL) return 0;
+    if (!sound_init_from_file(sound, path, flags, &self->engine)) return 0;
+    sound_attach_scheduler(sound, &self->scheduler);
+    return 1;
+}
+
+int engine_set_job_threads(Engine *const self, uint32_t count)
+{
+    // Fixed for the resource manager's lifetime, so only before engine_init.
+    if (self == NULL || self->resource_manager_ready) return 0;
+    if (count < 1) count = 1;
+    if (count > MA_RESOURCE_MANAGER_MAX_JOB_THREAD_COUNT)
+        count = MA_RESOURCE_MANAGER_MAX_JOB_THREAD_COUNT;
+    self->job_threads = count;
+    return 1;
+}
+
+void engine_set_load_callback(Engine *const self, SoundLoadCallback callback, void *user_data)
+{
+    if (self == NULL) return;
+    sound_loader_set_callback(&self->loader, callback, user_data);
+}
+
+int engine_load_sound_async(
+    Engine *const self,
+    Sound *const sound,
+    float *data,
+    size_t const data_size,
+    ma_format format,
+    int sample_rate,
+    int channels,
+    uint32_t flags)
+{
+    if (self == NULL || !self->resource_manager_ready) return 0;
+    return sound_loader_submit_memory(&self->loader, sound, data, data_size,
+                                      format, channels, sample_rate, flags);
+}
+
+int engine_load_sound_adopt_async(
+    Engine *const self,
+    Sound *const sound,
+    void *data,
+    size_t const data_size,
+    ma_format format,
+    int sample_rate,
+    int channels,
+    uint32_t flags,
+    void (*free_fn)(void *data))
+{
+    if (self == NULL || !self->resource_manager_ready) {
+        if (data) {
+            if (free_fn) free_fn(data);
+            else free(data);
+        }
+        return 0;
+    }
+    return sound_loader_submit_adopted(&self->loader, sound, data, data_size,
+                                       format, channels, sample_rate, flags,
+                                       free_fn);
+}
+
+int engine_load_sound_file_async(
+    Engine *const self,
+    Sound *const sound,
+    const char *path,
+    uint32_t flags)
+{
+    if (self == NULL || !self->resource_manager_ready) return 0;
+    return sound_loader_submit_file(&self->loader, sound, path, flags);
+}
+
+uint32_t engine_get_pending_loads(Engine *const self)
+{
+    return self ? sound_loader_pending(&self->loader) : 0;
+}
+
+int engine_load_sound_shared(
+    Engine *const self,
+    Sound *const sound,
+    const char *key,
+    float *data,
+    size_t const data_size,
+    ma_format format,
+    int sample_rate,
+    int channels,
+    uint32_t flags)
+{
+    if (self == NULL || sound == NULL || !self->assets_ready) return 0;
+
+    SoundAsset *asset = NULL;
+    if ((flags & SOUND_LOAD_DECODE) && format == ma_format_unknown && data != NULL) {
+        // Cache the decoded PCM so the decode runs once per asset. A keyed
+        // asset is looked up first; content-keyed ones hash the decoded PCM.
+        if (key != NULL) {
+            asset = asset_cache_acquire(&self->assets, key, NULL, 0,
+                                        ma_format_unknown, 0, 0);
+        }
+        if (asset == NULL) {
+            void *pcm = NULL;
+            size_t pcm_size = 0;
+            int pcm_channels = 0, pcm_rate = 0;
+            if (!sound_decode_to_pcm(data, data_size, &self->engine,
+                                     &pcm, &pcm_size, &pcm_channels, &pcm_rate)) {
+                return 0;
+            }
+            asset = asset_cache_acquire(&self->assets, key, pcm, pcm_size,
+                                        ma_format_f32, pcm_channels, pcm_rate);
+            free(pcm);
+        }
+    } else {
+        asset = asset_cache_acquire(&self->assets, key, data, data_size,
+                                    format, channels, sample_rate);
     }
+    if (asset == NULL) return 0;
+    int ok = sound_init_from_asset(sound, asset, &self->engine);
+    sound_asset_release(asset); // the sound holds its own reference
+    if (ok) sound_attach_scheduler(sound, &self->scheduler);
+    return ok;
+}
+
+int engine_has_asset(Engine *self, const char *key)
+{
+    if (self == NULL || !self->assets_ready) return 0;
+    return asset_cache_contains(&self->assets, key);
+}
 
-    for (ma_uint32 i = 0; i < playbackCount; ++i) {
-        PlaybackDeviceInfo* dst = &self->playbackInfos[i];
-        ma_device_info* src = &pPlaybackInfos[i];
-        // Copy friendly name
-        size_t n = strlen(src->name);
-        if (n >= sizeof(dst->name)) n = sizeof(dst->name) - 1;
-        memcpy(dst->name, src->name, n);
-        dst->name[n] = '\0';
-        // Copy default flag and id
-        dst->isDefault = src->isDefault;
-        dst->id = src->id; // struct copy
-    }
-    self->playbackCount = playbackCount;
-    self->playbackGeneration++; 
+int engine_evict_asset(Engine *self, const char *key)
+{
+    if (self == NULL || !self->assets_ready) return 0;
+    return asset_cache_evict(&self->assets, key);
+}
+
+uint64_t engine_trim_assets(Engine *self)
+{
+    if (self == NULL || !self->assets_ready) return 0;
+    return asset_cache_trim(&self->assets);
+}
+
+int engine_get_asset_stats(Engine *self, uint32_t *outCount, uint64_t *outBytes)
+{
+    if (self == NULL || !self->assets_ready) return 0;
+    ma_mutex_lock(&self->assets.lock);
+    if (outCount) *outCount = self->assets.count;
+    if (outBytes) *outBytes = self->assets.bytes;
+    ma_mutex_unlock(&self->assets.lock);
     return 1;
 }
 
+// Re-enumerate devices for every component sharing the context.
+int engine_refresh_playback_devices(Engine* self) {
+    if (self == NULL || self->context == NULL) return 0;
+    return audio_context_refresh_devices();
+}
+
 ma_uint32 engine_get_playback_device_count(Engine* self) {
-    return self ? self->playbackCount : 0;
+    return self ? audio_context_get_device_count(ma_device_type_playback) : 0;
 }
 
 int engine_get_playback_device_name(Engine* self, ma_uint32 index, char* outName, ma_uint32 capName, ma_bool32* pIsDefault) {
-    if (!self || index >= self->playbackCount || !outName || capName == 0) return 0;
-    PlaybackDeviceInfo* info = &self->playbackInfos[index];
-    size_t n = strlen(info->name);
+    AudioDeviceInfo info;
+    if (!self || !outName || capName == 0) return 0;
+    if (!audio_context_get_device(ma_device_type_playback, index, &info)) return 0;
+    size_t n = strlen(info.name);
     if (n >= capName) n = capName - 1;
-    memcpy(outName, info->name, n);
+    memcpy(outName, info.name, n);
     outName[n] = '\0';
-    if (pIsDefault) *pIsDefault = info->isDefault;
+    if (pIsDefault) *pIsDefault = info.isDefault;
     return 1;
 }
 
-// Recreate engine on selected playback device. Caller should stop sounds/players first.
+// Move output to the selected playback device. Only the ma_device is
+// replaced: the engine, its node graph and everything playing through it
+// stay as they are, so sounds and stream players carry on where they were.
+// The new device runs at the engine's format and converts to the hardware
+// if it has to. On failure the current device is kept.
 int engine_select_playback_device_by_index(Engine* self, ma_uint32 index) {
-    if (!self || index >= self->playbackCount) return 0;
-
-    // Preserve state
-    bool was_started = self->is_started;
-
-    if (was_started) {
-        ma_engine_stop(&self->engine);
+    AudioDeviceInfo info;
+    if (!self || self->offline) return 0;
+    if (!audio_context_get_device(ma_device_type_playback, index, &info)) return 0;
+
+    ma_device* next = engine_open_device(self, &info.id,
+                                         ma_engine_get_channels(&self->engine),
+                                         ma_engine_get_sample_rate(&self->engine));
+    if (next == NULL) return 0;
+
+    // Neither device runs while the pointer changes hands, so the audio
+    // thread never sees the swap.
+    bool const was_started = self->is_started;
+    ma_device* prev = self->engine.pDevice;
+    if (was_started) ma_device_stop(prev);
+    self->engine.pDevice = next;
+    // New device, new timing: the audio thread starts over on it.
+    self->last_callback_us = 0;
+    au_store_u32(&self->load_reset, 1);
+    if (was_started && ma_device_start(next) != MA_SUCCESS) {
         self->is_started = false;
     }
-    ma_engine_uninit(&self->engine);
+    ma_device_uninit(prev);
+    ma_free(prev, NULL);
 
-    ma_engine_config engine_config = ma_engine_config_init();
-    engine_config.noAutoStart = true;
-    engine_config.pContext = &self->context;
-    // Use the selected device id
-    engine_config.pPlaybackDeviceID = &self->playbackInfos[index].id;
-
-    if (ma_engine_init(&engine_config, &self->engine) != MA_SUCCESS) {
-        // Try to fall back to default device
-        ma_engine_config fallback = ma_engine_config_init();
-        fallback.noAutoStart = true;
-        fallback.pContext = &self->context;
-        if (ma_engine_init(&fallback, &self->engine) != MA_SUCCESS) {
-            return 0;
-        }
-    }
+    self->playbackGeneration++; // NEW
+    return self->is_started == was_started;
+}
 
-    self->dec_config = ma_decoder_config_init(
-        self->engine.pDevice->playback.format,
-        self->engine.pDevice->playback.channels,
-        self->engine.sampleRate);
+void engine_set_max_voices(Engine *self, uint32_t max_voices) {
+    if (self) voice_scheduler_set_max_voices(&self->scheduler, max_voices);
+}
 
-    if (was_started) {
-        if (ma_engine_start(&self->engine) != MA_SUCCESS) {
-            return 0;
+uint32_t engine_get_max_voices(Engine *self) {
+    return self ? self->scheduler.maxVoices : 0;
+}
+
+int engine_get_voice_stats(Engine *self, uint32_t *outMixed, uint32_t *outVirtual) {
+    if (self == NULL) return 0;
+    if (outMixed) *outMixed = self->scheduler.mixedVoices;
+    if (outVirtual) *outVirtual = self->scheduler.virtualVoices;
+    return 1;
+}
+
+uint64_t engine_get_time_in_pcm_frames(Engine *self) {
+    return self ? ma_engine_get_time_in_pcm_frames(&self->engine) : 0;
+}
+
+uint32_t engine_get_sample_rate(Engine *self) {
+    return self ? ma_engine_get_sample_rate(&self->engine) : 0;
+}
+
+int engine_get_load_stats(Engine *self, EngineLoadStats *out)
+{
+    if (self == NULL || out == NULL) return 0;
+    // The audio thread holds the sequence odd for well under a
+    // microsecond, so this settles within a few tries.
+    for (int attempt = 0; attempt < 100000; ++attempt) {
+        uint32_t const seq = au_load_u32(&self->load_seq);
+        if (seq & 1) continue;
+        memcpy(out, &self->load, sizeof(*out));
+        au_fence();
+        if (au_load_u32(&self->load_seq) != seq) continue;
+        if (au_load_u32(&self->load_reset)) {
+            // Not applied yet (no callback since): it reads as applied.
+            int const backend = out->backend;
+            memset(out, 0, sizeof(*out));
+            out->backend = backend;
         }
-        self->is_started = true;
+        return 1;
     }
-    self->playbackGeneration++; // NEW
-    return 1;
+    return 0;
+}
+
+void engine_reset_load_stats(Engine *self)
+{
+    if (self) au_store_u32(&self->load_reset, 1);
 }
 
 ma_engine* engine_get_ma_engine(Engine *self) {
@@ -220,6 +823,140 @@ ma_engine* engine_get_ma_engine(Engine *self) {
     return &self->engine;
 }
 
+int engine_set_duplex(Engine *self, uint32_t capture_channels, uint32_t buffer_ms)
+{
+    // The device type is fixed when the engine opens it.
+    if (self == NULL || self->resource_manager_ready) return 0;
+    if (capture_channels > MA_MAX_CHANNELS) return 0;
+    self->duplex_channels = capture_channels;
+    self->duplex_buffer_ms = buffer_ms ? buffer_ms : ENGINE_DUPLEX_BUFFER_MS;
+    return 1;
+}
+
+uint32_t engine_get_capture_channels(Engine *self) {
+    return self && self->duplex_ready ? self->duplex_channels : 0;
+}
+
+uint32_t engine_get_channels(Engine *self) {
+    return self ? ma_engine_get_channels(&self->engine) : 0;
+}
+
+uint32_t engine_duplex_available(Engine *self) {
+    if (self == NULL || !self->duplex_ready) return 0;
+    return ma_pcm_rb_available_read(&self->duplex_rb);
+}
+
+uint32_t engine_duplex_read(Engine *self, float *capture, float *reference, uint32_t frames) {
+    if (self == NULL || !self->duplex_ready) return 0;
+    ma_uint32 const inCh  = self->duplex_channels;
+    ma_uint32 const outCh = ma_engine_get_channels(&self->engine);
+
+    uint32_t done = 0;
+    while (done < frames) {
+        ma_uint32 n = frames - done;
+        void* src = NULL;
+        if (ma_pcm_rb_acquire_read(&self->duplex_rb, &n, &src) != MA_SUCCESS || n == 0) break;
+        const float* f = (const float*)src;
+        for (ma_uint32 i = 0; i < n; ++i) {
+            if (capture) memcpy(capture + (done + i) * inCh, f, inCh * sizeof(float));
+            if (reference) memcpy(reference + (done + i) * outCh, f + inCh, outCh * sizeof(float));
+            f += inCh + outCh;
+        }
+        ma_pcm_rb_commit_read(&self->duplex_rb, n);
+        done += n;
+    }
+    return done;
+}
+
+void engine_set_monitor_gain(Engine *self, float gain) {
+    if (self) au_store_f32(&self->monitor_gain, gain < 0.0f ? 0.0f : gain);
+}
+
+float engine_get_monitor_gain(Engine *self) {
+    return self ? au_load_f32(&self->monitor_gain) : 0.0f;
+}
+
+// Swaps the reference under echo_lock, so the audio thread never pushes
+// into one being detached.
+static int engine_swap_echo_reference(Engine *self, bool any, EchoCanceller *expected,
+                                      EchoCanceller *ec)
+{
+    if (self == NULL) return 0;
+    // Converted to the canceller's rate on the audio thread; set up here.
+    if (ec != NULL &&
+        !echo_canceller_set_reference_rate(ec, ma_engine_get_sample_rate(&self->engine)))
+        return 0;
+    while (!au_cas_u32(&self->echo_lock, 0, 1)) { /* one callback's push at most */ }
+    int const ok = any || self->echo_reference == expected;
+    if (ok) self->echo_reference = ec;
+    au_store_u32(&self->echo_lock, 0);
+    return ok;
+}
+
+int engine_set_echo_reference(Engine *self, EchoCanceller *ec)
+{
+    return engine_swap_echo_reference(self, true, NULL, ec);
+}
+
+int engine_replace_echo_reference(Engine *self, EchoCanceller *expected, EchoCanceller *ec)
+{
+    return engine_swap_echo_reference(self, false, expected, ec);
+}
+
+EngineLatencyConfig engine_latency_config_init(EngineLatencyProfile profile)
+{
+    EngineLatencyConfig cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.profile = profile;
+    switch (profile) {
+    case ENGINE_LATENCY_LOW:
+        cfg.periodFrames = 256;
+        cfg.periods = 3;
+        break;
+    case ENGINE_LATENCY_ULTRA:
+        cfg.periodFrames = 128;
+        cfg.periods = 2;
+        cfg.exclusive = 1;
+        cfg.noFixedSizedCallback = 1;
+        cfg.preferLowLatencyBackend = 1;
+        break;
+    default:
+        cfg.profile = ENGINE_LATENCY_CONSERVATIVE;
+        break;
+    }
+    return cfg;
+}
+
+int engine_set_latency_config(Engine *self, const EngineLatencyConfig *config)
+{
+    // Device settings, fixed once engine_init opens it.
+    if (self == NULL || config == NULL || self->resource_manager_ready) return 0;
+    self->latency = *config;
+    self->latency_set = true;
+    return 1;
+}
+
+int engine_get_latency_info(Engine *self, EngineLatencyInfo *out)
+{
+    if (self == NULL || out == NULL || self->engine.pDevice == NULL) return 0;
+    ma_device const* device = self->engine.pDevice;
+    memset(out, 0, sizeof(*out));
+    out->periodFrames  = device->playback.internalPeriodSizeInFrames;
+    out->periods       = device->playback.internalPeriods;
+    out->sampleRate    = device->playback.internalSampleRate;
+    out->latencyFrames = out->periodFrames * out->periods;
+    out->latencyMs     = out->sampleRate ? out->latencyFrames * 1000.0f / out->sampleRate : 0.0f;
+    out->exclusive     = device->playback.shareMode == ma_share_mode_exclusive;
+    out->backend       = self->context ? (int)self->context->backend : 0;
+    return 1;
+}
+
+const char* engine_get_backend_name(Engine *self)
+{
+    if (self == NULL || self->context == NULL) return "";
+    return ma_get_backend_name(self->context->backend);
+}
+
 ma_uint32 engine_get_playback_device_generation(Engine* self) {
-    return self ? self->playbackGeneration : 0;
+    return self ? audio_context_get_generation() + self->playbackGeneration : 0;
 }
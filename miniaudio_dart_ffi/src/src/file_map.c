@@ -0,0 +1,99 @@
+#include "../include/file_map.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+int file_map_open(FileMap* map, const char* path) {
+    if (!map || !path) return 0;
+    memset(map, 0, sizeof(*map));
+
+    wchar_t wpath[MAX_PATH * 4];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, (int)(sizeof(wpath) / sizeof(wpath[0]))) == 0)
+        return 0;
+
+    HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return 0;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); /* the mapping keeps the file open */
+    if (mapping == NULL) return 0;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        return 0;
+    }
+    map->data   = view;
+    map->size   = (size_t)size.QuadPart;
+    map->handle = mapping;
+    return 1;
+}
+
+void file_map_close(FileMap* map) {
+    if (!map || !map->data) return;
+    UnmapViewOfFile(map->data);
+    CloseHandle((HANDLE)map->handle);
+    memset(map, 0, sizeof(*map));
+}
+
+#elif defined(__EMSCRIPTEN__)
+
+/* No file system worth mapping in the browser build. */
+int file_map_open(FileMap* map, const char* path) {
+    (void)path;
+    if (map) memset(map, 0, sizeof(*map));
+    return 0;
+}
+
+void file_map_close(FileMap* map) {
+    (void)map;
+}
+
+#else
+
+int file_map_open(FileMap* map, const char* path) {
+    if (!map || !path) return 0;
+    memset(map, 0, sizeof(*map));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* the mapping keeps the file open */
+    if (view == MAP_FAILED) return 0;
+
+    /* Decoders read front to back. */
+    madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+    map->data = view;
+    map->size = (size_t)st.st_size;
+    return 1;
+}
+
+void file_map_close(FileMap* map) {
+    if (!map || !map->data) return;
+    munmap(map->data, map->size);
+    memset(map, 0, sizeof(*map));
+}
+
+#endif
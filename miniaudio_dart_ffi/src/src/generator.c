@@ -1,4 +1,5 @@
 #include "../include/generator.h"
+#include "../include/audio_context.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -11,6 +12,8 @@ ma_waveform waveform;
 ma_pulsewave pulsewave;
 ma_noise noise;
 ma_device device;
+static ma_bool32 deviceReady = MA_FALSE;
+static ma_context *context = NULL; /* shared, see audio_context.h */
 ma_device_config deviceConfig;
 ma_waveform_config sineWaveConfig;
 
@@ -30,6 +33,16 @@ void generator_destroy(Generator *generator)
 {
     if (generator != NULL)
     {
+        if (deviceReady)
+        {
+            ma_device_uninit(&device);
+            deviceReady = MA_FALSE;
+        }
+        if (context != NULL)
+        {
+            audio_context_release();
+            context = NULL;
+        }
         ma_waveform_uninit(&waveform);
         ma_pulsewave_uninit(&pulsewave);
         ma_noise_uninit(&noise, NULL);
@@ -79,11 +92,14 @@ GeneratorResult generator_init(Generator *generator, ma_format format, int chann
     deviceConfig.dataCallback = data_callback;
     deviceConfig.pUserData = generator;
 
-    if (ma_device_init(NULL, &deviceConfig, &device) != MA_SUCCESS)
+    if (context == NULL)
+        context = audio_context_acquire();
+    if (context == NULL || ma_device_init(context, &deviceConfig, &device) != MA_SUCCESS)
     {
         printf("Failed to open playback device.\n");
         return -4;
     }
+    deviceReady = MA_TRUE;
     if (generator == NULL)
     {
         printf("Error: Generator is NULL in generator_init.\n");
@@ -104,6 +120,7 @@ GeneratorResult generator_init(Generator *generator, ma_format format, int chann
     {
         printf("Error: Failed to initialize circular buffer.\n");
         ma_device_uninit(&device);
+        deviceReady = MA_FALSE;
         return GENERATOR_ERROR;
     }
 
@@ -0,0 +1,140 @@
+#include "../include/mix_bus.h"
+#include "../include/effect_chain.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct MixBus {
+    ma_engine*     engine;
+    ma_sound_group group;
+    EffectChain    effects;  /* group -> effects -> parent or endpoint */
+    MixBus*        parent;
+    float          volume;
+    bool           muted;
+    int            initialized;
+    char           name[MIX_BUS_NAME_MAX];
+};
+
+/*************
+ ** private **
+ *************/
+
+static void mb_route(void* owner, ma_node* input) {
+    MixBus* self = (MixBus*)owner;
+    ma_node_attach_output_bus(&self->group, 0, input, 0);
+}
+
+/************
+ ** public **
+ ************/
+
+MixBus* mix_bus_alloc(void) {
+    return (MixBus*)calloc(1, sizeof(MixBus));
+}
+
+void mix_bus_free(MixBus* self) {
+    if (!self) return;
+    mix_bus_uninit(self);
+    free(self);
+}
+
+int mix_bus_init(MixBus* self, Engine* engine, const char* name) {
+    if (!self || !engine || self->initialized) return 0;
+    ma_engine* mae = engine_get_ma_engine(engine);
+    if (!mae) return 0;
+
+    ma_sound_group_config config = ma_sound_group_config_init_2(mae);
+    config.volumeSmoothTimeInPCMFrames =
+        ma_engine_get_sample_rate(mae) * MIX_BUS_SMOOTH_MS / 1000;
+    if (ma_sound_group_init_ex(mae, &config, &self->group) != MA_SUCCESS) return 0;
+
+    self->engine = mae;
+    self->parent = NULL;
+    self->volume = 1.0f;
+    self->muted  = false;
+    memset(self->name, 0, sizeof(self->name));
+    if (name) strncpy(self->name, name, MIX_BUS_NAME_MAX - 1);
+    /* The group starts out attached to the endpoint, which is the chain's
+       empty state already. */
+    effect_chain_init(&self->effects, ma_engine_get_endpoint(mae), mb_route, self);
+    self->initialized = 1;
+    return 1;
+}
+
+void mix_bus_uninit(MixBus* self) {
+    if (!self || !self->initialized) return;
+    /* Detaches the members too; uninit the group before releasing effects
+       so nothing is pulled through them meanwhile. */
+    ma_sound_group_uninit(&self->group);
+    for (uint32_t i = 0; i < self->effects.count; ++i) {
+        ma_node_detach_output_bus(self->effects.effects[i], 0);
+    }
+    memset(&self->effects, 0, sizeof(self->effects));
+    self->parent = NULL;
+    self->initialized = 0;
+}
+
+const char* mix_bus_get_name(MixBus* self) {
+    return self ? self->name : "";
+}
+
+void mix_bus_set_volume(MixBus* self, float volume) {
+    if (!self || !self->initialized) return;
+    self->volume = volume < 0.0f ? 0.0f : volume;
+    ma_sound_group_set_volume(&self->group, self->volume);
+}
+
+float mix_bus_get_volume(MixBus* self) {
+    return self ? self->volume : 1.0f;
+}
+
+void mix_bus_set_muted(MixBus* self, bool muted) {
+    if (!self || !self->initialized || self->muted == muted) return;
+    self->muted = muted;
+    /* -1 starts from wherever a fade in progress is. */
+    ma_sound_group_set_fade_in_milliseconds(&self->group, -1.0f, muted ? 0.0f : 1.0f,
+                                            MIX_BUS_SMOOTH_MS);
+}
+
+bool mix_bus_get_muted(MixBus* self) {
+    return self ? self->muted : false;
+}
+
+int mix_bus_set_parent(MixBus* self, MixBus* parent) {
+    if (!self || !self->initialized) return 0;
+    if (parent) {
+        if (!parent->initialized || parent->engine != self->engine) return 0;
+        for (MixBus* up = parent; up; up = up->parent) {
+            if (up == self) return 0;
+        }
+    }
+    self->parent = parent;
+    effect_chain_set_target(&self->effects,
+                            parent ? mix_bus_get_input(parent) : ma_engine_get_endpoint(self->engine));
+    return 1;
+}
+
+MixBus* mix_bus_get_parent(MixBus* self) {
+    return self ? self->parent : NULL;
+}
+
+int mix_bus_insert_effect(MixBus* self, ma_node* effect, int index) {
+    if (!self || !self->initialized) return 0;
+    return effect_chain_insert(&self->effects, effect, index);
+}
+
+int mix_bus_remove_effect(MixBus* self, ma_node* effect) {
+    if (!self || !self->initialized) return 0;
+    return effect_chain_remove(&self->effects, effect);
+}
+
+void mix_bus_clear_effects(MixBus* self) {
+    if (self && self->initialized) effect_chain_clear(&self->effects);
+}
+
+ma_node* mix_bus_get_input(MixBus* self) {
+    return (self && self->initialized) ? (ma_node*)&self->group : NULL;
+}
+
+ma_engine* mix_bus_get_engine(MixBus* self) {
+    return (self && self->initialized) ? self->engine : NULL;
+}
@@ -0,0 +1,576 @@
+#include "../include/playlist.h"
+#include "../include/atomic_util.h"
+#include "../include/mix_bus.h"
+#include "../include/effect_chain.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define PL_INDEX_MASK     (PLAYLIST_MAX_ITEMS - 1)
+#define PL_SCRATCH_FRAMES 1024
+
+typedef struct PlaylistItem {
+    uint32_t   id;
+    ma_decoder decoder;
+    bool       has_decoder;
+    void*      encoded;       /* owned bytes behind an in-memory decoder */
+    float*     pcm;           /* the whole PCM item */
+    ma_uint64  pcm_frames;
+    /* A decoder item is read from here. The control thread fills it before
+       queueing, then a job refills it whenever it runs down to refill_at;
+       only that job touches the decoder. */
+    ma_pcm_rb         ring;
+    bool              has_ring;
+    ma_uint32         refill_at;
+    volatile uint32_t refilling;  /* a job is posted or running */
+    volatile uint32_t eof;        /* the decoder is drained */
+    ma_uint64  length;        /* 0 when the decoder cannot tell */
+    ma_uint64  cursor;        /* audio thread once queued */
+} PlaylistItem;
+
+typedef struct {
+    ma_data_source_base base;
+    struct Playlist*    owner;
+} pl_data_source;
+
+struct Playlist {
+    ma_engine*     engine;
+    ma_sound       sound;
+    EffectChain    effects;  /* sound -> effects -> bus or endpoint */
+    pl_data_source ds;
+    ma_uint32      channels;
+    ma_uint32      sample_rate;
+    int            initialized;
+    int            started;
+    float          volume;
+    uint32_t       next_id;
+
+    /* Ring of items: [reclaimed, head) finished and waiting to be freed,
+       [head, tail) queued. Indices run freely and are masked on access. */
+    PlaylistItem*     items[PLAYLIST_MAX_ITEMS];
+    volatile uint32_t head;       /* written by the audio thread */
+    volatile uint32_t tail;       /* written by the control thread */
+    uint32_t          reclaimed;  /* control thread */
+    volatile uint32_t skip_to;    /* head the audio thread should move to */
+    volatile uint32_t crossfade_frames;
+
+    /* Audio thread only. */
+    float*    scratch;
+    bool      fading;
+    ma_uint64 fade_from;
+    ma_uint64 fade_len;
+};
+
+#define PL_CONTAINER_OF(ptr, type, member) ((type*)((char*)(ptr) - offsetof(type, member)))
+
+/*************
+ ** private **
+ *************/
+
+static void pl_route(void* owner, ma_node* input) {
+    Playlist* self = (Playlist*)owner;
+    ma_node_attach_output_bus(&self->sound, 0, input, 0);
+}
+
+static int pl_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static void pl_item_free(PlaylistItem* it) {
+    if (!it) return;
+    if (it->has_ring) ma_pcm_rb_uninit(&it->ring);
+    if (it->has_decoder) ma_decoder_uninit(&it->decoder);
+    free(it->encoded);
+    free(it->pcm);
+    free(it);
+}
+
+/* Until no refill job holds the item. */
+static void pl_item_wait(Playlist* self, PlaylistItem* it) {
+    ma_resource_manager* rm = ma_engine_get_resource_manager(self->engine);
+    while (au_load_u32(&it->refilling) != 0) {
+        if (rm && rm->config.jobThreadCount == 0) {
+            ma_resource_manager_process_next_job(rm);  /* nobody else will */
+            continue;
+        }
+#if defined(_WIN32)
+        Sleep(1);
+#else
+        usleep(1000);
+#endif
+    }
+}
+
+/* Free the items the audio thread has moved past, up to one a refill job
+   still holds; the next call gets the rest. Control thread. */
+static void pl_reclaim(Playlist* self) {
+    uint32_t const head = au_load_u32(&self->head);
+    while (self->reclaimed != head) {
+        uint32_t const slot = self->reclaimed & PL_INDEX_MASK;
+        if (au_load_u32(&self->items[slot]->refilling)) break;
+        pl_item_free(self->items[slot]);
+        self->items[slot] = NULL;
+        self->reclaimed++;
+    }
+}
+
+static ma_uint64 pl_ms_to_frames(Playlist* self, uint32_t ms) {
+    return (ma_uint64)ms * self->sample_rate / 1000;
+}
+
+/* Decode into the item's ring until it is full or the decoder runs dry.
+   The control thread before the item is queued, then one job at a time. */
+static int pl_item_fill(PlaylistItem* it) {
+    for (;;) {
+        ma_uint32 n = ma_pcm_rb_available_write(&it->ring);
+        void* dst = NULL;
+        if (n == 0 || ma_pcm_rb_acquire_write(&it->ring, &n, &dst) != MA_SUCCESS || n == 0) return 1;
+        ma_uint64 read = 0;
+        ma_result const r = ma_decoder_read_pcm_frames(&it->decoder, dst, n, &read);
+        ma_pcm_rb_commit_write(&it->ring, (ma_uint32)read);
+        if (read < n) {
+            au_store_u32(&it->eof, 1);  /* after the frames it follows */
+            return r == MA_SUCCESS || r == MA_AT_END;
+        }
+    }
+}
+
+static ma_result pl_refill_job(ma_job* job) {
+    PlaylistItem* it = (PlaylistItem*)job->data.custom.data0;
+    pl_item_fill(it);
+    au_store_u32(&it->refilling, 0);  /* the item may be freed from here on */
+    return MA_SUCCESS;
+}
+
+/* Audio thread: post a refill once the ring is down to refill_at. A full
+   job queue just means trying again on the next read. */
+static void pl_item_refill(Playlist* self, PlaylistItem* it) {
+    if (au_load_u32(&it->eof) || ma_pcm_rb_available_read(&it->ring) > it->refill_at) return;
+    if (!au_cas_u32(&it->refilling, 0, 1)) return;
+    ma_job job = ma_job_init(MA_JOB_TYPE_CUSTOM);
+    job.data.custom.proc  = pl_refill_job;
+    job.data.custom.data0 = (ma_uintptr)it;
+    ma_resource_manager* rm = ma_engine_get_resource_manager(self->engine);
+    if (rm == NULL || ma_resource_manager_post_job(rm, &job) != MA_SUCCESS) {
+        au_store_u32(&it->refilling, 0);
+    }
+}
+
+/* Give a freshly opened item its ring, PLAYLIST_PREFETCH_MS or the
+   crossfade if longer, and fill it so the audio thread starts it from
+   memory. It is refilled once half of it has played. */
+static int pl_item_prefetch(Playlist* self, PlaylistItem* it) {
+    ma_uint64 frames = pl_ms_to_frames(self, PLAYLIST_PREFETCH_MS);
+    ma_uint64 const crossfade = au_load_u32(&self->crossfade_frames);
+    if (crossfade > frames) frames = crossfade;
+    if (it->length > 0 && it->length < frames) frames = it->length;
+    if (frames == 0) frames = 1;
+
+    if (ma_pcm_rb_init(ma_format_f32, self->channels, (ma_uint32)frames, NULL, NULL, &it->ring) != MA_SUCCESS)
+        return 0;
+    it->has_ring  = true;
+    it->refill_at = (ma_uint32)(frames / 2);
+    return pl_item_fill(it);
+}
+
+static uint32_t pl_push(Playlist* self, PlaylistItem* it) {
+    pl_reclaim(self);
+    uint32_t const tail = self->tail;
+    if (tail - self->reclaimed >= PLAYLIST_MAX_ITEMS) {
+        pl_item_free(it);
+        return 0;
+    }
+    if (++self->next_id == 0) self->next_id = 1;
+    it->id = self->next_id;
+    self->items[tail & PL_INDEX_MASK] = it;
+    au_store_u32(&self->tail, tail + 1);  /* publishes the item */
+    return it->id;
+}
+
+static uint32_t pl_push_decoded(Playlist* self, PlaylistItem* it) {
+    it->has_decoder = true;
+    ma_decoder_get_length_in_pcm_frames(&it->decoder, &it->length);
+    if (!pl_item_prefetch(self, it)) {
+        pl_item_free(it);
+        return 0;
+    }
+    return pl_push(self, it);
+}
+
+static ma_decoder_config pl_decoder_config(Playlist* self) {
+    return ma_decoder_config_init(ma_format_f32, self->channels, self->sample_rate);
+}
+
+/* Never touches the decoder: a ring that ran dry returns short, see
+   pl_item_ended. */
+static ma_uint64 pl_item_read(Playlist* self, PlaylistItem* it, float* out, ma_uint64 frames) {
+    ma_uint64 done = 0;
+    if (it->has_ring) {
+        while (done < frames) {
+            ma_uint32 n = (ma_uint32)(frames - done);
+            void* src = NULL;
+            if (ma_pcm_rb_acquire_read(&it->ring, &n, &src) != MA_SUCCESS || n == 0) break;
+            memcpy(out + done * self->channels, src, (size_t)n * self->channels * sizeof(float));
+            ma_pcm_rb_commit_read(&it->ring, n);
+            done += n;
+        }
+        pl_item_refill(self, it);
+    } else if (it->cursor < it->pcm_frames) {
+        done = it->pcm_frames - it->cursor;
+        if (done > frames) done = frames;
+        memcpy(out, it->pcm + it->cursor * self->channels,
+               (size_t)done * self->channels * sizeof(float));
+    }
+    it->cursor += done;
+    return done;
+}
+
+/* Whether a short read was the item's end, not a refill running late. */
+static bool pl_item_ended(PlaylistItem* it) {
+    if (!it->has_ring) return it->cursor >= it->pcm_frames;
+    return au_load_u32(&it->eof) && ma_pcm_rb_available_read(&it->ring) == 0;
+}
+
+static void pl_advance(Playlist* self, uint32_t head) {
+    au_store_u32(&self->head, head + 1);
+    self->fading = false;
+}
+
+static void pl_apply_skips(Playlist* self) {
+    uint32_t const head = self->head;
+    uint32_t const target = au_load_u32(&self->skip_to);
+    if (!pl_before(head, target)) return;
+    au_store_u32(&self->head, target);  /* never past the tail */
+    self->fading = false;
+}
+
+/* Blend `in` into `out` over the fade window, equal power. */
+static void pl_mix_fade(Playlist* self, float* out, const float* in, ma_uint64 frames, ma_uint64 pos) {
+    ma_uint32 const ch = self->channels;
+    float const len = (float)self->fade_len;
+    for (ma_uint64 i = 0; i < frames; ++i) {
+        float const t = (float)(pos + i + 1) / len;
+        float const gOut = sqrtf(t < 1.0f ? 1.0f - t : 0.0f);
+        float const gIn  = sqrtf(t < 1.0f ? t : 1.0f);
+        for (ma_uint32 c = 0; c < ch; ++c) {
+            out[i * ch + c] = out[i * ch + c] * gOut + in[i * ch + c] * gIn;
+        }
+    }
+}
+
+static ma_result pl_on_read(ma_data_source* pDS, void* pFramesOut, ma_uint64 frameCount, ma_uint64* pFramesRead) {
+    Playlist* self = PL_CONTAINER_OF(pDS, pl_data_source, base)->owner;
+    ma_uint32 const ch = self->channels;
+    float* out = (float*)pFramesOut;
+    ma_uint64 left = frameCount;
+
+    pl_apply_skips(self);
+    while (left > 0) {
+        uint32_t const head = self->head;
+        uint32_t const tail = au_load_u32(&self->tail);
+        if (head == tail) {
+            memset(out, 0, (size_t)left * ch * sizeof(float));  /* drained */
+            break;
+        }
+        PlaylistItem* cur  = self->items[head & PL_INDEX_MASK];
+        PlaylistItem* next = head + 1 != tail ? self->items[(head + 1) & PL_INDEX_MASK] : NULL;
+        ma_uint64 n = left < PL_SCRATCH_FRAMES ? left : PL_SCRATCH_FRAMES;
+
+        if (!next) self->fading = false;  /* the next item was skipped away */
+        if (!self->fading && next && cur->length > cur->cursor) {
+            ma_uint64 fade = au_load_u32(&self->crossfade_frames);
+            if (fade > cur->length / 2) fade = cur->length / 2;
+            ma_uint64 const remaining = cur->length - cur->cursor;
+            if (fade > 0 && remaining <= fade) {
+                /* Also covers a next item queued after the window opened. */
+                self->fading    = true;
+                self->fade_from = cur->cursor;
+                self->fade_len  = remaining;
+            } else if (fade > 0 && n > remaining - fade) {
+                n = remaining - fade;  /* stop on the window's first frame */
+            }
+        }
+
+        if (self->fading) {
+            ma_uint64 const fadeEnd = self->fade_from + self->fade_len;
+            if (n > fadeEnd - cur->cursor) n = fadeEnd - cur->cursor;
+            ma_uint64 const pos = cur->cursor - self->fade_from;
+            ma_uint64 a = pl_item_read(self, cur, out, n);
+            if (a < n && !pl_item_ended(cur)) {
+                /* Behind on decoding: a gap, not the end of the item. */
+                memset(out + a * ch, 0, (size_t)(n - a) * ch * sizeof(float));
+                a = n;
+            }
+            ma_uint64 const b = pl_item_read(self, next, self->scratch, n);
+            memset(self->scratch + b * ch, 0, (size_t)(n - b) * ch * sizeof(float));
+            pl_mix_fade(self, out, self->scratch, a, pos);
+            /* The outgoing item ran short of its reported length. */
+            if (b > a) memcpy(out + a * ch, self->scratch + a * ch, (size_t)(b - a) * ch * sizeof(float));
+            ma_uint64 const produced = a > b ? a : b;
+            if (a < n || cur->cursor >= fadeEnd) pl_advance(self, head);
+            out  += produced * ch;
+            left -= produced;
+            continue;
+        }
+
+        ma_uint64 got = pl_item_read(self, cur, out, n);
+        if (got < n && !pl_item_ended(cur)) {
+            /* Behind on decoding, as above. */
+            memset(out + got * ch, 0, (size_t)(n - got) * ch * sizeof(float));
+            got = n;
+        }
+        if (got < n) pl_advance(self, head);  /* gapless: the loop goes on into the next */
+        out  += got * ch;
+        left -= got;
+    }
+
+    if (pFramesRead) *pFramesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+static ma_result pl_on_seek(ma_data_source* pDS, ma_uint64 frameIndex) {
+    (void)pDS; (void)frameIndex;
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_result pl_on_format(ma_data_source* pDS,
+                              ma_format* pFormat,
+                              ma_uint32* pChannels,
+                              ma_uint32* pSampleRate,
+                              ma_channel* pChannelMap,
+                              size_t channelMapCap)
+{
+    (void)pChannelMap; (void)channelMapCap;
+    Playlist* self = PL_CONTAINER_OF(pDS, pl_data_source, base)->owner;
+    if (pFormat)     *pFormat     = ma_format_f32;
+    if (pChannels)   *pChannels   = self->channels;
+    if (pSampleRate) *pSampleRate = self->sample_rate;
+    return MA_SUCCESS;
+}
+
+static ma_data_source_vtable g_pl_vtable = {
+    pl_on_read,
+    pl_on_seek,
+    pl_on_format,
+    NULL,
+    NULL,
+    NULL,
+    0
+};
+
+/************
+ ** public **
+ ************/
+
+Playlist* playlist_alloc(void) {
+    Playlist* self = (Playlist*)ma_malloc(sizeof(Playlist), NULL);
+    if (self) memset(self, 0, sizeof(Playlist));
+    return self;
+}
+
+void playlist_free(Playlist* self) {
+    if (!self) return;
+    playlist_uninit(self);
+    ma_free(self, NULL);
+}
+
+int playlist_init(Playlist* self, Engine* engine, uint32_t crossfade_ms) {
+    if (!self || !engine || self->initialized) return 0;
+    ma_engine* mae = engine_get_ma_engine(engine);
+    if (!mae) return 0;
+
+    self->engine      = mae;
+    self->channels    = ma_engine_get_channels(mae);
+    self->sample_rate = ma_engine_get_sample_rate(mae);
+    self->volume      = 1.0f;
+    au_store_u32(&self->crossfade_frames, (uint32_t)pl_ms_to_frames(self, crossfade_ms));
+
+    self->scratch = (float*)malloc((size_t)PL_SCRATCH_FRAMES * self->channels * sizeof(float));
+    if (!self->scratch) return 0;
+
+    self->ds.owner = self;
+    ma_data_source_config dsc = ma_data_source_config_init();
+    dsc.vtable = &g_pl_vtable;
+    if (ma_data_source_init(&dsc, (ma_data_source*)&self->ds.base) != MA_SUCCESS) {
+        free(self->scratch);
+        self->scratch = NULL;
+        return 0;
+    }
+    if (ma_sound_init_from_data_source(mae,
+                                       (ma_data_source*)&self->ds.base,
+                                       MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_NO_SPATIALIZATION,
+                                       NULL,
+                                       &self->sound) != MA_SUCCESS) {
+        ma_data_source_uninit((ma_data_source*)&self->ds.base);
+        free(self->scratch);
+        self->scratch = NULL;
+        return 0;
+    }
+    effect_chain_init(&self->effects, ma_engine_get_endpoint(mae), pl_route, self);
+    self->initialized = 1;
+    return 1;
+}
+
+void playlist_uninit(Playlist* self) {
+    if (!self || !self->initialized) return;
+    effect_chain_clear(&self->effects);
+    ma_sound_uninit(&self->sound);
+    ma_data_source_uninit((ma_data_source*)&self->ds.base);
+    for (uint32_t i = self->reclaimed; i != self->tail; ++i) {
+        pl_item_wait(self, self->items[i & PL_INDEX_MASK]);
+        pl_item_free(self->items[i & PL_INDEX_MASK]);
+    }
+    free(self->scratch);
+    memset(self, 0, sizeof(*self));
+}
+
+int playlist_start(Playlist* self) {
+    if (!self || !self->initialized) return 0;
+    if (self->started) return 1;
+    if (ma_sound_start(&self->sound) != MA_SUCCESS) return 0;
+    self->started = 1;
+    return 1;
+}
+
+int playlist_stop(Playlist* self) {
+    if (!self || !self->initialized) return 0;
+    ma_sound_stop(&self->sound);
+    self->started = 0;
+    return 1;
+}
+
+void playlist_set_volume(Playlist* self, float volume) {
+    if (!self || !self->initialized) return;
+    self->volume = volume;
+    ma_sound_set_volume(&self->sound, volume);
+}
+
+float playlist_get_volume(Playlist* self) {
+    return self ? self->volume : 1.0f;
+}
+
+int playlist_set_bus(Playlist* self, struct MixBus* bus) {
+    if (!self || !self->initialized) return 0;
+    if (bus && mix_bus_get_engine(bus) != self->engine) return 0;
+    ma_node* target = bus ? mix_bus_get_input(bus) : ma_engine_get_endpoint(self->engine);
+    effect_chain_set_target(&self->effects, target);
+    return 1;
+}
+
+int playlist_insert_effect(Playlist* self, ma_node* effect, int index) {
+    if (!self || !self->initialized) return 0;
+    return effect_chain_insert(&self->effects, effect, index);
+}
+
+int playlist_remove_effect(Playlist* self, ma_node* effect) {
+    if (!self || !self->initialized) return 0;
+    return effect_chain_remove(&self->effects, effect);
+}
+
+void playlist_clear_effects(Playlist* self) {
+    if (self && self->initialized) effect_chain_clear(&self->effects);
+}
+
+void playlist_set_crossfade(Playlist* self, uint32_t crossfade_ms) {
+    if (!self || !self->initialized) return;
+    au_store_u32(&self->crossfade_frames, (uint32_t)pl_ms_to_frames(self, crossfade_ms));
+}
+
+uint32_t playlist_get_crossfade(Playlist* self) {
+    if (!self || !self->initialized || self->sample_rate == 0) return 0;
+    return (uint32_t)((ma_uint64)au_load_u32(&self->crossfade_frames) * 1000 / self->sample_rate);
+}
+
+uint32_t playlist_enqueue(Playlist* self, const void* data, size_t size) {
+    if (!self || !self->initialized || !data || size == 0) return 0;
+    PlaylistItem* it = (PlaylistItem*)calloc(1, sizeof(PlaylistItem));
+    if (!it) return 0;
+    it->encoded = malloc(size);
+    if (!it->encoded) {
+        free(it);
+        return 0;
+    }
+    memcpy(it->encoded, data, size);
+    ma_decoder_config const cfg = pl_decoder_config(self);
+    if (ma_decoder_init_memory(it->encoded, size, &cfg, &it->decoder) != MA_SUCCESS) {
+        pl_item_free(it);
+        return 0;
+    }
+    return pl_push_decoded(self, it);
+}
+
+uint32_t playlist_enqueue_file(Playlist* self, const char* path) {
+    if (!self || !self->initialized || !path) return 0;
+    PlaylistItem* it = (PlaylistItem*)calloc(1, sizeof(PlaylistItem));
+    if (!it) return 0;
+    ma_decoder_config const cfg = pl_decoder_config(self);
+    if (ma_decoder_init_file(path, &cfg, &it->decoder) != MA_SUCCESS) {
+        free(it);
+        return 0;
+    }
+    return pl_push_decoded(self, it);
+}
+
+uint32_t playlist_enqueue_pcm(Playlist* self,
+                              const void* data,
+                              size_t size,
+                              ma_format format,
+                              int channels,
+                              int sample_rate)
+{
+    if (!self || !self->initialized || !data || channels <= 0 || sample_rate <= 0) return 0;
+    ma_uint32 const bpf = ma_get_bytes_per_frame(format, (ma_uint32)channels);
+    if (bpf == 0 || size < bpf) return 0;
+    ma_uint64 const inFrames = size / bpf;
+
+    ma_uint64 const outFrames = ma_convert_frames(NULL, 0, ma_format_f32, self->channels, self->sample_rate,
+                                                  data, inFrames, format, (ma_uint32)channels, (ma_uint32)sample_rate);
+    PlaylistItem* it = (PlaylistItem*)calloc(1, sizeof(PlaylistItem));
+    if (!it) return 0;
+    it->pcm = (float*)malloc((size_t)(outFrames ? outFrames : 1) * self->channels * sizeof(float));
+    if (!it->pcm) {
+        free(it);
+        return 0;
+    }
+    it->pcm_frames = ma_convert_frames(it->pcm, outFrames, ma_format_f32, self->channels, self->sample_rate,
+                                       data, inFrames, format, (ma_uint32)channels, (ma_uint32)sample_rate);
+    it->length = it->pcm_frames;
+    return pl_push(self, it);
+}
+
+void playlist_skip(Playlist* self) {
+    if (!self || !self->initialized) return;
+    uint32_t const head = au_load_u32(&self->head);
+    uint32_t const pending = au_load_u32(&self->skip_to);
+    /* Skips the audio thread has not applied yet count: skip from there. */
+    uint32_t const from = pl_before(head, pending) ? pending : head;
+    if (from == self->tail) return;
+    au_store_u32(&self->skip_to, from + 1);
+}
+
+void playlist_clear(Playlist* self) {
+    if (!self || !self->initialized) return;
+    au_store_u32(&self->skip_to, self->tail);
+    pl_reclaim(self);
+}
+
+uint32_t playlist_get_current(Playlist* self) {
+    if (!self || !self->initialized) return 0;
+    pl_reclaim(self);
+    uint32_t const head = au_load_u32(&self->head);
+    if (head == self->tail) return 0;
+    return self->items[head & PL_INDEX_MASK]->id;
+}
+
+uint32_t playlist_get_queued(Playlist* self) {
+    if (!self || !self->initialized) return 0;
+    pl_reclaim(self);
+    return self->tail - au_load_u32(&self->head);
+}
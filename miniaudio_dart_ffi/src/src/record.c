@@ -1,13 +1,8 @@
 #include "../include/record.h"
+#include "../include/audio_context.h"
 #include <stdlib.h>
 #include <string.h>
 
-typedef struct {
-    char        name[256];
-    ma_device_id id;
-    ma_bool32   isDefault;
-} CaptureDeviceInfo;
-
 /* Internal structure */
 struct Recorder {
     ma_device        device;
@@ -34,20 +29,22 @@ struct Recorder {
     /* Codec config for dynamic changes */
     RecorderCodecConfig currentCodecConfig;
 
-    /* Device enumeration context & cache */
-    ma_context            context;
-    int                   context_initialized;
-    CaptureDeviceInfo*    captureInfos;
-    ma_uint32             captureCount;
-    ma_uint32             captureGeneration;
+    /* Shared context (audio_context.h), NULL until first needed */
+    ma_context*           context;
+    ma_uint32             captureGeneration; /* device switches */
+
+    /* Capture processing (f32 only), run before buffering or encoding */
+    CaptureChain          chain;
+    float*                processBuffer;     /* RECORDER_PROCESS_FRAMES */
+    NoiseSuppressor*      noiseSuppressor;
+    uint32_t              noiseStage;
+    EchoCanceller*        echoCanceller;
+    uint32_t              echoStage;
+    Engine*               echoEngine;        /* feeding the reference */
 };
 
-static void data_callback(ma_device* dev, void* pOutput, const void* pInput, ma_uint32 frameCount) {
-    (void)pOutput;
-    Recorder* r = (Recorder*)dev->pUserData;
-    if(!r || !pInput || frameCount==0) return;
-
-    const float g = r->gain;
+/* Buffer or encode frameCount frames of captured audio */
+static void recorder_emit(Recorder* r, const void* pInput, ma_uint32 frameCount, float g) {
     const ma_uint32 bpf = r->frameSizeBytes;
     const ma_uint8* srcBytes = (const ma_uint8*)pInput;
 
@@ -124,6 +121,31 @@ static void data_callback(ma_device* dev, void* pOutput, const void* pInput, ma_
     }
 }
 
+static void data_callback(ma_device* dev, void* pOutput, const void* pInput, ma_uint32 frameCount) {
+    (void)pOutput;
+    Recorder* r = (Recorder*)dev->pUserData;
+    if(!r || !pInput || frameCount==0) return;
+
+    if (!r->processBuffer || capture_chain_count(&r->chain) == 0) {
+        recorder_emit(r, pInput, frameCount, r->gain);
+        return;
+    }
+
+    /* Gain, then the chain, in place on a copy */
+    const float g = r->gain;
+    const float* src = (const float*)pInput;
+    const ma_uint32 ch = (ma_uint32)r->channels;
+    while (frameCount > 0) {
+        ma_uint32 n = frameCount < RECORDER_PROCESS_FRAMES ? frameCount : RECORDER_PROCESS_FRAMES;
+        ma_uint32 samples = n * ch;
+        for (ma_uint32 i = 0; i < samples; i++) r->processBuffer[i] = src[i] * g;
+        capture_chain_process(&r->chain, r->processBuffer, n, ch);
+        recorder_emit(r, r->processBuffer, n, 1.0f);
+        src        += samples;
+        frameCount -= n;
+    }
+}
+
 RecorderConfig recorder_config_default(int sampleRate, int channels, ma_format format) {
     RecorderConfig cfg;
     cfg.sampleRate            = sampleRate;
@@ -149,87 +171,45 @@ Recorder* recorder_create(void) {
     return (Recorder*)calloc(1, sizeof(Recorder));
 }
 
-/* Initialize context lazily */
+/* Take a reference on the shared context the first time it is needed */
 static int recorder_ensure_context(Recorder* r) {
     if (!r) return 0;
-    if (r->context_initialized) return 1;
-    
-    ma_context_config cfg = ma_context_config_init();
-    if (ma_context_init(NULL, 0, &cfg, &r->context) != MA_SUCCESS) {
-        return 0;
-    }
-    r->context_initialized = 1;
-    return 1;
-}
-
-void recorder_free_capture_cache(Recorder* r) {
-    if (!r) return;
-    if (r->captureInfos) {
-        free(r->captureInfos);
-        r->captureInfos = NULL;
-    }
-    r->captureCount = 0;
+    if (r->context) return 1;
+    r->context = audio_context_acquire();
+    return r->context != NULL;
 }
 
 int recorder_refresh_capture_devices(Recorder* r) {
-    if (!r) return 0;
     if (!recorder_ensure_context(r)) return 0;
-
-    ma_device_info* pPlayback = NULL;
-    ma_uint32 playbackCount = 0;
-    ma_device_info* pCapture = NULL;
-    ma_uint32 captureCount = 0;
-
-    if (ma_context_get_devices(&r->context, &pPlayback, &playbackCount, 
-                               &pCapture, &captureCount) != MA_SUCCESS) {
-        return 0;
-    }
-
-    recorder_free_capture_cache(r);
-    if (captureCount == 0) {
-        r->captureGeneration++;
-        return 1;
-    }
-
-    r->captureInfos = (CaptureDeviceInfo*)malloc(sizeof(CaptureDeviceInfo) * captureCount);
-    if (!r->captureInfos) return 0;
-
-    for (ma_uint32 i = 0; i < captureCount; i++) {
-        CaptureDeviceInfo* dst = &r->captureInfos[i];
-        ma_device_info* src = &pCapture[i];
-        memset(dst, 0, sizeof(*dst));
-        strncpy(dst->name, src->name, 255);
-        dst->name[255] = '\0';
-        dst->id = src->id;
-        dst->isDefault = src->isDefault;
-    }
-    r->captureCount = captureCount;
-    r->captureGeneration++;
-    return 1;
+    return audio_context_refresh_devices();
 }
 
 ma_uint32 recorder_get_capture_device_count(Recorder* r) {
-    return r ? r->captureCount : 0;
+    if (!recorder_ensure_context(r) || !audio_context_ensure_devices()) return 0;
+    return audio_context_get_device_count(ma_device_type_capture);
 }
 
 int recorder_get_capture_device_name(Recorder* r, ma_uint32 index,
                                      char* outName, ma_uint32 capName,
                                      ma_bool32* pIsDefault) {
-    if (!r || index >= r->captureCount || !outName || capName == 0) return 0;
-    
-    CaptureDeviceInfo* info = &r->captureInfos[index];
-    strncpy(outName, info->name, capName - 1);
+    AudioDeviceInfo info;
+    if (!r || !outName || capName == 0) return 0;
+    if (!audio_context_get_device(ma_device_type_capture, index, &info)) return 0;
+
+    strncpy(outName, info.name, capName - 1);
     outName[capName - 1] = '\0';
-    if (pIsDefault) *pIsDefault = info->isDefault;
+    if (pIsDefault) *pIsDefault = info.isDefault;
     return 1;
 }
 
 ma_uint32 recorder_get_capture_device_generation(Recorder* r) {
-    return r ? r->captureGeneration : 0;
+    return r ? audio_context_get_generation() + r->captureGeneration : 0;
 }
 
 int recorder_select_capture_device_by_index(Recorder* r, ma_uint32 index) {
-    if (!r || index >= r->captureCount) return 0;
+    AudioDeviceInfo info;
+    if (!recorder_ensure_context(r)) return 0;
+    if (!audio_context_get_device(ma_device_type_capture, index, &info)) return 0;
 
     /* Preserve state */
     int wasRecording = r->isRecording;
@@ -246,12 +226,12 @@ int recorder_select_capture_device_by_index(Recorder* r, ma_uint32 index) {
     r->deviceConfig.sampleRate       = (ma_uint32)r->sampleRate;
     r->deviceConfig.dataCallback     = data_callback;
     r->deviceConfig.pUserData        = r;
-    r->deviceConfig.capture.pDeviceID = &r->captureInfos[index].id;
+    r->deviceConfig.capture.pDeviceID = &info.id;
 
-    if (ma_device_init(&r->context, &r->deviceConfig, &r->device) != MA_SUCCESS) {
-        /* Attempt fallback to default (NULL context / default device) */
+    if (ma_device_init(r->context, &r->deviceConfig, &r->device) != MA_SUCCESS) {
+        /* Attempt fallback to the default device */
         r->deviceConfig.capture.pDeviceID = NULL;
-        if (ma_device_init(NULL, &r->deviceConfig, &r->device) != MA_SUCCESS) {
+        if (ma_device_init(r->context, &r->deviceConfig, &r->device) != MA_SUCCESS) {
             return 0;
         }
     }
@@ -270,11 +250,13 @@ void recorder_destroy(Recorder* r) {
     if(!r) return;
     if(r->isRecording) ma_device_stop(&r->device);
     ma_device_uninit(&r->device);
-    if(r->context_initialized) {
-        ma_context_uninit(&r->context);
-        r->context_initialized = 0;
+    recorder_disable_echo_cancellation(r);
+    recorder_set_noise_suppression(r, 0.0f);
+    free(r->processBuffer);
+    if(r->context) {
+        audio_context_release();
+        r->context = NULL;
     }
-    recorder_free_capture_cache(r);
     if(r->crossCoder) crosscoder_destroy(r->crossCoder);
     if(r->tempEncodeBuffer) free(r->tempEncodeBuffer);
     ma_pcm_rb_uninit(&r->rb);
@@ -300,6 +282,13 @@ int recorder_init(Recorder* r, const RecorderConfig* cfg) {
         r->frameSizeBytes = (ma_uint32)(ma_get_bytes_per_sample(ma_format_f32) * r->channels);
     }
 
+    /* Processing works on f32; other formats are captured as is */
+    capture_chain_init(&r->chain);
+    if (r->format == ma_format_f32) {
+        r->processBuffer = (float*)malloc((size_t)RECORDER_PROCESS_FRAMES * r->channels * sizeof(float));
+        if (!r->processBuffer) return 0;
+    }
+
     ma_uint64 capacityFrames = (ma_uint64)cfg->sampleRate * (ma_uint64)cfg->bufferDurationSeconds;
     if(capacityFrames < 1024) capacityFrames = 1024;
     if(capacityFrames > 0x7FFFFFFFULL) capacityFrames = 0x7FFFFFFF;
@@ -339,7 +328,8 @@ int recorder_init(Recorder* r, const RecorderConfig* cfg) {
     r->deviceConfig.dataCallback     = data_callback;
     r->deviceConfig.pUserData        = r;
 
-    if(ma_device_init(NULL, &r->deviceConfig, &r->device) != MA_SUCCESS) {
+    if(!recorder_ensure_context(r) ||
+       ma_device_init(r->context, &r->deviceConfig, &r->device) != MA_SUCCESS) {
         if(r->crossCoder) crosscoder_destroy(r->crossCoder);
         ma_pcm_rb_uninit(&r->rb);
         return 0;
@@ -436,6 +426,75 @@ int recorder_update_codec_config(Recorder* r, const RecorderCodecConfig* codecCo
     return 0;
 }
 
+uint32_t recorder_add_processor(Recorder* r, CaptureProcessFn fn, void* user_data) {
+    if (!r || !r->processBuffer) return 0;
+    return capture_chain_add(&r->chain, CAPTURE_ORDER_DEFAULT, fn, user_data);
+}
+
+int recorder_remove_processor(Recorder* r, uint32_t id) {
+    return r ? capture_chain_remove(&r->chain, id) : 0;
+}
+
+int recorder_set_noise_suppression(Recorder* r, float reductionDb) {
+    if (!r) return 0;
+    if (reductionDb <= 0.0f) {
+        if (r->noiseStage) capture_chain_remove(&r->chain, r->noiseStage);
+        noise_suppressor_destroy(r->noiseSuppressor);
+        r->noiseSuppressor = NULL;
+        r->noiseStage = 0;
+        return 1;
+    }
+    if (r->noiseSuppressor) {
+        noise_suppressor_set_reduction(r->noiseSuppressor, reductionDb);
+        return 1;
+    }
+    if (!r->processBuffer) return 0;
+    r->noiseSuppressor = noise_suppressor_create((uint32_t)r->sampleRate, reductionDb);
+    if (!r->noiseSuppressor) return 0;
+    r->noiseStage = capture_chain_add(&r->chain, CAPTURE_ORDER_NOISE,
+                                      noise_suppressor_process, r->noiseSuppressor);
+    if (!r->noiseStage) {
+        noise_suppressor_destroy(r->noiseSuppressor);
+        r->noiseSuppressor = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+int recorder_enable_echo_cancellation(Recorder* r, Engine* engine, uint32_t filterMs) {
+    if (!r || !engine || !r->processBuffer) return 0;
+    recorder_disable_echo_cancellation(r);
+
+    r->echoCanceller = echo_canceller_create((uint32_t)r->sampleRate, filterMs);
+    if (!r->echoCanceller) return 0;
+    r->echoStage = capture_chain_add(&r->chain, CAPTURE_ORDER_ECHO,
+                                     echo_canceller_process_queued, r->echoCanceller);
+    /* Fails while another canceller, another recorder's say, holds the
+       engine's reference. */
+    if (!r->echoStage || !engine_replace_echo_reference(engine, NULL, r->echoCanceller)) {
+        recorder_disable_echo_cancellation(r);
+        return 0;
+    }
+    r->echoEngine = engine;
+    return 1;
+}
+
+void recorder_disable_echo_cancellation(Recorder* r) {
+    if (!r || !r->echoCanceller) return;
+    /* Neither thread may still be using it once both are detached. The
+       engine's reference is only cleared while it is still ours. */
+    if (r->echoEngine) engine_replace_echo_reference(r->echoEngine, r->echoCanceller, NULL);
+    if (r->echoStage) capture_chain_remove(&r->chain, r->echoStage);
+    echo_canceller_destroy(r->echoCanceller);
+    r->echoCanceller = NULL;
+    r->echoStage = 0;
+    r->echoEngine = NULL;
+}
+
+float recorder_get_echo_return_loss_enhancement(Recorder* r) {
+    return r ? echo_canceller_get_erle(r->echoCanceller) : 0.0f;
+}
+
 RecorderCodec recorder_get_codec(Recorder* r) {
     if (!r) return RECORDER_CODEC_PCM;
     return r->currentCodecConfig.codec;
@@ -1,40 +1,223 @@
 #include "../include/sound.h"
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "../include/miniaudio.h"
+#include "../include/atomic_util.h"
+#include "../include/mix_bus.h"
 
-Sound *sound_alloc()
-{
-    Sound *const sound = malloc(sizeof(Sound));
-    return sound;
-}
+#if defined(_WIN32)
+#include <windows.h>
+#endif
 
-int sound_init(
-    Sound *const self,
-    float *data,
-    size_t const data_size,
-    const ma_format format,
-    const int channels,
-    const int sample_rate,
-    ma_engine *const engine)
+/*************
+ ** private **
+ *************/
+
+static void sound_route(void *owner, ma_node *input);
+
+static void sound_reset(Sound *const self, ma_engine *const engine)
 {
     self->engine = engine;
     self->is_looped = false;
     self->loop_delay_ms = 0;
     self->owned_data = NULL;
     self->owned_size = 0;
+    self->data_free = NULL;
+    self->data_release = NULL;
+    self->data_release_user = NULL;
+    self->asset = NULL;
+    self->is_stream = false;
+    self->path = NULL;
+    memset(&self->map, 0, sizeof(self->map));
+    memset(&self->voices, 0, sizeof(self->voices));
+    self->scheduler = NULL;
+    self->priority = 1.0f;
+    self->bus = NULL;
+    effect_chain_init(&self->effects, ma_engine_get_endpoint(engine), sound_route, self);
+}
 
-    self->original_format = format;      // may be ma_format_unknown for encoded
-    self->channels        = channels;
-    self->sample_rate     = sample_rate;
+static void sound_release_data(Sound *const self)
+{
+    if (self->asset) {
+        sound_asset_release(self->asset);
+        self->asset = NULL;
+    } else if (self->map.data) {
+        file_map_close(&self->map);  // owned_data pointed into the mapping
+    } else if (self->owned_data) {
+        if (self->data_release) self->data_release(self->owned_data, self->data_release_user);
+        else if (self->data_free) self->data_free(self->owned_data);
+        else free(self->owned_data);
+    }
+    self->owned_data = NULL;
+    self->owned_size = 0;
+    self->data_free = NULL;
+    self->data_release = NULL;
+    self->data_release_user = NULL;
+    free(self->path);
+    self->path = NULL;
+}
 
-    if (data != NULL && data_size > 0) {
-        self->owned_data = malloc(data_size);
-        if (self->owned_data == NULL) return 0;
-        memcpy(self->owned_data, (const void*)data, data_size);
-        self->owned_size = data_size;
+// Where the effect chain ends.
+static ma_node *sound_output(Sound *const self)
+{
+    ma_node *const input = mix_bus_get_input(self->bus);
+    return input ? input : ma_engine_get_endpoint(self->engine);
+}
+
+// EffectChainRoute: attach the sound and its voices to the chain's input.
+static void sound_route(void *owner, ma_node *input)
+{
+    Sound *const self = (Sound *)owner;
+    voice_scheduler_route(self->scheduler, &self->sound, input);
+    for (uint32_t i = 0; i < self->voices.count; ++i) {
+        voice_scheduler_route(self->scheduler, &self->voices.voices[i].sound, input);
     }
+}
+
+// Decoders seek by decoding, which the voice scheduler keeps off the audio
+// thread. Streams seek on the resource manager's job thread anyway.
+static bool sound_slow_seek(Sound *const self)
+{
+    return !self->is_stream && !self->is_raw_data;
+}
+
+// The data source the ma_sound reads from (head of any loop-delay chain).
+static ma_data_source *sound_source(Sound *const self)
+{
+    if (self->is_stream) return ma_sound_get_data_source(&self->sound);
+    return self->is_raw_data
+        ? (ma_data_source*)&self->buffer
+        : (ma_data_source*)&self->decoder;
+}
+
+// Stream path through the engine's resource manager: pages are decoded by
+// its job thread, so the audio thread never touches the file.
+static int sound_open_stream(const char *path, ma_engine *const engine, ma_sound *out)
+{
+    ma_uint32 const flags = MA_SOUND_FLAG_STREAM |
+                            MA_SOUND_FLAG_NO_PITCH |
+                            MA_SOUND_FLAG_NO_SPATIALIZATION;
+
+    // miniaudio leaks its data source allocation when the open fails, so
+    // make sure the file is readable first.
+#if defined(_WIN32)
+    // The narrow variants are not UTF-8 aware on Windows.
+    wchar_t wpath[MAX_PATH * 4];
+    if (MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath,
+                            (int)(sizeof(wpath) / sizeof(wpath[0]))) == 0)
+        return 0;
+    FILE *probe = _wfopen(wpath, L"rb");
+    if (probe == NULL) return 0;
+    fclose(probe);
+    return ma_sound_init_from_file_w(engine, wpath, flags, NULL, NULL, out) == MA_SUCCESS;
+#else
+    FILE *probe = fopen(path, "rb");
+    if (probe == NULL) return 0;
+    fclose(probe);
+    return ma_sound_init_from_file(engine, path, flags, NULL, NULL, out) == MA_SUCCESS;
+#endif
+}
+
+static int sound_init_stream(Sound *const self, ma_engine *const engine)
+{
+    self->is_raw_data = false;
+    self->is_stream = true;
+    return sound_open_stream(self->path, engine, &self->sound);
+}
+
+// A voice gets its own cursor over the Sound's data; the bytes are shared.
+static int sound_voice_init(Sound *const self, SoundVoice *v, ma_engine *const engine)
+{
+    if (self->is_stream) return sound_open_stream(self->path, engine, &v->sound);
+
+    ma_data_source *src;
+    if (self->is_raw_data) {
+        ma_uint32 const ch = (ma_uint32)self->channels;
+        ma_uint64 const bytes_per_frame =
+            (ma_uint64)ma_get_bytes_per_sample(self->original_format) * ch;
+        ma_audio_buffer_config const cfg = ma_audio_buffer_config_init(
+            self->original_format, ch,
+            bytes_per_frame ? self->owned_size / bytes_per_frame : 0,
+            self->owned_data, NULL);
+        if (ma_audio_buffer_init(&cfg, &v->buffer) != MA_SUCCESS) return 0;
+        src = (ma_data_source*)&v->buffer;
+    } else {
+        if (ma_decoder_init_memory(self->owned_data, self->owned_size, NULL, &v->decoder) != MA_SUCCESS)
+            return 0;
+        src = (ma_data_source*)&v->decoder;
+    }
+
+    if (ma_sound_init_from_data_source(
+            engine, src,
+            MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_NO_SPATIALIZATION,
+            NULL, &v->sound) != MA_SUCCESS) {
+        if (self->is_raw_data) ma_audio_buffer_uninit(&v->buffer);
+        else ma_decoder_uninit(&v->decoder);
+        return 0;
+    }
+    return 1;
+}
+
+static void sound_voice_uninit(Sound *const self, SoundVoice *v)
+{
+    ma_sound_uninit(&v->sound);
+    if (self->is_stream) return;
+    if (self->is_raw_data) ma_audio_buffer_uninit(&v->buffer);
+    else ma_decoder_uninit(&v->decoder);
+}
+
+static void sound_voices_uninit(Sound *const self)
+{
+    for (uint32_t i = 0; i < self->voices.count; ++i) {
+        voice_scheduler_remove(self->scheduler, &self->voices.voices[i].sound);
+        sound_voice_uninit(self, &self->voices.voices[i]);
+    }
+    voice_pool_free(&self->voices);
+}
+
+static int sound_voices_init(Sound *const self,
+                             uint32_t const count,
+                             SoundStealPolicy const policy,
+                             ma_engine *const engine)
+{
+    if (!voice_pool_alloc(&self->voices, count, policy)) return 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!sound_voice_init(self, &self->voices.voices[i], engine)) {
+            self->voices.count = i;  // only tear down what was built
+            sound_voices_uninit(self);
+            return 0;
+        }
+        voice_scheduler_add(self->scheduler, &self->voices.voices[i].sound, self->priority,
+                            sound_slow_seek(self));
+        if (self->bus || self->effects.count > 0) {
+            voice_scheduler_route(self->scheduler, &self->voices.voices[i].sound,
+                                  effect_chain_input(&self->effects));
+        }
+    }
+    return 1;
+}
+
+// Start at an absolute engine time (0 = now). A stop time that has already
+// passed would keep the node silent after the start, so it is cleared; one
+// still ahead is kept.
+static int sound_start_at(ma_sound *sound, ma_uint64 const time_in_frames)
+{
+    ma_uint64 const now = ma_engine_get_time_in_pcm_frames(ma_sound_get_engine(sound));
+    if (ma_node_get_state_time(sound, ma_node_state_stopped) - 1 <= now) {
+        ma_sound_set_stop_time_in_pcm_frames(sound, ~(ma_uint64)0);
+    }
+    ma_sound_set_start_time_in_pcm_frames(sound, time_in_frames);
+    return ma_sound_start(sound) == MA_SUCCESS;
+}
+
+// Build the buffer/decoder and ma_sound over owned_data.
+static int sound_init_source(Sound *const self, ma_engine *const engine)
+{
+    ma_format const format = self->original_format;
+    int const channels = self->channels;
+    int const sample_rate = self->sample_rate;
 
     if (format != ma_format_unknown && channels > 0 && sample_rate > 0)
     {
@@ -52,7 +235,7 @@ int sound_init(
             ma_audio_buffer_config_init(format, ch, frames, self->owned_data, NULL);
 
         if (ma_audio_buffer_init(&cfg, &self->buffer) != MA_SUCCESS) {
-            free(self->owned_data); self->owned_data = NULL; self->owned_size = 0;
+            sound_release_data(self);
             return 0;
         }
 
@@ -63,17 +246,17 @@ int sound_init(
                 NULL,
                 &self->sound) != MA_SUCCESS) {
             ma_audio_buffer_uninit(&self->buffer);
-            free(self->owned_data); self->owned_data = NULL; self->owned_size = 0;
+            sound_release_data(self);
             return 0;
         }
     }
     else
     {
         self->is_raw_data = false;
-        // For encoded data we set original_format to unknown already above.
+        // Encoded data: original_format is ma_format_unknown.
 
         if (ma_decoder_init_memory(self->owned_data, self->owned_size, NULL, &self->decoder) != MA_SUCCESS) {
-            free(self->owned_data); self->owned_data = NULL; self->owned_size = 0;
+            sound_release_data(self);
             return 0;
         }
 
@@ -84,7 +267,7 @@ int sound_init(
                 NULL,
                 &self->sound) != MA_SUCCESS) {
             ma_decoder_uninit(&self->decoder);
-            free(self->owned_data); self->owned_data = NULL; self->owned_size = 0;
+            sound_release_data(self);
             return 0;
         }
     }
@@ -92,29 +275,324 @@ int sound_init(
     return 1;
 }
 
+// Decode encoded bytes to PCM and play that from a buffer.
+static int sound_init_decoded(Sound *const self,
+                              const void *data,
+                              size_t const data_size,
+                              ma_engine *const engine)
+{
+    if (!sound_decode_to_pcm(data, data_size, engine,
+                             &self->owned_data, &self->owned_size,
+                             &self->channels, &self->sample_rate)) {
+        return 0;
+    }
+    self->original_format = ma_format_f32;
+    return sound_init_source(self, engine);
+}
+
+// Shared by the no-copy loaders: the release fields are already set, and
+// the buffer is released through them whatever the outcome.
+static int sound_init_buffer(Sound *const self,
+                             void *data,
+                             size_t const data_size,
+                             const ma_format format,
+                             const int channels,
+                             const int sample_rate,
+                             const uint32_t flags,
+                             ma_engine *const engine)
+{
+    if ((flags & SOUND_LOAD_DECODE) && format == ma_format_unknown && data != NULL) {
+        // Decoded into a buffer of our own; the input is not needed after.
+        void (*data_free)(void *) = self->data_free;
+        SoundDataRelease data_release = self->data_release;
+        void *user = self->data_release_user;
+        self->data_free = NULL;
+        self->data_release = NULL;
+        self->data_release_user = NULL;
+        int const ok = sound_init_decoded(self, data, data_size, engine);
+        if (data_release) data_release(data, user);
+        else if (data_free) data_free(data);
+        else free(data);
+        return ok;
+    }
+
+    self->original_format = format;      // may be ma_format_unknown for encoded
+    self->channels        = channels;
+    self->sample_rate     = sample_rate;
+    self->owned_data      = data;
+    self->owned_size      = data_size;
+
+    return sound_init_source(self, engine);
+}
+
+/************
+ ** public **
+ ************/
+
+Sound *sound_alloc()
+{
+    // Zeroed so load_state reads SOUND_LOAD_STATE_NONE until a load is queued.
+    Sound *const sound = calloc(1, sizeof(Sound));
+    return sound;
+}
+
+void *sound_data_alloc(size_t const size)
+{
+    return size ? malloc(size) : NULL;
+}
+
+int sound_init(
+    Sound *const self,
+    float *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
+    ma_engine *const engine)
+{
+    if ((flags & SOUND_LOAD_DECODE) && format == ma_format_unknown &&
+        data != NULL && data_size > 0) {
+        // Decode straight from the caller's bytes; the encoded copy is never kept.
+        sound_reset(self, engine);
+        return sound_init_decoded(self, data, data_size, engine);
+    }
+
+    void *copy = NULL;
+    if (data != NULL && data_size > 0) {
+        copy = malloc(data_size);
+        if (copy == NULL) return 0;
+        memcpy(copy, (const void*)data, data_size);
+    }
+    return sound_init_owned(self, copy, copy ? data_size : 0, format,
+                            channels, sample_rate, flags, engine);
+}
+
+int sound_init_owned(
+    Sound *const self,
+    void *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
+    ma_engine *const engine)
+{
+    return sound_init_adopt(self, data, data_size, format, channels,
+                            sample_rate, flags, NULL, engine);
+}
+
+int sound_init_adopt(
+    Sound *const self,
+    void *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
+    void (*free_fn)(void *data),
+    ma_engine *const engine)
+{
+    sound_reset(self, engine);
+    self->data_free = free_fn;
+    return sound_init_buffer(self, data, data_size, format, channels,
+                             sample_rate, flags, engine);
+}
+
+int sound_init_external(
+    Sound *const self,
+    const void *data,
+    size_t const data_size,
+    const ma_format format,
+    const int channels,
+    const int sample_rate,
+    const uint32_t flags,
+    SoundDataRelease release,
+    void *user_data,
+    ma_engine *const engine)
+{
+    sound_reset(self, engine);
+    if (release == NULL) return 0;  // nothing would tell the owner when it is done
+    self->data_release      = release;
+    self->data_release_user = user_data;
+    // Only read from; the cast is for the shared owned_data field.
+    return sound_init_buffer(self, (void *)data, data_size, format, channels,
+                             sample_rate, flags, engine);
+}
+
+int sound_decode_to_pcm(
+    const void *data,
+    size_t const data_size,
+    ma_engine *const engine,
+    void **out_data,
+    size_t *out_size,
+    int *out_channels,
+    int *out_sample_rate)
+{
+    if (data == NULL || data_size == 0 || engine == NULL) return 0;
+
+    ma_uint32 const channels    = ma_engine_get_channels(engine);
+    ma_uint32 const sample_rate = ma_engine_get_sample_rate(engine);
+    ma_decoder_config const cfg =
+        ma_decoder_config_init(ma_format_f32, channels, sample_rate);
+
+    ma_decoder decoder;
+    if (ma_decoder_init_memory(data, data_size, &cfg, &decoder) != MA_SUCCESS)
+        return 0;
+
+    // The length is an estimate for some formats (or unknown), so grow as needed.
+    ma_uint64 capacity = 0;
+    if (ma_decoder_get_length_in_pcm_frames(&decoder, &capacity) != MA_SUCCESS ||
+        capacity == 0) {
+        capacity = sample_rate;
+    }
+    size_t const frame_bytes = (size_t)channels * sizeof(float);
+    ma_uint8 *pcm = malloc((size_t)capacity * frame_bytes);
+    ma_uint64 frames = 0;
+
+    while (pcm != NULL) {
+        if (frames == capacity) {
+            ma_uint8 *grown = realloc(pcm, (size_t)(capacity * 2) * frame_bytes);
+            if (grown == NULL) { free(pcm); pcm = NULL; break; }
+            pcm = grown;
+            capacity *= 2;
+        }
+        ma_uint64 read = 0;
+        ma_result const r = ma_decoder_read_pcm_frames(
+            &decoder, pcm + (size_t)frames * frame_bytes, capacity - frames, &read);
+        frames += read;
+        if (r != MA_SUCCESS || read == 0) break;
+    }
+    ma_decoder_uninit(&decoder);
+
+    if (pcm == NULL || frames == 0) {
+        free(pcm);
+        return 0;
+    }
+    // Give back the slack from over-estimated lengths.
+    ma_uint8 *trimmed = realloc(pcm, (size_t)frames * frame_bytes);
+    *out_data        = trimmed ? trimmed : pcm;
+    *out_size        = (size_t)frames * frame_bytes;
+    *out_channels    = (int)channels;
+    *out_sample_rate = (int)sample_rate;
+    return 1;
+}
+
+int sound_init_from_asset(
+    Sound *const self,
+    SoundAsset *asset,
+    ma_engine *const engine)
+{
+    if (asset == NULL) return 0;
+
+    sound_reset(self, engine);
+
+    self->original_format = asset->format;
+    self->channels        = asset->channels;
+    self->sample_rate     = asset->sampleRate;
+
+    sound_asset_retain(asset);
+    self->asset      = asset;
+    self->owned_data = asset->data;
+    self->owned_size = asset->size;
+
+    return sound_init_source(self, engine);
+}
+
+int sound_init_from_file(
+    Sound *const self,
+    const char *path,
+    const uint32_t flags,
+    ma_engine *const engine)
+{
+    if (path == NULL || engine == NULL) return 0;
+
+    sound_reset(self, engine);
+    self->original_format = ma_format_unknown;
+    self->channels        = 0;
+    self->sample_rate     = 0;
+
+    if (flags & (SOUND_LOAD_MMAP | SOUND_LOAD_DECODE)) {
+        if (!file_map_open(&self->map, path)) return 0;
+
+        if (flags & SOUND_LOAD_DECODE) {
+            // Decode once from the mapping, then let it go.
+            void *pcm = NULL;
+            size_t pcm_size = 0;
+            int ok = sound_decode_to_pcm(self->map.data, self->map.size, engine,
+                                         &pcm, &pcm_size,
+                                         &self->channels, &self->sample_rate);
+            file_map_close(&self->map);
+            if (!ok) return 0;
+            self->owned_data      = pcm;
+            self->owned_size      = pcm_size;
+            self->original_format = ma_format_f32;
+        } else {
+            self->owned_data = self->map.data;
+            self->owned_size = self->map.size;
+        }
+        return sound_init_source(self, engine);
+    }
+
+    self->path = malloc(strlen(path) + 1);
+    if (self->path == NULL) return 0;
+    strcpy(self->path, path);
+    if (!sound_init_stream(self, engine)) {
+        sound_release_data(self);
+        return 0;
+    }
+    return 1;
+}
+
+int sound_get_load_state(Sound const *const self)
+{
+    return self ? (int)au_load_u32((volatile uint32_t *)&self->load_state) : SOUND_LOAD_STATE_FAILED;
+}
+
+void sound_attach_scheduler(Sound *const self, VoiceScheduler *scheduler)
+{
+    self->scheduler = scheduler;
+    bool const slow = sound_slow_seek(self);
+    voice_scheduler_add(scheduler, &self->sound, self->priority, slow);
+    for (uint32_t i = 0; i < self->voices.count; ++i) {
+        voice_scheduler_add(scheduler, &self->voices.voices[i].sound, self->priority, slow);
+    }
+}
+
 void sound_unload(Sound *const self)
 {
-    if (self->is_raw_data) {
+    effect_chain_clear(&self->effects);
+    sound_voices_uninit(self);
+    voice_scheduler_remove(self->scheduler, &self->sound);
+    if (self->is_stream) {
+        ma_sound_uninit(&self->sound);
+    } else if (self->is_raw_data) {
         ma_sound_uninit(&self->sound);
         ma_audio_buffer_uninit(&self->buffer);
     } else {
         ma_sound_uninit(&self->sound);
         ma_decoder_uninit(&self->decoder);
     }
-    if (self->owned_data) {
-        free(self->owned_data);
-        self->owned_data = NULL;
-        self->owned_size = 0;
-    }
+    sound_release_data(self);
 }
 
 int sound_play(Sound *const self)
 {
-    ma_sound *sound = &self->sound;
-    if (ma_sound_start(sound) != MA_SUCCESS)
-        return 0;
+    return sound_start_at(&self->sound, 0);
+}
 
-    return 1;
+int sound_play_at(Sound *const self, uint64_t const time_in_frames)
+{
+    return sound_start_at(&self->sound, time_in_frames);
+}
+
+void sound_stop_at(Sound *const self, uint64_t const time_in_frames)
+{
+    // miniaudio silences a whole read whose end reaches the stop time, so the
+    // node's stop is one frame late; the engine splits its read at the frame
+    // itself (voice_scheduler_next_event).
+    ma_uint64 const stop = time_in_frames == ~(uint64_t)0 ? time_in_frames : time_in_frames + 1;
+    ma_sound_set_stop_time_in_pcm_frames(&self->sound, stop);
 }
 
 int sound_replay(Sound *const self)
@@ -134,6 +612,77 @@ void sound_stop(Sound *const self)
     ma_sound *sound = &self->sound;
     ma_sound_stop(sound);
     ma_sound_seek_to_pcm_frame(sound, 0);
+    for (uint32_t i = 0; i < self->voices.count; ++i) {
+        ma_sound_stop(&self->voices.voices[i].sound);
+    }
+}
+
+int sound_set_polyphony(Sound *const self, uint32_t const max_voices, int const policy)
+{
+    if (self == NULL || max_voices > VOICE_POOL_MAX_VOICES) return 0;
+    if (policy < SOUND_STEAL_OLDEST || policy > SOUND_STEAL_NONE) return 0;
+
+    // Building voices allocates, so it happens here and never in play.
+    sound_voices_uninit(self);
+    if (max_voices == 0) return 1;
+    return sound_voices_init(self, max_voices, (SoundStealPolicy)policy, self->engine);
+}
+
+uint32_t sound_get_polyphony(Sound const *const self)
+{
+    return self ? self->voices.count : 0;
+}
+
+uint32_t sound_play_voice(Sound *const self,
+                          float const volume,
+                          int const priority,
+                          bool const looped)
+{
+    return sound_play_voice_at(self, volume, priority, looped, 0);
+}
+
+uint32_t sound_play_voice_at(Sound *const self,
+                             float const volume,
+                             int const priority,
+                             bool const looped,
+                             uint64_t const time_in_frames)
+{
+    bool stolen = false;
+    SoundVoice *v = voice_pool_acquire(&self->voices, priority, &stolen);
+    if (v == NULL) return 0;
+
+    ma_sound_set_looping(&v->sound, looped);
+    ma_sound_set_volume(&v->sound, volume);
+    // A stolen voice is cut mid-signal; a short fade-in softens the click.
+    ma_sound_set_fade_in_milliseconds(&v->sound, stolen ? 0.0f : 1.0f, 1.0f, stolen ? 5 : 0);
+    ma_sound_seek_to_pcm_frame(&v->sound, 0);
+    // A reused voice may still carry the stop time that ended it.
+    ma_sound_set_stop_time_in_pcm_frames(&v->sound, ~(ma_uint64)0);
+    if (!sound_start_at(&v->sound, time_in_frames)) return 0;
+    return voice_pool_handle(&self->voices, v);
+}
+
+void sound_stop_voice(Sound *const self, uint32_t const voice)
+{
+    SoundVoice *v = voice_pool_lookup(&self->voices, voice);
+    if (v) ma_sound_stop(&v->sound);
+}
+
+bool sound_voice_is_playing(Sound *const self, uint32_t const voice)
+{
+    SoundVoice *v = voice_pool_lookup(&self->voices, voice);
+    return v != NULL && ma_sound_is_playing(&v->sound);
+}
+
+void sound_set_voice_volume(Sound *const self, uint32_t const voice, float const value)
+{
+    SoundVoice *v = voice_pool_lookup(&self->voices, voice);
+    if (v) ma_sound_set_volume(&v->sound, value);
+}
+
+uint32_t sound_get_active_voices(Sound *const self)
+{
+    return voice_pool_active(&self->voices);
 }
 
 float sound_get_volume(Sound const *const self)
@@ -148,18 +697,62 @@ void sound_set_volume(Sound *const self, float const value)
     ma_sound_set_volume(sound, value);
 }
 
+int sound_set_bus(Sound *const self, struct MixBus *bus)
+{
+    if (self == NULL) return 0;
+    int const state = sound_get_load_state(self);
+    if (state == SOUND_LOAD_STATE_PENDING || state == SOUND_LOAD_STATE_FAILED) return 0;
+    if (bus && mix_bus_get_engine(bus) != self->engine) return 0;
+
+    self->bus = bus;
+    effect_chain_set_target(&self->effects, sound_output(self));
+    return 1;
+}
+
+int sound_insert_effect(Sound *const self, ma_node *effect, int index)
+{
+    if (self == NULL) return 0;
+    int const state = sound_get_load_state(self);
+    if (state == SOUND_LOAD_STATE_PENDING || state == SOUND_LOAD_STATE_FAILED) return 0;
+    return effect_chain_insert(&self->effects, effect, index);
+}
+
+int sound_remove_effect(Sound *const self, ma_node *effect)
+{
+    return self ? effect_chain_remove(&self->effects, effect) : 0;
+}
+
+void sound_clear_effects(Sound *const self)
+{
+    if (self) effect_chain_clear(&self->effects);
+}
+
 float sound_get_duration(Sound *const self)
 {
     ma_uint64 length_in_frames;
     if (self->is_raw_data)
     {
         ma_audio_buffer_get_length_in_pcm_frames(&self->buffer, &length_in_frames);
+        return (float)length_in_frames / ma_engine_get_sample_rate(self->engine);
     }
-    else
-    {
-        ma_sound_get_length_in_pcm_frames(&self->sound, &length_in_frames);
+    // Decoders and streams report frames at their own rate.
+    float seconds = 0;
+    ma_sound_get_length_in_seconds(&self->sound, &seconds);
+    return seconds;
+}
+
+float sound_get_priority(Sound const *const self)
+{
+    return self->priority;
+}
+
+void sound_set_priority(Sound *const self, float const value)
+{
+    self->priority = value < 0.0f ? 0.0f : value;
+    voice_scheduler_set_weight(self->scheduler, &self->sound, self->priority);
+    for (uint32_t i = 0; i < self->voices.count; ++i) {
+        voice_scheduler_set_weight(self->scheduler, &self->voices.voices[i].sound, self->priority);
     }
-    return (float)length_in_frames / ma_engine_get_sample_rate(self->engine);
 }
 
 bool sound_get_is_looped(Sound const *const self)
@@ -177,9 +770,7 @@ void sound_set_looped(
     self->loop_delay_ms = (int)delay_ms;
 
     // Choose the actual data source we wrapped the ma_sound with.
-    ma_data_source* src = self->is_raw_data
-        ? (ma_data_source*)&self->buffer
-        : (ma_data_source*)&self->decoder;
+    ma_data_source* src = sound_source(self);
 
     if (!value) {
         // Turn off looping and break any chain.
@@ -219,6 +810,8 @@ void sound_set_looped(
 int sound_rebind_engine(Sound *self, ma_engine *newEngine)
 {
     if (!self || !newEngine) return 0;
+    // Device switches keep the engine and its graph; nothing to rebuild.
+    if (newEngine == self->engine) return 1;
 
     float    vol      = ma_sound_get_volume(&self->sound);
     ma_bool32 playing = ma_sound_is_playing(&self->sound);
@@ -226,8 +819,19 @@ int sound_rebind_engine(Sound *self, ma_engine *newEngine)
     ma_sound_get_cursor_in_pcm_frames(&self->sound, &cursor);
     ma_bool32 looped  = self->is_looped ? MA_TRUE : MA_FALSE;
     int      loopDelay = self->loop_delay_ms;
+    uint32_t voiceCount = self->voices.count;
+    SoundStealPolicy voicePolicy = self->voices.policy;
 
-    if (self->is_raw_data) {
+    // Voices are rebuilt on the new engine; whatever they were playing stops.
+    effect_chain_clear(&self->effects);
+    sound_voices_uninit(self);
+    self->bus = NULL;
+    voice_scheduler_remove(self->scheduler, &self->sound);
+
+    if (self->is_stream) {
+        ma_sound_uninit(&self->sound);
+        if (!sound_init_stream(self, newEngine)) return 0;
+    } else if (self->is_raw_data) {
         ma_sound_uninit(&self->sound);
         ma_audio_buffer_uninit(&self->buffer);
 
@@ -273,6 +877,8 @@ int sound_rebind_engine(Sound *self, ma_engine *newEngine)
     }
 
     self->engine = newEngine;
+    effect_chain_init(&self->effects, ma_engine_get_endpoint(newEngine), sound_route, self);
+    voice_scheduler_add(self->scheduler, &self->sound, self->priority, sound_slow_seek(self));
 
     ma_sound_set_volume(&self->sound, vol);
     if (looped) {
@@ -284,5 +890,8 @@ int sound_rebind_engine(Sound *self, ma_engine *newEngine)
     if (playing) {
         ma_sound_start(&self->sound);
     }
+    if (voiceCount > 0 && !sound_voices_init(self, voiceCount, voicePolicy, newEngine)) {
+        return 0;
+    }
     return 1;
 }
@@ -0,0 +1,206 @@
+#include "../include/sound_loader.h"
+#include "../include/sound.h"
+#include "../include/atomic_util.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/*************
+ ** private **
+ *************/
+
+struct SoundLoadJob {
+    SoundLoader*  loader;
+    struct Sound* sound;
+    void*         data;   /* owned, handed to sound_init_adopt */
+    size_t        size;
+    void        (*freeFn)(void* data);  /* NULL: free() */
+    char*         path;   /* file jobs */
+    ma_format     format;
+    int           channels;
+    int           sampleRate;
+    uint32_t      flags;
+};
+
+static void sl_run(SoundLoadJob* job) {
+    SoundLoader* loader = job->loader;
+    int ok;
+    if (job->path) {
+        ok = sound_init_from_file(job->sound, job->path, job->flags, loader->engine);
+    } else {
+        /* Ownership of data moves to the sound (or is freed on failure). */
+        ok = sound_init_adopt(job->sound, job->data, job->size, job->format,
+                              job->channels, job->sampleRate, job->flags,
+                              job->freeFn, loader->engine);
+    }
+    if (ok && loader->scheduler) sound_attach_scheduler(job->sound, loader->scheduler);
+    au_store_u32(&job->sound->load_state,
+                 ok ? SOUND_LOAD_STATE_READY : SOUND_LOAD_STATE_FAILED);
+
+    ma_spinlock_lock(&loader->lock);
+    SoundLoadCallback cb = loader->callback;
+    void* user = loader->userData;
+    ma_spinlock_unlock(&loader->lock);
+    if (cb) cb(job->sound, ok, user);
+
+    free(job->path);
+    free(job);
+    au_fetch_add_u32(&loader->pending, (uint32_t)-1);
+}
+
+static ma_result sl_job_proc(ma_job* pJob) {
+    sl_run((SoundLoadJob*)pJob->data.custom.data0);
+    return MA_SUCCESS;
+}
+
+static int sl_submit(SoundLoader* loader, SoundLoadJob* job) {
+    job->loader = loader;
+    au_store_u32(&job->sound->load_state, SOUND_LOAD_STATE_PENDING);
+    au_fetch_add_u32(&loader->pending, 1);
+
+    if (!loader->workersReady) {
+        sl_run(job);  /* nobody would pick the job up */
+        return 1;
+    }
+    ma_job mj = ma_job_init(MA_JOB_TYPE_CUSTOM);
+    mj.data.custom.proc  = sl_job_proc;
+    mj.data.custom.data0 = (ma_uintptr)job;
+    if (ma_resource_manager_post_job(&loader->workers, &mj) != MA_SUCCESS) {
+        sl_run(job);  /* queue full: load here rather than fail */
+    }
+    return 1;
+}
+
+static void sl_sleep_ms(unsigned ms) {
+#if defined(_WIN32)
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+/************
+ ** public **
+ ************/
+
+void sound_loader_init(SoundLoader* loader, ma_resource_manager* rm, ma_engine* engine) {
+    if (!loader) return;
+    memset(loader, 0, sizeof(*loader));
+    loader->resourceManager = rm;
+    loader->engine = engine;
+    if (!rm || rm->config.jobThreadCount == 0) return;
+
+    /* Only its job threads are used; it never loads anything itself. */
+    ma_resource_manager_config cfg = ma_resource_manager_config_init();
+    cfg.jobThreadCount = rm->config.jobThreadCount;
+    loader->workersReady = ma_resource_manager_init(&cfg, &loader->workers) == MA_SUCCESS;
+}
+
+void sound_loader_uninit(SoundLoader* loader) {
+    if (!loader) return;
+    sound_loader_wait_idle(loader);
+    if (loader->workersReady) {
+        ma_resource_manager_uninit(&loader->workers);
+        loader->workersReady = 0;
+    }
+}
+
+void sound_loader_set_callback(SoundLoader* loader, SoundLoadCallback cb, void* userData) {
+    if (!loader) return;
+    ma_spinlock_lock(&loader->lock);
+    loader->callback = cb;
+    loader->userData = userData;
+    ma_spinlock_unlock(&loader->lock);
+}
+
+int sound_loader_submit_memory(SoundLoader* loader,
+                               struct Sound* sound,
+                               const void* data,
+                               size_t size,
+                               ma_format format,
+                               int channels,
+                               int sampleRate,
+                               uint32_t flags)
+{
+    if (!loader || !loader->resourceManager || !sound || !data || size == 0) return 0;
+    SoundLoadJob* job = (SoundLoadJob*)calloc(1, sizeof(SoundLoadJob));
+    if (!job) return 0;
+    job->data = malloc(size);
+    if (!job->data) {
+        free(job);
+        return 0;
+    }
+    memcpy(job->data, data, size);
+    job->sound      = sound;
+    job->size       = size;
+    job->format     = format;
+    job->channels   = channels;
+    job->sampleRate = sampleRate;
+    job->flags      = flags;
+    return sl_submit(loader, job);
+}
+
+int sound_loader_submit_adopted(SoundLoader* loader,
+                                struct Sound* sound,
+                                void* data,
+                                size_t size,
+                                ma_format format,
+                                int channels,
+                                int sampleRate,
+                                uint32_t flags,
+                                void (*freeFn)(void* data))
+{
+    SoundLoadJob* job = NULL;
+    if (loader && loader->resourceManager && sound && data && size > 0) {
+        job = (SoundLoadJob*)calloc(1, sizeof(SoundLoadJob));
+    }
+    if (!job) {
+        if (data) {
+            if (freeFn) freeFn(data);
+            else free(data);
+        }
+        return 0;
+    }
+    job->data       = data;
+    job->freeFn     = freeFn;
+    job->sound      = sound;
+    job->size       = size;
+    job->format     = format;
+    job->channels   = channels;
+    job->sampleRate = sampleRate;
+    job->flags      = flags;
+    return sl_submit(loader, job);
+}
+
+int sound_loader_submit_file(SoundLoader* loader,
+                             struct Sound* sound,
+                             const char* path,
+                             uint32_t flags)
+{
+    if (!loader || !loader->resourceManager || !sound || !path) return 0;
+    SoundLoadJob* job = (SoundLoadJob*)calloc(1, sizeof(SoundLoadJob));
+    if (!job) return 0;
+    job->path = (char*)malloc(strlen(path) + 1);
+    if (!job->path) {
+        free(job);
+        return 0;
+    }
+    strcpy(job->path, path);
+    job->sound = sound;
+    job->flags = flags;
+    return sl_submit(loader, job);
+}
+
+uint32_t sound_loader_pending(SoundLoader* loader) {
+    return loader ? au_load_u32(&loader->pending) : 0;
+}
+
+void sound_loader_wait_idle(SoundLoader* loader) {
+    if (!loader) return;
+    while (au_load_u32(&loader->pending) != 0) sl_sleep_ms(1);
+}
@@ -1,8 +1,12 @@
 #include "../include/stream_player.h"
 #include "../include/engine.h"
+#include "../include/atomic_util.h"
+#include "../include/mix_bus.h"
+#include "../include/effect_chain.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
+#include <math.h>
 
 /* Data source wrapper */
 typedef struct {
@@ -13,7 +17,11 @@ typedef struct {
 struct StreamPlayer {
     ma_engine*      engine;
     ma_sound        sound;
+    EffectChain     effects;  /* sound -> effects -> bus or endpoint */
     ma_pcm_rb       rb;
+    StreamTimeline  timeline;
+    int             buffered;
+    volatile uint64_t playedFrames; /* live mode position */
 
     ma_format       format;
     ma_uint32       channels;
@@ -31,10 +39,207 @@ struct StreamPlayer {
 
     float*          decodeBuf;
     int             decodeBufFrames;
+
+    /* Telemetry counters (atomic access). */
+    uint32_t          capacityFrames;
+    volatile uint64_t underrunEvents;
+    volatile uint64_t silenceFrames;
+    volatile uint64_t droppedFrames;
+    volatile uint32_t peakFillFrames;
+    volatile uint32_t decodeErrors[STREAM_PLAYER_CODEC_SLOTS];
+    volatile uint32_t primed;   /* audio has flowed since the last clear */
+    int               starved;  /* audio thread only */
+
+    /* Pre-roll gate (prerollFrames == 0 disables it). */
+    ma_uint32         prerollFrames;
+    ma_uint32         fadeFrames;
+    volatile uint32_t gateState;  /* SP_GATE_*; clear() forces BUFFERING */
+    ma_uint32         fadeInPos;  /* audio thread only */
+
+    /* Threshold notifications (guarded by telemetryLock, never taken on the
+       audio thread). */
+    ma_spinlock                   telemetryLock;
+    StreamPlayerTelemetryCallback telemetryCb;
+    void*                         telemetryUserData;
+    uint32_t                      thresholds[3];   /* indexed by event - 1 */
+    uint64_t                      notified[3];
+
+    /* Gain automation. rampCmd hands a packed ramp to the audio thread
+       (SP_RAMP_NONE when empty); gainOut mirrors the gain for queries. */
+    volatile uint64_t rampCmd;
+    volatile uint32_t gainOut;     /* f32 bits */
+    float             gain;        /* audio thread only from here */
+    float             rampTarget;
+    float             rampStep;    /* per-frame delta, or ratio if exponential */
+    ma_uint32         rampLeft;
+    int               rampExp;
+
+    /* Sidechain: the slot this player publishes its level to, and the slot
+       (packed with its generation) that ducks this player. */
+    volatile uint32_t sendSlot;    /* SP_NO_SLOT when unused */
+    volatile uint64_t duckSource;  /* SP_NO_DUCK when disabled */
+    volatile uint32_t duckThreshold, duckGain, duckAttack, duckRelease; /* f32 bits */
+    float             duckLevel;   /* audio thread only */
 };
 
 #define SP_CONTAINER_OF(ptr, type, member) ((type*)((char*)(ptr) - offsetof(type, member)))
 
+#define SP_GATE_BUFFERING 0
+#define SP_GATE_PLAYING   1
+
+#define SP_RAMP_NONE      UINT64_MAX
+#define SP_NO_SLOT        0xFFFFFFFFu
+#define SP_NO_DUCK        UINT64_MAX
+#define SP_MIN_EXP_GAIN   0.0001f  /* -80 dB */
+
+/* Sidechain levels live in static slots so a ducked player never holds a
+   pointer to its sidechain; a generation bump invalidates stale links. */
+#define SP_SIDECHAIN_SLOTS 64
+
+typedef struct {
+    volatile uint32_t inUse;
+    volatile uint32_t generation;
+    volatile uint32_t level;  /* f32 bits: peak of the last block */
+} sp_sidechain_slot;
+
+static sp_sidechain_slot g_sp_sidechains[SP_SIDECHAIN_SLOTS];
+
+static void sp_route(void* owner, ma_node* input) {
+    StreamPlayer* sp = (StreamPlayer*)owner;
+    ma_node_attach_output_bus(&sp->sound, 0, input, 0);
+}
+
+static ma_uint32 sp_fill_frames(StreamPlayer* sp) {
+    if(sp->buffered) return stream_timeline_available_read(&sp->timeline);
+    return ma_pcm_rb_available_read(&sp->rb);
+}
+
+/* Copy up to frameCount buffered frames into out; returns frames copied. */
+static ma_uint64 sp_source_read(StreamPlayer* sp, ma_uint8* out, ma_uint64 frameCount) {
+    if(sp->buffered) {
+        ma_uint32 req = (ma_uint32)((frameCount > 0x7FFFFFFF) ? 0x7FFFFFFF : frameCount);
+        return stream_timeline_read(&sp->timeline, out, req);
+    }
+
+    ma_uint64 done = 0;
+    while(done < frameCount) {
+        ma_uint64 left = frameCount - done;
+        ma_uint32 req = (ma_uint32)((left > 0x7FFFFFFF) ? 0x7FFFFFFF : left);
+        void* pRead = NULL;
+        if(ma_pcm_rb_acquire_read(&sp->rb, &req, &pRead) != MA_SUCCESS || req == 0) break;
+        memcpy(out + (size_t)done * sp->frameSizeBytes, pRead, (size_t)req * sp->frameSizeBytes);
+        ma_pcm_rb_commit_read(&sp->rb, req);
+        done += req;
+    }
+    au_fetch_add_u64(&sp->playedFrames, done);
+    return done;
+}
+
+/* Gated read: hold back until the pre-roll is queued, fade in on start and
+   fade out the last frames before running dry, then rebuild the pre-roll. */
+static ma_uint64 sp_gated_read(StreamPlayer* sp, ma_uint8* out, ma_uint64 frameCount) {
+    if(au_load_u32(&sp->gateState) == SP_GATE_BUFFERING) {
+        if(sp_fill_frames(sp) < sp->prerollFrames) return 0;
+        au_store_u32(&sp->gateState, SP_GATE_PLAYING);
+        sp->fadeInPos = 0;
+    }
+
+    ma_uint64 got = sp_source_read(sp, out, frameCount);
+    if(sp->format != ma_format_f32) {
+        if(got < frameCount) au_store_u32(&sp->gateState, SP_GATE_BUFFERING);
+        return got;
+    }
+
+    float* f = (float*)out;
+    ma_uint32 ch = sp->channels;
+    for(ma_uint64 i = 0; i < got && sp->fadeInPos < sp->fadeFrames; ++i, ++sp->fadeInPos) {
+        float g = (float)(sp->fadeInPos + 1) / (float)sp->fadeFrames;
+        for(ma_uint32 c = 0; c < ch; ++c) f[i * ch + c] *= g;
+    }
+
+    if(got < frameCount) {
+        ma_uint64 n = got < sp->fadeFrames ? got : sp->fadeFrames;
+        float* tail = f + (size_t)(got - n) * ch;
+        for(ma_uint64 i = 0; i < n; ++i) {
+            float g = (float)(n - 1 - i) / (float)n;
+            for(ma_uint32 c = 0; c < ch; ++c) tail[i * ch + c] *= g;
+        }
+        au_store_u32(&sp->gateState, SP_GATE_BUFFERING);
+    }
+    return got;
+}
+
+/* Pick up a ramp posted by stream_player_ramp_gain. */
+static void sp_take_ramp(StreamPlayer* sp) {
+    if(au_load_u64(&sp->rampCmd) == SP_RAMP_NONE) return;
+    uint64_t cmd = au_exchange_u64(&sp->rampCmd, SP_RAMP_NONE);
+    if(cmd == SP_RAMP_NONE) return;
+
+    uint32_t bits = (uint32_t)cmd;
+    float target;
+    memcpy(&target, &bits, sizeof(target));
+    ma_uint32 frames = (ma_uint32)((cmd >> 32) & 0x7FFFFFFF);
+    sp->rampExp    = (int)(cmd >> 63);
+    sp->rampTarget = target;
+    sp->rampLeft   = frames;
+    if(frames == 0) {
+        sp->gain = target;
+    } else if(sp->rampExp) {
+        float from = sp->gain > SP_MIN_EXP_GAIN ? sp->gain : SP_MIN_EXP_GAIN;
+        float to   = target   > SP_MIN_EXP_GAIN ? target   : SP_MIN_EXP_GAIN;
+        sp->gain     = from;
+        sp->rampStep = powf(to / from, 1.0f / (float)frames);
+    } else {
+        sp->rampStep = (target - sp->gain) / (float)frames;
+    }
+}
+
+/* Apply ramp and ducking gain to a block, and publish the sidechain level.
+   Runs on the audio thread; every input is read lock-free. */
+static void sp_process_gain(StreamPlayer* sp, float* f, ma_uint64 frames) {
+    sp_take_ramp(sp);
+
+    float duckTarget = 1.0f;
+    uint64_t src = au_load_u64(&sp->duckSource);
+    if(src != SP_NO_DUCK) {
+        sp_sidechain_slot* slot = &g_sp_sidechains[(src >> 32) % SP_SIDECHAIN_SLOTS];
+        float level = 0.0f;
+        if(au_load_u32(&slot->inUse) && au_load_u32(&slot->generation) == (uint32_t)src)
+            level = au_load_f32(&slot->level);
+        if(level > au_load_f32(&sp->duckThreshold)) duckTarget = au_load_f32(&sp->duckGain);
+    }
+
+    ma_uint32 ch = sp->channels;
+    if(sp->rampLeft || sp->gain != 1.0f || sp->duckLevel != 1.0f || duckTarget != 1.0f) {
+        float attack  = au_load_f32(&sp->duckAttack);
+        float release = au_load_f32(&sp->duckRelease);
+        for(ma_uint64 i = 0; i < frames; ++i) {
+            if(sp->rampLeft) {
+                sp->gain = sp->rampExp ? sp->gain * sp->rampStep : sp->gain + sp->rampStep;
+                if(--sp->rampLeft == 0) sp->gain = sp->rampTarget;
+            }
+            if(sp->duckLevel != duckTarget) {
+                float c = duckTarget < sp->duckLevel ? attack : release;
+                sp->duckLevel = duckTarget + (sp->duckLevel - duckTarget) * c;
+                if(fabsf(sp->duckLevel - duckTarget) < 1e-5f) sp->duckLevel = duckTarget;
+            }
+            float g = sp->gain * sp->duckLevel;
+            for(ma_uint32 c = 0; c < ch; ++c) f[i * ch + c] *= g;
+        }
+        au_store_f32(&sp->gainOut, sp->gain);
+    }
+
+    uint32_t send = au_load_u32(&sp->sendSlot);
+    if(send != SP_NO_SLOT) {
+        float peak = 0.0f;
+        for(ma_uint64 i = 0; i < frames * ch; ++i) {
+            float a = fabsf(f[i]);
+            if(a > peak) peak = a;
+        }
+        au_store_f32(&g_sp_sidechains[send].level, peak);
+    }
+}
+
 static ma_result sp_on_read(ma_data_source* pDS,
                             void* pFramesOut,
                             ma_uint64 frameCount,
@@ -43,32 +248,43 @@ static ma_result sp_on_read(ma_data_source* pDS,
     sp_data_source* dsw = SP_CONTAINER_OF(pDS, sp_data_source, base);
     StreamPlayer* sp = dsw->owner;
     ma_uint8* out = (ma_uint8*)pFramesOut;
-    ma_uint64 remaining = frameCount;
 
-    while(remaining > 0) {
-        ma_uint32 req = (ma_uint32)((remaining > 0x7FFFFFFF) ? 0x7FFFFFFF : remaining);
-        void* pRead = NULL;
-        if(ma_pcm_rb_acquire_read(&sp->rb, &req, &pRead) != MA_SUCCESS || req == 0) {
-            /* Underrun: fill silence */
-            size_t silenceBytes = (size_t)remaining * sp->frameSizeBytes;
-            memset(out, 0, silenceBytes);
-            out += silenceBytes;
-            remaining = 0;
-            break;
+    ma_uint64 got = sp->prerollFrames ? sp_gated_read(sp, out, frameCount)
+                                      : sp_source_read(sp, out, frameCount);
+    if(got > 0 && !sp->primed) au_store_u32(&sp->primed, 1);
+    if(got < frameCount) {
+        /* Underrun: fill silence */
+        memset(out + (size_t)got * sp->frameSizeBytes, 0,
+               (size_t)(frameCount - got) * sp->frameSizeBytes);
+        /* Silence before the first write (or after a clear) is not a fault. */
+        if(au_load_u32(&sp->primed)) {
+            au_fetch_add_u64(&sp->silenceFrames, frameCount - got);
+            if(!sp->starved) {
+                sp->starved = 1;
+                au_fetch_add_u64(&sp->underrunEvents, 1);
+            }
         }
-        memcpy(out, pRead, (size_t)req * sp->frameSizeBytes);
-        ma_pcm_rb_commit_read(&sp->rb, req);
-        out += (size_t)req * sp->frameSizeBytes;
-        remaining -= req;
+    } else {
+        sp->starved = 0;
     }
+    /* Ramps run on the output clock, so they also advance through silence. */
+    if(sp->format == ma_format_f32) sp_process_gain(sp, (float*)out, frameCount);
     if(pFramesRead) *pFramesRead = frameCount;
     return MA_SUCCESS;
 }
 
 static ma_result sp_on_seek(ma_data_source* pDS, ma_uint64 frameIndex) {
-    (void)pDS;
-    (void)frameIndex;
-    return MA_INVALID_OPERATION;
+    sp_data_source* dsw = SP_CONTAINER_OF(pDS, sp_data_source, base);
+    StreamPlayer* sp = dsw->owner;
+    if(!sp->buffered) return MA_INVALID_OPERATION;
+    return stream_timeline_seek(&sp->timeline, (int64_t)frameIndex) ? MA_SUCCESS : MA_INVALID_OPERATION;
+}
+
+static ma_result sp_on_cursor(ma_data_source* pDS, ma_uint64* pCursor) {
+    sp_data_source* dsw = SP_CONTAINER_OF(pDS, sp_data_source, base);
+    int64_t pos = stream_player_get_position(dsw->owner);
+    *pCursor = pos > 0 ? (ma_uint64)pos : 0;
+    return MA_SUCCESS;
 }
 
 static ma_result sp_on_format(ma_data_source* pDS,
@@ -91,7 +307,10 @@ static ma_data_source_vtable g_sp_vtable = {
     sp_on_read,
     sp_on_seek,
     sp_on_format,
-    NULL
+    sp_on_cursor,
+    NULL,
+    NULL,
+    0
 };
 
 StreamPlayerConfig stream_player_config_default(int channels, int sampleRate) {
@@ -102,9 +321,75 @@ StreamPlayerConfig stream_player_config_default(int channels, int sampleRate) {
     cfg.bufferMilliseconds = 200;
     cfg.allowCodecPackets  = 1;
     cfg.decodeAccumFrames  = 0;
+    cfg.bufferedMode       = 0;
+    cfg.segmentMilliseconds = 0;
+    cfg.prerollMilliseconds = 0;
+    cfg.fadeMilliseconds    = 0;
     return cfg;
 }
 
+static void sp_source_uninit(StreamPlayer* sp) {
+    if(sp->buffered) stream_timeline_uninit(&sp->timeline);
+    else             ma_pcm_rb_uninit(&sp->rb);
+}
+
+static uint64_t sp_event_total(StreamPlayer* sp, int idx) {
+    switch(idx) {
+        case 0:  return au_load_u64(&sp->underrunEvents);
+        case 1:  return au_load_u64(&sp->droppedFrames);
+        default: {
+            uint64_t total = 0;
+            for(int i = 0; i < STREAM_PLAYER_CODEC_SLOTS; ++i)
+                total += au_load_u32(&sp->decodeErrors[i]);
+            return total;
+        }
+    }
+}
+
+/* Fire the telemetry callback for counters that crossed their threshold.
+   Runs on writer/control threads only. */
+static void sp_check_thresholds(StreamPlayer* sp) {
+    if(!sp->telemetryCb) return;
+
+    StreamPlayerTelemetryCallback cb;
+    void* userData;
+    uint64_t fire[3] = {0, 0, 0};
+    int any = 0;
+
+    ma_spinlock_lock(&sp->telemetryLock);
+    cb = sp->telemetryCb;
+    userData = sp->telemetryUserData;
+    for(int i = 0; cb && i < 3; ++i) {
+        if(sp->thresholds[i] == 0) continue;
+        uint64_t total = sp_event_total(sp, i);
+        if(total - sp->notified[i] >= sp->thresholds[i]) {
+            sp->notified[i] = total;
+            fire[i] = total;
+            any = 1;
+        }
+    }
+    ma_spinlock_unlock(&sp->telemetryLock);
+
+    if(!any) return;
+    for(int i = 0; i < 3; ++i) {
+        if(fire[i]) cb(userData, i + 1, fire[i]);
+    }
+}
+
+/* Account for a producer write of `requested` frames of which `written`
+   made it into the buffer. */
+static void sp_note_write(StreamPlayer* sp, size_t requested, size_t written) {
+    if(written < requested) au_fetch_add_u64(&sp->droppedFrames, requested - written);
+    au_max_u32(&sp->peakFillFrames, sp_fill_frames(sp));
+    sp_check_thresholds(sp);
+}
+
+static void sp_count_decode_error(StreamPlayer* sp, CodecID cid) {
+    if((int)cid < 0 || (int)cid >= STREAM_PLAYER_CODEC_SLOTS) return;
+    au_fetch_add_u32(&sp->decodeErrors[cid], 1);
+    sp_check_thresholds(sp);
+}
+
 static int sp_realloc_decode_buf(StreamPlayer* sp, int frames) {
     if(frames <= sp->decodeBufFrames) return 1;
     float* nb = (float*)realloc(sp->decodeBuf,
@@ -148,16 +433,47 @@ int stream_player_init(StreamPlayer* sp,
     sp->volume     = 1.0f;
     sp->allowCodecPackets = cfg->allowCodecPackets ? 1 : 0;
 
+    sp->buffered   = cfg->bufferedMode ? 1 : 0;
+    sp->playedFrames = 0;
+
     ma_uint64 capacityFrames = ((ma_uint64)cfg->bufferMilliseconds * sp->sampleRate) / 1000;
     if(capacityFrames < 1024) capacityFrames = 1024;
     if(capacityFrames > 0x7FFFFFFFULL) capacityFrames = 0x7FFFFFFF;
-
-    if(ma_pcm_rb_init(sp->format,
-                      sp->channels,
-                      (ma_uint32)capacityFrames,
-                      NULL,
-                      NULL,
-                      &sp->rb) != MA_SUCCESS) {
+    sp->capacityFrames = (uint32_t)capacityFrames;
+
+    ma_uint64 preroll = ((ma_uint64)cfg->prerollMilliseconds * sp->sampleRate) / 1000;
+    if(preroll > capacityFrames / 2) preroll = capacityFrames / 2;
+    sp->prerollFrames = (ma_uint32)preroll;
+    ma_uint32 fadeMs  = cfg->fadeMilliseconds ? cfg->fadeMilliseconds : 5;
+    sp->fadeFrames    = (ma_uint32)(((ma_uint64)fadeMs * sp->sampleRate) / 1000);
+    if(sp->fadeFrames == 0) sp->fadeFrames = 1;
+    sp->gateState     = SP_GATE_BUFFERING;
+
+    sp->rampCmd    = SP_RAMP_NONE;
+    sp->gain       = 1.0f;
+    sp->rampLeft   = 0;
+    au_store_f32(&sp->gainOut, 1.0f);
+    sp->sendSlot   = SP_NO_SLOT;
+    sp->duckSource = SP_NO_DUCK;
+    sp->duckLevel  = 1.0f;
+
+    if(sp->buffered) {
+        ma_uint32 segMs = cfg->segmentMilliseconds ? cfg->segmentMilliseconds : 1000;
+        ma_uint64 segFrames = ((ma_uint64)segMs * sp->sampleRate) / 1000;
+        if(segFrames < 1024) segFrames = 1024;
+        if(!stream_timeline_init(&sp->timeline, sp->frameSizeBytes,
+                                 (ma_uint32)segFrames, capacityFrames)) {
+            return 0;
+        }
+        /* The window is rounded up to whole segments. */
+        if(sp->timeline.capacityFrames < 0xFFFFFFFFULL)
+            sp->capacityFrames = (uint32_t)sp->timeline.capacityFrames;
+    } else if(ma_pcm_rb_init(sp->format,
+                             sp->channels,
+                             (ma_uint32)capacityFrames,
+                             NULL,
+                             NULL,
+                             &sp->rb) != MA_SUCCESS) {
         return 0;
     }
 
@@ -165,7 +481,7 @@ int stream_player_init(StreamPlayer* sp,
     ma_data_source_config dsc = ma_data_source_config_init();
     dsc.vtable = &g_sp_vtable;
     if(ma_data_source_init(&dsc, (ma_data_source*)&sp->ds.base) != MA_SUCCESS) {
-        ma_pcm_rb_uninit(&sp->rb);
+        sp_source_uninit(sp);
         return 0;
     }
 
@@ -175,10 +491,11 @@ int stream_player_init(StreamPlayer* sp,
                                       NULL,
                                       &sp->sound) != MA_SUCCESS) {
         ma_data_source_uninit((ma_data_source*)&sp->ds.base);
-        ma_pcm_rb_uninit(&sp->rb);
+        sp_source_uninit(sp);
         return 0;
     }
     ma_sound_set_volume(&sp->sound, sp->volume);
+    effect_chain_init(&sp->effects, ma_engine_get_endpoint(engine), sp_route, sp);
 
     CodecConfig ccfg = {
         .sample_rate     = sp->sampleRate,
@@ -219,9 +536,19 @@ void stream_player_uninit(StreamPlayer* sp) {
         codec_runtime_uninit(&sp->codecRT);
         sp->codecInitialized = 0;
     }
+    effect_chain_clear(&sp->effects);
     ma_sound_uninit(&sp->sound);
     ma_data_source_uninit((ma_data_source*)&sp->ds.base);
-    ma_pcm_rb_uninit(&sp->rb);
+    sp_source_uninit(sp);
+
+    /* Release the sidechain slot; players ducked by it will release. */
+    uint32_t send = au_exchange_u32(&sp->sendSlot, SP_NO_SLOT);
+    if(send != SP_NO_SLOT) {
+        sp_sidechain_slot* slot = &g_sp_sidechains[send];
+        au_fetch_add_u32(&slot->generation, 1);
+        au_store_f32(&slot->level, 0.0f);
+        au_store_u32(&slot->inUse, 0);
+    }
     
     sp->initialized = 0;  // Mark as uninitialized
 }
@@ -236,6 +563,14 @@ int codec_runtime_on_decoded_frames(CodecRuntime* rt,
     StreamPlayer* sp = (StreamPlayer*)userData;
     if(!sp || frames <= 0 || !pcm) return 0;
 
+    /* Buffered mode keeps history; the producer is expected to pace itself. */
+    if(sp->buffered) {
+        size_t written = stream_timeline_write(&sp->timeline, pcm, (size_t)frames,
+                                               STREAM_TIMELINE_NO_TIMESTAMP);
+        sp_note_write(sp, (size_t)frames, written);
+        return (int)written;
+    }
+
     int remaining = frames;
     int offsetFrames = 0;
     while(remaining > 0) {
@@ -243,8 +578,9 @@ int codec_runtime_on_decoded_frames(CodecRuntime* rt,
         if(space == 0) {
             /* Drop oldest half to make space */
             ma_uint32 availRead = ma_pcm_rb_available_read(&sp->rb);
-            if(availRead == 0) return 0; /* nothing to drop */
+            if(availRead == 0) break; /* nothing to drop */
             ma_pcm_rb_seek_read(&sp->rb, availRead / 2);
+            au_fetch_add_u64(&sp->droppedFrames, availRead / 2);
             continue;
         }
         ma_uint32 writeNow = (ma_uint32)((remaining < (int)space) ? remaining : (int)space);
@@ -257,7 +593,8 @@ int codec_runtime_on_decoded_frames(CodecRuntime* rt,
         remaining     -= (int)writeNow;
         offsetFrames  += (int)writeNow;
     }
-    return frames;
+    sp_note_write(sp, (size_t)frames, (size_t)offsetFrames);
+    return offsetFrames;
 }
 
 int stream_player_start(StreamPlayer* sp) {
@@ -278,7 +615,10 @@ int stream_player_stop(StreamPlayer* sp) {
 
 void stream_player_clear(StreamPlayer* sp) {
     if(!sp) return;
-    ma_pcm_rb_reset(&sp->rb);
+    if(sp->buffered) stream_timeline_clear(&sp->timeline);
+    else             ma_pcm_rb_reset(&sp->rb);
+    au_store_u32(&sp->primed, 0);
+    au_store_u32(&sp->gateState, SP_GATE_BUFFERING);
 }
 
 void stream_player_set_volume(StreamPlayer* sp, float volume) {
@@ -291,11 +631,39 @@ float stream_player_get_volume(StreamPlayer* sp) {
     return sp ? sp->volume : 1.0f;
 }
 
+int stream_player_set_bus(StreamPlayer* sp, struct MixBus* bus) {
+    if(!sp || !sp->initialized) return 0;
+    if(bus && mix_bus_get_engine(bus) != sp->engine) return 0;
+    ma_node* target = bus ? mix_bus_get_input(bus) : ma_engine_get_endpoint(sp->engine);
+    effect_chain_set_target(&sp->effects, target);
+    return 1;
+}
+
+int stream_player_insert_effect(StreamPlayer* sp, ma_node* effect, int index) {
+    if(!sp || !sp->initialized) return 0;
+    return effect_chain_insert(&sp->effects, effect, index);
+}
+
+int stream_player_remove_effect(StreamPlayer* sp, ma_node* effect) {
+    if(!sp || !sp->initialized) return 0;
+    return effect_chain_remove(&sp->effects, effect);
+}
+
+void stream_player_clear_effects(StreamPlayer* sp) {
+    if(sp && sp->initialized) effect_chain_clear(&sp->effects);
+}
+
 size_t stream_player_write_frames_f32(StreamPlayer* sp,
                                       const float* frames,
                                       size_t frameCount)
 {
     if(!sp || !frames || frameCount==0) return 0;
+    if(sp->buffered) {
+        size_t n = stream_timeline_write(&sp->timeline, frames, frameCount,
+                                         STREAM_TIMELINE_NO_TIMESTAMP);
+        sp_note_write(sp, frameCount, n);
+        return n;
+    }
     size_t written = 0;
     while(written < frameCount) {
         ma_uint32 space = ma_pcm_rb_available_write(&sp->rb);
@@ -310,9 +678,76 @@ size_t stream_player_write_frames_f32(StreamPlayer* sp,
         ma_pcm_rb_commit_write(&sp->rb, req);
         written += req;
     }
+    sp_note_write(sp, frameCount, written);
     return written;
 }
 
+size_t stream_player_write_frames_f32_at(StreamPlayer* sp,
+                                         const float* frames,
+                                         size_t frameCount,
+                                         int64_t timestampFrames)
+{
+    if(!sp || !frames || frameCount==0) return 0;
+    if(!sp->buffered) return stream_player_write_frames_f32(sp, frames, frameCount);
+    size_t n = stream_timeline_write(&sp->timeline, frames, frameCount, timestampFrames);
+    sp_note_write(sp, frameCount, n);
+    return n;
+}
+
+int stream_player_acquire_write_region(StreamPlayer* sp, void** outPtr, int* outFrames) {
+    if(!sp || !sp->initialized || !outPtr || !outFrames) return 0;
+    ma_uint32 req = *outFrames > 0 ? (ma_uint32)*outFrames : 0x7FFFFFFF;
+    void* pWrite = NULL;
+    *outPtr = NULL;
+    *outFrames = 0;
+
+    if(sp->buffered) {
+        if(!stream_timeline_acquire_write(&sp->timeline, &req, &pWrite)) return 0;
+    } else {
+        ma_uint32 space = ma_pcm_rb_available_write(&sp->rb);
+        if(req > space) req = space;
+        if(req == 0) return 1;
+        if(ma_pcm_rb_acquire_write(&sp->rb, &req, &pWrite) != MA_SUCCESS) return 0;
+    }
+    *outPtr    = req ? pWrite : NULL;
+    *outFrames = (int)req;
+    return 1;
+}
+
+int stream_player_commit_write_at(StreamPlayer* sp, int frames, int64_t timestampFrames) {
+    if(!sp || !sp->initialized || frames < 0) return 0;
+    if(sp->buffered) {
+        if(!stream_timeline_commit_write(&sp->timeline, (ma_uint32)frames, timestampFrames)) return 0;
+    } else if(ma_pcm_rb_commit_write(&sp->rb, (ma_uint32)frames) != MA_SUCCESS) {
+        return 0;
+    }
+    sp_note_write(sp, (size_t)frames, (size_t)frames);
+    return 1;
+}
+
+int stream_player_commit_write(StreamPlayer* sp, int frames) {
+    return stream_player_commit_write_at(sp, frames, STREAM_TIMELINE_NO_TIMESTAMP);
+}
+
+int64_t stream_player_get_position(StreamPlayer* sp) {
+    if(!sp || !sp->initialized) return 0;
+    if(sp->buffered) return stream_timeline_get_position(&sp->timeline);
+    return (int64_t)au_load_u64(&sp->playedFrames);
+}
+
+int stream_player_seek(StreamPlayer* sp, int64_t timestampFrames) {
+    if(!sp || !sp->initialized || !sp->buffered) return 0;
+    return stream_timeline_seek(&sp->timeline, timestampFrames);
+}
+
+int stream_player_get_buffered_range(StreamPlayer* sp,
+                                     int64_t* outStart,
+                                     int64_t* outEnd)
+{
+    if(!sp || !sp->initialized || !sp->buffered) return 0;
+    return stream_timeline_get_range(&sp->timeline, outStart, outEnd);
+}
+
 int stream_player_push_encoded_packet(StreamPlayer* sp,
                                       const void* packet,
                                       int packetBytes)
@@ -333,9 +768,131 @@ int stream_player_push_encoded_packet(StreamPlayer* sp,
             .channels        = sp->channels,
             .bits_per_sample = 32
         };
-        if(!codec_runtime_init(&sp->codecRT, cid, &ccfg)) return 0;
+        if(!codec_runtime_init(&sp->codecRT, cid, &ccfg)) {
+            sp_count_decode_error(sp, cid);
+            return 0;
+        }
         sp->codecInitialized = 1;
     }
 
-    return codec_runtime_push_packet(&sp->codecRT, pkt, packetBytes, sp);
-}
\ No newline at end of file
+    int frames = codec_runtime_push_packet(&sp->codecRT, pkt, packetBytes, sp);
+    if(frames <= 0) sp_count_decode_error(sp, cid);
+    return frames;
+}
+
+int stream_player_get_stats(StreamPlayer* sp, StreamPlayerStats* outStats) {
+    if(!sp || !sp->initialized || !outStats) return 0;
+    outStats->underrunEvents = au_load_u64(&sp->underrunEvents);
+    outStats->silenceFrames  = au_load_u64(&sp->silenceFrames);
+    outStats->droppedFrames  = au_load_u64(&sp->droppedFrames);
+    outStats->fillFrames     = sp_fill_frames(sp);
+    outStats->peakFillFrames = au_load_u32(&sp->peakFillFrames);
+    outStats->capacityFrames = sp->capacityFrames;
+    for(int i = 0; i < STREAM_PLAYER_CODEC_SLOTS; ++i)
+        outStats->decodeErrors[i] = au_load_u32(&sp->decodeErrors[i]);
+    sp_check_thresholds(sp);
+    return 1;
+}
+
+void stream_player_reset_stats(StreamPlayer* sp) {
+    if(!sp || !sp->initialized) return;
+    au_store_u64(&sp->underrunEvents, 0);
+    au_store_u64(&sp->silenceFrames, 0);
+    au_store_u64(&sp->droppedFrames, 0);
+    au_store_u32(&sp->peakFillFrames, sp_fill_frames(sp));
+    for(int i = 0; i < STREAM_PLAYER_CODEC_SLOTS; ++i)
+        au_store_u32(&sp->decodeErrors[i], 0);
+
+    ma_spinlock_lock(&sp->telemetryLock);
+    memset(sp->notified, 0, sizeof(sp->notified));
+    ma_spinlock_unlock(&sp->telemetryLock);
+}
+
+void stream_player_set_telemetry_callback(StreamPlayer* sp,
+                                          StreamPlayerTelemetryCallback cb,
+                                          void* userData,
+                                          uint32_t underrunThreshold,
+                                          uint32_t dropThresholdFrames,
+                                          uint32_t decodeErrorThreshold)
+{
+    if(!sp) return;
+    ma_spinlock_lock(&sp->telemetryLock);
+    sp->telemetryCb       = cb;
+    sp->telemetryUserData = userData;
+    sp->thresholds[0] = underrunThreshold;
+    sp->thresholds[1] = dropThresholdFrames;
+    sp->thresholds[2] = decodeErrorThreshold;
+    /* Only growth from now on triggers a notification. */
+    for(int i = 0; i < 3; ++i) sp->notified[i] = sp_event_total(sp, i);
+    ma_spinlock_unlock(&sp->telemetryLock);
+}
+
+void stream_player_ramp_gain(StreamPlayer* sp, float target, uint32_t durationMs, int curve) {
+    if(!sp || !sp->initialized) return;
+    if(!(target >= 0.0f)) target = 0.0f;
+    uint64_t frames = ((uint64_t)durationMs * sp->sampleRate) / 1000;
+    if(frames > 0x7FFFFFFF) frames = 0x7FFFFFFF;
+    uint32_t bits;
+    memcpy(&bits, &target, sizeof(bits));
+    uint64_t cmd = (uint64_t)bits | (frames << 32);
+    if(curve == STREAM_PLAYER_RAMP_EXPONENTIAL) cmd |= (uint64_t)1 << 63;
+    au_store_u64(&sp->rampCmd, cmd);
+}
+
+float stream_player_get_gain(StreamPlayer* sp) {
+    if(!sp || !sp->initialized) return 1.0f;
+    return au_load_f32(&sp->gainOut);
+}
+
+void stream_player_crossfade(StreamPlayer* from, StreamPlayer* to, uint32_t durationMs, int curve) {
+    stream_player_ramp_gain(from, 0.0f, durationMs, curve);
+    stream_player_ramp_gain(to, 1.0f, durationMs, curve);
+}
+
+/* One-pole coefficient reaching ~63% of a step in `ms`. */
+static float sp_smoothing_coef(uint32_t ms, ma_uint32 sampleRate) {
+    if(ms == 0) return 0.0f;
+    return expf(-1000.0f / ((float)ms * (float)sampleRate));
+}
+
+static uint32_t sp_acquire_send_slot(StreamPlayer* sp) {
+    uint32_t cur = au_load_u32(&sp->sendSlot);
+    if(cur != SP_NO_SLOT) return cur;
+    for(uint32_t i = 0; i < SP_SIDECHAIN_SLOTS; ++i) {
+        sp_sidechain_slot* slot = &g_sp_sidechains[i];
+        if(au_load_u32(&slot->inUse) || !au_cas_u32(&slot->inUse, 0, 1)) continue;
+        au_fetch_add_u32(&slot->generation, 1);
+        au_store_f32(&slot->level, 0.0f);
+        if(au_cas_u32(&sp->sendSlot, SP_NO_SLOT, i)) return i;
+        /* Another thread registered this player first. */
+        au_store_u32(&slot->inUse, 0);
+        return au_load_u32(&sp->sendSlot);
+    }
+    return SP_NO_SLOT;
+}
+
+int stream_player_set_ducking(StreamPlayer* sp,
+                              StreamPlayer* sidechain,
+                              float threshold,
+                              float duckGain,
+                              uint32_t attackMs,
+                              uint32_t releaseMs)
+{
+    if(!sp || !sp->initialized || sidechain == sp) return 0;
+    if(!sidechain) {
+        au_store_u64(&sp->duckSource, SP_NO_DUCK);
+        return 1;
+    }
+    if(!sidechain->initialized) return 0;
+
+    uint32_t slot = sp_acquire_send_slot(sidechain);
+    if(slot == SP_NO_SLOT) return 0;
+
+    au_store_f32(&sp->duckThreshold, threshold);
+    au_store_f32(&sp->duckGain, duckGain < 0.0f ? 0.0f : duckGain);
+    au_store_f32(&sp->duckAttack, sp_smoothing_coef(attackMs, sp->sampleRate));
+    au_store_f32(&sp->duckRelease, sp_smoothing_coef(releaseMs, sp->sampleRate));
+    uint32_t gen = au_load_u32(&g_sp_sidechains[slot].generation);
+    au_store_u64(&sp->duckSource, ((uint64_t)slot << 32) | gen);
+    return 1;
+}
@@ -0,0 +1,298 @@
+#include "../include/stream_timeline.h"
+#include "../include/atomic_util.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TL_NO_SEEK UINT64_MAX
+
+/*************
+ ** private **
+ *************/
+
+static ma_uint8* tl_frame_ptr(StreamTimeline* tl, uint64_t abs) {
+    uint64_t seg = (abs / tl->segmentFrames) % tl->segmentCount;
+    uint64_t off = abs % tl->segmentFrames;
+    ma_uint8* base = tl->segments[seg];
+    return base ? base + off * tl->frameSizeBytes : NULL;
+}
+
+/* Effective read position as seen by the writer: a posted seek counts as
+   already applied so the writer never overwrites the seek target. The reader
+   stores readAbs before clearing pendingSeek, so loading in the opposite
+   order here always observes one or the other. */
+static uint64_t tl_reader_floor(StreamTimeline* tl) {
+    uint64_t pending = au_load_u64(&tl->pendingSeek);
+    uint64_t ra = au_load_u64(&tl->readAbs);
+    return (pending != TL_NO_SEEK && pending < ra) ? pending : ra;
+}
+
+/* Oldest frame a seek may target. Frames below this are, or may be about to
+   be, overwritten by the writer. */
+static uint64_t tl_oldest_seekable(StreamTimeline* tl) {
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    uint64_t end = tl->reserveEnd > wa ? tl->reserveEnd : wa;
+    uint64_t floor = end > tl->capacityFrames ? end - tl->capacityFrames : 0;
+    return floor > tl->baseAbs ? floor : tl->baseAbs;
+}
+
+static StreamTimelineChunk* tl_chunk_at(StreamTimeline* tl, ma_uint32 i) {
+    return &tl->chunks[(tl->chunkHead + i) % STREAM_TIMELINE_MAX_CHUNKS];
+}
+
+/* Map an absolute index to a timestamp. Caller holds lock. */
+static int64_t tl_timestamp_of(StreamTimeline* tl, uint64_t abs) {
+    if (tl->chunkCount == 0) return (int64_t)abs;
+    for (ma_uint32 i = tl->chunkCount; i > 0; --i) {
+        StreamTimelineChunk* c = tl_chunk_at(tl, i - 1);
+        if (c->absStart <= abs) {
+            return c->timestamp + (int64_t)(abs - c->absStart);
+        }
+    }
+    return tl_chunk_at(tl, 0)->timestamp;
+}
+
+/* Drop chunk records that lie entirely below the addressable window. */
+static void tl_prune_chunks(StreamTimeline* tl, uint64_t oldest) {
+    while (tl->chunkCount > 1 && tl_chunk_at(tl, 1)->absStart <= oldest) {
+        tl->chunkHead = (tl->chunkHead + 1) % STREAM_TIMELINE_MAX_CHUNKS;
+        tl->chunkCount--;
+    }
+}
+
+static void tl_push_chunk(StreamTimeline* tl, uint64_t absStart, int64_t timestamp) {
+    if (tl->chunkCount == STREAM_TIMELINE_MAX_CHUNKS) {
+        /* Table full: forget the oldest chunk and the frames it covered. */
+        tl->chunkHead = (tl->chunkHead + 1) % STREAM_TIMELINE_MAX_CHUNKS;
+        tl->chunkCount--;
+        uint64_t newBase = tl_chunk_at(tl, 0)->absStart;
+        if (newBase > tl->baseAbs) tl->baseAbs = newBase;
+    }
+    StreamTimelineChunk* c = tl_chunk_at(tl, tl->chunkCount);
+    c->absStart  = absStart;
+    c->timestamp = timestamp;
+    tl->chunkCount++;
+}
+
+/************
+ ** public **
+ ************/
+
+int stream_timeline_init(StreamTimeline* tl,
+                         ma_uint32 frameSizeBytes,
+                         ma_uint32 segmentFrames,
+                         uint64_t windowFrames)
+{
+    if (!tl || frameSizeBytes == 0 || segmentFrames == 0) return 0;
+    memset(tl, 0, sizeof(*tl));
+
+    uint64_t count = (windowFrames + segmentFrames - 1) / segmentFrames;
+    if (count < 2) count = 2;
+    if (count > 0xFFFF) count = 0xFFFF;
+
+    tl->segments = (ma_uint8**)calloc((size_t)count, sizeof(ma_uint8*));
+    if (!tl->segments) return 0;
+
+    tl->frameSizeBytes = frameSizeBytes;
+    tl->segmentFrames  = segmentFrames;
+    tl->segmentCount   = (ma_uint32)count;
+    tl->capacityFrames = count * segmentFrames;
+    tl->pendingSeek    = TL_NO_SEEK;
+    return 1;
+}
+
+void stream_timeline_uninit(StreamTimeline* tl) {
+    if (!tl || !tl->segments) return;
+    for (ma_uint32 i = 0; i < tl->segmentCount; ++i) {
+        free(tl->segments[i]);
+    }
+    free(tl->segments);
+    tl->segments = NULL;
+}
+
+int stream_timeline_acquire_write(StreamTimeline* tl, ma_uint32* inOutFrames, void** ppWrite) {
+    if (!tl || !inOutFrames || !ppWrite) return 0;
+    *ppWrite = NULL;
+
+    ma_spinlock_lock(&tl->lock);
+    uint64_t wa    = au_load_u64(&tl->writeAbs);
+    uint64_t used  = wa - tl_reader_floor(tl);
+    uint64_t space = used < tl->capacityFrames ? tl->capacityFrames - used : 0;
+    uint64_t toSegEnd = tl->segmentFrames - (wa % tl->segmentFrames);
+
+    uint64_t n = *inOutFrames;
+    if (n > space)    n = space;
+    if (n > toSegEnd) n = toSegEnd;
+    if (n == 0) {
+        ma_spinlock_unlock(&tl->lock);
+        *inOutFrames = 0;
+        return 1;
+    }
+
+    ma_uint32 seg = (ma_uint32)((wa / tl->segmentFrames) % tl->segmentCount);
+    if (tl->segments[seg] == NULL) {
+        tl->segments[seg] = (ma_uint8*)malloc((size_t)tl->segmentFrames * tl->frameSizeBytes);
+        if (tl->segments[seg] == NULL) {
+            ma_spinlock_unlock(&tl->lock);
+            *inOutFrames = 0;
+            return 0;
+        }
+    }
+    tl->reserveEnd = wa + n;
+    ma_spinlock_unlock(&tl->lock);
+
+    *ppWrite     = tl_frame_ptr(tl, wa);
+    *inOutFrames = (ma_uint32)n;
+    return 1;
+}
+
+int stream_timeline_commit_write(StreamTimeline* tl, ma_uint32 frames, int64_t timestamp) {
+    if (!tl) return 0;
+    ma_spinlock_lock(&tl->lock);
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    if (wa + frames > tl->reserveEnd) {
+        ma_spinlock_unlock(&tl->lock);
+        return 0;
+    }
+    if (frames > 0) {
+        if (timestamp != STREAM_TIMELINE_NO_TIMESTAMP) {
+            /* Only record a chunk when it is not a seamless continuation. */
+            if (tl->chunkCount == 0 || tl_timestamp_of(tl, wa) != timestamp) {
+                tl_push_chunk(tl, wa, timestamp);
+            }
+        } else if (tl->chunkCount == 0) {
+            tl_push_chunk(tl, wa, (int64_t)wa);
+        }
+        au_store_u64(&tl->writeAbs, wa + frames);
+        uint64_t end = wa + frames;
+        tl_prune_chunks(tl, end > tl->capacityFrames ? end - tl->capacityFrames : 0);
+    }
+    tl->reserveEnd = wa + frames;
+    ma_spinlock_unlock(&tl->lock);
+    return 1;
+}
+
+size_t stream_timeline_write(StreamTimeline* tl, const void* frames, size_t frameCount, int64_t timestamp) {
+    if (!tl || !frames || frameCount == 0) return 0;
+    const ma_uint8* src = (const ma_uint8*)frames;
+    size_t written = 0;
+    while (written < frameCount) {
+        size_t left = frameCount - written;
+        ma_uint32 req = (ma_uint32)(left > 0x7FFFFFFF ? 0x7FFFFFFF : left);
+        void* pWrite = NULL;
+        if (!stream_timeline_acquire_write(tl, &req, &pWrite) || req == 0) break;
+        memcpy(pWrite, src + written * tl->frameSizeBytes, (size_t)req * tl->frameSizeBytes);
+        int64_t ts = (timestamp == STREAM_TIMELINE_NO_TIMESTAMP)
+            ? STREAM_TIMELINE_NO_TIMESTAMP
+            : timestamp + (int64_t)written;
+        stream_timeline_commit_write(tl, req, ts);
+        written += req;
+    }
+    return written;
+}
+
+ma_uint32 stream_timeline_read(StreamTimeline* tl, void* out, ma_uint32 frames) {
+    if (!tl || !out || frames == 0) return 0;
+
+    uint64_t pending = au_load_u64(&tl->pendingSeek);
+    if (pending != TL_NO_SEEK) {
+        au_store_u64(&tl->readAbs, pending);
+        au_cas_u64(&tl->pendingSeek, pending, TL_NO_SEEK);
+    }
+
+    uint64_t ra = au_load_u64(&tl->readAbs);
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    uint64_t avail = wa > ra ? wa - ra : 0;
+    ma_uint32 total = (ma_uint32)(avail < frames ? avail : frames);
+
+    ma_uint8* dst = (ma_uint8*)out;
+    ma_uint32 done = 0;
+    while (done < total) {
+        uint64_t abs = ra + done;
+        ma_uint32 toSegEnd = tl->segmentFrames - (ma_uint32)(abs % tl->segmentFrames);
+        ma_uint32 n = total - done;
+        if (n > toSegEnd) n = toSegEnd;
+        const ma_uint8* src = tl_frame_ptr(tl, abs);
+        if (!src) break;
+        memcpy(dst + (size_t)done * tl->frameSizeBytes, src, (size_t)n * tl->frameSizeBytes);
+        done += n;
+    }
+    au_store_u64(&tl->readAbs, ra + done);
+    return done;
+}
+
+ma_uint32 stream_timeline_available_read(StreamTimeline* tl) {
+    if (!tl) return 0;
+    uint64_t ra = au_load_u64(&tl->readAbs);
+    uint64_t pending = au_load_u64(&tl->pendingSeek);
+    if (pending != TL_NO_SEEK) ra = pending;
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    uint64_t avail = wa > ra ? wa - ra : 0;
+    return (ma_uint32)(avail > 0x7FFFFFFF ? 0x7FFFFFFF : avail);
+}
+
+ma_uint32 stream_timeline_available_write(StreamTimeline* tl) {
+    if (!tl) return 0;
+    uint64_t used = au_load_u64(&tl->writeAbs) - tl_reader_floor(tl);
+    uint64_t space = used < tl->capacityFrames ? tl->capacityFrames - used : 0;
+    return (ma_uint32)(space > 0x7FFFFFFF ? 0x7FFFFFFF : space);
+}
+
+int64_t stream_timeline_get_position(StreamTimeline* tl) {
+    if (!tl) return 0;
+    uint64_t pending = au_load_u64(&tl->pendingSeek);
+    uint64_t ra = pending != TL_NO_SEEK ? pending : au_load_u64(&tl->readAbs);
+    ma_spinlock_lock(&tl->lock);
+    int64_t ts = tl_timestamp_of(tl, ra);
+    ma_spinlock_unlock(&tl->lock);
+    return ts;
+}
+
+int stream_timeline_seek(StreamTimeline* tl, int64_t timestamp) {
+    if (!tl) return 0;
+    ma_spinlock_lock(&tl->lock);
+
+    uint64_t oldest = tl_oldest_seekable(tl);
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    uint64_t target = TL_NO_SEEK;
+
+    /* Newest chunk wins when timestamps overlap (e.g. after a rewind). */
+    for (ma_uint32 i = tl->chunkCount; i > 0 && target == TL_NO_SEEK; --i) {
+        StreamTimelineChunk* c = tl_chunk_at(tl, i - 1);
+        uint64_t end = (i < tl->chunkCount) ? tl_chunk_at(tl, i)->absStart : wa;
+        if (timestamp < c->timestamp) continue;
+        uint64_t abs = c->absStart + (uint64_t)(timestamp - c->timestamp);
+        if (abs <= end && abs >= oldest) target = abs;
+    }
+    if (target == TL_NO_SEEK && tl->chunkCount == 0 && timestamp >= 0 &&
+        (uint64_t)timestamp >= oldest && (uint64_t)timestamp <= wa) {
+        target = (uint64_t)timestamp;
+    }
+
+    if (target != TL_NO_SEEK) {
+        au_store_u64(&tl->pendingSeek, target);
+    }
+    ma_spinlock_unlock(&tl->lock);
+    return target != TL_NO_SEEK;
+}
+
+int stream_timeline_get_range(StreamTimeline* tl, int64_t* outStart, int64_t* outEnd) {
+    if (!tl) return 0;
+    ma_spinlock_lock(&tl->lock);
+    uint64_t oldest = tl_oldest_seekable(tl);
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    if (outStart) *outStart = tl_timestamp_of(tl, oldest);
+    if (outEnd)   *outEnd   = tl_timestamp_of(tl, wa);
+    ma_spinlock_unlock(&tl->lock);
+    return 1;
+}
+
+void stream_timeline_clear(StreamTimeline* tl) {
+    if (!tl) return;
+    ma_spinlock_lock(&tl->lock);
+    uint64_t wa = au_load_u64(&tl->writeAbs);
+    tl->baseAbs = wa;
+    tl->chunkHead = 0;
+    tl->chunkCount = 0;
+    au_store_u64(&tl->pendingSeek, wa);
+    ma_spinlock_unlock(&tl->lock);
+}
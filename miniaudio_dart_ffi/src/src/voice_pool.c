@@ -0,0 +1,123 @@
+#include "../include/voice_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* handle = generation << 8 | index; generations are 24-bit and never 0. */
+#define VP_INDEX_BITS 8
+#define VP_INDEX_MASK ((1u << VP_INDEX_BITS) - 1)
+#define VP_GEN_MASK   (0xFFFFFFFFu >> VP_INDEX_BITS)
+
+/*************
+ ** private **
+ *************/
+
+static float vp_loudness(SoundVoice* v) {
+    return ma_sound_get_volume(&v->sound) *
+           ma_sound_get_current_fade_volume(&v->sound);
+}
+
+/* Playing, or started with a start time still ahead of the engine clock.
+   A voice past its stop time or its end is free even if never stopped. */
+static bool vp_busy(SoundVoice* v) {
+    ma_sound* s = &v->sound;
+    if (ma_node_get_state(s) != ma_node_state_started || ma_sound_at_end(s)) return false;
+    ma_uint64 const now = ma_engine_get_time_in_pcm_frames(ma_sound_get_engine(s));
+    return ma_node_get_state_time(s, ma_node_state_stopped) > now;
+}
+
+/* Pick a busy voice to take over; every voice is playing when this runs. */
+static SoundVoice* vp_victim(VoicePool* pool) {
+    SoundVoice* best = &pool->voices[0];
+    float bestLoudness = vp_loudness(best);
+    for (uint32_t i = 1; i < pool->count; ++i) {
+        SoundVoice* v = &pool->voices[i];
+        switch (pool->policy) {
+            case SOUND_STEAL_QUIETEST: {
+                float const l = vp_loudness(v);
+                if (l < bestLoudness) { best = v; bestLoudness = l; }
+                break;
+            }
+            case SOUND_STEAL_LOWEST_PRIORITY:
+                if (v->priority < best->priority ||
+                    (v->priority == best->priority && v->started < best->started))
+                    best = v;
+                break;
+            default:
+                if (v->started < best->started) best = v;
+                break;
+        }
+    }
+    return best;
+}
+
+/************
+ ** public **
+ ************/
+
+int voice_pool_alloc(VoicePool* pool, uint32_t count, SoundStealPolicy policy) {
+    if (!pool || count == 0 || count > VOICE_POOL_MAX_VOICES) return 0;
+    memset(pool, 0, sizeof(*pool));
+    pool->voices = (SoundVoice*)calloc(count, sizeof(SoundVoice));
+    if (!pool->voices) return 0;
+    pool->count  = count;
+    pool->policy = policy;
+    for (uint32_t i = 0; i < count; ++i) pool->voices[i].generation = 1;
+    return 1;
+}
+
+void voice_pool_free(VoicePool* pool) {
+    if (!pool) return;
+    free(pool->voices);
+    memset(pool, 0, sizeof(*pool));
+}
+
+SoundVoice* voice_pool_acquire(VoicePool* pool, int priority, bool* stolen) {
+    if (stolen) *stolen = false;
+    if (!pool || pool->count == 0) return NULL;
+
+    SoundVoice* voice = NULL;
+    for (uint32_t i = 0; i < pool->count; ++i) {
+        if (!vp_busy(&pool->voices[i])) {
+            voice = &pool->voices[i];
+            break;
+        }
+    }
+    if (!voice) {
+        if (pool->policy == SOUND_STEAL_NONE) return NULL;
+        voice = vp_victim(pool);
+        /* A newer, more important sound is not displaced by a lesser one. */
+        if (pool->policy == SOUND_STEAL_LOWEST_PRIORITY && voice->priority > priority)
+            return NULL;
+        ma_sound_stop(&voice->sound);
+        if (stolen) *stolen = true;
+    }
+
+    voice->generation = (voice->generation + 1) & VP_GEN_MASK;
+    if (voice->generation == 0) voice->generation = 1;
+    voice->started  = ++pool->clock;
+    voice->priority = priority;
+    return voice;
+}
+
+uint32_t voice_pool_handle(VoicePool const* pool, SoundVoice const* voice) {
+    if (!pool || !voice) return 0;
+    uint32_t const index = (uint32_t)(voice - pool->voices);
+    return (voice->generation << VP_INDEX_BITS) | index;
+}
+
+SoundVoice* voice_pool_lookup(VoicePool* pool, uint32_t handle) {
+    if (!pool || handle == 0) return NULL;
+    uint32_t const index = handle & VP_INDEX_MASK;
+    if (index >= pool->count) return NULL;
+    SoundVoice* v = &pool->voices[index];
+    return v->generation == (handle >> VP_INDEX_BITS) ? v : NULL;
+}
+
+uint32_t voice_pool_active(VoicePool* pool) {
+    if (!pool) return 0;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < pool->count; ++i) {
+        if (vp_busy(&pool->voices[i])) n++;
+    }
+    return n;
+}
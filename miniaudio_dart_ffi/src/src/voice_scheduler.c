@@ -0,0 +1,389 @@
+#include "../include/voice_scheduler.h"
+#include "../include/atomic_util.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define VS_REAL_BONUS     1.05f  /* hysteresis for voices already mixed */
+#define VS_RESTORE_FADE_MS 5
+
+enum {
+    VS_SEEK_NONE = 0,
+    VS_SEEK_QUEUED,  /* posted; the voice stays detached */
+    VS_SEEK_DONE,    /* landed; the next pass finishes the restore */
+};
+
+/*************
+ ** private **
+ *************/
+
+static void vs_lock(VoiceScheduler* s) {
+    while (!au_cas_u32(&s->lock, 0, 1)) { /* held briefly by the audio thread */ }
+}
+
+static void vs_unlock(VoiceScheduler* s) {
+    au_store_u32(&s->lock, 0);
+}
+
+static void vs_wait_seeks(VoiceScheduler* s) {
+    ma_resource_manager* rm = ma_engine_get_resource_manager(s->engine);
+    while (au_load_u32(&s->pendingSeeks) != 0) {
+        if (rm && rm->config.jobThreadCount == 0) {
+            ma_resource_manager_process_next_job(rm);  /* nobody else will */
+            continue;
+        }
+#if defined(_WIN32)
+        Sleep(1);
+#else
+        usleep(1000);
+#endif
+    }
+}
+
+static VoiceSchedulerEntry* vs_find(VoiceScheduler* s, ma_sound* sound, uint32_t* outIndex) {
+    for (uint32_t i = 0; i < s->count; ++i) {
+        if (s->entries[i].sound == sound) {
+            if (outIndex) *outIndex = i;
+            return &s->entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void vs_reattach(VoiceSchedulerEntry* e) {
+    ma_node_attach_output_bus(e->sound, 0, e->outNode, e->outBus);
+    e->isVirtual = false;
+}
+
+static void vs_virtualize(VoiceScheduler* s, VoiceSchedulerEntry* e) {
+    ma_node_output_bus* bus = &((ma_node_base*)e->sound)->pOutputBuses[0];
+    ma_node* target = (ma_node*)bus->pInputNode;
+    if (target == NULL) return;  /* not in the graph, nothing to save */
+
+    e->outNode = target;
+    e->outBus  = bus->inputNodeInputBusIndex;
+    e->cursor  = 0;
+    ma_sound_get_cursor_in_pcm_frames(e->sound, &e->cursor);
+    e->since   = ma_engine_get_time_in_pcm_frames(s->engine);
+    ma_node_detach_output_bus(e->sound, 0);
+    e->isVirtual = true;
+}
+
+/* Where a virtual voice would be now. Returns 0 when it would have ended. */
+static int vs_position(VoiceScheduler* s, VoiceSchedulerEntry* e, ma_uint64* outFrame) {
+    ma_uint32 srcRate = 0;
+    ma_sound_get_data_format(e->sound, NULL, NULL, &srcRate, NULL, 0);
+    ma_uint32 const engRate = ma_engine_get_sample_rate(s->engine);
+    ma_uint64 const elapsed = ma_engine_get_time_in_pcm_frames(s->engine) - e->since;
+    /* Pitch is disabled on our sounds, so source time runs at the rate ratio. */
+    ma_uint64 frame = e->cursor +
+        (srcRate && engRate ? elapsed * srcRate / engRate : elapsed);
+
+    ma_uint64 length = 0;
+    ma_sound_get_length_in_pcm_frames(e->sound, &length);
+    if (length > 0 && frame >= length) {
+        if (!ma_sound_is_looping(e->sound)) return 0;
+        frame %= length;
+    }
+    *outFrame = frame;
+    return 1;
+}
+
+static void vs_resume(VoiceSchedulerEntry* e) {
+    /* Leave a caller's fade alone; otherwise ease back in. */
+    if (ma_sound_get_current_fade_volume(e->sound) >= 1.0f) {
+        ma_sound_set_fade_in_milliseconds(e->sound, 0.0f, 1.0f, VS_RESTORE_FADE_MS);
+    }
+    vs_reattach(e);
+}
+
+/* Job thread. The position is taken when the job runs, not when it was
+   queued, and the seek itself happens outside the lock. */
+static ma_result vs_seek_job(ma_job* job) {
+    VoiceScheduler* s = (VoiceScheduler*)job->data.custom.data0;
+    ma_sound* sound = (ma_sound*)job->data.custom.data1;
+    ma_uint64 frame = 0;
+
+    vs_lock(s);
+    VoiceSchedulerEntry* e = vs_find(s, sound, NULL);
+    int const queued = e && e->seek == VS_SEEK_QUEUED;
+    if (queued && !e->seekRewind && !vs_position(s, e, &frame)) {
+        ma_sound_stop(sound);  /* ran out while waiting */
+        e->seekRewind = true;
+    }
+    if (queued && e->seekRewind) frame = 0;
+    vs_unlock(s);
+
+    if (queued) {
+        ma_sound_seek_to_pcm_frame(sound, frame);
+        vs_lock(s);
+        e = vs_find(s, sound, NULL);
+        if (e) e->seek = VS_SEEK_DONE;
+        vs_unlock(s);
+    }
+    au_fetch_add_u32(&s->pendingSeeks, (uint32_t)-1);
+    return MA_SUCCESS;
+}
+
+/* Keeps e detached until the job has seeked it, see above. frame is only
+   used when the job cannot be posted. */
+static void vs_queue_seek(VoiceScheduler* s, VoiceSchedulerEntry* e, bool rewind, ma_uint64 frame) {
+    e->seek = VS_SEEK_QUEUED;
+    e->seekRewind = rewind;
+    au_fetch_add_u32(&s->pendingSeeks, 1);
+    ma_job job = ma_job_init(MA_JOB_TYPE_CUSTOM);
+    job.data.custom.proc  = vs_seek_job;
+    job.data.custom.data0 = (ma_uintptr)s;
+    job.data.custom.data1 = (ma_uintptr)e->sound;
+    ma_resource_manager* rm = ma_engine_get_resource_manager(s->engine);
+    if (rm == NULL || ma_resource_manager_post_job(rm, &job) != MA_SUCCESS) {
+        /* Queue full: seek here rather than leave the voice stuck. */
+        au_fetch_add_u32(&s->pendingSeeks, (uint32_t)-1);
+        ma_sound_seek_to_pcm_frame(e->sound, rewind ? 0 : frame);
+        e->seek = VS_SEEK_DONE;
+    }
+}
+
+/* A virtual voice past its end: stopped and rewound, as if it had played
+   out. */
+static void vs_finish(VoiceScheduler* s, VoiceSchedulerEntry* e) {
+    ma_sound_stop(e->sound);
+    if (e->slowSeek) {
+        vs_queue_seek(s, e, true, 0);
+        return;
+    }
+    ma_sound_seek_to_pcm_frame(e->sound, 0);
+    vs_reattach(e);
+}
+
+static void vs_restore(VoiceScheduler* s, VoiceSchedulerEntry* e) {
+    ma_uint64 frame = 0;
+    if (!vs_position(s, e, &frame)) {
+        vs_finish(s, e);
+        return;
+    }
+    if (e->slowSeek) {
+        vs_queue_seek(s, e, false, frame);
+        return;
+    }
+    ma_sound_seek_to_pcm_frame(e->sound, frame);
+    vs_resume(e);
+}
+
+/* The pass after a queued seek has landed. */
+static void vs_seeked(VoiceSchedulerEntry* e) {
+    e->seek = VS_SEEK_NONE;
+    if (e->seekRewind || !ma_sound_is_playing(e->sound)) vs_reattach(e);
+    else vs_resume(e);
+}
+
+static float vs_score(VoiceSchedulerEntry* e) {
+    float score = e->weight *
+                  ma_sound_get_volume(e->sound) *
+                  ma_sound_get_current_fade_volume(e->sound);
+    return e->isVirtual ? score : score * VS_REAL_BONUS;
+}
+
+/* k-th largest (1-based) of a[0..n), reordering a. */
+static float vs_select(float* a, uint32_t n, uint32_t k) {
+    uint32_t lo = 0, hi = n - 1, target = k - 1;
+    while (lo < hi) {
+        float const pivot = a[lo + (hi - lo) / 2];
+        uint32_t i = lo, j = hi;
+        while (i <= j) {
+            while (a[i] > pivot) i++;
+            while (a[j] < pivot) j--;
+            if (i <= j) {
+                float t = a[i]; a[i] = a[j]; a[j] = t;
+                i++;
+                if (j == 0) break;
+                j--;
+            }
+        }
+        if (target <= j) hi = j;
+        else if (target >= i) lo = i;
+        else break;
+    }
+    return a[target];
+}
+
+/************
+ ** public **
+ ************/
+
+void voice_scheduler_init(VoiceScheduler* s, ma_engine* engine) {
+    memset(s, 0, sizeof(*s));
+    s->engine = engine;
+}
+
+void voice_scheduler_uninit(VoiceScheduler* s) {
+    vs_wait_seeks(s);
+    free(s->entries);
+    free(s->scores);
+    free(s->ranked);
+    memset(s, 0, sizeof(*s));
+}
+
+int voice_scheduler_add(VoiceScheduler* s, ma_sound* sound, float weight, bool slowSeek) {
+    if (!s || !sound) return 0;
+    vs_lock(s);
+    if (s->count == s->capacity) {
+        uint32_t const cap = s->capacity ? s->capacity * 2 : 32;
+        VoiceSchedulerEntry* entries = (VoiceSchedulerEntry*)realloc(s->entries, cap * sizeof(*entries));
+        if (entries) s->entries = entries;
+        float* scores = (float*)realloc(s->scores, cap * sizeof(float));
+        if (scores) s->scores = scores;
+        float* ranked = (float*)realloc(s->ranked, cap * sizeof(float));
+        if (ranked) s->ranked = ranked;
+        if (!entries || !scores || !ranked) {
+            vs_unlock(s);
+            return 0;
+        }
+        s->capacity = cap;
+    }
+    VoiceSchedulerEntry* e = &s->entries[s->count++];
+    memset(e, 0, sizeof(*e));
+    e->sound    = sound;
+    e->weight   = weight;
+    e->slowSeek = slowSeek;
+    vs_unlock(s);
+    return 1;
+}
+
+void voice_scheduler_remove(VoiceScheduler* s, ma_sound* sound) {
+    if (!s || !sound) return;
+    vs_lock(s);
+    uint32_t i = 0;
+    VoiceSchedulerEntry* e = vs_find(s, sound, &i);
+    VoiceSchedulerEntry removed = { 0 };
+    if (e) {
+        removed = *e;
+        s->entries[i] = s->entries[--s->count];
+    }
+    vs_unlock(s);
+    /* A job may be seeking the sound right now; the caller is about to
+       uninit it. Without an entry, jobs not yet started leave it alone. */
+    if (removed.seek == VS_SEEK_QUEUED) vs_wait_seeks(s);
+    if (removed.isVirtual) vs_reattach(&removed);
+}
+
+void voice_scheduler_set_weight(VoiceScheduler* s, ma_sound* sound, float weight) {
+    if (!s || !sound) return;
+    vs_lock(s);
+    VoiceSchedulerEntry* e = vs_find(s, sound, NULL);
+    if (e) e->weight = weight;
+    vs_unlock(s);
+}
+
+void voice_scheduler_route(VoiceScheduler* s, ma_sound* sound, ma_node* target) {
+    if (!sound || !target) return;
+    if (!s) {
+        ma_node_attach_output_bus(sound, 0, target, 0);
+        return;
+    }
+    vs_lock(s);
+    VoiceSchedulerEntry* e = vs_find(s, sound, NULL);
+    if (e && e->isVirtual) {
+        e->outNode = target;
+        e->outBus  = 0;
+    } else {
+        ma_node_attach_output_bus(sound, 0, target, 0);
+    }
+    vs_unlock(s);
+}
+
+void voice_scheduler_set_max_voices(VoiceScheduler* s, uint32_t maxVoices) {
+    if (s) au_store_u32(&s->maxVoices, maxVoices);
+}
+
+void voice_scheduler_process(VoiceScheduler* s) {
+    if (!au_cas_u32(&s->lock, 0, 1)) return;  /* registration in progress */
+
+    uint32_t playing = 0, seeking = 0;
+    for (uint32_t i = 0; i < s->count; ++i) {
+        VoiceSchedulerEntry* e = &s->entries[i];
+        s->scores[i] = -1.0f;
+        if (e->seek == VS_SEEK_QUEUED) {
+            seeking++;  /* out of the ranking until it lands */
+            continue;
+        }
+        if (e->seek == VS_SEEK_DONE) vs_seeked(e);
+        if (!ma_sound_is_playing(e->sound)) {
+            /* Stopped or paused while virtual: back in the graph as is. */
+            if (e->isVirtual) vs_reattach(e);
+            continue;
+        }
+        s->scores[i] = vs_score(e);
+        s->ranked[playing++] = s->scores[i];
+    }
+
+    uint32_t const maxVoices = au_load_u32(&s->maxVoices);
+    uint32_t const keep = (maxVoices == 0 || playing <= maxVoices) ? playing : maxVoices;
+    float threshold = -1.0f;
+    uint32_t ties = 0;
+    if (keep < playing) {
+        threshold = keep ? vs_select(s->ranked, playing, keep) : 3.4e38f;
+        uint32_t above = 0;
+        for (uint32_t i = 0; i < s->count; ++i) {
+            if (s->scores[i] > threshold) above++;
+        }
+        ties = keep - above;
+    }
+
+    /* Mixed voices win ties over virtual ones, so nothing swaps needlessly. */
+    for (int pass = 0; pass < 2; ++pass) {
+        for (uint32_t i = 0; i < s->count; ++i) {
+            VoiceSchedulerEntry* e = &s->entries[i];
+            if (s->scores[i] < 0.0f || s->scores[i] != threshold) continue;
+            if (e->isVirtual == (pass == 0)) continue;
+            if (ties > 0) {
+                ties--;
+                s->scores[i] = 3.4e38f;  /* mark as kept */
+            }
+        }
+    }
+
+    uint32_t mixed = 0, virtualized = 0;
+    for (uint32_t i = 0; i < s->count; ++i) {
+        VoiceSchedulerEntry* e = &s->entries[i];
+        if (s->scores[i] < 0.0f) continue;
+        if (s->scores[i] > threshold) {
+            if (e->isVirtual) vs_restore(s, e);
+        } else if (!e->isVirtual) {
+            vs_virtualize(s, e);
+        } else {
+            ma_uint64 frame;
+            /* A virtual voice that has run out is simply finished. */
+            if (!vs_position(s, e, &frame)) {
+                vs_finish(s, e);
+                continue;
+            }
+        }
+        if (e->isVirtual) virtualized++;
+        else if (ma_sound_is_playing(e->sound)) mixed++;
+    }
+    au_store_u32(&s->mixedVoices, mixed);
+    au_store_u32(&s->virtualVoices, virtualized + seeking);
+    vs_unlock(s);
+}
+
+ma_uint64 voice_scheduler_next_event(VoiceScheduler* s, ma_uint64 beg, ma_uint64 end) {
+    if (!au_cas_u32(&s->lock, 0, 1)) return end;  /* one unsplit read at worst */
+
+    ma_uint64 next = end;
+    for (uint32_t i = 0; i < s->count; ++i) {
+        ma_node* node = s->entries[i].sound;
+        if (ma_node_get_state(node) != ma_node_state_started) continue;
+        ma_uint64 const start = ma_node_get_state_time(node, ma_node_state_started);
+        ma_uint64 const stop  = ma_node_get_state_time(node, ma_node_state_stopped) - 1;
+        if (start > beg && start < next) next = start;
+        if (stop  > beg && stop  < next) next = stop;
+    }
+    vs_unlock(s);
+    return next;
+}
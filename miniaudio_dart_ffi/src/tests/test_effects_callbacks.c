@@ -0,0 +1,207 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/effects.h"
+#include "../include/engine.h"
+#include "../include/mix_bus.h"
+#include "../include/sound.h"
+#include "../include/stream_player.h"
+#include "virtual_device.h"
+
+/* Built-in effects on a virtual device: a shelf lifts a constant by its
+   gain, gliding there rather than jumping; the compressor settles on its
+   static curve; the limiter never lets a sample over the ceiling; the
+   reverb rings on after its input stops and dies away; and effects go in
+   and out of sound, voice, stream player and bus chains. */
+
+#define NEAR(a, b, tol) (fabsf((a) - (b)) < (tol))
+
+typedef struct Level {
+    float last;
+    float peak;  /* since the last reset */
+} Level;
+
+static void on_output(void* user, const float* frames, uint32_t frameCount,
+                      uint32_t channels, uint64_t time) {
+    Level* level = (Level*)user;
+    (void)time;
+    for (uint32_t i = 0; i < frameCount * channels; ++i) {
+        float const a = fabsf(frames[i]);
+        if (a > level->peak) level->peak = a;
+    }
+    level->last = frames[(frameCount - 1) * channels];
+}
+
+static Sound* load_signal(Engine* engine, float* data, uint32_t frames, int looped) {
+    Sound* sound = sound_alloc();
+    if (!engine_load_sound(engine, sound, data, frames * sizeof(float), ma_format_f32, 48000, 1)) {
+        free(sound);
+        return NULL;
+    }
+    sound_set_looped(sound, looped, 0);
+    return sound;
+}
+
+static Effect* make_effect(Engine* engine, int type) {
+    Effect* effect = effect_alloc();
+    if (effect && !effect_init(effect, engine, type)) {
+        effect_free(effect);
+        return NULL;
+    }
+    return effect;
+}
+
+int main(void) {
+    VDEV_CHECK(vdev_install(48000));
+    Level level = { 0 };
+    vdev_set_output(on_output, &level);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init(engine, 10));
+    VDEV_CHECK(engine_start(engine));
+
+    uint32_t const frames = 4800;
+    float* data = (float*)malloc(frames * sizeof(float));
+    VDEV_CHECK(data != NULL);
+    for (uint32_t i = 0; i < frames; ++i) data[i] = 0.25f;
+    Sound* constant = load_signal(engine, data, frames, 1);
+    VDEV_CHECK(constant != NULL);
+    sound_play(constant);
+    vdev_advance_ms(20);
+    VDEV_CHECK(NEAR(level.last, 0.25f, 1e-4f));
+
+    /* EQ: a +6 dB low shelf passes DC at A^2. The gain glides in. */
+    Effect* eq = make_effect(engine, EFFECT_EQ);
+    VDEV_CHECK(eq != NULL);
+    VDEV_CHECK(!effect_set_param(eq, EFFECT_PARAM_THRESHOLD, -10.0f));
+    VDEV_CHECK(sound_insert_effect(constant, (ma_node*)eq, -1));
+    VDEV_CHECK(!sound_insert_effect(constant, (ma_node*)eq, -1));
+    vdev_advance_ms(20);
+    VDEV_CHECK(NEAR(level.last, 0.25f, 1e-3f));
+    VDEV_CHECK(effect_set_param(eq, EFFECT_PARAM_EQ(0, EFFECT_EQ_GAIN), 6.0f));
+    vdev_advance_ms(20);
+    float const gliding = level.last;
+    vdev_advance_ms(300);
+    float const lifted = 0.25f * powf(10.0f, 6.0f / 20.0f);
+    printf("shelf: %.4f after 20 ms, %.4f settled (%.4f)\n", gliding, level.last, lifted);
+    VDEV_CHECK(gliding > 0.26f && gliding < lifted - 0.01f);
+    VDEV_CHECK(NEAR(level.last, lifted, 2e-3f));
+
+    /* Voices share the chain. */
+    sound_stop(constant);
+    VDEV_CHECK(sound_set_polyphony(constant, 2, 0));
+    VDEV_CHECK(sound_play_voice(constant, 1.0f, 0, true) != 0);
+    vdev_advance_ms(50);
+    printf("voice through shelf: %.4f\n", level.last);
+    VDEV_CHECK(NEAR(level.last, lifted, 2e-3f));
+    VDEV_CHECK(sound_remove_effect(constant, (ma_node*)eq));
+    vdev_advance_ms(20);
+    VDEV_CHECK(NEAR(level.last, 0.25f, 1e-4f));
+    sound_set_polyphony(constant, 0, 0);
+    sound_play(constant);
+
+    /* Compressor: -12 dBFS in, 12 dB over a -18 dB threshold at 4:1 with a
+       hard knee is 9 dB of reduction, plus 3 dB of makeup. */
+    for (uint32_t i = 0; i < frames; ++i) data[i] = 0.5f;
+    Sound* loud = load_signal(engine, data, frames, 1);
+    VDEV_CHECK(loud != NULL);
+    sound_stop(constant);
+    sound_play(loud);
+    Effect* comp = make_effect(engine, EFFECT_COMPRESSOR);
+    VDEV_CHECK(comp != NULL);
+    effect_set_param(comp, EFFECT_PARAM_KNEE, 0.0f);
+    effect_set_param(comp, EFFECT_PARAM_MAKEUP, 3.0f);
+    VDEV_CHECK(sound_insert_effect(loud, (ma_node*)comp, 0));
+    vdev_advance_ms(400);
+    float const level_db = 20.0f * log10f(0.5f);
+    float const compressed = powf(10.0f, (level_db - 0.75f * (level_db + 18.0f) + 3.0f) / 20.0f);
+    printf("compressor: %.4f (%.4f), reduction %.2f dB\n", level.last, compressed,
+           effect_get_reduction_db(comp));
+    VDEV_CHECK(NEAR(level.last, compressed, 2e-3f));
+    VDEV_CHECK(NEAR(effect_get_reduction_db(comp), 0.75f * (level_db + 18.0f) * -1.0f, 0.05f));
+
+    /* Limiter after the compressor, then more makeup pushing into it:
+       nothing gets over the ceiling. */
+    Effect* limiter = make_effect(engine, EFFECT_LIMITER);
+    VDEV_CHECK(limiter != NULL);
+    effect_set_param(limiter, EFFECT_PARAM_CEILING, -20.0f);
+    VDEV_CHECK(sound_insert_effect(loud, (ma_node*)limiter, -1));
+    vdev_advance_ms(20);
+    level.peak = 0.0f;
+    effect_set_param(comp, EFFECT_PARAM_MAKEUP, 12.0f);
+    vdev_advance_ms(300);
+    float const ceiling = powf(10.0f, -20.0f / 20.0f);
+    printf("limiter: peak %.4f, ceiling %.4f, reduction %.2f dB\n", level.peak, ceiling,
+           effect_get_reduction_db(limiter));
+    VDEV_CHECK(level.peak <= ceiling + 1e-4f);
+    VDEV_CHECK(NEAR(level.last, ceiling, 1e-3f));
+    VDEV_CHECK(effect_get_reduction_db(limiter) < -1.0f);
+
+    /* Fully dry, the chain passes the sound as it is. */
+    effect_set_param(comp, EFFECT_PARAM_MIX, 0.0f);
+    effect_set_param(limiter, EFFECT_PARAM_MIX, 0.0f);
+    vdev_advance_ms(200);
+    VDEV_CHECK(NEAR(level.last, 0.5f, 1e-3f));
+    sound_stop(loud);
+    sound_clear_effects(loud);
+
+    /* Reverb on a bus, fed by a stream player: a 10 ms burst rings on and
+       decays. */
+    MixBus* bus = mix_bus_alloc();
+    VDEV_CHECK(mix_bus_init(bus, engine, "room"));
+    Effect* reverb = make_effect(engine, EFFECT_REVERB);
+    VDEV_CHECK(reverb != NULL);
+    effect_set_param(reverb, EFFECT_PARAM_MIX, 1.0f);
+    effect_set_param(reverb, EFFECT_PARAM_DECAY, 0.5f);
+    VDEV_CHECK(mix_bus_insert_effect(bus, (ma_node*)reverb, -1));
+    StreamPlayer* player = stream_player_alloc();
+    StreamPlayerConfig config = stream_player_config_default(1, 48000);
+    VDEV_CHECK(stream_player_init_with_engine(player, engine, &config) == 1);
+    VDEV_CHECK(stream_player_set_bus(player, bus));
+    VDEV_CHECK(stream_player_start(player) == 1);
+    vdev_advance_ms(50);
+    for (uint32_t i = 0; i < 480; ++i) data[i] = (i & 1) ? 0.5f : -0.5f;
+    stream_player_write_frames_f32(player, data, 480);
+    vdev_advance_ms(100);
+    level.peak = 0.0f;
+    vdev_advance_ms(100);
+    float const tail = level.peak;
+    vdev_advance_ms(2000);
+    level.peak = 0.0f;
+    vdev_advance_ms(100);
+    printf("reverb tail: %.5f, 2 s later %.7f\n", tail, level.peak);
+    VDEV_CHECK(tail > 1e-3f);
+    VDEV_CHECK(level.peak < tail * 1e-3f);
+
+    /* Another engine's effect cannot join this engine's chains. */
+    Engine* other = engine_alloc();
+    VDEV_CHECK(engine_init_offline(other, 2, 48000));
+    Effect* foreign = make_effect(other, EFFECT_EQ);
+    VDEV_CHECK(foreign != NULL);
+    VDEV_CHECK(!stream_player_insert_effect(player, (ma_node*)foreign, -1));
+    VDEV_CHECK(!mix_bus_insert_effect(bus, (ma_node*)foreign, -1));
+    effect_free(foreign);
+    engine_uninit(other);
+    engine_free(other);
+
+    /* Player and bus chains let go of their effects on the way out. */
+    VDEV_CHECK(stream_player_insert_effect(player, (ma_node*)eq, -1));
+    stream_player_stop(player);
+    stream_player_uninit(player);
+    stream_player_free(player);
+    mix_bus_free(bus);
+    effect_free(eq);
+    effect_free(comp);
+    effect_free(limiter);
+    effect_free(reverb);
+    sound_unload(constant);
+    sound_unload(loud);
+    free(constant);
+    free(loud);
+    engine_uninit(engine);
+    engine_free(engine);
+    free(data);
+    VDEV_CHECK(vdev_device_count() == 0);
+    vdev_uninstall();
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/engine.h"
+#include "../include/sound.h"
+#include "virtual_device.h"
+
+/* Engine on a virtual device: scheduled sounds land on their frame of the
+   device clock, the mix of many voices keeps up with jittery periods, and
+   the engine's own load meter agrees with the harness and spots a stall.
+   Offline, an engine with nothing playing still renders every frame asked
+   for, as silence, and its clock runs on to the sounds scheduled later.
+   In duplex mode the monitored input is heard but kept out of the far-end
+   reference. Shared assets keyed by content tell the same bytes apart by
+   their layout. */
+
+#define VOICES 32
+
+typedef struct Onset {
+    int64_t first; /* clock time of the first non-zero output, -1 = none */
+    int     stall; /* sleep this many ms after the next callback */
+} Onset;
+
+static void on_output(void* user, const float* frames, uint32_t frameCount,
+                      uint32_t channels, uint64_t time) {
+    Onset* onset = (Onset*)user;
+    for (uint32_t i = 0; i < frameCount && onset->first < 0; ++i) {
+        if (frames[i * channels] != 0.0f) onset->first = (int64_t)(time + i);
+    }
+    if (onset->stall > 0) {
+        struct timespec ts = { 0, onset->stall * 1000000L };
+        onset->stall = 0;
+        nanosleep(&ts, NULL);
+    }
+}
+
+static int render_empty(void) {
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init_offline(engine, 2, 48000));
+
+    char path[256];
+    snprintf(path, sizeof(path), "miniaudio_dart_empty_%ld.wav", (long)time(NULL));
+    VDEV_CHECK(engine_render_to_file(engine, path, 48000));
+    VDEV_CHECK(engine_get_time_in_pcm_frames(engine) == 48000);
+    ma_decoder decoder;
+    ma_uint64 length = 0;
+    VDEV_CHECK(ma_decoder_init_file(path, NULL, &decoder) == MA_SUCCESS);
+    ma_decoder_get_length_in_pcm_frames(&decoder, &length);
+    ma_decoder_uninit(&decoder);
+    remove(path);
+    printf("empty offline engine: %llu frames written\n", (unsigned long long)length);
+    VDEV_CHECK(length == 48000);
+
+    /* A sound scheduled past the silence starts on its frame. */
+    float data[480];
+    for (int i = 0; i < 480; ++i) data[i] = 0.5f;
+    Sound* sound = sound_alloc();
+    VDEV_CHECK(engine_load_sound(engine, sound, data, sizeof(data), ma_format_f32, 48000, 1));
+    VDEV_CHECK(sound_play_at(sound, 48000 + 1000));
+    float out[1200 * 2];
+    VDEV_CHECK(engine_render(engine, out, 1200) == 1200);
+    VDEV_CHECK(out[999 * 2] == 0.0f && out[1000 * 2] != 0.0f);
+
+    sound_unload(sound);
+    free(sound);
+    engine_uninit(engine);
+    engine_free(engine);
+    return 0;
+}
+
+static void on_input(void* user, float* frames, uint32_t frameCount,
+                     uint32_t channels, uint64_t time) {
+    (void)user; (void)time;
+    for (uint32_t i = 0; i < frameCount * channels; ++i) frames[i] = 0.25f;
+}
+
+/* Runs on the installed virtual device, with nothing playing. */
+static int duplex_monitor(void) {
+    Onset onset = { -1, 0 };
+    vdev_set_input(on_input, NULL);
+    vdev_set_output(on_output, &onset);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_set_duplex(engine, 1, 0));
+    VDEV_CHECK(engine_init(engine, 10));
+    engine_set_monitor_gain(engine, 1.0f);
+    VDEV_CHECK(engine_start(engine));
+    vdev_advance_ms(100);
+    VDEV_CHECK(onset.first >= 0);
+
+    /* All of it, the first periods the device captured included. */
+    float capture[480], reference[480 * 2];
+    float peak = 0.0f;
+    VDEV_CHECK(engine_duplex_available(engine) >= 480);
+    while (engine_duplex_available(engine) >= 480) {
+        VDEV_CHECK(engine_duplex_read(engine, capture, reference, 480) == 480);
+        for (int i = 0; i < 480 * 2; ++i) peak = fmaxf(peak, fabsf(reference[i]));
+    }
+    printf("duplex: capture %.2f, reference peak %.2f\n", capture[479], peak);
+    VDEV_CHECK(capture[479] == 0.25f && peak == 0.0f);
+
+    engine_uninit(engine);
+    engine_free(engine);
+    vdev_set_input(NULL, NULL);
+    vdev_set_output(NULL, NULL);
+    return 0;
+}
+
+static int shared_layouts(void) {
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init_offline(engine, 2, 48000));
+
+    /* One buffer: 480 stereo frames at 48 kHz, or 960 mono frames at
+       24 kHz. The third load is the first layout again. */
+    float data[960];
+    for (int i = 0; i < 960; ++i) data[i] = 0.25f;
+    Sound* sounds[3];
+    for (int i = 0; i < 3; ++i) sounds[i] = sound_alloc();
+    VDEV_CHECK(engine_load_sound_shared(engine, sounds[0], NULL, data, sizeof(data),
+                                        ma_format_f32, 48000, 2, 0));
+    VDEV_CHECK(engine_load_sound_shared(engine, sounds[1], NULL, data, sizeof(data),
+                                        ma_format_f32, 24000, 1, 0));
+    VDEV_CHECK(engine_load_sound_shared(engine, sounds[2], NULL, data, sizeof(data),
+                                        ma_format_f32, 48000, 2, 0));
+    uint32_t count = 0;
+    uint64_t bytes = 0;
+    VDEV_CHECK(engine_get_asset_stats(engine, &count, &bytes));
+    printf("shared: %u assets\n", count);
+    VDEV_CHECK(count == 2 && bytes == 2 * sizeof(data));
+    /* Raw PCM durations count frames at the engine rate. */
+    VDEV_CHECK(fabsf(sound_get_duration(sounds[0]) - 0.01f) < 1e-4f);
+    VDEV_CHECK(fabsf(sound_get_duration(sounds[1]) - 0.02f) < 1e-4f);
+    VDEV_CHECK(fabsf(sound_get_duration(sounds[2]) - 0.01f) < 1e-4f);
+
+    for (int i = 0; i < 3; ++i) {
+        sound_unload(sounds[i]);
+        free(sounds[i]);
+    }
+    engine_uninit(engine);
+    engine_free(engine);
+    return 0;
+}
+
+int main(void) {
+    if (render_empty()) return 1;
+    if (shared_layouts()) return 1;
+
+    VDEV_CHECK(vdev_install(48000));
+    Onset onset = { -1, 0 };
+    vdev_set_output(on_output, &onset);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init(engine, 10));
+    VDEV_CHECK(vdev_device_count() == 1);
+    VDEV_CHECK(engine_start(engine));
+
+    uint32_t const frames = 48000;
+    float* data = (float*)malloc(frames * sizeof(float));
+    VDEV_CHECK(data != NULL);
+    for (uint32_t i = 0; i < frames; ++i) data[i] = 0.01f;
+
+    Sound* sounds[VOICES];
+    for (int i = 0; i < VOICES; ++i) {
+        sounds[i] = sound_alloc();
+        VDEV_CHECK(engine_load_sound(engine, sounds[i], data, frames * sizeof(float),
+                                     ma_format_f32, 48000, 1));
+    }
+
+    /* Sample-accurate start, off any period boundary. */
+    vdev_advance_ms(100);
+    uint64_t const at = engine_get_time_in_pcm_frames(engine) + 1234;
+    VDEV_CHECK(sound_play_at(sounds[0], at));
+    vdev_advance_ms(100);
+    printf("scheduled at %llu, first output at %lld\n",
+           (unsigned long long)at, (long long)onset.first);
+    VDEV_CHECK(onset.first == (int64_t)at);
+
+    /* Every voice, with callbacks up to 64 frames early or late. */
+    for (int i = 1; i < VOICES; ++i) sound_play(sounds[i]);
+    vdev_set_period_jitter(64, 1234);
+    vdev_reset_stats();
+    engine_reset_load_stats(engine);
+    vdev_advance_ms(1000);
+    vdev_print_stats("engine playback", ma_device_type_playback);
+
+    VdevStats stats;
+    vdev_get_stats(ma_device_type_playback, &stats);
+    VDEV_CHECK(stats.frames >= 48000);
+    VDEV_CHECK(stats.load < 1.0);
+
+    EngineLoadStats load;
+    VDEV_CHECK(engine_get_load_stats(engine, &load));
+    printf("engine load %.4f, peak %.4f, max callback %.1f us, %llu xruns\n",
+           load.load, load.peakLoad, load.maxCallbackUs, (unsigned long long)load.xruns);
+    /* The engine sees fixed 480-frame callbacks, which miniaudio buffers
+       to and from the jittery device periods. */
+    VDEV_CHECK(load.frames == load.callbacks * 480);
+    VDEV_CHECK(llabs((long long)load.frames - (long long)stats.frames) <= 480);
+    VDEV_CHECK(load.backend == ma_backend_custom);
+    VDEV_CHECK(load.peakLoad < 1.0f && load.xruns == 0);
+
+    /* The audio thread held up for longer than the device buffer. */
+    onset.stall = 100;
+    vdev_advance_ms(100);
+    VDEV_CHECK(engine_get_load_stats(engine, &load));
+    VDEV_CHECK(load.xruns == 1 && load.overruns == 0);
+    engine_reset_load_stats(engine);
+    VDEV_CHECK(engine_get_load_stats(engine, &load) && load.callbacks == 0);
+
+    for (int i = 0; i < VOICES; ++i) {
+        sound_unload(sounds[i]);
+        free(sounds[i]);
+    }
+    engine_uninit(engine);
+    engine_free(engine);
+    free(data);
+    VDEV_CHECK(vdev_device_count() == 0);
+    VDEV_CHECK(duplex_monitor() == 0);
+    VDEV_CHECK(vdev_device_count() == 0);
+    vdev_uninstall();
+    return 0;
+}
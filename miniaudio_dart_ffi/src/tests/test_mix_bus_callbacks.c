@@ -0,0 +1,130 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/engine.h"
+#include "../include/mix_bus.h"
+#include "../include/sound.h"
+#include "../include/stream_player.h"
+#include "virtual_device.h"
+
+/* Mix buses on a virtual device: constant signals routed through buses
+   come out scaled by each bus on the way, mute fades to silence, nesting
+   multiplies, a bus cannot feed itself, and a voice the scheduler has
+   virtualized lands on its new bus when it comes back. */
+
+#define NEAR(a, b) (fabsf((a) - (b)) < 1e-4f)
+
+static void on_output(void* user, const float* frames, uint32_t frameCount,
+                      uint32_t channels, uint64_t time) {
+    (void)time;
+    *(float*)user = frames[(frameCount - 1) * channels];
+}
+
+static Sound* load_constant(Engine* engine, float* data, uint32_t frames, float value) {
+    for (uint32_t i = 0; i < frames; ++i) data[i] = value;
+    Sound* sound = sound_alloc();
+    if (!engine_load_sound(engine, sound, data, frames * sizeof(float), ma_format_f32, 48000, 1)) {
+        free(sound);
+        return NULL;
+    }
+    sound_set_looped(sound, true, 0);
+    return sound;
+}
+
+int main(void) {
+    VDEV_CHECK(vdev_install(48000));
+    float level = 0.0f;
+    vdev_set_output(on_output, &level);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init(engine, 10));
+    VDEV_CHECK(engine_start(engine));
+
+    uint32_t const frames = 4800;
+    float* data = (float*)malloc(frames * sizeof(float));
+    VDEV_CHECK(data != NULL);
+    Sound* music = load_constant(engine, data, frames, 0.25f);
+    Sound* sfx = load_constant(engine, data, frames, 0.1f);
+    VDEV_CHECK(music && sfx);
+
+    MixBus* musicBus = mix_bus_alloc();
+    MixBus* sfxBus = mix_bus_alloc();
+    VDEV_CHECK(mix_bus_init(musicBus, engine, "music"));
+    VDEV_CHECK(mix_bus_init(sfxBus, engine, "sfx"));
+
+    sound_play(music);
+    VDEV_CHECK(sound_set_bus(music, musicBus));
+    vdev_advance_ms(50);
+    VDEV_CHECK(NEAR(level, 0.25f));
+
+    mix_bus_set_volume(musicBus, 0.5f);
+    vdev_advance_ms(50);
+    printf("music bus at 0.5: %.4f\n", level);
+    VDEV_CHECK(NEAR(level, 0.125f));
+
+    mix_bus_set_muted(musicBus, true);
+    vdev_advance_ms(50);
+    VDEV_CHECK(level == 0.0f);
+    mix_bus_set_muted(musicBus, false);
+    vdev_advance_ms(50);
+    VDEV_CHECK(NEAR(level, 0.125f));
+
+    /* sfx -> music -> engine: (0.25 + 0.1 * 0.8) * 0.5 */
+    sound_play(sfx);
+    VDEV_CHECK(sound_set_bus(sfx, sfxBus));
+    mix_bus_set_volume(sfxBus, 0.8f);
+    VDEV_CHECK(mix_bus_set_parent(sfxBus, musicBus));
+    VDEV_CHECK(!mix_bus_set_parent(musicBus, sfxBus));
+    VDEV_CHECK(!mix_bus_set_parent(musicBus, musicBus));
+    vdev_advance_ms(50);
+    printf("nested buses: %.4f\n", level);
+    VDEV_CHECK(NEAR(level, 0.165f));
+
+    /* A stream player joins the music bus. */
+    StreamPlayer* player = stream_player_alloc();
+    StreamPlayerConfig config = stream_player_config_default(1, 48000);
+    VDEV_CHECK(stream_player_init_with_engine(player, engine, &config) == 1);
+    VDEV_CHECK(stream_player_set_bus(player, musicBus));
+    VDEV_CHECK(stream_player_start(player) == 1);
+    for (uint32_t i = 0; i < frames; ++i) data[i] = 0.2f;
+    stream_player_write_frames_f32(player, data, frames);
+    vdev_advance_ms(40);
+    VDEV_CHECK(NEAR(level, 0.265f));
+    stream_player_stop(player);
+    stream_player_uninit(player);
+    stream_player_free(player);
+
+    /* With one voice allowed the quieter sound is virtual; moving it to
+       the engine must hold until it is mixed again. */
+    mix_bus_set_parent(sfxBus, NULL);
+    mix_bus_set_volume(musicBus, 1.0f);
+    sound_set_priority(sfx, 0.5f);
+    engine_set_max_voices(engine, 1);
+    vdev_advance_ms(50);
+    uint32_t mixed = 0, virtualized = 0;
+    VDEV_CHECK(engine_get_voice_stats(engine, &mixed, &virtualized));
+    VDEV_CHECK(mixed == 1 && virtualized == 1);
+    VDEV_CHECK(NEAR(level, 0.25f));
+    VDEV_CHECK(sound_set_bus(sfx, NULL));
+    vdev_advance_ms(50);
+    VDEV_CHECK(NEAR(level, 0.25f));
+    sound_stop(music);
+    vdev_advance_ms(50);
+    printf("restored voice: %.4f\n", level);
+    VDEV_CHECK(NEAR(level, 0.1f));
+
+    /* Out of the buses before they go. */
+    sound_set_bus(music, NULL);
+    mix_bus_free(musicBus);
+    mix_bus_free(sfxBus);
+    sound_unload(music);
+    sound_unload(sfx);
+    free(music);
+    free(sfx);
+    engine_uninit(engine);
+    engine_free(engine);
+    free(data);
+    VDEV_CHECK(vdev_device_count() == 0);
+    vdev_uninstall();
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/engine.h"
+#include "../include/playlist.h"
+#include "virtual_device.h"
+
+/* Playlist of files on an offline engine. Each item is decoded ahead on a
+   job thread, never in the render, so the render only ever holds what has
+   been decoded so far: every frame of every item still comes out, once,
+   in order, with nothing in between but silence. */
+
+#define FRAMES 48000
+#define BLOCK  480
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static int write_wav(const char* path, float value) {
+    ma_encoder_config const cfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 1, 48000);
+    ma_encoder encoder;
+    if (ma_encoder_init_file(path, &cfg, &encoder) != MA_SUCCESS) return 0;
+    float* data = (float*)malloc(FRAMES * sizeof(float));
+    int ok = data != NULL;
+    for (uint32_t i = 0; ok && i < FRAMES; ++i) data[i] = value;
+    ok = ok && ma_encoder_write_pcm_frames(&encoder, data, FRAMES, NULL) == MA_SUCCESS;
+    ma_encoder_uninit(&encoder);
+    free(data);
+    return ok;
+}
+
+static int run(const char* first, const char* second) {
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init_offline(engine, 2, 48000));
+    Playlist* playlist = playlist_alloc();
+    VDEV_CHECK(playlist_init(playlist, engine, 0));
+    VDEV_CHECK(playlist_enqueue_file(playlist, first) != 0);
+    VDEV_CHECK(playlist_enqueue_file(playlist, second) != 0);
+    VDEV_CHECK(playlist_start(playlist));
+
+    /* Faster than real time, with a pause now and then for the jobs. */
+    uint64_t quarter = 0, half = 0;
+    float out[BLOCK * 2];
+    for (int i = 0; i < 2000 && playlist_get_queued(playlist) > 0; ++i) {
+        engine_render(engine, out, BLOCK);
+        for (int f = 0; f < BLOCK; ++f) {
+            float const v = out[f * 2];
+            if (v == 0.25f) {
+                VDEV_CHECK(half == 0);  /* the first item is over */
+                quarter++;
+            } else if (v == 0.5f) {
+                half++;
+            } else {
+                VDEV_CHECK(v == 0.0f);
+            }
+        }
+        if (i % 10 == 0) sleep_ms(1);
+    }
+    printf("playlist: %llu + %llu frames\n", (unsigned long long)quarter, (unsigned long long)half);
+    VDEV_CHECK(playlist_get_queued(playlist) == 0);
+    VDEV_CHECK(quarter == FRAMES && half == FRAMES);
+
+    playlist_free(playlist);
+    engine_uninit(engine);
+    engine_free(engine);
+    return 0;
+}
+
+int main(void) {
+    char first[256], second[256];
+    long const now = (long)time(NULL);
+    snprintf(first, sizeof(first), "miniaudio_dart_playlist_a_%ld.wav", now);
+    snprintf(second, sizeof(second), "miniaudio_dart_playlist_b_%ld.wav", now);
+    VDEV_CHECK(write_wav(first, 0.25f));
+    VDEV_CHECK(write_wav(second, 0.5f));
+    int const failed = run(first, second);
+    remove(first);
+    remove(second);
+    return failed;
+}
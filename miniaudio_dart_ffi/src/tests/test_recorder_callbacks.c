@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/engine.h"
+#include "../include/record.h"
+#include "../include/sound.h"
+#include "virtual_device.h"
+
+/* End to end through virtual devices: an engine plays a click, loopback
+   carries it back to the capture side after a fixed acoustic delay, and the
+   recorder must deliver it exactly that delay plus one capture period after
+   it was played (miniaudio's fixed-size capture callbacks start with a
+   period of silence queued), with nothing lost on the way. Then the echo
+   canceller has to learn that path and take played noise back out. */
+
+#define LOOP_DELAY 240
+
+int main(void) {
+    VDEV_CHECK(vdev_install(48000));
+    vdev_set_loopback(LOOP_DELAY);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init(engine, 10));
+    VDEV_CHECK(engine_start(engine));
+
+    float click[64] = { 0.0f };
+    click[0] = 0.5f;
+    Sound* sound = sound_alloc();
+    VDEV_CHECK(engine_load_sound(engine, sound, click, sizeof(click), ma_format_f32, 48000, 1));
+
+    Recorder* recorder = recorder_create();
+    RecorderConfig config = recorder_config_default(48000, 1, ma_format_f32);
+    config.bufferDurationSeconds = 2;
+    VDEV_CHECK(recorder_init(recorder, &config) == 1);
+    VDEV_CHECK(vdev_device_count() == 2);
+    VDEV_CHECK(recorder_start(recorder) == 1);
+    uint64_t const recordStart = vdev_now();
+
+    vdev_advance_ms(50);
+    uint64_t const at = engine_get_time_in_pcm_frames(engine) + 777;
+    VDEV_CHECK(sound_play_at(sound, at));
+    vdev_reset_stats();
+    vdev_advance_ms(500);
+
+    /* Everything captured is there, and the click is where it belongs. */
+    int const available = recorder_get_available_frames(recorder);
+    VDEV_CHECK(available > 0);
+    VdevStats capture;
+    vdev_get_stats(ma_device_type_capture, &capture);
+    printf("captured %llu frames, %d available\n", (unsigned long long)capture.frames, available);
+    int64_t const period = (int64_t)(capture.frames / capture.callbacks);
+    VDEV_CHECK(available == (int64_t)(vdev_now() - recordStart) + period);
+
+    int64_t found = -1;
+    int64_t index = 0;
+    while (found < 0) {
+        void* region = NULL;
+        int n = 0;
+        if (!recorder_acquire_read_region(recorder, &region, &n) || n <= 0) break;
+        const float* samples = (const float*)region;
+        for (int i = 0; i < n && found < 0; ++i) {
+            if (samples[i] > 0.25f) found = index + i;
+        }
+        index += n;
+        recorder_commit_read_frames(recorder, n);
+    }
+    VDEV_CHECK(found >= 0);
+    int64_t const latency = (int64_t)(recordStart + (uint64_t)found) - (int64_t)at;
+    printf("click played at %llu, recorded at %lld: %lld frames (%.2f ms) end to end\n",
+           (unsigned long long)at, (long long)(recordStart + found),
+           (long long)latency, latency * 1000.0 / 48000);
+    VDEV_CHECK(latency == LOOP_DELAY + period);
+
+    vdev_print_stats("recorder capture", ma_device_type_capture);
+    VDEV_CHECK(capture.load < 1.0);
+
+    /* The echo canceller, referenced to the engine, takes noise played
+       into the loop back out of the capture. */
+    float* noise = (float*)malloc(48000 * sizeof(float));
+    VDEV_CHECK(noise != NULL);
+    uint32_t seed = 1;
+    for (int i = 0; i < 48000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        noise[i] = 0.2f * ((float)(seed >> 8) / 16777216.0f - 0.5f);
+    }
+    Sound* hiss = sound_alloc();
+    VDEV_CHECK(engine_load_sound(engine, hiss, noise, 48000 * sizeof(float), ma_format_f32, 48000, 1));
+    sound_set_looped(hiss, true, 0);
+    VDEV_CHECK(recorder_enable_echo_cancellation(recorder, engine, 0));
+    VDEV_CHECK(sound_play(hiss));
+    vdev_advance_ms(4000);
+    float const erle = recorder_get_echo_return_loss_enhancement(recorder);
+    printf("echo return loss enhancement after 4 s: %.1f dB\n", erle);
+    VDEV_CHECK(erle > 20.0f);
+
+    /* A second recorder on the same engine cannot take the reference
+       away, and its disable leaves the first one's alone. Without the
+       reference the first one's ERLE would collapse. */
+    Recorder* second = recorder_create();
+    VDEV_CHECK(recorder_init(second, &config) == 1);
+    VDEV_CHECK(recorder_start(second) == 1);
+    VDEV_CHECK(!recorder_enable_echo_cancellation(second, engine, 0));
+    recorder_disable_echo_cancellation(second);
+    vdev_advance_ms(500);
+    float const kept = recorder_get_echo_return_loss_enhancement(recorder);
+    printf("first recorder, second refused: %.1f dB\n", kept);
+    VDEV_CHECK(kept > 20.0f);
+
+    /* Once the first lets go the second gets it, and a repeated disable on
+       the first does not detach it. */
+    recorder_disable_echo_cancellation(recorder);
+    VDEV_CHECK(recorder_enable_echo_cancellation(second, engine, 0));
+    recorder_disable_echo_cancellation(recorder);
+    vdev_advance_ms(4000);
+    float const taken = recorder_get_echo_return_loss_enhancement(second);
+    printf("second recorder after 4 s: %.1f dB\n", taken);
+    VDEV_CHECK(taken > 20.0f);
+    recorder_stop(second);
+    recorder_destroy(second);
+    sound_stop(hiss);
+
+    recorder_stop(recorder);
+    recorder_destroy(recorder);
+    sound_unload(sound);
+    free(sound);
+    sound_unload(hiss);
+    free(hiss);
+    free(noise);
+    engine_uninit(engine);
+    engine_free(engine);
+    VDEV_CHECK(vdev_device_count() == 0);
+    vdev_uninstall();
+    return 0;
+}
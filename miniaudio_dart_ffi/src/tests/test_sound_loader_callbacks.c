@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../include/engine.h"
+#include "../include/sound.h"
+#include "virtual_device.h"
+
+/* Background loads of a file on disk: as many concurrent streamed loads
+   as there are job threads, or more, all complete and play, next to mapped
+   and decoded ones. A streamed load opens its stream on the engine's job
+   threads, so it must not be holding one of them while it waits. */
+
+#define LOADS 4
+#define FRAMES 48000
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static int write_wav(const char* path, float value) {
+    ma_encoder_config const cfg = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 1, 48000);
+    ma_encoder encoder;
+    if (ma_encoder_init_file(path, &cfg, &encoder) != MA_SUCCESS) return 0;
+    float* data = (float*)malloc(FRAMES * sizeof(float));
+    int ok = data != NULL;
+    for (uint32_t i = 0; ok && i < FRAMES; ++i) data[i] = value;
+    ok = ok && ma_encoder_write_pcm_frames(&encoder, data, FRAMES, NULL) == MA_SUCCESS;
+    ma_encoder_uninit(&encoder);
+    free(data);
+    return ok;
+}
+
+/* 1 once nothing is pending, 0 after 5 s. */
+static int wait_loads(Engine* engine) {
+    for (int i = 0; i < 500; ++i) {
+        if (engine_get_pending_loads(engine) == 0) return 1;
+        sleep_ms(10);
+    }
+    return 0;
+}
+
+static int run(const char* path, uint32_t threads) {
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_set_job_threads(engine, threads));
+    VDEV_CHECK(engine_init_offline(engine, 2, 48000));
+
+    static const uint32_t k_flags[LOADS] = {
+        SOUND_LOAD_STREAM, SOUND_LOAD_STREAM, SOUND_LOAD_MMAP, SOUND_LOAD_DECODE
+    };
+    Sound* sounds[LOADS];
+    for (int i = 0; i < LOADS; ++i) {
+        sounds[i] = sound_alloc();
+        VDEV_CHECK(engine_load_sound_file_async(engine, sounds[i], path, k_flags[i]));
+    }
+    VDEV_CHECK(wait_loads(engine));
+    printf("%u job thread(s): %d loads done\n", threads, LOADS);
+
+    float out[480 * 2];
+    for (int i = 0; i < LOADS; ++i) {
+        VDEV_CHECK(sound_get_load_state(sounds[i]) == SOUND_LOAD_STATE_READY);
+        VDEV_CHECK(sound_get_duration(sounds[i]) > 0.99f && sound_get_duration(sounds[i]) < 1.01f);
+        VDEV_CHECK(sound_play(sounds[i]));
+        engine_render(engine, out, 480);
+        sound_stop(sounds[i]);
+        VDEV_CHECK(out[479 * 2] > 0.249f && out[479 * 2] < 0.251f);
+    }
+
+    for (int i = 0; i < LOADS; ++i) {
+        sound_unload(sounds[i]);
+        free(sounds[i]);
+    }
+    engine_uninit(engine);
+    engine_free(engine);
+    return 0;
+}
+
+int main(void) {
+    char path[256];
+    snprintf(path, sizeof(path), "miniaudio_dart_loader_%ld.wav", (long)time(NULL));
+    VDEV_CHECK(write_wav(path, 0.25f));
+    int const failed = run(path, 1) || run(path, 2);
+    remove(path);
+    return failed;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/engine.h"
+#include "../include/stream_player.h"
+#include "virtual_device.h"
+
+/* StreamPlayer on a virtual device: a write reaches the output within a
+   period, and starving the player is counted as exactly one underrun with
+   the silence it caused. */
+
+typedef struct Onset {
+    int64_t first; /* clock time of the first non-zero output, -1 = none */
+} Onset;
+
+static void on_output(void* user, const float* frames, uint32_t frameCount,
+                      uint32_t channels, uint64_t time) {
+    Onset* onset = (Onset*)user;
+    for (uint32_t i = 0; i < frameCount && onset->first < 0; ++i) {
+        if (frames[i * channels] != 0.0f) onset->first = (int64_t)(time + i);
+    }
+}
+
+int main(void) {
+    VDEV_CHECK(vdev_install(48000));
+    Onset onset = { -1 };
+    vdev_set_output(on_output, &onset);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init(engine, 10));
+    VDEV_CHECK(engine_start(engine));
+
+    StreamPlayer* player = stream_player_alloc();
+    StreamPlayerConfig config = stream_player_config_default(1, 48000);
+    VDEV_CHECK(stream_player_init_with_engine(player, engine, &config) == 1);
+    VDEV_CHECK(stream_player_start(player) == 1);
+    vdev_advance_ms(50);
+
+    /* 100 ms of audio written at once, then nothing. */
+    uint32_t const frames = 4800;
+    float* data = (float*)malloc(frames * sizeof(float));
+    VDEV_CHECK(data != NULL);
+    for (uint32_t i = 0; i < frames; ++i) data[i] = 0.1f;
+    stream_player_reset_stats(player);
+    uint64_t const written = vdev_now();
+    VDEV_CHECK(stream_player_write_frames_f32(player, data, frames) == frames);
+    vdev_reset_stats();
+    vdev_advance_ms(300);
+
+    VDEV_CHECK(onset.first >= 0);
+    int64_t const latency = onset.first - (int64_t)written;
+    printf("written at %llu, first output at %lld: %lld frames (%.2f ms)\n",
+           (unsigned long long)written, (long long)onset.first,
+           (long long)latency, latency * 1000.0 / 48000);
+    VDEV_CHECK(latency <= 2 * 480);
+
+    StreamPlayerStats stats;
+    VDEV_CHECK(stream_player_get_stats(player, &stats));
+    printf("underruns %llu, silence %llu frames, dropped %llu frames\n",
+           (unsigned long long)stats.underrunEvents, (unsigned long long)stats.silenceFrames,
+           (unsigned long long)stats.droppedFrames);
+    VDEV_CHECK(stats.underrunEvents == 1);
+    VDEV_CHECK(stats.droppedFrames == 0);
+    VDEV_CHECK(stats.silenceFrames > 0 && stats.silenceFrames <= 14400 - frames);
+
+    vdev_print_stats("stream player playback", ma_device_type_playback);
+
+    stream_player_stop(player);
+    stream_player_uninit(player);
+    stream_player_free(player);
+    engine_uninit(engine);
+    engine_free(engine);
+    free(data);
+    vdev_uninstall();
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/engine.h"
+#include "../include/sound.h"
+#include "virtual_device.h"
+
+/* Voice limit with decoder-backed sounds on an offline engine: a voice
+   coming back from virtual is not seeked on the audio thread. It stays out
+   of the mix for the pass that restores it, while a job thread seeks it,
+   and then resumes at the frame it would have reached. */
+
+#define FRAMES 48000
+#define BLOCK  480
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void put_u32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+/* Mono 16-bit WAV of a ramp from 0 to 0.5 over FRAMES, so the output level
+   tells the playback position. */
+static unsigned char* ramp_wav(size_t* outSize) {
+    size_t const bytes = FRAMES * 2;
+    unsigned char* wav = (unsigned char*)malloc(44 + bytes);
+    if (!wav) return NULL;
+    memcpy(wav, "RIFF\0\0\0\0WAVEfmt \x10\0\0\0\x01\0\x01\0\0\0\0\0\0\0\0\0\x02\0\x10\0data", 40);
+    put_u32(wav + 4, (uint32_t)(36 + bytes));
+    put_u32(wav + 24, 48000);
+    put_u32(wav + 28, 48000 * 2);
+    put_u32(wav + 40, (uint32_t)bytes);
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        int16_t const s = (int16_t)(16384.0 * i / FRAMES);
+        wav[44 + i * 2]     = (unsigned char)(s & 0xff);
+        wav[44 + i * 2 + 1] = (unsigned char)((s >> 8) & 0xff);
+    }
+    *outSize = 44 + bytes;
+    return wav;
+}
+
+int main(void) {
+    size_t size = 0;
+    unsigned char* wav = ramp_wav(&size);
+    VDEV_CHECK(wav != NULL);
+
+    Engine* engine = engine_alloc();
+    VDEV_CHECK(engine_init_offline(engine, 2, 48000));
+    Sound* loud = sound_alloc();
+    Sound* quiet = sound_alloc();
+    VDEV_CHECK(engine_load_sound(engine, loud, (float*)wav, size, ma_format_unknown, 0, 0));
+    VDEV_CHECK(engine_load_sound(engine, quiet, (float*)wav, size, ma_format_unknown, 0, 0));
+    sound_set_priority(quiet, 0.5f);
+    sound_set_looped(loud, true, 0);
+    sound_set_looped(quiet, true, 0);
+    engine_set_max_voices(engine, 1);
+    VDEV_CHECK(sound_play(loud));
+    VDEV_CHECK(sound_play(quiet));
+
+    float out[BLOCK * 2];
+    uint32_t mixed = 0, virtualized = 0;
+    for (int i = 0; i < 20; ++i) engine_render(engine, out, BLOCK);
+    VDEV_CHECK(engine_get_voice_stats(engine, &mixed, &virtualized));
+    VDEV_CHECK(mixed == 1 && virtualized == 1);
+
+    /* The quiet sound now outranks the loud one. Its seek is queued, so the
+       pass that restores it mixes nothing. */
+    sound_set_volume(loud, 0.0f);
+    engine_render(engine, out, BLOCK);
+    VDEV_CHECK(engine_get_voice_stats(engine, &mixed, &virtualized));
+    printf("restoring: %u mixed, %u virtual, out %.5f\n", mixed, virtualized, out[(BLOCK - 1) * 2]);
+    VDEV_CHECK(mixed == 0 && virtualized == 2);
+    VDEV_CHECK(out[(BLOCK - 1) * 2] == 0.0f);
+
+    /* The offline clock stands still until the next render, so once the job
+       has landed the sound picks up exactly where it would have been. */
+    for (int i = 0; i < 500 && virtualized == 2; ++i) {
+        sleep_ms(1);
+        engine_render(engine, out, BLOCK);
+        VDEV_CHECK(engine_get_voice_stats(engine, &mixed, &virtualized));
+    }
+    VDEV_CHECK(mixed == 1);
+    engine_render(engine, out, BLOCK);
+    uint64_t const played = engine_get_time_in_pcm_frames(engine) - 1;
+    float const expected = 0.5f * (float)(played % FRAMES) / FRAMES;
+    printf("resumed: %.5f, expected %.5f\n", out[(BLOCK - 1) * 2], expected);
+    VDEV_CHECK(out[(BLOCK - 1) * 2] > expected - 1e-3f && out[(BLOCK - 1) * 2] < expected + 1e-3f);
+
+    /* Unloading waits for any seek still in flight. */
+    sound_set_volume(loud, 1.0f);
+    engine_render(engine, out, BLOCK);
+    sound_unload(loud);
+    sound_unload(quiet);
+    free(loud);
+    free(quiet);
+    engine_uninit(engine);
+    engine_free(engine);
+    free(wav);
+    return 0;
+}
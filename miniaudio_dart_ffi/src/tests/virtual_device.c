@@ -0,0 +1,387 @@
+#include "virtual_device.h"
+#include "../include/audio_context.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*************
+ ** private **
+ *************/
+
+/* Loopback history, indexed by clock time. */
+#define VDEV_LOOP_FRAMES (1u << 18)
+
+typedef struct VdevDevice {
+    ma_device* device;
+    uint32_t   period;
+    uint64_t   next;      /* clock time of the next callback */
+    int        started;
+    float*     out;
+    float*     in;
+    uint32_t   capacity;  /* frames out and in can hold */
+} VdevDevice;
+
+typedef struct VdevTotals {
+    uint64_t callbacks;
+    uint64_t frames;
+    uint64_t deadlineMisses;
+    double   sumUs;
+    double   sumSqUs;
+    double   maxUs;
+} VdevTotals;
+
+/* Only the test thread touches any of this: devices are opened, started
+   and run from it, and nothing here has a thread of its own. */
+static VdevDevice   vd_devices[VDEV_MAX_DEVICES];
+static uint32_t     vd_rate = 48000;
+static uint64_t     vd_now = 0;
+static VdevInputFn  vd_inputFn = NULL;
+static void*        vd_inputUser = NULL;
+static VdevOutputFn vd_outputFn = NULL;
+static void*        vd_outputUser = NULL;
+static int32_t      vd_loopDelay = -1;
+static float*       vd_loop = NULL;
+static uint64_t     vd_loopEnd = 0;   /* loop history is valid below this */
+static uint32_t     vd_jitter = 0;
+static uint32_t     vd_seed = 1;
+static VdevTotals   vd_playback;
+static VdevTotals   vd_capture;
+
+static double vd_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static uint32_t vd_random(void) {
+    /* xorshift32: the same seed always gives the same periods */
+    vd_seed ^= vd_seed << 13;
+    vd_seed ^= vd_seed >> 17;
+    vd_seed ^= vd_seed << 5;
+    return vd_seed;
+}
+
+static VdevDevice* vd_find(ma_device* device) {
+    for (uint32_t i = 0; i < VDEV_MAX_DEVICES; ++i) {
+        if (vd_devices[i].device == device) return &vd_devices[i];
+    }
+    return NULL;
+}
+
+static int vd_plays(const VdevDevice* d) {
+    return d->device->type == ma_device_type_playback || d->device->type == ma_device_type_duplex;
+}
+
+static int vd_captures(const VdevDevice* d) {
+    return d->device->type == ma_device_type_capture || d->device->type == ma_device_type_duplex;
+}
+
+static void vd_add_totals(VdevTotals* t, uint32_t frames, double us) {
+    t->callbacks++;
+    t->frames += frames;
+    t->sumUs += us;
+    t->sumSqUs += us * us;
+    if (us > t->maxUs) t->maxUs = us;
+    if (us > frames * 1e6 / vd_rate) t->deadlineMisses++;
+}
+
+static void vd_loop_write(const float* frames, uint32_t count, uint32_t channels, uint64_t time) {
+    if (vd_loop == NULL) return;
+    /* Clear what this is the first to write to, then mix into it. */
+    while (vd_loopEnd < time + count) {
+        vd_loop[vd_loopEnd & (VDEV_LOOP_FRAMES - 1)] = 0.0f;
+        vd_loopEnd++;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        vd_loop[(time + i) & (VDEV_LOOP_FRAMES - 1)] += frames[i * channels];
+    }
+}
+
+static void vd_loop_read(float* frames, uint32_t count, uint32_t channels, uint64_t time) {
+    if (vd_loop == NULL || vd_loopDelay < 0) return;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t const t = time + i;
+        if (t < (uint64_t)vd_loopDelay) continue;
+        uint64_t const s = t - (uint64_t)vd_loopDelay;
+        if (s >= vd_loopEnd || s + VDEV_LOOP_FRAMES <= vd_loopEnd) continue;
+        float const v = vd_loop[s & (VDEV_LOOP_FRAMES - 1)];
+        for (uint32_t c = 0; c < channels; ++c) frames[i * channels + c] += v;
+    }
+}
+
+static int vd_reserve(VdevDevice* d, uint32_t frames) {
+    if (frames <= d->capacity) return 1;
+    uint32_t const out = d->device->playback.internalChannels;
+    uint32_t const in  = d->device->capture.internalChannels;
+    float* pOut = (float*)realloc(d->out, (size_t)frames * (out ? out : 1) * sizeof(float));
+    if (pOut) d->out = pOut;
+    float* pIn = (float*)realloc(d->in, (size_t)frames * (in ? in : 1) * sizeof(float));
+    if (pIn) d->in = pIn;
+    if (!pOut || !pIn) return 0;
+    d->capacity = frames;
+    return 1;
+}
+
+static void vd_run(VdevDevice* d, uint32_t frames) {
+    if (!vd_reserve(d, frames)) return;
+    uint32_t const outChannels = d->device->playback.internalChannels;
+    uint32_t const inChannels  = d->device->capture.internalChannels;
+    int const plays = vd_plays(d);
+    int const captures = vd_captures(d);
+
+    if (captures) {
+        memset(d->in, 0, (size_t)frames * inChannels * sizeof(float));
+        if (vd_inputFn) vd_inputFn(vd_inputUser, d->in, frames, inChannels, d->next);
+        vd_loop_read(d->in, frames, inChannels, d->next);
+    }
+
+    double const start = vd_now_us();
+    ma_device_handle_backend_data_callback(d->device, plays ? d->out : NULL,
+                                           captures ? d->in : NULL, frames);
+    double const us = vd_now_us() - start;
+
+    if (plays) {
+        vd_loop_write(d->out, frames, outChannels, d->next);
+        if (vd_outputFn) vd_outputFn(vd_outputUser, d->out, frames, outChannels, d->next);
+        vd_add_totals(&vd_playback, frames, us);
+    }
+    if (captures) vd_add_totals(&vd_capture, frames, us);
+}
+
+static void vd_fill_descriptor(ma_device_descriptor* d, const ma_device_config* config,
+                               uint32_t defaultChannels) {
+    d->format = ma_format_f32;
+    if (d->channels == 0 || d->channels > MA_MAX_CHANNELS) d->channels = defaultChannels;
+    d->sampleRate = vd_rate;
+    ma_channel_map_init_standard(ma_standard_channel_map_default, d->channelMap,
+                                 MA_MAX_CHANNELS, d->channels);
+    d->periodSizeInFrames = ma_calculate_buffer_size_in_frames_from_descriptor(
+        d, vd_rate, config->performanceProfile);
+    if (d->periodCount == 0) d->periodCount = 3;
+}
+
+static void vd_fill_info(ma_device_type type, ma_device_info* info) {
+    memset(info, 0, sizeof(*info));
+    snprintf(info->name, sizeof(info->name), "%s",
+             type == ma_device_type_capture ? "Virtual Input" : "Virtual Output");
+    info->isDefault = MA_TRUE;
+    info->nativeDataFormatCount = 1;
+    info->nativeDataFormats[0].format     = ma_format_f32;
+    info->nativeDataFormats[0].channels   = 0;
+    info->nativeDataFormats[0].sampleRate = vd_rate;
+}
+
+/* backend callbacks */
+
+static ma_result vd_context_init(ma_context* context, const ma_context_config* config,
+                                 ma_backend_callbacks* callbacks) {
+    (void)context; (void)config; (void)callbacks; /* already set from the config */
+    return MA_SUCCESS;
+}
+
+static ma_result vd_context_uninit(ma_context* context) {
+    (void)context;
+    return MA_SUCCESS;
+}
+
+static ma_result vd_enumerate(ma_context* context, ma_enum_devices_callback_proc callback, void* user) {
+    ma_device_info info;
+    vd_fill_info(ma_device_type_playback, &info);
+    if (!callback(context, ma_device_type_playback, &info, user)) return MA_SUCCESS;
+    vd_fill_info(ma_device_type_capture, &info);
+    callback(context, ma_device_type_capture, &info, user);
+    return MA_SUCCESS;
+}
+
+static ma_result vd_get_device_info(ma_context* context, ma_device_type type,
+                                    const ma_device_id* id, ma_device_info* info) {
+    (void)context; (void)id;
+    vd_fill_info(type, info);
+    return MA_SUCCESS;
+}
+
+static ma_result vd_device_init(ma_device* device, const ma_device_config* config,
+                                ma_device_descriptor* playback, ma_device_descriptor* capture) {
+    if (config->deviceType == ma_device_type_loopback) return MA_DEVICE_TYPE_NOT_SUPPORTED;
+    VdevDevice* d = vd_find(NULL);
+    if (d == NULL) return MA_OUT_OF_MEMORY;
+
+    int const plays = config->deviceType != ma_device_type_capture;
+    int const captures = config->deviceType != ma_device_type_playback;
+    if (plays) vd_fill_descriptor(playback, config, 2);
+    if (captures) {
+        vd_fill_descriptor(capture, config, 1);
+        /* One clock: a duplex device captures in the periods it plays. */
+        if (plays) capture->periodSizeInFrames = playback->periodSizeInFrames;
+    }
+
+    memset(d, 0, sizeof(*d));
+    d->device = device;
+    d->period = plays ? playback->periodSizeInFrames : capture->periodSizeInFrames;
+    return MA_SUCCESS;
+}
+
+static ma_result vd_device_uninit(ma_device* device) {
+    VdevDevice* d = vd_find(device);
+    if (d == NULL) return MA_SUCCESS;
+    free(d->out);
+    free(d->in);
+    memset(d, 0, sizeof(*d));
+    return MA_SUCCESS;
+}
+
+static ma_result vd_device_start(ma_device* device) {
+    VdevDevice* d = vd_find(device);
+    if (d == NULL) return MA_INVALID_OPERATION;
+    d->started = 1;
+    d->next = vd_now;
+    return MA_SUCCESS;
+}
+
+static ma_result vd_device_stop(ma_device* device) {
+    VdevDevice* d = vd_find(device);
+    if (d) d->started = 0;
+    return MA_SUCCESS;
+}
+
+/************
+ ** public **
+ ************/
+
+int vdev_install(uint32_t sample_rate) {
+    ma_backend_callbacks callbacks;
+    memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.onContextInit             = vd_context_init;
+    callbacks.onContextUninit           = vd_context_uninit;
+    callbacks.onContextEnumerateDevices = vd_enumerate;
+    callbacks.onContextGetDeviceInfo    = vd_get_device_info;
+    callbacks.onDeviceInit              = vd_device_init;
+    callbacks.onDeviceUninit            = vd_device_uninit;
+    callbacks.onDeviceStart             = vd_device_start;
+    callbacks.onDeviceStop              = vd_device_stop;
+
+    vd_loop = (float*)calloc(VDEV_LOOP_FRAMES, sizeof(float));
+    if (vd_loop == NULL) return 0;
+    if (!audio_context_use_custom_backend(&callbacks, NULL)) {
+        free(vd_loop);
+        vd_loop = NULL;
+        return 0;
+    }
+    memset(vd_devices, 0, sizeof(vd_devices));
+    vd_rate = sample_rate ? sample_rate : 48000;
+    vd_now = 0;
+    vd_loopEnd = 0;
+    vdev_reset_stats();
+    return 1;
+}
+
+void vdev_uninstall(void) {
+    audio_context_use_custom_backend(NULL, NULL);
+    free(vd_loop);
+    vd_loop = NULL;
+    vd_inputFn = NULL;
+    vd_outputFn = NULL;
+    vd_loopDelay = -1;
+    vd_jitter = 0;
+}
+
+uint32_t vdev_sample_rate(void) {
+    return vd_rate;
+}
+
+uint64_t vdev_now(void) {
+    return vd_now;
+}
+
+uint64_t vdev_advance(uint64_t frames) {
+    uint64_t const target = vd_now + frames;
+    for (;;) {
+        /* The earliest callback due; playback first on a tie. */
+        VdevDevice* due = NULL;
+        for (uint32_t i = 0; i < VDEV_MAX_DEVICES; ++i) {
+            VdevDevice* d = &vd_devices[i];
+            if (d->device == NULL || !d->started || d->next >= target) continue;
+            if (due == NULL || d->next < due->next ||
+                (d->next == due->next && vd_plays(d) && !vd_plays(due))) {
+                due = d;
+            }
+        }
+        if (due == NULL) break;
+
+        uint32_t frames = due->period;
+        if (vd_jitter > 0) {
+            int64_t const delta = (int64_t)(vd_random() % (2 * vd_jitter + 1)) - vd_jitter;
+            frames = (int64_t)frames + delta > 1 ? (uint32_t)((int64_t)frames + delta) : 1;
+        }
+        vd_now = due->next;
+        vd_run(due, frames);
+        due->next += frames;
+    }
+    vd_now = target;
+    return vd_now;
+}
+
+uint64_t vdev_advance_ms(uint32_t ms) {
+    return vdev_advance((uint64_t)ms * vd_rate / 1000);
+}
+
+void vdev_set_input(VdevInputFn fn, void* user) {
+    vd_inputFn = fn;
+    vd_inputUser = user;
+}
+
+void vdev_set_output(VdevOutputFn fn, void* user) {
+    vd_outputFn = fn;
+    vd_outputUser = user;
+}
+
+void vdev_set_loopback(int32_t delay_frames) {
+    vd_loopDelay = delay_frames;
+}
+
+void vdev_set_period_jitter(uint32_t max_frames, uint32_t seed) {
+    vd_jitter = max_frames;
+    vd_seed = seed ? seed : 1;
+}
+
+int vdev_get_stats(ma_device_type type, VdevStats* out) {
+    if (out == NULL) return 0;
+    VdevTotals const* t = type == ma_device_type_capture ? &vd_capture : &vd_playback;
+    memset(out, 0, sizeof(*out));
+    out->callbacks      = t->callbacks;
+    out->frames         = t->frames;
+    out->deadlineMisses = t->deadlineMisses;
+    out->maxUs          = t->maxUs;
+    if (t->callbacks > 0) {
+        double const avg = t->sumUs / t->callbacks;
+        double const var = t->sumSqUs / t->callbacks - avg * avg;
+        out->avgUs    = avg;
+        out->jitterUs = var > 0.0 ? sqrt(var) : 0.0;
+    }
+    if (t->frames > 0) out->load = t->sumUs / (t->frames * 1e6 / vd_rate);
+    return 1;
+}
+
+void vdev_reset_stats(void) {
+    memset(&vd_playback, 0, sizeof(vd_playback));
+    memset(&vd_capture, 0, sizeof(vd_capture));
+}
+
+void vdev_print_stats(const char* label, ma_device_type type) {
+    VdevStats s;
+    vdev_get_stats(type, &s);
+    printf("%s: %llu callbacks, %llu frames, avg %.1f us, max %.1f us, jitter %.1f us, "
+           "load %.2f%%, %llu deadline misses\n",
+           label, (unsigned long long)s.callbacks, (unsigned long long)s.frames,
+           s.avgUs, s.maxUs, s.jitterUs, s.load * 100.0, (unsigned long long)s.deadlineMisses);
+}
+
+uint32_t vdev_device_count(void) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < VDEV_MAX_DEVICES; ++i) {
+        if (vd_devices[i].device != NULL) n++;
+    }
+    return n;
+}
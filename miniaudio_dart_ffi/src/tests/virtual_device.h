@@ -0,0 +1,95 @@
+#ifndef VIRTUAL_DEVICE_H
+#define VIRTUAL_DEVICE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#if __has_include("../external/miniaudio/include/miniaudio.h")
+#include "../external/miniaudio/include/miniaudio.h"
+#elif __has_include("miniaudio.h")
+#include "miniaudio.h"
+#else
+#error "miniaudio.h not found"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Virtual audio devices for the native tests.
+
+   vdev_install makes the shared context (audio_context) use a custom
+   miniaudio backend, so every Engine, Recorder and StreamPlayer opened
+   afterwards gets a virtual device instead of hardware. Nothing runs on its
+   own: the test moves a fake clock with vdev_advance, and each started
+   device gets its data callbacks, through miniaudio's usual conversion, at
+   the clock times its period falls on. Runs are deterministic, independent
+   of the machine's load, and faster than realtime.
+
+   Devices run in f32 at the harness rate; playback defaults to 2 channels
+   and capture to 1 unless the client asks for others. When a callback
+   time comes for a playback and a capture device at once, playback runs
+   first, so loopback can carry what was just played.
+
+   Each callback is timed. A callback that takes longer than the audio it
+   covers would have glitched on a real device and counts as a deadline
+   miss. */
+
+#define VDEV_MAX_DEVICES 16
+
+/* Test assertion: reports the failed condition and fails the test. */
+#define VDEV_CHECK(cond)                                                   \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                      \
+        }                                                                  \
+    } while (0)
+
+/* Capture source: fill frames (already zeroed) for clock time `time`. */
+typedef void (*VdevInputFn)(void* user, float* frames, uint32_t frameCount,
+                            uint32_t channels, uint64_t time);
+/* Playback sink: what a device played at clock time `time`. */
+typedef void (*VdevOutputFn)(void* user, const float* frames, uint32_t frameCount,
+                             uint32_t channels, uint64_t time);
+
+typedef struct VdevStats {
+    uint64_t callbacks;
+    uint64_t frames;
+    uint64_t deadlineMisses;
+    double   avgUs;     /* callback wall time */
+    double   maxUs;
+    double   jitterUs;  /* standard deviation of the callback time */
+    double   load;      /* callback time over audio time, 1.0 = all of it */
+} VdevStats;
+
+/* Must run before anything acquires the context. */
+int      vdev_install(uint32_t sample_rate);
+void     vdev_uninstall(void);
+
+uint32_t vdev_sample_rate(void);
+uint64_t vdev_now(void);
+/* Runs every started device up to now + frames. Returns the new time. */
+uint64_t vdev_advance(uint64_t frames);
+uint64_t vdev_advance_ms(uint32_t ms);
+
+void     vdev_set_input(VdevInputFn fn, void* user);
+void     vdev_set_output(VdevOutputFn fn, void* user);
+/* Feeds channel 0 of every playback device back into capture, delay_frames
+   later. Pass a negative delay to turn it off. */
+void     vdev_set_loopback(int32_t delay_frames);
+/* Each callback is up to max_frames shorter or longer than the period,
+   pseudo-randomly from seed; 0 gives fixed periods. */
+void     vdev_set_period_jitter(uint32_t max_frames, uint32_t seed);
+
+/* Totals over every device of a type (playback or capture); duplex
+   devices count as both. */
+int      vdev_get_stats(ma_device_type type, VdevStats* out);
+void     vdev_reset_stats(void);
+void     vdev_print_stats(const char* label, ma_device_type type);
+
+uint32_t vdev_device_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* VIRTUAL_DEVICE_H */
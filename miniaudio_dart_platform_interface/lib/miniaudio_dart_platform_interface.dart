@@ -32,6 +32,9 @@ abstract class MiniaudioDartPlatformInterface {
     required int channels,
     required int sampleRate,
     int bufferMs = 240,
+    bool buffered = false,
+    int prerollMs = 0,
+    int fadeMs = 0,
   });
 
   // Add CrossCoder factory method (standalone)
@@ -45,10 +48,92 @@ abstract interface class PlatformEngine {
       MiniaudioDartPlatformInterface.instance.createEngine();
 
   Future<void> init(int periodMs);
+  // offline: no device; the mix advances only as render or renderToFile
+  // pulls it, faster than realtime. Instead of init.
+  void initOffline(int channels, int sampleRate);
   void start();
   void dispose();
 
-  Future<PlatformSound> loadSound(AudioData audioData);
+  // predecode: decode encoded data to PCM in the engine format at load time.
+  // background: run the load off the calling thread where the platform can.
+  Future<PlatformSound> loadSound(AudioData audioData,
+      {bool predecode = false, bool background = false});
+  // loads straight from a file path: streamed from disk by default, decoded
+  // from a memory mapping with memoryMapped, or fully decoded with predecode.
+  Future<PlatformSound> loadSoundFile(String path,
+      {bool memoryMapped = false, bool predecode = false});
+
+  // background loading on native job threads: the future completes when the
+  // sound is ready, the caller's isolate only copies the input.
+  // setLoaderThreads must be called before init (default 1).
+  void setLoaderThreads(int count);
+  Future<PlatformSound> loadSoundAsync(AudioData audioData,
+      {bool predecode = false});
+  Future<PlatformSound> loadSoundFileAsync(String path,
+      {bool memoryMapped = false, bool predecode = false});
+  int get pendingLoads;
+
+  // shared assets: every sound loaded this way references one cached copy.
+  // key == null keys the asset by content; with a cached key audioData may be null.
+  Future<PlatformSound> loadSoundShared(AudioData? audioData,
+      {String? key, bool predecode = false});
+  bool hasSharedAsset(String key);
+  bool evictSharedAsset(String key);
+  // drops cached assets no sound references; returns bytes released.
+  int trimSharedAssets();
+  (int count, int bytes) get sharedAssetStats;
+
+  // engine-wide voice limit (0 = none): the loudest sounds by priority x
+  // gain are mixed, the rest virtualized. stats are from the last callback.
+  int get maxVoices;
+  set maxVoices(int value);
+  (int mixed, int virtualized) get voiceStats;
+
+  // the engine clock in output frames, for scheduled plays
+  int get timeInFrames;
+  int get sampleRate;
+
+  // full duplex: one device captures and plays, so both run on one clock.
+  // setDuplex must be called before init. readDuplex returns up to maxFrames
+  // of capture (captureChannels per frame) with the output rendered in the
+  // same callbacks (channels per frame), frame-aligned, as the far-end
+  // reference for echo cancellation.
+  void setDuplex(int captureChannels, int bufferMs);
+  int get captureChannels;
+  int get channels;
+  int get duplexAvailable;
+  (Float32List capture, Float32List reference) readDuplex(int maxFrames);
+  // capture mixed straight into the output
+  double get monitorGain;
+  set monitorGain(double value);
+
+  // device latency: the profile (optionally overridden) must be set before
+  // init; latency reports what the backend granted.
+  void setLatencyProfile(LatencyProfile profile,
+      {int? periodFrames, int? periods, bool? exclusive});
+  EngineLatency get latency;
+
+  // audio thread load, timed on every device callback; readable at any time
+  // without blocking the audio thread.
+  EngineLoadStats get loadStats;
+  void resetLoadStats();
+
+  // offline engines only: the next frames of the mix, interleaved, or
+  // written to path as a 32-bit float WAV.
+  Float32List render(int frames);
+  bool renderToFile(String path, int frames);
+
+  // gapless queue of tracks played through one engine sound; disposed with
+  // the engine if still alive.
+  PlatformPlaylist createPlaylist(int crossfadeMs);
+
+  // named submix that sounds, players and other buses are routed into;
+  // disposed with the engine if still alive.
+  PlatformMixBus createBus(String name);
+
+  // built-in effect node for the chains of sounds, playlists, stream
+  // players and buses; disposed with the engine if still alive.
+  PlatformEffect createEffect(EffectType type);
 
   // output devices
   Future<List<(String name, bool isDefault)>> enumeratePlaybackDevices();
@@ -60,22 +145,188 @@ abstract interface class PlatformEngine {
 
 typedef PlatformSoundLooping = (bool isLooped, int delayMs);
 
+// native values in declaration order
+enum LatencyProfile { conservative, lowLatency, ultra }
+
+typedef EngineLatency = ({
+  int periodFrames,
+  int periods,
+  int sampleRate,
+  double latencyMs,
+  bool exclusive,
+  String backend,
+});
+
+/// Snapshot of the engine's audio thread load since the last reset (or
+/// since the current device was opened).
+class EngineLoadStats {
+  const EngineLoadStats({
+    required this.callbacks,
+    required this.frames,
+    required this.xruns,
+    required this.overruns,
+    required this.load,
+    required this.peakLoad,
+    required this.lastCallbackUs,
+    required this.maxCallbackUs,
+    required this.periodUs,
+    required this.backend,
+  });
+
+  final int callbacks;
+  final int frames;
+
+  /// Callbacks that missed their deadline or came so late the device
+  /// buffer ran dry: each one is likely an audible glitch.
+  final int xruns;
+
+  /// The xruns where the callback itself took longer than its period.
+  final int overruns;
+
+  /// Callback time over period (1 = the deadline), smoothed over ~300 ms.
+  final double load;
+
+  /// The worst single callback, as [load].
+  final double peakLoad;
+
+  final double lastCallbackUs;
+  final double maxCallbackUs;
+  final double periodUs;
+  final String backend;
+}
+
+// which busy voice a new play takes over (native values in declaration order)
+enum VoiceStealPolicy { oldest, quietest, lowestPriority, none }
+
 abstract interface class PlatformSound {
   double get volume;
   set volume(double value);
   double get duration;
+  // weight for the engine's voice limit, default 1
+  double get priority;
+  set priority(double value);
   PlatformSoundLooping get looping;
   set looping(PlatformSoundLooping value);
   void play();
   void replay();
   void pause();
   void stop();
+  // sample-accurate scheduling at an engine time (Engine.timeInFrames)
+  bool playAt(int timeInFrames);
+  void stopAt(int timeInFrames);
   void unload();
 
+  // polyphony: overlapping plays on preallocated voices. playVoice returns a
+  // voice handle, 0 when none could be had; stale handles are ignored.
+  bool setPolyphony(int maxVoices, VoiceStealPolicy policy);
+  int get polyphony;
+  int playVoice(double volume, int priority, bool looped);
+  int playVoiceAt(double volume, int priority, bool looped, int timeInFrames);
+  void stopVoice(int voice);
+  bool isVoicePlaying(int voice);
+  void setVoiceVolume(int voice, double value);
+  int get activeVoices;
+
+  // null plays straight to the engine; false while a load is pending or
+  // for a bus of another engine.
+  bool setBus(PlatformMixBus? bus);
+
+  // effects on the sound and its voices, in order before the bus. index < 0
+  // appends; false when the chain is full (8), already holds the effect,
+  // the effect is another engine's, or a load is pending. Unloading
+  // releases them.
+  bool insertEffect(PlatformEffect effect, int index);
+  bool removeEffect(PlatformEffect effect);
+
   // optional engine rebind hook (device switch). Default no-op.
   bool rebindToEngine(PlatformEngine engine) => false;
 }
 
+// items are opened and their heads decoded when added, on the calling
+// thread. add/addFile return the item id, 0 when it could not be queued.
+abstract interface class PlatformPlaylist {
+  void start();
+  void stop();
+  double get volume;
+  set volume(double value);
+  int get crossfadeMs;
+  set crossfadeMs(int value);
+  // format AudioFormat.unknown queues encoded data, anything else raw PCM
+  int add(AudioData audioData);
+  int addFile(String path);
+  void skip();
+  void clear();
+  // id of the item playing, 0 when drained; queued includes it
+  int get current;
+  int get queued;
+  bool setBus(PlatformMixBus? bus);
+  // as PlatformSound.insertEffect; dispose releases them
+  bool insertEffect(PlatformEffect effect, int index);
+  bool removeEffect(PlatformEffect effect);
+  void dispose();
+}
+
+// submix on one group node: members are summed once, then take the bus
+// volume and mute (both smoothed, ~5 ms) and feed its parent, or the
+// engine when the parent is null. setParent refuses cycles. Members left
+// on a disposed bus fall silent until routed again.
+abstract interface class PlatformMixBus {
+  String get name;
+  double get volume;
+  set volume(double value);
+  bool get muted;
+  set muted(bool value);
+  bool setParent(PlatformMixBus? parent);
+  // effects after the bus gain, as PlatformSound.insertEffect; dispose
+  // releases them
+  bool insertEffect(PlatformEffect effect, int index);
+  bool removeEffect(PlatformEffect effect);
+  void dispose();
+}
+
+// native values in declaration order
+enum EffectType { eq, compressor, limiter, reverb }
+
+enum EqBandType { off, peak, lowShelf, highShelf, lowPass, highPass }
+
+// native parameter ids (effects.h)
+abstract final class EffectParam {
+  static const mix = 0; // 0 dry .. 1 wet
+  static const eqBands = 4;
+  static int eqType(int band) => 1 + band * 4; // EqBandType.index
+  static int eqFrequency(int band) => 2 + band * 4; // Hz
+  static int eqGain(int band) => 3 + band * 4; // dB
+  static int eqQ(int band) => 4 + band * 4;
+  static const threshold = 20; // dB
+  static const ratio = 21;
+  static const knee = 22; // dB
+  static const attack = 23; // ms
+  static const release = 24; // ms
+  static const makeup = 25; // dB
+  static const lookahead = 26; // ms
+  static const ceiling = 27; // dB
+  static const decay = 32; // RT60, s
+  static const damping = 33; // 0 .. 1
+  static const predelay = 34; // ms
+  static const width = 35; // 0 .. 1
+}
+
+// effect node with one input and one output at the engine's channels.
+// Values are clamped to each param's range; levels, frequencies and mix
+// glide there on the audio thread (~20 ms), band types, lookahead and
+// predelay switch at once. setParam is false for a param the effect does
+// not have. One chain at a time.
+abstract interface class PlatformEffect {
+  EffectType get type;
+  double getParam(int param);
+  bool setParam(int param, double value);
+  // deepest gain reduction of the last block, dB <= 0 (dynamics only)
+  double get reductionDb;
+  // drops filter, envelope and reverb state at the next block
+  void reset();
+  void dispose();
+}
+
 // Add codec config classes
 enum RecorderCodec {
   pcm(0),
@@ -132,6 +383,16 @@ abstract interface class PlatformRecorder {
   double get captureGain;
   set captureGain(double value);
 
+  /// Capture processing (float32 recorders), applied before buffering or
+  /// encoding. Noise suppression depth in dB, 0 = off.
+  double get noiseSuppression;
+  set noiseSuppression(double reductionDb);
+
+  /// Echo cancellation against everything [engine] plays.
+  bool enableEchoCancellation(PlatformEngine engine, int filterMs);
+  void disableEchoCancellation();
+  double get echoReturnLossEnhancement;
+
   // Remove old encoder methods
   // Future<bool> enableOpusEncoding(...) - REMOVED
   // int encodedPacketCount() - REMOVED
@@ -184,6 +445,48 @@ abstract interface class PlatformCrossCoder {
   void dispose();
 }
 
+/// Snapshot of a stream player's telemetry counters.
+class StreamPlayerStats {
+  const StreamPlayerStats({
+    required this.underrunEvents,
+    required this.silenceFrames,
+    required this.droppedFrames,
+    required this.fillFrames,
+    required this.peakFillFrames,
+    required this.capacityFrames,
+    required this.decodeErrors,
+  });
+
+  /// Times playback ran dry after audio had started flowing.
+  final int underrunEvents;
+
+  /// Frames of silence inserted while starved.
+  final int silenceFrames;
+
+  /// Frames discarded because the buffer was full.
+  final int droppedFrames;
+
+  final int fillFrames;
+  final int peakFillFrames;
+  final int capacityFrames;
+
+  /// Packet decode failures, indexed by codec id ([RecorderCodec.value]).
+  final List<int> decodeErrors;
+}
+
+enum StreamPlayerEvent {
+  underrun(1),
+  drop(2),
+  decodeError(3);
+
+  const StreamPlayerEvent(this.value);
+  final int value;
+}
+
+/// Receives the event and the counter's current total.
+typedef StreamPlayerTelemetryCallback = void Function(
+    StreamPlayerEvent event, int total);
+
 // Streaming playback of raw PCM (Float32 interleaved recommended)
 abstract interface class PlatformStreamPlayer {
   double get volume;
@@ -202,6 +505,62 @@ abstract interface class PlatformStreamPlayer {
   // Push encoded packets specifically
   bool pushEncodedPacket(Uint8List packet);
 
+  // Zero-copy write: a view of up to maxFrames frames straight into the
+  // playback buffer (shorter, or empty, when little space is left). Render
+  // into it, then commit the frames written; the view is invalid afterwards.
+  Float32List acquireWriteRegion(int maxFrames);
+  bool commitWrite(int frames, {int? timestampFrames});
+
+  // Buffered mode: write a chunk stamped with its stream position (frames).
+  int writeFloat32At(Float32List interleaved, int timestampFrames);
+
+  // Stream timestamp (frames) of the next frame to be played.
+  int get positionFrames;
+
+  // Buffered mode: seek within the buffered window. False if not buffered.
+  bool seekFrames(int timestampFrames);
+
+  // Buffered mode: (start, end) timestamps currently seekable, else null.
+  (int start, int end)? get bufferedRange;
+
+  // Gain automation evaluated on the audio thread, applied on top of volume.
+  // A new ramp starts from the current gain and replaces the previous one.
+  void rampGain(double target, int durationMs, {bool exponential = false});
+  double get gain;
+
+  // Ramp this player to 0 and [to] to 1 over the same duration.
+  void crossfadeTo(PlatformStreamPlayer to, int durationMs,
+      {bool exponential = false});
+
+  // Duck towards [duckGain] while [sidechain]'s peak exceeds [threshold].
+  // Pass null to stop ducking.
+  bool setDucking(
+    PlatformStreamPlayer? sidechain, {
+    double threshold = 0.05,
+    double duckGain = 0.25,
+    int attackMs = 10,
+    int releaseMs = 250,
+  });
+
+  // Play into a bus of the same engine, or the engine itself with null.
+  bool setBus(PlatformMixBus? bus);
+  // As PlatformSound.insertEffect; dispose releases them.
+  bool insertEffect(PlatformEffect effect, int index);
+  bool removeEffect(PlatformEffect effect);
+
+  // Telemetry snapshot; lock-free on the native side, cheap to poll.
+  StreamPlayerStats get stats;
+  void resetStats();
+
+  // Notify when a counter grows by its threshold (0 disables that event).
+  // Pass null to remove the callback.
+  void setTelemetryCallback(
+    StreamPlayerTelemetryCallback? callback, {
+    int underrunThreshold = 1,
+    int dropThresholdFrames = 0,
+    int decodeErrorThreshold = 1,
+  });
+
   void dispose();
 }
 
@@ -22,6 +22,32 @@ int engine_load_sound(int self, int sound, int data, int dataSize, int format,
         int sampleRate, int channels) =>
     _engine_load_sound(
         self, sound, data, dataSize, format, sampleRate, channels);
+int engine_load_sound_ex(int self, int sound, int data, int dataSize,
+        int format, int sampleRate, int channels, int flags) =>
+    _engine_load_sound_ex(
+        self, sound, data, dataSize, format, sampleRate, channels, flags);
+// free_fn 0 releases data with free(), which is _free on the wasm heap.
+int engine_load_sound_adopt(int self, int sound, int data, int dataSize,
+        int format, int sampleRate, int channels, int flags, int freeFn) =>
+    _engine_load_sound_adopt(self, sound, data, dataSize, format, sampleRate,
+        channels, flags, freeFn);
+int engine_load_sound_shared(int self, int sound, int key, int data,
+        int dataSize, int format, int sampleRate, int channels, int flags) =>
+    _engine_load_sound_shared(self, sound, key, data, dataSize, format,
+        sampleRate, channels, flags);
+int engine_has_asset(int self, int key) => _engine_has_asset(self, key);
+int engine_evict_asset(int self, int key) => _engine_evict_asset(self, key);
+// The uint64 result is truncated without WASM_BIGINT; callers use the stats.
+void engine_trim_assets(int self) => _engine_trim_assets(self);
+int engine_get_asset_stats(int self, int outCount, int outBytes) =>
+    _engine_get_asset_stats(self, outCount, outBytes);
+void engine_set_max_voices(int self, int maxVoices) =>
+    _engine_set_max_voices(self, maxVoices);
+int engine_get_max_voices(int self) => _engine_get_max_voices(self);
+int engine_get_voice_stats(int self, int outMixed, int outVirtual) =>
+    _engine_get_voice_stats(self, outMixed, outVirtual);
+int engine_get_sample_rate(int self) => _engine_get_sample_rate(self);
+int engine_get_channels(int self) => _engine_get_channels(self);
 
 // Engine JS bindings
 @JS()
@@ -35,6 +61,34 @@ external void _engine_uninit(int self);
 @JS()
 external int _engine_load_sound(int self, int sound, int data, int dataSize,
     int format, int sampleRate, int channels);
+@JS()
+external int _engine_load_sound_ex(int self, int sound, int data, int dataSize,
+    int format, int sampleRate, int channels, int flags);
+@JS()
+external int _engine_load_sound_adopt(int self, int sound, int data,
+    int dataSize, int format, int sampleRate, int channels, int flags,
+    int freeFn);
+@JS()
+external int _engine_load_sound_shared(int self, int sound, int key, int data,
+    int dataSize, int format, int sampleRate, int channels, int flags);
+@JS()
+external int _engine_has_asset(int self, int key);
+@JS()
+external int _engine_evict_asset(int self, int key);
+@JS()
+external void _engine_trim_assets(int self);
+@JS()
+external int _engine_get_asset_stats(int self, int outCount, int outBytes);
+@JS()
+external void _engine_set_max_voices(int self, int maxVoices);
+@JS()
+external int _engine_get_max_voices(int self);
+@JS()
+external int _engine_get_voice_stats(int self, int outMixed, int outVirtual);
+@JS()
+external int _engine_get_sample_rate(int self);
+@JS()
+external int _engine_get_channels(int self);
 
 Future<int> _engine_init(int self, int periodMs) async {
   final promise = jsu.callMethod(
@@ -64,8 +118,27 @@ double sound_get_volume(int self) => _sound_get_volume(self);
 void sound_set_volume(int self, double volume) =>
     _sound_set_volume(self, volume);
 double sound_get_duration(int self) => _sound_get_duration(self);
+double sound_get_priority(int self) => _sound_get_priority(self);
+void sound_set_priority(int self, double value) =>
+    _sound_set_priority(self, value);
 void sound_set_looped(int self, bool enabled, int delayMs) =>
     _sound_set_looped(self, enabled, delayMs);
+int sound_set_polyphony(int self, int maxVoices, int policy) =>
+    _sound_set_polyphony(self, maxVoices, policy);
+int sound_get_polyphony(int self) => _sound_get_polyphony(self);
+int sound_play_voice(int self, double volume, int priority, bool looped) =>
+    _sound_play_voice(self, volume, priority, looped);
+void sound_stop_voice(int self, int voice) => _sound_stop_voice(self, voice);
+bool sound_voice_is_playing(int self, int voice) =>
+    _sound_voice_is_playing(self, voice) != 0;
+void sound_set_voice_volume(int self, int voice, double value) =>
+    _sound_set_voice_volume(self, voice, value);
+int sound_get_active_voices(int self) => _sound_get_active_voices(self);
+int sound_set_bus(int self, int bus) => _sound_set_bus(self, bus);
+int sound_insert_effect(int self, int effect, int index) =>
+    _sound_insert_effect(self, effect, index);
+int sound_remove_effect(int self, int effect) =>
+    _sound_remove_effect(self, effect);
 
 @JS()
 external int _sound_alloc();
@@ -88,7 +161,162 @@ external void _sound_set_volume(int self, double volume);
 @JS()
 external double _sound_get_duration(int self);
 @JS()
+external double _sound_get_priority(int self);
+@JS()
+external void _sound_set_priority(int self, double value);
+@JS()
 external void _sound_set_looped(int self, bool enabled, int delayMs);
+@JS()
+external int _sound_set_polyphony(int self, int maxVoices, int policy);
+@JS()
+external int _sound_get_polyphony(int self);
+@JS()
+external int _sound_play_voice(
+    int self, double volume, int priority, bool looped);
+@JS()
+external void _sound_stop_voice(int self, int voice);
+@JS()
+external int _sound_voice_is_playing(int self, int voice);
+@JS()
+external void _sound_set_voice_volume(int self, int voice, double value);
+@JS()
+external int _sound_get_active_voices(int self);
+@JS()
+external int _sound_set_bus(int self, int bus);
+@JS()
+external int _sound_insert_effect(int self, int effect, int index);
+@JS()
+external int _sound_remove_effect(int self, int effect);
+
+// Playlist functions
+int playlist_alloc() => _playlist_alloc();
+void playlist_free(int self) => _playlist_free(self);
+int playlist_init(int self, int engine, int crossfadeMs) =>
+    _playlist_init(self, engine, crossfadeMs);
+int playlist_start(int self) => _playlist_start(self);
+int playlist_stop(int self) => _playlist_stop(self);
+void playlist_set_volume(int self, double volume) =>
+    _playlist_set_volume(self, volume);
+double playlist_get_volume(int self) => _playlist_get_volume(self);
+void playlist_set_crossfade(int self, int crossfadeMs) =>
+    _playlist_set_crossfade(self, crossfadeMs);
+int playlist_get_crossfade(int self) => _playlist_get_crossfade(self);
+int playlist_enqueue(int self, int data, int size) =>
+    _playlist_enqueue(self, data, size);
+int playlist_enqueue_pcm(int self, int data, int size, int format,
+        int channels, int sampleRate) =>
+    _playlist_enqueue_pcm(self, data, size, format, channels, sampleRate);
+void playlist_skip(int self) => _playlist_skip(self);
+void playlist_clear(int self) => _playlist_clear(self);
+int playlist_get_current(int self) => _playlist_get_current(self);
+int playlist_get_queued(int self) => _playlist_get_queued(self);
+int playlist_set_bus(int self, int bus) => _playlist_set_bus(self, bus);
+int playlist_insert_effect(int self, int effect, int index) =>
+    _playlist_insert_effect(self, effect, index);
+int playlist_remove_effect(int self, int effect) =>
+    _playlist_remove_effect(self, effect);
+
+@JS()
+external int _playlist_alloc();
+@JS()
+external void _playlist_free(int self);
+@JS()
+external int _playlist_init(int self, int engine, int crossfadeMs);
+@JS()
+external int _playlist_start(int self);
+@JS()
+external int _playlist_stop(int self);
+@JS()
+external void _playlist_set_volume(int self, double volume);
+@JS()
+external double _playlist_get_volume(int self);
+@JS()
+external void _playlist_set_crossfade(int self, int crossfadeMs);
+@JS()
+external int _playlist_get_crossfade(int self);
+@JS()
+external int _playlist_enqueue(int self, int data, int size);
+@JS()
+external int _playlist_enqueue_pcm(
+    int self, int data, int size, int format, int channels, int sampleRate);
+@JS()
+external void _playlist_skip(int self);
+@JS()
+external void _playlist_clear(int self);
+@JS()
+external int _playlist_get_current(int self);
+@JS()
+external int _playlist_get_queued(int self);
+@JS()
+external int _playlist_set_bus(int self, int bus);
+@JS()
+external int _playlist_insert_effect(int self, int effect, int index);
+@JS()
+external int _playlist_remove_effect(int self, int effect);
+
+// MixBus functions
+int mix_bus_alloc() => _mix_bus_alloc();
+void mix_bus_free(int self) => _mix_bus_free(self);
+int mix_bus_init(int self, int engine, int name) =>
+    _mix_bus_init(self, engine, name);
+void mix_bus_set_volume(int self, double volume) =>
+    _mix_bus_set_volume(self, volume);
+double mix_bus_get_volume(int self) => _mix_bus_get_volume(self);
+void mix_bus_set_muted(int self, bool muted) => _mix_bus_set_muted(self, muted);
+bool mix_bus_get_muted(int self) => _mix_bus_get_muted(self) != 0;
+int mix_bus_set_parent(int self, int parent) =>
+    _mix_bus_set_parent(self, parent);
+int mix_bus_insert_effect(int self, int effect, int index) =>
+    _mix_bus_insert_effect(self, effect, index);
+int mix_bus_remove_effect(int self, int effect) =>
+    _mix_bus_remove_effect(self, effect);
+
+@JS()
+external int _mix_bus_alloc();
+@JS()
+external void _mix_bus_free(int self);
+@JS()
+external int _mix_bus_init(int self, int engine, int name);
+@JS()
+external void _mix_bus_set_volume(int self, double volume);
+@JS()
+external double _mix_bus_get_volume(int self);
+@JS()
+external void _mix_bus_set_muted(int self, bool muted);
+@JS()
+external int _mix_bus_get_muted(int self);
+@JS()
+external int _mix_bus_set_parent(int self, int parent);
+@JS()
+external int _mix_bus_insert_effect(int self, int effect, int index);
+@JS()
+external int _mix_bus_remove_effect(int self, int effect);
+
+// Effect functions
+int effect_alloc() => _effect_alloc();
+void effect_free(int self) => _effect_free(self);
+int effect_init(int self, int engine, int type) =>
+    _effect_init(self, engine, type);
+int effect_set_param(int self, int param, double value) =>
+    _effect_set_param(self, param, value);
+double effect_get_param(int self, int param) => _effect_get_param(self, param);
+double effect_get_reduction_db(int self) => _effect_get_reduction_db(self);
+void effect_reset(int self) => _effect_reset(self);
+
+@JS()
+external int _effect_alloc();
+@JS()
+external void _effect_free(int self);
+@JS()
+external int _effect_init(int self, int engine, int type);
+@JS()
+external int _effect_set_param(int self, int param, double value);
+@JS()
+external double _effect_get_param(int self, int param);
+@JS()
+external double _effect_get_reduction_db(int self);
+@JS()
+external void _effect_reset(int self);
 
 // Recorder functions
 int recorder_create() => _recorder_create();
@@ -146,10 +374,33 @@ int stream_player_stop(int self) => _stream_player_stop(self);
 void stream_player_clear(int self) => _stream_player_clear(self);
 void stream_player_set_volume(int self, double volume) =>
     _stream_player_set_volume(self, volume);
+int stream_player_set_bus(int self, int bus) =>
+    _stream_player_set_bus(self, bus);
+int stream_player_insert_effect(int self, int effect, int index) =>
+    _stream_player_insert_effect(self, effect, index);
+int stream_player_remove_effect(int self, int effect) =>
+    _stream_player_remove_effect(self, effect);
 int stream_player_write_frames_f32(int self, int data, int frames) =>
     _stream_player_write_frames_f32(self, data, frames);
 int stream_player_push_encoded_packet(int self, int data, int bytes) =>
     _stream_player_push_encoded_packet(self, data, bytes);
+int stream_player_acquire_write_region(int self, int ptrOut, int framesOut) =>
+    _stream_player_acquire_write_region(self, ptrOut, framesOut);
+int stream_player_commit_write(int self, int frames) =>
+    _stream_player_commit_write(self, frames);
+void stream_player_ramp_gain(
+        int self, double target, int durationMs, int curve) =>
+    _stream_player_ramp_gain(self, target, durationMs, curve);
+double stream_player_get_gain(int self) => _stream_player_get_gain(self);
+void stream_player_crossfade(int from, int to, int durationMs, int curve) =>
+    _stream_player_crossfade(from, to, durationMs, curve);
+int stream_player_set_ducking(int self, int sidechain, double threshold,
+        double duckGain, int attackMs, int releaseMs) =>
+    _stream_player_set_ducking(
+        self, sidechain, threshold, duckGain, attackMs, releaseMs);
+int stream_player_get_stats(int self, int statsPtr) =>
+    _stream_player_get_stats(self, statsPtr);
+void stream_player_reset_stats(int self) => _stream_player_reset_stats(self);
 
 // StreamPlayer with config struct (matching FFI)
 int stream_player_init_with_engine(int self, int engine, int configPtr) =>
@@ -184,9 +435,35 @@ external void _stream_player_clear(int self);
 @JS()
 external void _stream_player_set_volume(int self, double volume);
 @JS()
+external int _stream_player_set_bus(int self, int bus);
+@JS()
+external int _stream_player_insert_effect(int self, int effect, int index);
+@JS()
+external int _stream_player_remove_effect(int self, int effect);
+@JS()
 external int _stream_player_write_frames_f32(int self, int data, int frames);
 @JS()
 external int _stream_player_push_encoded_packet(int self, int data, int bytes);
+@JS()
+external int _stream_player_acquire_write_region(
+    int self, int ptrOut, int framesOut);
+@JS()
+external int _stream_player_commit_write(int self, int frames);
+@JS()
+external void _stream_player_ramp_gain(
+    int self, double target, int durationMs, int curve);
+@JS()
+external double _stream_player_get_gain(int self);
+@JS()
+external void _stream_player_crossfade(
+    int from, int to, int durationMs, int curve);
+@JS()
+external int _stream_player_set_ducking(int self, int sidechain,
+    double threshold, double duckGain, int attackMs, int releaseMs);
+@JS()
+external int _stream_player_get_stats(int self, int statsPtr);
+@JS()
+external void _stream_player_reset_stats(int self);
 
 // CrossCoder functions
 int crosscoder_create(
@@ -1,6 +1,7 @@
 // ignore_for_file: omit_local_variable_types
 
 import "dart:async";
+import "dart:convert";
 import "dart:js_interop";
 import "dart:typed_data";
 import "package:miniaudio_dart_platform_interface/miniaudio_dart_platform_interface.dart";
@@ -50,6 +51,9 @@ class MiniaudioDartWeb extends MiniaudioDartPlatformInterface {
     required int channels,
     required int sampleRate,
     int bufferMs = 240,
+    bool buffered = false,
+    int prerollMs = 0,
+    int fadeMs = 0,
   }) {
     final engWrapper = (engine as WebEngine)._self;
     final sp = wasm.stream_player_alloc();
@@ -58,7 +62,7 @@ class MiniaudioDartWeb extends MiniaudioDartPlatformInterface {
     }
 
     // Create StreamPlayerConfig struct (matching FFI)
-    final cfgPtr = mem.allocate(28); // sizeof(StreamPlayerConfig)
+    final cfgPtr = mem.allocate(40); // sizeof(StreamPlayerConfig)
     try {
       mem.writeI32(cfgPtr, format); // formatAsInt
       mem.writeI32(cfgPtr + 4, channels); // channels
@@ -66,6 +70,10 @@ class MiniaudioDartWeb extends MiniaudioDartPlatformInterface {
       mem.writeI32(cfgPtr + 12, bufferMs); // bufferMilliseconds
       mem.writeI32(cfgPtr + 16, 1); // allowCodecPackets = true
       mem.writeI32(cfgPtr + 20, 0); // decodeAccumFrames = 0
+      mem.writeI32(cfgPtr + 24, buffered ? 1 : 0); // bufferedMode
+      mem.writeI32(cfgPtr + 28, 0); // segmentMilliseconds = default
+      mem.writeI32(cfgPtr + 32, prerollMs); // prerollMilliseconds
+      mem.writeI32(cfgPtr + 36, fadeMs); // fadeMilliseconds
 
       final ok = wasm.stream_player_init_with_engine(sp, engWrapper, cfgPtr);
       if (ok != 1) {
@@ -292,6 +300,175 @@ final class WebStreamPlayer implements PlatformStreamPlayer {
     return ok == 1;
   }
 
+  @override
+  Float32List acquireWriteRegion(int maxFrames) {
+    if (maxFrames <= 0) return Float32List(0);
+    final ptrOut = mem.allocate(8);
+    if (ptrOut == 0) throw MiniaudioDartPlatformOutOfMemoryException();
+    final framesOut = ptrOut + 4;
+    try {
+      mem.writeI32(framesOut, maxFrames);
+      final ok =
+          wasm.stream_player_acquire_write_region(_self, ptrOut, framesOut);
+      if (ok != 1) {
+        throw MiniaudioDartPlatformException(
+            "stream_player_acquire_write_region failed.");
+      }
+      final frames = mem.readI32(framesOut);
+      final dataPtr = mem.readI32(ptrOut);
+      if (frames <= 0 || dataPtr == 0) return Float32List(0);
+      final start = dataPtr >> 2;
+      return Float32List.sublistView(
+          mem.HEAPF32.toDart, start, start + frames * _channels);
+    } finally {
+      mem.free(ptrOut);
+    }
+  }
+
+  // Timestamps need int64 arguments (see below), so they are dropped here.
+  @override
+  bool commitWrite(int frames, {int? timestampFrames}) =>
+      wasm.stream_player_commit_write(_self, frames) == 1;
+
+  // Timeline calls take int64 arguments, which the wasm build does not
+  // export (no WASM_BIGINT); timestamps are ignored on web.
+  @override
+  int writeFloat32At(Float32List interleaved, int timestampFrames) =>
+      writeFloat32(interleaved);
+
+  @override
+  int get positionFrames => 0;
+
+  @override
+  bool seekFrames(int timestampFrames) => false;
+
+  @override
+  (int start, int end)? get bufferedRange => null;
+
+  @override
+  void rampGain(double target, int durationMs, {bool exponential = false}) =>
+      wasm.stream_player_ramp_gain(
+          _self, target, durationMs < 0 ? 0 : durationMs, exponential ? 1 : 0);
+
+  @override
+  double get gain => wasm.stream_player_get_gain(_self);
+
+  @override
+  void crossfadeTo(PlatformStreamPlayer to, int durationMs,
+          {bool exponential = false}) =>
+      wasm.stream_player_crossfade(_self, (to as WebStreamPlayer)._self,
+          durationMs < 0 ? 0 : durationMs, exponential ? 1 : 0);
+
+  @override
+  bool setDucking(
+    PlatformStreamPlayer? sidechain, {
+    double threshold = 0.05,
+    double duckGain = 0.25,
+    int attackMs = 10,
+    int releaseMs = 250,
+  }) =>
+      wasm.stream_player_set_ducking(
+        _self,
+        sidechain == null ? 0 : (sidechain as WebStreamPlayer)._self,
+        threshold,
+        duckGain,
+        attackMs < 0 ? 0 : attackMs,
+        releaseMs < 0 ? 0 : releaseMs,
+      ) ==
+      1;
+
+  // Native callbacks would need addFunction, so thresholds are evaluated
+  // here whenever stats are polled.
+  StreamPlayerTelemetryCallback? _telemetry;
+  final List<int> _thresholds = [0, 0, 0];
+  final List<int> _notified = [0, 0, 0];
+
+  @override
+  bool setBus(PlatformMixBus? bus) =>
+      wasm.stream_player_set_bus(_self, WebMixBus._native(bus)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) {
+    final node = WebEffect._node(effect);
+    return wasm.stream_player_insert_effect(_self, node, index) == 1;
+  }
+
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      wasm.stream_player_remove_effect(_self, WebEffect._node(effect)) == 1;
+
+  @override
+  StreamPlayerStats get stats {
+    final ptr = mem.allocate(48); // sizeof(StreamPlayerStats)
+    if (ptr == 0) throw MiniaudioDartPlatformOutOfMemoryException();
+    try {
+      if (wasm.stream_player_get_stats(_self, ptr) != 1) {
+        throw MiniaudioDartPlatformException("stream_player_get_stats failed.");
+      }
+      int u64(int addr) =>
+          (mem.readI32(addr) & 0xFFFFFFFF) +
+          (mem.readI32(addr + 4) & 0xFFFFFFFF) * 0x100000000;
+      int u32(int addr) => mem.readI32(addr) & 0xFFFFFFFF;
+      final s = StreamPlayerStats(
+        underrunEvents: u64(ptr),
+        silenceFrames: u64(ptr + 8),
+        droppedFrames: u64(ptr + 16),
+        fillFrames: u32(ptr + 24),
+        peakFillFrames: u32(ptr + 28),
+        capacityFrames: u32(ptr + 32),
+        decodeErrors: [u32(ptr + 36), u32(ptr + 40)],
+      );
+      _checkThresholds(s);
+      return s;
+    } finally {
+      mem.free(ptr);
+    }
+  }
+
+  void _checkThresholds(StreamPlayerStats s) {
+    final cb = _telemetry;
+    if (cb == null) return;
+    final totals = [
+      s.underrunEvents,
+      s.droppedFrames,
+      s.decodeErrors.fold<int>(0, (a, b) => a + b),
+    ];
+    for (int i = 0; i < 3; i++) {
+      if (_thresholds[i] == 0) continue;
+      if (totals[i] - _notified[i] >= _thresholds[i]) {
+        _notified[i] = totals[i];
+        cb(StreamPlayerEvent.values[i], totals[i]);
+      }
+    }
+  }
+
+  @override
+  void resetStats() {
+    wasm.stream_player_reset_stats(_self);
+    _notified.fillRange(0, 3, 0);
+  }
+
+  @override
+  void setTelemetryCallback(
+    StreamPlayerTelemetryCallback? callback, {
+    int underrunThreshold = 1,
+    int dropThresholdFrames = 0,
+    int decodeErrorThreshold = 1,
+  }) {
+    _telemetry = null;
+    if (callback == null) return;
+    _thresholds
+      ..[0] = underrunThreshold
+      ..[1] = dropThresholdFrames
+      ..[2] = decodeErrorThreshold;
+    final s = stats;
+    _notified
+      ..[0] = s.underrunEvents
+      ..[1] = s.droppedFrames
+      ..[2] = s.decodeErrors.fold<int>(0, (a, b) => a + b);
+    _telemetry = callback;
+  }
+
   @override
   void dispose() {
     if (_scratchPtr != 0) {
@@ -442,6 +619,18 @@ class WebRecorder implements PlatformRecorder {
     // Web implementation would call wasm function if available
   }
 
+  // The browser applies its own processing (getUserMedia constraints).
+  @override
+  double get noiseSuppression => 0;
+  @override
+  set noiseSuppression(double reductionDb) {}
+  @override
+  bool enableEchoCancellation(PlatformEngine engine, int filterMs) => false;
+  @override
+  void disableEchoCancellation() {}
+  @override
+  double get echoReturnLossEnhancement => 0;
+
   @override
   void dispose() => wasm.recorder_destroy(_self);
 
@@ -461,10 +650,15 @@ final class WebEngine implements PlatformEngine {
   WebEngine(this._self);
   final int _self;
 
+  static const _soundLoadDecode = 1; // SOUND_LOAD_DECODE
+
   @override
   EngineState state = EngineState.uninit;
   Future<void>? _initPending;
   int _playbackGen = 0;
+  final Set<WebPlaylist> _playlists = {};
+  final Set<WebMixBus> _buses = {};
+  final Set<WebEffect> _effects = {};
 
   @override
   Future<void> init(int periodMs) async {
@@ -501,6 +695,15 @@ final class WebEngine implements PlatformEngine {
 
   @override
   void dispose() {
+    for (final p in List.of(_playlists)) {
+      p.dispose();
+    }
+    for (final b in List.of(_buses)) {
+      b.dispose();
+    }
+    for (final e in List.of(_effects)) {
+      e.dispose();
+    }
     wasm.engine_uninit(_self);
     wasm.engine_free(_self);
   }
@@ -524,7 +727,9 @@ final class WebEngine implements PlatformEngine {
   }
 
   @override
-  Future<PlatformSound> loadSound(AudioData audioData) async {
+  Future<PlatformSound> loadSound(AudioData audioData,
+      {bool predecode = false, bool background = false}) async {
+    // No threads in the wasm build: background loads run inline.
     if (_initPending != null) {
       await _initPending;
     }
@@ -532,35 +737,263 @@ final class WebEngine implements PlatformEngine {
     if (bytes == 0) {
       throw MiniaudioDartPlatformException("loadSound: empty buffer");
     }
+    final sound = wasm.sound_alloc();
+    if (sound == 0) {
+      throw MiniaudioDartPlatformException("Failed to allocate a sound.");
+    }
     final dataPtr = mem.allocate(bytes);
-    try {
-      mem.copyBytes(dataPtr, audioData.buffer.buffer);
+    mem.copyBytes(dataPtr, audioData.buffer.buffer);
+
+    // The sound adopts the heap copy and frees it itself (even on failure),
+    // so this is the only copy held.
+    final result = wasm.engine_load_sound_adopt(
+      _self,
+      sound,
+      dataPtr,
+      bytes,
+      audioData.format,
+      audioData.sampleRate,
+      audioData.channels,
+      predecode ? _soundLoadDecode : 0,
+      0,
+    );
+    if (result != 1) {
+      wasm.sound_unload(sound);
+      throw MiniaudioDartPlatformException("Failed to load a sound.");
+    }
+
+    return WebSound._fromPtrs(sound, 0);
+  }
+
+  @override
+  Future<PlatformSound> loadSoundFile(String path,
+      {bool memoryMapped = false, bool predecode = false}) async {
+    throw MiniaudioDartPlatformException(
+        "loadSoundFile: no file system on the web, use loadSound");
+  }
+
+  // The wasm build has no job threads; async loads complete inline.
+  @override
+  void setLoaderThreads(int count) {}
+
+  @override
+  int get pendingLoads => 0;
+
+  @override
+  Future<PlatformSound> loadSoundAsync(AudioData audioData,
+          {bool predecode = false}) =>
+      loadSound(audioData, predecode: predecode);
+
+  @override
+  Future<PlatformSound> loadSoundFileAsync(String path,
+          {bool memoryMapped = false, bool predecode = false}) =>
+      loadSoundFile(path, memoryMapped: memoryMapped, predecode: predecode);
 
-      final sound = wasm.sound_alloc();
-      if (sound == 0) {
-        mem.free(dataPtr);
-        throw MiniaudioDartPlatformException("Failed to allocate a sound.");
+  @override
+  Future<PlatformSound> loadSoundShared(AudioData? audioData,
+      {String? key, bool predecode = false}) async {
+    if (_initPending != null) {
+      await _initPending;
+    }
+    if (audioData == null && key == null) {
+      throw MiniaudioDartPlatformException(
+          "loadSoundShared: audioData or key required");
+    }
+    return _withKey(key, (keyPtr) {
+      final bytes = audioData?.buffer.lengthInBytes ?? 0;
+      // The cache keeps its own copy, so this staging buffer is freed below.
+      final dataPtr = bytes > 0 ? mem.allocate(bytes) : 0;
+      try {
+        if (dataPtr != 0) mem.copyBytes(dataPtr, audioData!.buffer.buffer);
+        final sound = wasm.sound_alloc();
+        if (sound == 0) {
+          throw MiniaudioDartPlatformException("Failed to allocate a sound.");
+        }
+        final result = wasm.engine_load_sound_shared(
+          _self,
+          sound,
+          keyPtr,
+          dataPtr,
+          bytes,
+          audioData?.format ?? 0,
+          audioData?.sampleRate ?? 0,
+          audioData?.channels ?? 0,
+          predecode ? _soundLoadDecode : 0,
+        );
+        if (result != 1) {
+          wasm.sound_free(sound);
+          throw MiniaudioDartPlatformException("Failed to load a sound.");
+        }
+        return WebSound._fromPtrs(sound, 0);
+      } finally {
+        if (dataPtr != 0) mem.free(dataPtr);
       }
+    });
+  }
 
-      final result = wasm.engine_load_sound(
-        _self,
-        sound,
-        dataPtr,
-        bytes,
-        audioData.format,
-        audioData.sampleRate,
-        audioData.channels,
+  @override
+  bool hasSharedAsset(String key) =>
+      _withKey(key, (k) => wasm.engine_has_asset(_self, k) == 1);
+
+  @override
+  bool evictSharedAsset(String key) =>
+      _withKey(key, (k) => wasm.engine_evict_asset(_self, k) == 1);
+
+  @override
+  int trimSharedAssets() {
+    final before = sharedAssetStats.$2;
+    wasm.engine_trim_assets(_self);
+    return before - sharedAssetStats.$2;
+  }
+
+  @override
+  int get maxVoices => wasm.engine_get_max_voices(_self);
+  @override
+  set maxVoices(int value) => wasm.engine_set_max_voices(_self, value);
+
+  @override
+  (int mixed, int virtualized) get voiceStats {
+    final ptr = mem.allocate(8);
+    try {
+      if (wasm.engine_get_voice_stats(_self, ptr, ptr + 4) != 1) return (0, 0);
+      return (mem.readI32(ptr), mem.readI32(ptr + 4));
+    } finally {
+      mem.free(ptr);
+    }
+  }
+
+  // The engine clock is a uint64, which the wasm build does not export (no
+  // WASM_BIGINT); scheduled plays fall back to immediate ones on web.
+  @override
+  int get timeInFrames => 0;
+  @override
+  int get sampleRate => wasm.engine_get_sample_rate(_self);
+
+  // The browser build has no capture on the engine device.
+  @override
+  void setDuplex(int captureChannels, int bufferMs) =>
+      throw MiniaudioDartPlatformException(
+          "Duplex mode is not supported on the web.");
+  @override
+  int get captureChannels => 0;
+  @override
+  int get channels => wasm.engine_get_channels(_self);
+  @override
+  int get duplexAvailable => 0;
+  @override
+  (Float32List capture, Float32List reference) readDuplex(int maxFrames) =>
+      (Float32List(0), Float32List(0));
+  @override
+  double get monitorGain => 0;
+  @override
+  set monitorGain(double value) {}
+
+  // The browser sizes the audio worklet's buffers itself.
+  @override
+  void setLatencyProfile(LatencyProfile profile,
+      {int? periodFrames, int? periods, bool? exclusive}) {}
+  @override
+  EngineLatency get latency => (
+        periodFrames: 0,
+        periods: 0,
+        sampleRate: sampleRate,
+        latencyMs: 0,
+        exclusive: false,
+        backend: "Web Audio",
       );
-      if (result != 1) {
-        wasm.sound_unload(sound);
-        mem.free(dataPtr);
-        throw MiniaudioDartPlatformException("Failed to load a sound.");
-      }
 
-      return WebSound._fromPtrs(sound, dataPtr);
-    } catch (e) {
-      mem.free(dataPtr);
-      rethrow;
+  // The audio worklet scope has no clock to time callbacks with.
+  @override
+  EngineLoadStats get loadStats => const EngineLoadStats(
+        callbacks: 0,
+        frames: 0,
+        xruns: 0,
+        overruns: 0,
+        load: 0,
+        peakLoad: 0,
+        lastCallbackUs: 0,
+        maxCallbackUs: 0,
+        periodUs: 0,
+        backend: "Web Audio",
+      );
+  @override
+  void resetLoadStats() {}
+
+  // The wasm build has no file system to write to, and pulling the mix from
+  // the main thread would starve the worklet.
+  @override
+  void initOffline(int channels, int sampleRate) =>
+      throw MiniaudioDartPlatformException(
+          "Offline rendering is not supported on the web.");
+  @override
+  Float32List render(int frames) => Float32List(0);
+  @override
+  bool renderToFile(String path, int frames) => false;
+
+  @override
+  PlatformPlaylist createPlaylist(int crossfadeMs) {
+    final self = wasm.playlist_alloc();
+    if (self == 0) throw MiniaudioDartPlatformOutOfMemoryException();
+    if (wasm.playlist_init(self, _self, crossfadeMs) != 1) {
+      wasm.playlist_free(self);
+      throw MiniaudioDartPlatformException("Failed to init the playlist.");
+    }
+    final playlist = WebPlaylist._(self, this);
+    _playlists.add(playlist);
+    return playlist;
+  }
+
+  @override
+  PlatformMixBus createBus(String name) {
+    final self = wasm.mix_bus_alloc();
+    if (self == 0) throw MiniaudioDartPlatformOutOfMemoryException();
+    if (_withKey(name, (n) => wasm.mix_bus_init(self, _self, n)) != 1) {
+      wasm.mix_bus_free(self);
+      throw MiniaudioDartPlatformException("Failed to init the bus.");
+    }
+    final bus = WebMixBus._(self, this, name);
+    _buses.add(bus);
+    return bus;
+  }
+
+  @override
+  PlatformEffect createEffect(EffectType type) {
+    final self = wasm.effect_alloc();
+    if (self == 0) throw MiniaudioDartPlatformOutOfMemoryException();
+    if (wasm.effect_init(self, _self, type.index) != 1) {
+      wasm.effect_free(self);
+      throw MiniaudioDartPlatformException("Failed to init the effect.");
+    }
+    final effect = WebEffect._(self, this, type);
+    _effects.add(effect);
+    return effect;
+  }
+
+  @override
+  (int count, int bytes) get sharedAssetStats {
+    final ptr = mem.allocate(16);
+    try {
+      if (wasm.engine_get_asset_stats(_self, ptr, ptr + 8) != 1) return (0, 0);
+      final lo = mem.readI32(ptr + 8) & 0xffffffff;
+      final hi = mem.readI32(ptr + 12) & 0xffffffff;
+      return (mem.readI32(ptr), hi * 0x100000000 + lo);
+    } finally {
+      mem.free(ptr);
+    }
+  }
+
+  // NUL-terminated UTF-8 copy of key in wasm memory (0 when key is null).
+  T _withKey<T>(String? key, T Function(int keyPtr) body) {
+    if (key == null) return body(0);
+    final encoded = utf8.encode(key);
+    final ptr = mem.allocate(encoded.length + 1);
+    try {
+      final heap = mem.HEAPU8.toDart;
+      heap.setRange(ptr, ptr + encoded.length, encoded);
+      heap[ptr + encoded.length] = 0;
+      return body(ptr);
+    } finally {
+      mem.free(ptr);
     }
   }
 
@@ -599,6 +1032,11 @@ final class WebSound implements PlatformSound {
   @override
   late final double duration = wasm.sound_get_duration(_self);
 
+  @override
+  double get priority => wasm.sound_get_priority(_self);
+  @override
+  set priority(double value) => wasm.sound_set_priority(_self, value);
+
   var _looping = (false, 0);
   @override
   PlatformSoundLooping get looping => _looping;
@@ -637,6 +1075,44 @@ final class WebSound implements PlatformSound {
   void pause() => wasm.sound_pause(_self);
   @override
   void stop() => wasm.sound_stop(_self);
+  // No int64 arguments on web (see WebEngine.timeInFrames): immediate.
+  @override
+  bool playAt(int timeInFrames) => wasm.sound_play(_self) == 1;
+  @override
+  void stopAt(int timeInFrames) {}
+
+  @override
+  bool setPolyphony(int maxVoices, VoiceStealPolicy policy) =>
+      wasm.sound_set_polyphony(_self, maxVoices, policy.index) == 1;
+  @override
+  int get polyphony => wasm.sound_get_polyphony(_self);
+  @override
+  int playVoice(double volume, int priority, bool looped) =>
+      wasm.sound_play_voice(_self, volume, priority, looped);
+  @override
+  int playVoiceAt(
+      double volume, int priority, bool looped, int timeInFrames) =>
+      wasm.sound_play_voice(_self, volume, priority, looped);
+  @override
+  void stopVoice(int voice) => wasm.sound_stop_voice(_self, voice);
+  @override
+  bool isVoicePlaying(int voice) => wasm.sound_voice_is_playing(_self, voice);
+  @override
+  void setVoiceVolume(int voice, double value) =>
+      wasm.sound_set_voice_volume(_self, voice, value);
+  @override
+  int get activeVoices => wasm.sound_get_active_voices(_self);
+
+  @override
+  bool setBus(PlatformMixBus? bus) =>
+      wasm.sound_set_bus(_self, WebMixBus._native(bus)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) =>
+      wasm.sound_insert_effect(_self, WebEffect._node(effect), index) == 1;
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      wasm.sound_remove_effect(_self, WebEffect._node(effect)) == 1;
 
   @override
   bool rebindToEngine(PlatformEngine engine) {
@@ -645,6 +1121,164 @@ final class WebSound implements PlatformSound {
   }
 }
 
+// Web Playlist implementation (matching FFI)
+final class WebPlaylist implements PlatformPlaylist {
+  WebPlaylist._(this._self, this._engine);
+
+  final int _self;
+  final WebEngine _engine;
+  bool _disposed = false;
+
+  @override
+  void start() {
+    if (wasm.playlist_start(_self) != 1) {
+      throw MiniaudioDartPlatformException("Failed to start the playlist.");
+    }
+  }
+
+  @override
+  void stop() => wasm.playlist_stop(_self);
+
+  @override
+  double get volume => wasm.playlist_get_volume(_self);
+  @override
+  set volume(double value) => wasm.playlist_set_volume(_self, value);
+
+  @override
+  int get crossfadeMs => wasm.playlist_get_crossfade(_self);
+  @override
+  set crossfadeMs(int value) => wasm.playlist_set_crossfade(_self, value);
+
+  @override
+  int add(AudioData audioData) {
+    final bytes = audioData.buffer.lengthInBytes;
+    if (bytes == 0) return 0;
+    final dataPtr = mem.allocate(bytes);
+    try {
+      mem.copyFromTypedData(dataPtr, audioData.buffer);
+      if (audioData.format == AudioFormat.unknown) {
+        return wasm.playlist_enqueue(_self, dataPtr, bytes);
+      }
+      return wasm.playlist_enqueue_pcm(_self, dataPtr, bytes, audioData.format,
+          audioData.channels, audioData.sampleRate);
+    } finally {
+      mem.free(dataPtr);
+    }
+  }
+
+  @override
+  int addFile(String path) => throw MiniaudioDartPlatformException(
+      "addFile: no file system on the web, use add");
+
+  @override
+  void skip() => wasm.playlist_skip(_self);
+  @override
+  void clear() => wasm.playlist_clear(_self);
+
+  @override
+  int get current => wasm.playlist_get_current(_self);
+  @override
+  int get queued => wasm.playlist_get_queued(_self);
+
+  @override
+  bool setBus(PlatformMixBus? bus) =>
+      wasm.playlist_set_bus(_self, WebMixBus._native(bus)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) =>
+      wasm.playlist_insert_effect(_self, WebEffect._node(effect), index) == 1;
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      wasm.playlist_remove_effect(_self, WebEffect._node(effect)) == 1;
+
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _engine._playlists.remove(this);
+    wasm.playlist_free(_self);
+  }
+}
+
+// Web MixBus implementation (matching FFI)
+final class WebMixBus implements PlatformMixBus {
+  WebMixBus._(this._self, this._engine, this.name);
+
+  final int _self;
+  final WebEngine _engine;
+  bool _disposed = false;
+
+  static int _native(PlatformMixBus? bus) =>
+      bus is WebMixBus && !bus._disposed ? bus._self : 0;
+
+  @override
+  final String name;
+
+  @override
+  double get volume => wasm.mix_bus_get_volume(_self);
+  @override
+  set volume(double value) => wasm.mix_bus_set_volume(_self, value);
+
+  @override
+  bool get muted => wasm.mix_bus_get_muted(_self);
+  @override
+  set muted(bool value) => wasm.mix_bus_set_muted(_self, value);
+
+  @override
+  bool setParent(PlatformMixBus? parent) =>
+      wasm.mix_bus_set_parent(_self, _native(parent)) == 1;
+
+  @override
+  bool insertEffect(PlatformEffect effect, int index) =>
+      wasm.mix_bus_insert_effect(_self, WebEffect._node(effect), index) == 1;
+  @override
+  bool removeEffect(PlatformEffect effect) =>
+      wasm.mix_bus_remove_effect(_self, WebEffect._node(effect)) == 1;
+
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _engine._buses.remove(this);
+    wasm.mix_bus_free(_self);
+  }
+}
+
+// Web Effect implementation (matching FFI)
+final class WebEffect implements PlatformEffect {
+  WebEffect._(this._self, this._engine, this.type);
+
+  final int _self;
+  final WebEngine _engine;
+  bool _disposed = false;
+
+  static int _node(PlatformEffect effect) =>
+      effect is WebEffect && !effect._disposed ? effect._self : 0;
+
+  @override
+  final EffectType type;
+
+  @override
+  double getParam(int param) => wasm.effect_get_param(_self, param);
+  @override
+  bool setParam(int param, double value) =>
+      wasm.effect_set_param(_self, param, value) == 1;
+
+  @override
+  double get reductionDb => wasm.effect_get_reduction_db(_self);
+
+  @override
+  void reset() => wasm.effect_reset(_self);
+
+  @override
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    _engine._effects.remove(this);
+    wasm.effect_free(_self);
+  }
+}
+
 // Web Generator implementation (matching FFI)
 class WebGenerator implements PlatformGenerator {
   WebGenerator(this._self);